@@ -0,0 +1,527 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "mvk/DrawList.hpp"
+#include "mvk/Instance.hpp"
+#include "mvk/PipelineCache.hpp"
+
+#if defined(MVK_EMBED_SHADERS)
+#include "testCompute/square.comp.spv.hpp"
+#endif
+
+// Microbenchmarks for the hot paths of libmarsvk.
+//
+// usage: benchmark [--device N] [--samples N] [--filter SUBSTRING] [--json] [--output PATH] [--baseline PATH] [--threshold FRACTION]
+//
+// Each benchmark is run for a number of samples; every sample times a batch of operations and
+// reports the mean time of one operation in the batch. The median of the samples is compared
+// against the baseline, and the process exits with 1 if any benchmark regressed by more than the
+// threshold. Baselines are files previously written with --output.
+
+constexpr int INPUT_BUFFER_BINDING = 0;
+constexpr int OUTPUT_BUFFER_BINDING = 1;
+constexpr VkDeviceSize BUFFER_SIZE = 64 * 1024;
+constexpr std::uint32_t PIPELINE_BATCH_SIZE = 64;
+constexpr std::size_t DRAW_LIST_SIZE = 100 * 1000;
+constexpr std::size_t DRAW_LIST_DESCRIPTOR_SETS = 64;
+
+struct Options {
+    std::ptrdiff_t device = 0;
+    std::size_t samples = 50;
+    std::string filter;
+    bool json = false;
+    std::string outputPath;
+    std::string baselinePath;
+    double threshold = 0.10;
+};
+
+struct Result {
+    std::string name;
+    std::size_t samples;
+    std::size_t batch;
+    double minNs;
+    double medianNs;
+    double meanNs;
+    double p99Ns;
+};
+
+class Runner {
+    const Options& _options;
+    std::vector<Result> _results;
+
+public:
+    Runner(const Options& options) :
+        _options(options) {}
+
+    // fn performs batch operations. Only the time spent in fn is measured.
+    void run(const std::string& name, std::size_t batch, const std::function<void(std::size_t)>& fn) {
+        if (!_options.filter.empty() && std::string::npos == name.find(_options.filter)) {
+            return;
+        }
+
+        // warm up allocators and caches
+        fn(batch);
+
+        auto samples = std::vector<double> ();
+        samples.reserve(_options.samples);
+
+        for (std::size_t i = 0; i < _options.samples; i++) {
+            const auto start = std::chrono::steady_clock::now();
+
+            fn(batch);
+
+            const auto end = std::chrono::steady_clock::now();
+
+            samples.push_back(std::chrono::duration<double, std::nano> (end - start).count() / batch);
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        auto result = Result {};
+        result.name = name;
+        result.samples = samples.size();
+        result.batch = batch;
+        result.minNs = samples.front();
+        result.medianNs = samples[samples.size() / 2];
+        result.p99Ns = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+
+        double sum = 0.0;
+
+        for (auto sample : samples) {
+            sum += sample;
+        }
+
+        result.meanNs = sum / samples.size();
+
+        if (!_options.json) {
+            std::cout << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(1)
+                << std::setw(14) << result.medianNs << " ns"
+                << std::setw(14) << result.p99Ns << " ns p99" << std::endl;
+        }
+
+        _results.push_back(result);
+    }
+
+    const std::vector<Result>& getResults() const noexcept {
+        return _results;
+    }
+};
+
+std::string toJSON(const mvk::PhysicalDevice& physicalDevice, const std::vector<Result>& results) {
+    const auto& properties = physicalDevice.getProperties();
+    auto out = std::stringstream ();
+
+    out << std::setprecision(6);
+    out << "{\"device\":" << mvk::Util::escapeJSON(properties.deviceName)
+        << ",\"vendorID\":" << properties.vendorID
+        << ",\"deviceID\":" << properties.deviceID
+        << ",\"driverVersion\":" << properties.driverVersion
+        << ",\"benchmarks\":[";
+
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const auto& result = results[i];
+
+        out << (i > 0 ? "," : "") << "\n  {\"name\":" << mvk::Util::escapeJSON(result.name)
+            << ",\"samples\":" << result.samples
+            << ",\"batch\":" << result.batch
+            << ",\"minNs\":" << result.minNs
+            << ",\"medianNs\":" << result.medianNs
+            << ",\"meanNs\":" << result.meanNs
+            << ",\"p99Ns\":" << result.p99Ns
+            << "}";
+    }
+
+    out << "\n]}";
+
+    return out.str();
+}
+
+// Reads the median of every benchmark from a file written by toJSON.
+std::map<std::string, double> loadBaseline(const std::string& path) {
+    std::ifstream file(path);
+
+    if (!file) {
+        throw std::runtime_error("Unable to open baseline file: " + path);
+    }
+
+    auto text = std::string(std::istreambuf_iterator<char> (file), std::istreambuf_iterator<char> ());
+    auto pattern = std::regex("\\{\"name\":\"([^\"]*)\"[^}]*\"medianNs\":([-+0-9.eE]+)");
+    auto out = std::map<std::string, double> ();
+
+    for (auto it = std::sregex_iterator(text.begin(), text.end(), pattern); it != std::sregex_iterator(); ++it) {
+        out[(*it)[1].str()] = std::stod((*it)[2].str());
+    }
+
+    return out;
+}
+
+// Prints the change of every benchmark against the baseline. Returns the number of regressions.
+std::size_t compare(const std::map<std::string, double>& baseline, const std::vector<Result>& results, double threshold) {
+    std::size_t regressions = 0;
+
+    std::cerr << "\nComparison against baseline (threshold " << std::setprecision(1) << std::fixed << threshold * 100.0 << "%):" << std::endl;
+
+    for (const auto& result : results) {
+        auto it = baseline.find(result.name);
+
+        if (baseline.end() == it) {
+            std::cerr << std::left << std::setw(40) << result.name << "  (new)" << std::endl;
+            continue;
+        }
+
+        const auto change = (result.medianNs - it->second) / it->second;
+        const bool regressed = change > threshold;
+
+        if (regressed) {
+            regressions++;
+        }
+
+        std::cerr << std::left << std::setw(40) << result.name << std::right
+            << std::setw(12) << it->second << " ->" << std::setw(12) << result.medianNs << " ns"
+            << std::setw(9) << std::showpos << change * 100.0 << std::noshowpos << "%"
+            << (regressed ? "  REGRESSION" : "") << std::endl;
+    }
+
+    return regressions;
+}
+
+Options parseOptions(int argc, char ** argv) {
+    auto options = Options {};
+
+    for (int i = 1; i < argc; i++) {
+        const auto arg = std::string(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if ("--device" == arg && hasValue) {
+            options.device = std::atoi(argv[++i]);
+        } else if ("--samples" == arg && hasValue) {
+            options.samples = std::max(1, std::atoi(argv[++i]));
+        } else if ("--filter" == arg && hasValue) {
+            options.filter = argv[++i];
+        } else if ("--json" == arg) {
+            options.json = true;
+        } else if ("--output" == arg && hasValue) {
+            options.outputPath = argv[++i];
+        } else if ("--baseline" == arg && hasValue) {
+            options.baselinePath = argv[++i];
+        } else if ("--threshold" == arg && hasValue) {
+            options.threshold = std::atof(argv[++i]);
+        } else {
+            throw std::runtime_error("Unknown argument: " + arg);
+        }
+    }
+
+    return options;
+}
+
+int main(int argc, char ** argv) {
+    const auto options = parseOptions(argc, argv);
+
+    auto& instance = mvk::Instance::getCurrent();
+    auto& physicalDevice = instance.getPhysicalDevice(options.device);
+    auto pDevice = physicalDevice.createDevice();
+
+    if (!options.json) {
+        std::cout << physicalDevice.toString() << std::endl;
+    }
+
+    auto pQueueFamily = pDevice->getQueueFamily(0);
+    auto pQueue = pQueueFamily->getQueue(0);
+    auto pCommandPool = pQueueFamily->getCurrentCommandPool();
+
+    auto bufferCI = mvk::Buffer::CreateInfo {};
+    bufferCI.usage = mvk::BufferUsageFlag::STORAGE_BUFFER;
+    bufferCI.size = BUFFER_SIZE;
+
+    auto pStorageBuffer = pDevice->createBuffer(bufferCI, mvk::MemoryUsage::GPU_ONLY);
+
+    auto setLayoutInfo = mvk::DescriptorSetLayout::CreateInfo {};
+
+    {
+        auto dslBinding = mvk::DescriptorSetLayout::Binding {};
+        dslBinding.stages = mvk::ShaderStage::COMPUTE;
+        dslBinding.descriptorType = mvk::DescriptorType::STORAGE_BUFFER;
+        dslBinding.descriptorCount = 1;
+        dslBinding.binding = INPUT_BUFFER_BINDING;
+
+        setLayoutInfo.bindings.push_back(dslBinding);
+
+        dslBinding.binding = OUTPUT_BUFFER_BINDING;
+
+        setLayoutInfo.bindings.push_back(dslBinding);
+    }
+
+    auto pipelineCI = mvk::ComputePipeline::CreateInfo {};
+    pipelineCI.stage.name = "main";
+    pipelineCI.stage.stage = mvk::ShaderStage::COMPUTE;
+    pipelineCI.stage.moduleInfo.path = "shaders/testCompute/square.comp.spv";
+    pipelineCI.layoutInfo.setLayoutInfos.push_back(setLayoutInfo);
+
+    // holds the layouts in the caches so that lookups measure hits
+    auto pPipeline = pDevice->createPipeline(pipelineCI);
+    auto pSetLayout = pPipeline->getDescriptorSetLayout(0);
+
+    Runner runner(options);
+
+    {
+        auto pCommandBuffer = pCommandPool->allocate();
+
+        pCommandBuffer->begin(mvk::CommandBufferUsageFlag::SIMULTANEOUS_USE);
+        pCommandBuffer->end();
+
+        runner.run("Queue::submit", 100, [&](std::size_t batch) {
+            for (std::size_t i = 0; i < batch; i++) {
+                pQueue->submit(pCommandBuffer.get());
+            }
+
+            pQueue->waitIdle();
+        });
+
+        auto pFence = pDevice->acquireFence();
+
+        runner.run("Queue::submit+Fence::waitFor", 20, [&](std::size_t batch) {
+            for (std::size_t i = 0; i < batch; i++) {
+                pQueue->submit(pCommandBuffer.get(), pFence);
+                pFence->waitFor();
+                pFence->reset();
+            }
+        });
+
+        pFence->release();
+    }
+
+    runner.run("CommandPool::allocate", 100, [&](std::size_t batch) {
+        for (std::size_t i = 0; i < batch; i++) {
+            auto pCommandBuffer = pCommandPool->allocate();
+        }
+    });
+
+    runner.run("DescriptorPool::allocate+release", 100, [&](std::size_t batch) {
+        for (std::size_t i = 0; i < batch; i++) {
+            pSetLayout->allocate()->release();
+        }
+    });
+
+    {
+        auto pDescriptorSet = pSetLayout->allocate();
+
+        runner.run("DescriptorSet::writeBuffer", 1000, [&](std::size_t batch) {
+            for (std::size_t i = 0; i < batch; i++) {
+                pDescriptorSet->writeBuffer(mvk::DescriptorType::STORAGE_BUFFER, INPUT_BUFFER_BINDING, pStorageBuffer.get());
+            }
+        });
+
+        pDescriptorSet->release();
+    }
+
+    runner.run("DescriptorSetLayoutCache::allocate", 1000, [&](std::size_t batch) {
+        for (std::size_t i = 0; i < batch; i++) {
+            pDevice->allocateDescriptorSetLayout(setLayoutInfo)->release();
+        }
+    });
+
+    runner.run("PipelineLayoutCache::allocate", 1000, [&](std::size_t batch) {
+        for (std::size_t i = 0; i < batch; i++) {
+            pDevice->allocatePipelineLayout(pipelineCI.layoutInfo)->release();
+        }
+    });
+
+    {
+        auto samplerCI = mvk::Sampler::CreateInfo {};
+        samplerCI.minFilter = mvk::Filter::LINEAR;
+        samplerCI.magFilter = mvk::Filter::LINEAR;
+        samplerCI.maxLod = 1.0F;
+
+        auto pSampler = pDevice->allocateSampler(samplerCI);
+
+        runner.run("SamplerCache::allocate", 1000, [&](std::size_t batch) {
+            for (std::size_t i = 0; i < batch; i++) {
+                pDevice->allocateSampler(samplerCI)->release();
+            }
+        });
+
+        pSampler->release();
+    }
+
+    runner.run("Device::getShaderModule", 1000, [&](std::size_t batch) {
+        for (std::size_t i = 0; i < batch; i++) {
+            pDevice->getShaderModule(pipelineCI.stage.moduleInfo);
+        }
+    });
+
+    runner.run("ComputePipeline (cold PipelineCache)", 1, [&](std::size_t batch) {
+        for (std::size_t i = 0; i < batch; i++) {
+            mvk::PipelineCache cache(pDevice.get());
+            auto pColdPipeline = cache.createPipeline(pipelineCI);
+        }
+    });
+
+    {
+        // workgroup size variants of the kernel, so every pipeline of the batch is compiled separately
+        auto variantCIs = std::vector<mvk::ComputePipeline::CreateInfo> ();
+
+        for (std::uint32_t workgroupSize = 1; workgroupSize <= PIPELINE_BATCH_SIZE; workgroupSize++) {
+            auto variantCI = pipelineCI;
+            variantCI.stage.specializationInfo.set(0, workgroupSize);
+
+            variantCIs.push_back(std::move(variantCI));
+        }
+
+        runner.run("ComputePipeline x" + std::to_string(PIPELINE_BATCH_SIZE) + " (cold, serial)", PIPELINE_BATCH_SIZE, [&](std::size_t batch) {
+            mvk::PipelineCache cache(pDevice.get());
+
+            for (std::size_t i = 0; i < batch; i++) {
+                auto pColdPipeline = cache.createPipeline(variantCIs[i]);
+            }
+        });
+
+        runner.run("PipelineCache::createPipelines x" + std::to_string(PIPELINE_BATCH_SIZE) + " (cold)", PIPELINE_BATCH_SIZE, [&](std::size_t batch) {
+            mvk::PipelineCache cache(pDevice.get());
+            auto pColdPipelines = cache.createPipelines(variantCIs);
+        });
+
+        runner.run("PipelineCache::createPipelines x" + std::to_string(PIPELINE_BATCH_SIZE) + " (cold, merged caches)", PIPELINE_BATCH_SIZE, [&](std::size_t batch) {
+            auto batchInfo = mvk::PipelineCache::BatchInfo {};
+            batchInfo.mergeCaches = true;
+
+            mvk::PipelineCache cache(pDevice.get());
+            auto pColdPipelines = cache.createPipelines(variantCIs, batchInfo);
+        });
+    }
+
+    runner.run("ComputePipeline (warm PipelineCache)", 1, [&](std::size_t batch) {
+        for (std::size_t i = 0; i < batch; i++) {
+            auto pWarmPipeline = pDevice->createPipeline(pipelineCI);
+        }
+    });
+
+    {
+        // holding one reference keeps the shared pipeline alive, so every lookup is a hit
+        auto pSharedPipeline = pDevice->getPipeline(pipelineCI);
+
+        runner.run("PipelineCache::getPipeline (hit)", 1000, [&](std::size_t batch) {
+            for (std::size_t i = 0; i < batch; i++) {
+                auto pHitPipeline = pDevice->getPipeline(pipelineCI);
+            }
+        });
+    }
+
+    {
+        auto pCommandBuffer = pCommandPool->allocate();
+
+        auto barrier = mvk::BufferMemoryBarrier {};
+        barrier.srcAccessMask = mvk::AccessFlag::SHADER_WRITE;
+        barrier.dstAccessMask = mvk::AccessFlag::SHADER_READ;
+        barrier.buffer = pStorageBuffer.get();
+        barrier.offset = 0;
+        barrier.size = mvk::Buffer::WHOLE_SIZE;
+
+        runner.run("CommandBuffer::pipelineBarrier", 1000, [&](std::size_t batch) {
+            pCommandBuffer->begin(mvk::CommandBufferUsageFlag::ONE_TIME_SUBMIT);
+
+            for (std::size_t i = 0; i < batch; i++) {
+                pCommandBuffer->pipelineBarrier(
+                    mvk::PipelineStageFlag::COMPUTE_SHADER, mvk::PipelineStageFlag::COMPUTE_SHADER,
+                    mvk::DependencyFlag::NONE,
+                    0, nullptr,
+                    1, &barrier,
+                    0, nullptr);
+            }
+
+            pCommandBuffer->end();
+        });
+    }
+
+    {
+        // the sort only reads the state pointers, so one Pipeline and a few DescriptorSets make a realistic key spread
+        auto pDescriptorSets = std::vector<mvk::DescriptorSet *> ();
+
+        for (std::size_t i = 0; i < DRAW_LIST_DESCRIPTOR_SETS; i++) {
+            pDescriptorSets.push_back(pSetLayout->allocate());
+        }
+
+        mvk::DrawList drawList;
+        drawList.reserve(DRAW_LIST_SIZE);
+
+        for (std::size_t i = 0; i < DRAW_LIST_SIZE; i++) {
+            auto draw = mvk::DrawList::Draw {};
+            draw.pipeline = pPipeline.get();
+            draw.descriptorSet = pDescriptorSets[(i * 7919) % DRAW_LIST_DESCRIPTOR_SETS];
+            draw.count = 3;
+            draw.instanceCount = 1;
+            draw.depth = static_cast<float> ((i * 104729) % DRAW_LIST_SIZE) / DRAW_LIST_SIZE;
+
+            drawList.add(draw);
+        }
+
+        runner.run("DrawList::sort x" + std::to_string(DRAW_LIST_SIZE) + " (1 thread)", DRAW_LIST_SIZE, [&](std::size_t) {
+            drawList.sort(1);
+        });
+
+        runner.run("DrawList::sort x" + std::to_string(DRAW_LIST_SIZE) + " (all threads)", DRAW_LIST_SIZE, [&](std::size_t) {
+            drawList.sort();
+        });
+
+        for (auto pDescriptorSet : pDescriptorSets) {
+            pDescriptorSet->release();
+        }
+    }
+
+    {
+        auto stagingCI = mvk::Buffer::CreateInfo {};
+        stagingCI.usage = mvk::BufferUsageFlag::TRANSFER_SRC;
+        stagingCI.size = BUFFER_SIZE;
+
+        runner.run("Buffer create+map+destroy", 100, [&](std::size_t batch) {
+            for (std::size_t i = 0; i < batch; i++) {
+                auto pBuffer = pDevice->createBuffer(stagingCI, mvk::MemoryUsage::CPU_ONLY);
+
+                pBuffer->map();
+                pBuffer->unmap();
+            }
+        });
+    }
+
+    const auto json = toJSON(physicalDevice, runner.getResults());
+
+    if (options.json) {
+        std::cout << json << std::endl;
+    }
+
+    if (!options.outputPath.empty()) {
+        std::ofstream file(options.outputPath);
+
+        if (!file) {
+            throw std::runtime_error("Unable to open output file: " + options.outputPath);
+        }
+
+        file << json << std::endl;
+    }
+
+    int status = 0;
+
+    if (!options.baselinePath.empty()) {
+        if (compare(loadBaseline(options.baselinePath), runner.getResults(), options.threshold) > 0) {
+            status = 1;
+        }
+    }
+
+    pQueueFamily->detach();
+
+    return status;
+}
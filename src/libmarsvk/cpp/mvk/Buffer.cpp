@@ -5,6 +5,7 @@
 #include "volk.h"
 #include "vk_mem_alloc.h"
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
@@ -53,6 +54,8 @@ namespace mvk {
     Buffer::Buffer(Device * device, const Buffer::CreateInfo& createInfo, MemoryUsage memoryUsage) {
         _device = device;
         _info = createInfo;
+        _memoryUsage = memoryUsage;
+        _serial = Util::nextSerial();
 
         auto pQueueFamilyIndices = std::vector<std::uint32_t>();
         pQueueFamilyIndices.reserve(createInfo.queueFamilies.size());
@@ -70,6 +73,8 @@ namespace mvk {
         bufferCI.sharingMode = static_cast<VkSharingMode> (createInfo.sharingMode);
         bufferCI.size = static_cast<VkDeviceSize> (createInfo.size);
 
+        MVK_METRICS_SCOPED_TIMER(device, CREATE_BUFFER);
+
         if (createInfo.exported) {
             Util::vkAssert(vkCreateBuffer(device->getHandle(), &bufferCI, nullptr, &_handle));
 
@@ -96,6 +101,8 @@ namespace mvk {
 
             Util::vkAssert(vmaCreateBuffer(device->getMemoryAllocator(), &bufferCI, &allocationCI, &_handle, &_memory.local, nullptr));
         }
+
+        device->setObjectName(VK_OBJECT_TYPE_BUFFER, _handle, createInfo.name);
         
     }
 
@@ -115,7 +122,9 @@ namespace mvk {
     Buffer::Buffer(Buffer&& from) noexcept {
         _device = std::move(from._device);
         _info = std::move(from._info);
+        _memoryUsage = from._memoryUsage;
         _handle = std::exchange(from._handle, nullptr);
+        _serial = std::exchange(from._serial, 0);
 
         if (_info.exported) {
             _memory.shared = std::exchange(from._memory.shared, nullptr);
@@ -127,7 +136,9 @@ namespace mvk {
     Buffer& Buffer::operator= (Buffer&& from) noexcept {
         std::swap(_device, from._device);
         std::swap(_info, from._info);
+        std::swap(_memoryUsage, from._memoryUsage);
         std::swap(_handle, from._handle);
+        std::swap(_serial, from._serial);
         std::swap(_memory, from._memory);
         
         return *this;
@@ -153,6 +164,31 @@ namespace mvk {
         }
     }
 
+    void Buffer::flush(VkDeviceSize offset, VkDeviceSize size) noexcept {
+        if (_info.exported) {
+            // the range must cover whole nonCoherentAtomSize blocks or end at the end of the allocation
+            const auto atomSize = _device->getPhysicalDevice()->getProperties().limits.nonCoherentAtomSize;
+            auto memoryReqs = VkMemoryRequirements {};
+
+            vkGetBufferMemoryRequirements(_device->getHandle(), _handle, &memoryReqs);
+
+            auto mappedMemoryRange = VkMappedMemoryRange {};
+            mappedMemoryRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+            mappedMemoryRange.memory = _memory.shared;
+            mappedMemoryRange.offset = offset / atomSize * atomSize;
+
+            if (WHOLE_SIZE == size) {
+                mappedMemoryRange.size = VK_WHOLE_SIZE;
+            } else {
+                mappedMemoryRange.size = std::min(Util::alignUp(offset + size, atomSize), memoryReqs.size) - mappedMemoryRange.offset;
+            }
+
+            vkFlushMappedMemoryRanges(_device->getHandle(), 1, &mappedMemoryRange);
+        } else {
+            vmaFlushAllocation(_device->getMemoryAllocator(), _memory.local, offset, size);
+        }
+    }
+
     int Buffer::getFd() const {
         if (!_info.exported) {
             throw std::runtime_error("Memory is not exported!");
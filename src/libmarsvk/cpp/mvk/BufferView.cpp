@@ -18,6 +18,8 @@ namespace mvk {
         bufferViewCI.range = static_cast<VkDeviceSize> (info.range);
         bufferViewCI.format = static_cast<VkFormat> (info.format);
 
+        MVK_METRICS_SCOPED_TIMER(buffer->getDevice(), CREATE_BUFFER_VIEW);
+
         Util::vkAssert(vkCreateBufferView(buffer->getDevice()->getHandle(), &bufferViewCI, nullptr, &_handle));
     }
 
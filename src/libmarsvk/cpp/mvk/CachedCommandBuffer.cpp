@@ -0,0 +1,115 @@
+#include "mvk/CachedCommandBuffer.hpp"
+
+#include <utility>
+
+#include "mvk/Buffer.hpp"
+#include "mvk/CommandPool.hpp"
+#include "mvk/DescriptorSet.hpp"
+#include "mvk/Framebuffer.hpp"
+#include "mvk/Pipeline.hpp"
+#include "mvk/Swapchain.hpp"
+
+namespace mvk {
+    namespace {
+        inline std::uint64_t combine(std::uint64_t seed, std::uint64_t value) noexcept {
+            return seed ^ (value + 0x9E3779B97F4A7C15ULL + (seed << 6) + (seed >> 2));
+        }
+    }
+
+    CachedCommandBuffer::CachedCommandBuffer(CommandPool * pool, CommandBufferUsageFlag flags, RecordFunction recordFunction) {
+        _commandBuffer = pool->allocate(CommandBufferLevel::PRIMARY);
+        _flags = flags;
+        _recordFunction = std::move(recordFunction);
+        _invalidated = true;
+        _recordCount = 0;
+    }
+
+    std::uint64_t CachedCommandBuffer::keyOf(const Buffer * buffer) noexcept {
+        return buffer->getSerial();
+    }
+
+    std::uint64_t CachedCommandBuffer::keyOf(const Pipeline * pipeline) noexcept {
+        return pipeline->getSerial();
+    }
+
+    std::uint64_t CachedCommandBuffer::keyOf(const Framebuffer * framebuffer) noexcept {
+        return framebuffer->getSerial();
+    }
+
+    std::uint64_t CachedCommandBuffer::keyOf(const DescriptorSet * descriptorSet) noexcept {
+        return combine(descriptorSet->getSerial(), descriptorSet->getWriteCount());
+    }
+
+    std::uint64_t CachedCommandBuffer::keyOf(const Swapchain * swapchain) noexcept {
+        auto key = swapchain->getSerial();
+
+        key = combine(key, static_cast<std::uint64_t> (swapchain->getWidth()));
+        key = combine(key, static_cast<std::uint64_t> (swapchain->getHeight()));
+
+        return key;
+    }
+
+    void CachedCommandBuffer::track(std::function<std::uint64_t()> key) {
+        auto dependency = Dependency {};
+        dependency.recordedKey = key();
+        dependency.key = std::move(key);
+
+        _dependencies.push_back(std::move(dependency));
+        _invalidated = true;
+    }
+
+    void CachedCommandBuffer::track(const Buffer * buffer) {
+        track([buffer] () { return keyOf(buffer); });
+    }
+
+    void CachedCommandBuffer::track(const Pipeline * pipeline) {
+        track([pipeline] () { return keyOf(pipeline); });
+    }
+
+    void CachedCommandBuffer::track(const Framebuffer * framebuffer) {
+        track([framebuffer] () { return keyOf(framebuffer); });
+    }
+
+    void CachedCommandBuffer::track(const DescriptorSet * descriptorSet) {
+        track([descriptorSet] () { return keyOf(descriptorSet); });
+    }
+
+    void CachedCommandBuffer::track(const Swapchain * swapchain) {
+        track([swapchain] () { return keyOf(swapchain); });
+    }
+
+    bool CachedCommandBuffer::isStale() const {
+        if (_invalidated) {
+            return true;
+        }
+
+        for (const auto& dependency : _dependencies) {
+            if (dependency.key() != dependency.recordedKey) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    CommandBuffer * CachedCommandBuffer::getCommandBuffer() {
+        if (isStale()) {
+            if (_recordCount > 0) {
+                _commandBuffer->reset();
+            }
+
+            _commandBuffer->begin(_flags);
+            _recordFunction(_commandBuffer.get());
+            _commandBuffer->end();
+
+            for (auto& dependency : _dependencies) {
+                dependency.recordedKey = dependency.key();
+            }
+
+            _invalidated = false;
+            _recordCount++;
+        }
+
+        return _commandBuffer.get();
+    }
+}
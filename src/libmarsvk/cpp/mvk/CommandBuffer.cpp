@@ -11,6 +11,7 @@
 #include "mvk/Framebuffer.hpp"
 #include "mvk/Image.hpp"
 #include "mvk/Pipeline.hpp"
+#include "mvk/QueryPool.hpp"
 #include "mvk/RenderPass.hpp"
 #include "mvk/Util.hpp"
 
@@ -19,6 +20,8 @@ namespace mvk {
         std::swap(_pool, from._pool);
         std::swap(_level, from._level);
         std::swap(_handle, from._handle);
+        std::swap(_shadowState, from._shadowState);
+        std::swap(_recordStart, from._recordStart);
 
         return *this;
     }
@@ -31,16 +34,186 @@ namespace mvk {
         return _pool->getDevice();
     }
 
+    void CommandBuffer::reset(unsigned int flags) {
+        Util::vkAssert(vkResetCommandBuffer(_handle, static_cast<VkCommandBufferResetFlags> (flags)));
+
+        clearShadowState();
+    }
+
+    void CommandBuffer::setShadowStateEnabled(bool enabled) {
+        if (!enabled) {
+            flushDescriptorSets();
+            _shadowState = nullptr;
+        } else if (nullptr == _shadowState) {
+            _shadowState = std::make_unique<ShadowState> ();
+            _shadowState->redundantCalls = 0;
+
+            clearShadowState();
+        }
+    }
+
+    void CommandBuffer::clearShadowState() noexcept {
+        if (nullptr == _shadowState) {
+            return;
+        }
+
+        auto& state = *_shadowState;
+
+        std::fill_n(state.pipelines, MAX_SHADOW_BIND_POINTS, VkPipeline {});
+        std::fill_n(state.layouts, MAX_SHADOW_BIND_POINTS, VkPipelineLayout {});
+
+        for (auto& sets : state.descriptorSets) {
+            std::fill_n(sets, MAX_SHADOW_SETS, VkDescriptorSet {});
+        }
+
+        std::fill_n(state.vertexBuffers, MAX_SHADOW_BINDINGS, VkBuffer {});
+        std::fill_n(state.vertexOffsets, MAX_SHADOW_BINDINGS, 0);
+        state.indexBuffer = VK_NULL_HANDLE;
+        state.indexOffset = 0;
+        state.indexType = VK_INDEX_TYPE_UINT16;
+        state.hasViewport = false;
+        state.hasScissor = false;
+        state.pendingLayout = VK_NULL_HANDLE;
+        state.pendingSets.clear();
+        state.pendingDynamicOffsets.clear();
+    }
+
+    void CommandBuffer::flushDescriptorSets() noexcept {
+        if (nullptr == _shadowState || _shadowState->pendingSets.empty()) {
+            return;
+        }
+
+        auto& state = *_shadowState;
+
+        vkCmdBindDescriptorSets(
+            _handle, state.pendingBindPoint, state.pendingLayout, state.pendingFirstSet, 
+            static_cast<std::uint32_t> (state.pendingSets.size()), state.pendingSets.data(), 
+            static_cast<std::uint32_t> (state.pendingDynamicOffsets.size()), state.pendingDynamicOffsets.data());
+
+        state.pendingSets.clear();
+        state.pendingDynamicOffsets.clear();
+    }
+
+    void CommandBuffer::bindDescriptorSets(
+        VkPipelineBindPoint bindPoint, VkPipelineLayout layout, std::uint32_t firstSet, VkDescriptorSet set, 
+        std::size_t nDynamicOffsets, const std::uint32_t * pDynamicOffsets) noexcept {
+
+        if (nullptr == _shadowState) {
+            vkCmdBindDescriptorSets(_handle, bindPoint, layout, firstSet, 1, &set, static_cast<std::uint32_t> (nDynamicOffsets), pDynamicOffsets);
+            return;
+        }
+
+        auto& state = *_shadowState;
+        const auto bp = static_cast<std::size_t> (bindPoint);
+        const bool isTracked = bp < MAX_SHADOW_BIND_POINTS && firstSet < MAX_SHADOW_SETS;
+
+        if (isTracked) {
+            // dynamic offsets are not shadowed; so only binds without them can be redundant.
+            if (0 == nDynamicOffsets && layout == state.layouts[bp] && set == state.descriptorSets[bp][firstSet]) {
+                state.redundantCalls++;
+                return;
+            }
+
+            // binding with a different layout may disturb every other set.
+            if (layout != state.layouts[bp]) {
+                std::fill_n(state.descriptorSets[bp], MAX_SHADOW_SETS, VkDescriptorSet {});
+                state.layouts[bp] = layout;
+            }
+
+            state.descriptorSets[bp][firstSet] = (0 == nDynamicOffsets) ? set : VK_NULL_HANDLE;
+        }
+
+        const bool isMergeable = !state.pendingSets.empty() 
+            && bindPoint == state.pendingBindPoint 
+            && layout == state.pendingLayout 
+            && firstSet == state.pendingFirstSet + state.pendingSets.size();
+
+        if (isMergeable) {
+            state.redundantCalls++;
+        } else {
+            flushDescriptorSets();
+
+            state.pendingBindPoint = bindPoint;
+            state.pendingLayout = layout;
+            state.pendingFirstSet = firstSet;
+        }
+
+        state.pendingSets.push_back(set);
+        state.pendingDynamicOffsets.insert(state.pendingDynamicOffsets.end(), pDynamicOffsets, pDynamicOffsets + nDynamicOffsets);
+    }
+
     void CommandBuffer::begin(CommandBufferUsageFlag flags) {
+        clearShadowState();
+
+        // secondary CommandBuffers always require inheritance info; even if it inherits nothing.
+        auto inheritanceI = VkCommandBufferInheritanceInfo {};
+        inheritanceI.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+
         auto commandBufferBI = VkCommandBufferBeginInfo {};
         commandBufferBI.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
         commandBufferBI.flags = static_cast<VkCommandBufferUsageFlags> (flags);
 
+        if (CommandBufferLevel::SECONDARY == _level) {
+            commandBufferBI.pInheritanceInfo = &inheritanceI;
+        }
+
         Util::vkAssert(vkBeginCommandBuffer(_handle, &commandBufferBI));
+
+        _recordStart = getDevice()->getTracer().isRecording() ? Tracer::now() : 0;
+    }
+
+    void CommandBuffer::begin(CommandBufferUsageFlag flags, const RenderPass * renderPass, int subpass, const Framebuffer * framebuffer) {
+        clearShadowState();
+
+        if (CommandBufferLevel::SECONDARY != _level) {
+            throw std::runtime_error("Only secondary CommandBuffers can inherit RenderPass state!");
+        }
+
+        auto inheritanceI = VkCommandBufferInheritanceInfo {};
+        inheritanceI.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceI.renderPass = renderPass->getHandle();
+        inheritanceI.subpass = static_cast<std::uint32_t> (subpass);
+        inheritanceI.framebuffer = (nullptr == framebuffer) ? VK_NULL_HANDLE : framebuffer->getHandle();
+
+        auto commandBufferBI = VkCommandBufferBeginInfo {};
+        commandBufferBI.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        commandBufferBI.flags = static_cast<VkCommandBufferUsageFlags> (flags | CommandBufferUsageFlag::RENDER_PASS_CONTINUE);
+        commandBufferBI.pInheritanceInfo = &inheritanceI;
+
+        Util::vkAssert(vkBeginCommandBuffer(_handle, &commandBufferBI));
+
+        _recordStart = getDevice()->getTracer().isRecording() ? Tracer::now() : 0;
+    }
+
+    void CommandBuffer::begin(CommandBufferUsageFlag flags, const Framebuffer * framebuffer, int subpass) {
+        begin(flags, framebuffer->getRenderPass(), subpass, framebuffer);
+    }
+
+    void CommandBuffer::executeCommands(std::size_t commandBufferCount, const CommandBuffer * const * pCommandBuffers) noexcept {
+        flushDescriptorSets();
+
+        auto handles = std::vector<VkCommandBuffer> ();
+        handles.reserve(commandBufferCount);
+
+        for (std::size_t i = 0; i < commandBufferCount; i++) {
+            handles.push_back(pCommandBuffers[i]->getHandle());
+        }
+
+        vkCmdExecuteCommands(_handle, static_cast<std::uint32_t> (handles.size()), handles.data());
+
+        // state is undefined after executing secondary CommandBuffers.
+        clearShadowState();
     }
 
     void CommandBuffer::end() {
+        flushDescriptorSets();
+
         Util::vkAssert(vkEndCommandBuffer(_handle));
+
+        if (0 != _recordStart) {
+            getDevice()->getTracer().addSpan("CommandBuffer::record", "record", _recordStart, Tracer::now());
+            _recordStart = 0;
+        }
     }
 
     void CommandBuffer::bindDescriptorSet(
@@ -52,7 +225,7 @@ namespace mvk {
         auto set = descriptorSet->getHandle();
         auto offsets = reinterpret_cast<const uint32_t * > (pDynamicOffsets);
 
-        vkCmdBindDescriptorSets(_handle, bindPoint, layout, static_cast<uint32_t> (firstSet), 1, &set, nDynamicOffsets, offsets);
+        bindDescriptorSets(bindPoint, layout, static_cast<uint32_t> (firstSet), set, nDynamicOffsets, offsets);
     }
 
     void CommandBuffer::bindDescriptorSet(const Pipeline * pipeline, int firstSet, const DescriptorSet * descriptorSet) noexcept {
@@ -60,29 +233,47 @@ namespace mvk {
         auto layout = pipeline->getPipelineLayout()->getHandle();
         auto set = descriptorSet->getHandle();
 
-        vkCmdBindDescriptorSets(_handle, bindPoint, layout, static_cast<uint32_t> (firstSet), 1, &set, 0, nullptr);
+        bindDescriptorSets(bindPoint, layout, static_cast<uint32_t> (firstSet), set, 0, nullptr);
     }
 
     void CommandBuffer::bindPipeline(const Pipeline * pipeline) noexcept {
         auto bindPoint = static_cast<VkPipelineBindPoint> (pipeline->getBindPoint());
+        auto handle = pipeline->getHandle();
+
+        if (_shadowState && static_cast<std::size_t> (bindPoint) < MAX_SHADOW_BIND_POINTS) {
+            auto& boundPipeline = _shadowState->pipelines[bindPoint];
+
+            if (handle == boundPipeline) {
+                _shadowState->redundantCalls++;
+                return;
+            }
+
+            boundPipeline = handle;
+        }
 
-        vkCmdBindPipeline(_handle, bindPoint, pipeline->getHandle());
+        vkCmdBindPipeline(_handle, bindPoint, handle);
     }
 
     void CommandBuffer::dispatch(unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ) noexcept {
+        flushDescriptorSets();
+
         vkCmdDispatch(_handle, groupsX, groupsY, groupsZ);
     }
 
     void CommandBuffer::dispatchIndirect(const Buffer * buffer, std::ptrdiff_t offset) noexcept {
+        flushDescriptorSets();
+
         vkCmdDispatchIndirect(_handle, buffer->getHandle(), static_cast<VkDeviceSize> (offset));
     }
 
     void CommandBuffer::beginRenderPass(const Framebuffer * framebuffer, SubpassContents contents) noexcept {
+        flushDescriptorSets();
+
         const auto& info = framebuffer->getInfo();
         const auto& attachments = framebuffer->getAttachments();
 
         auto clearValues = std::vector<VkClearValue> ();
-        clearValues.resize(attachments.size());
+        clearValues.reserve(attachments.size());
 
         for (const auto& attachment : attachments) {
             auto aspect = Util::aspect(attachment->getInfo().format);
@@ -116,10 +307,14 @@ namespace mvk {
     }
 
     void CommandBuffer::endRenderPass() noexcept {
+        flushDescriptorSets();
+
         vkCmdEndRenderPass(_handle);
     }
 
     void CommandBuffer::nextSubpass(SubpassContents contents) noexcept {
+        flushDescriptorSets();
+
         vkCmdNextSubpass(_handle, static_cast<VkSubpassContents> (contents));
     }
 
@@ -132,6 +327,22 @@ namespace mvk {
         viewport.minDepth = minDepth;
         viewport.maxDepth = maxDepth;
 
+        if (_shadowState) {
+            const auto& current = _shadowState->viewport;
+            const bool isRedundant = _shadowState->hasViewport
+                && current.x == x && current.y == y 
+                && current.width == width && current.height == height
+                && current.minDepth == minDepth && current.maxDepth == maxDepth;
+
+            if (isRedundant) {
+                _shadowState->redundantCalls++;
+                return;
+            }
+
+            _shadowState->hasViewport = true;
+            _shadowState->viewport = viewport;
+        }
+
         vkCmdSetViewport(_handle, 0, 1, &viewport);
     }
 
@@ -142,6 +353,21 @@ namespace mvk {
         rect.extent.width = static_cast<std::uint32_t> (width);
         rect.extent.height = static_cast<std::uint32_t> (height);
 
+        if (_shadowState) {
+            const auto& current = _shadowState->scissor;
+            const bool isRedundant = _shadowState->hasScissor
+                && current.offset.x == rect.offset.x && current.offset.y == rect.offset.y
+                && current.extent.width == rect.extent.width && current.extent.height == rect.extent.height;
+
+            if (isRedundant) {
+                _shadowState->redundantCalls++;
+                return;
+            }
+
+            _shadowState->hasScissor = true;
+            _shadowState->scissor = rect;
+        }
+
         vkCmdSetScissor(_handle, 0, 1, &rect);
     }
 
@@ -149,33 +375,67 @@ namespace mvk {
         auto handle = buffer->getHandle();
         auto off = static_cast<VkDeviceSize> (offset);
 
+        if (_shadowState && static_cast<std::size_t> (binding) < MAX_SHADOW_BINDINGS) {
+            if (handle == _shadowState->vertexBuffers[binding] && off == _shadowState->vertexOffsets[binding]) {
+                _shadowState->redundantCalls++;
+                return;
+            }
+
+            _shadowState->vertexBuffers[binding] = handle;
+            _shadowState->vertexOffsets[binding] = off;
+        }
+
         vkCmdBindVertexBuffers(_handle, binding, 1, &handle, &off);
     }
 
     void CommandBuffer::bindIndexBuffer(const Buffer * buffer, std::ptrdiff_t offset, IndexType indexType) noexcept {
         auto off = static_cast<VkDeviceSize> (offset);
         auto type = static_cast<VkIndexType> (indexType);
+        auto handle = buffer->getHandle();
+
+        if (_shadowState) {
+            auto& state = *_shadowState;
 
-        vkCmdBindIndexBuffer(_handle, buffer->getHandle(), off, type);
+            if (handle == state.indexBuffer && off == state.indexOffset && type == state.indexType) {
+                state.redundantCalls++;
+                return;
+            }
+
+            state.indexBuffer = handle;
+            state.indexOffset = off;
+            state.indexType = type;
+        }
+
+        vkCmdBindIndexBuffer(_handle, handle, off, type);
     }
 
     void CommandBuffer::draw(int vertexCount, int instanceCount, int firstVertex, int firstInstance) noexcept {
+        flushDescriptorSets();
+
         vkCmdDraw(_handle, static_cast<uint32_t> (vertexCount), static_cast<uint32_t> (instanceCount), static_cast<uint32_t> (firstVertex), static_cast<uint32_t> (firstInstance));
     }
 
     void CommandBuffer::drawIndexed(int indexCount, int instanceCount, int firstIndex, int vertexOffset, int firstInstance) noexcept {
+        flushDescriptorSets();
+
         vkCmdDrawIndexed(_handle, static_cast<uint32_t> (indexCount), static_cast<uint32_t> (instanceCount), static_cast<uint32_t> (firstIndex), static_cast<uint32_t> (vertexOffset), static_cast<uint32_t> (firstInstance));
     }
 
     void CommandBuffer::drawIndirect(const Buffer * buffer, std::ptrdiff_t offset, int drawCount, int stride) noexcept {
+        flushDescriptorSets();
+
         vkCmdDrawIndirect(_handle, buffer->getHandle(), static_cast<VkDeviceSize> (offset), static_cast<uint32_t> (drawCount), static_cast<uint32_t> (stride));
     }
 
     void CommandBuffer::drawIndexedIndirect(const Buffer * buffer, std::ptrdiff_t offset, int drawCount, int stride) noexcept {
+        flushDescriptorSets();
+
         vkCmdDrawIndexedIndirect(_handle, buffer->getHandle(), static_cast<VkDeviceSize> (offset), static_cast<uint32_t> (drawCount), static_cast<uint32_t> (stride));
     }
 
     void CommandBuffer::pushConstants(const Pipeline * pipeline, ShaderStage stages, std::ptrdiff_t offset, std::size_t size, const void * data) noexcept {
+        flushDescriptorSets();
+
         vkCmdPushConstants(
             _handle, 
             pipeline->getPipelineLayout()->getHandle(), static_cast<VkShaderStageFlags> (stages), 
@@ -188,6 +448,8 @@ namespace mvk {
             const ImageSubresourceLayers& subresourceRange, 
             const Offset3D& offset, const Extent3D& extent) noexcept {
 
+        flushDescriptorSets();
+
         auto bufferImageCopy = VkBufferImageCopy {};
         bufferImageCopy.bufferOffset = static_cast<VkDeviceSize> (bufferOffset);
         bufferImageCopy.imageOffset.x = offset.x;
@@ -204,6 +466,30 @@ namespace mvk {
         vkCmdCopyBufferToImage(_handle, src->getHandle(), dst->getHandle(), static_cast<VkImageLayout> (layout), 1, &bufferImageCopy);
     }
 
+    void CommandBuffer::copyImageToBuffer(
+            const Image * src, ImageLayout layout,
+            const ImageSubresourceLayers& subresourceRange,
+            const Offset3D& offset, const Extent3D& extent,
+            const Buffer * dst, std::ptrdiff_t bufferOffset) noexcept {
+
+        flushDescriptorSets();
+
+        auto bufferImageCopy = VkBufferImageCopy {};
+        bufferImageCopy.bufferOffset = static_cast<VkDeviceSize> (bufferOffset);
+        bufferImageCopy.imageOffset.x = offset.x;
+        bufferImageCopy.imageOffset.y = offset.y;
+        bufferImageCopy.imageOffset.z = offset.z;
+        bufferImageCopy.imageExtent.width = static_cast<std::uint32_t> (extent.width);
+        bufferImageCopy.imageExtent.height = static_cast<std::uint32_t> (extent.height);
+        bufferImageCopy.imageExtent.depth = static_cast<std::uint32_t> (extent.depth);
+        bufferImageCopy.imageSubresource.aspectMask = static_cast<VkImageAspectFlags> (subresourceRange.aspectMask);
+        bufferImageCopy.imageSubresource.baseArrayLayer = static_cast<std::uint32_t> (subresourceRange.baseArrayLayer);
+        bufferImageCopy.imageSubresource.mipLevel = static_cast<std::uint32_t> (subresourceRange.mipLevel);
+        bufferImageCopy.imageSubresource.layerCount = static_cast<std::uint32_t> (subresourceRange.layerCount);
+
+        vkCmdCopyImageToBuffer(_handle, src->getHandle(), static_cast<VkImageLayout> (layout), dst->getHandle(), 1, &bufferImageCopy);
+    }
+
     void CommandBuffer::copyImage(
             const Image * src, ImageLayout srcLayout,
             const Image * dst, ImageLayout dstLayout,
@@ -211,6 +497,8 @@ namespace mvk {
             const ImageSubresourceLayers& srcSubresource,
             const ImageSubresourceLayers& dstSubresource) noexcept {
 
+        flushDescriptorSets();
+
         auto imageCopy = VkImageCopy {};
         imageCopy.srcOffset.x = srcOffset.x;
         imageCopy.srcOffset.y = srcOffset.y;
@@ -242,6 +530,8 @@ namespace mvk {
             const ImageSubresourceLayers& dstSubresource,
             Filter filter) noexcept {
 
+        flushDescriptorSets();
+
         auto imageBlit = VkImageBlit {};
         imageBlit.srcOffsets[0].x = srcOffset0.x;
         imageBlit.srcOffsets[0].y = srcOffset0.y;
@@ -274,6 +564,8 @@ namespace mvk {
             const ImageSubresourceLayers& dstSubresource,
             Filter filter) noexcept {
 
+        flushDescriptorSets();
+
         auto srcOffset1 = Offset3D{};
         srcOffset1.x = src->getInfo().extent.width;
         srcOffset1.y = src->getInfo().extent.height;
@@ -293,6 +585,8 @@ namespace mvk {
             PipelineStageFlag srcStageMask, PipelineStageFlag dstStageMask,
             AccessFlag srcAccess, AccessFlag dstAccess) noexcept {
 
+        flushDescriptorSets();
+
         auto imageMemoryBarrier = VkImageMemoryBarrier {};
         imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
         imageMemoryBarrier.srcAccessMask = static_cast<VkAccessFlags> (srcAccess);
@@ -311,6 +605,8 @@ namespace mvk {
         imageMemoryBarrier.subresourceRange.baseMipLevel = static_cast<std::uint32_t> (subresourceRange.baseMipLevel);
         imageMemoryBarrier.subresourceRange.levelCount = static_cast<std::uint32_t> (subresourceRange.levelCount);
 
+        MVK_METRICS_INCREMENT(getDevice(), PIPELINE_BARRIERS);
+
         vkCmdPipelineBarrier(_handle, static_cast<VkPipelineStageFlags> (srcStageMask), static_cast<VkPipelineStageFlags> (dstStageMask), 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
     }
 
@@ -319,11 +615,17 @@ namespace mvk {
             std::ptrdiff_t srcOffset, std::ptrdiff_t dstOffset,
             std::size_t size) noexcept {
 
+        flushDescriptorSets();
+
         auto region = VkBufferCopy {};
         region.srcOffset = static_cast<VkDeviceSize> (srcOffset);
         region.dstOffset = static_cast<VkDeviceSize> (dstOffset);
         region.size = static_cast<VkDeviceSize> (size);
 
+        if (MemoryUsage::CPU_ONLY == src->getMemoryUsage() || MemoryUsage::CPU_TO_GPU == src->getMemoryUsage()) {
+            MVK_METRICS_ADD(getDevice(), BYTES_UPLOADED, size);
+        }
+
         vkCmdCopyBuffer(_handle, src->getHandle(), dst->getHandle(), 1, &region);
     }
 
@@ -337,6 +639,8 @@ namespace mvk {
             std::size_t imageMemoryBarrierCount,
             const ImageMemoryBarrier * pImageMemoryBarriers) noexcept {
 
+        flushDescriptorSets();
+
         auto memoryBarriers = std::vector<VkMemoryBarrier> ();
         memoryBarriers.reserve(memoryBarrierCount);
 
@@ -406,6 +710,8 @@ namespace mvk {
             imageMemoryBarriers.push_back(imageMemoryBarrier);
         });
 
+        MVK_METRICS_INCREMENT(getDevice(), PIPELINE_BARRIERS);
+
         vkCmdPipelineBarrier(
             _handle, 
             static_cast<VkPipelineStageFlags> (srcStageMask), static_cast<VkPipelineStageFlags> (dstStageMask), static_cast<VkDependencyFlags> (dependencyFlags), 
@@ -413,4 +719,100 @@ namespace mvk {
             bufferMemoryBarriers.size(), bufferMemoryBarriers.empty() ? nullptr : bufferMemoryBarriers.data(),
             imageMemoryBarriers.size(), imageMemoryBarriers.empty() ? nullptr : imageMemoryBarriers.data());
     }
+
+    void CommandBuffer::resetQueryPool(const QueryPool * queryPool, std::uint32_t firstQuery, std::uint32_t queryCount) noexcept {
+        flushDescriptorSets();
+
+        vkCmdResetQueryPool(_handle, queryPool->getHandle(), firstQuery, queryCount);
+    }
+
+    void CommandBuffer::beginQuery(const QueryPool * queryPool, std::uint32_t query, bool precise) noexcept {
+        flushDescriptorSets();
+
+        vkCmdBeginQuery(_handle, queryPool->getHandle(), query, precise ? VK_QUERY_CONTROL_PRECISE_BIT : 0);
+    }
+
+    void CommandBuffer::endQuery(const QueryPool * queryPool, std::uint32_t query) noexcept {
+        flushDescriptorSets();
+
+        vkCmdEndQuery(_handle, queryPool->getHandle(), query);
+    }
+
+    void CommandBuffer::writeTimestamp(PipelineStageFlag stage, const QueryPool * queryPool, std::uint32_t query) noexcept {
+        flushDescriptorSets();
+
+        vkCmdWriteTimestamp(_handle, static_cast<VkPipelineStageFlagBits> (stage), queryPool->getHandle(), query);
+    }
+
+    void CommandBuffer::copyQueryPoolResults(
+        const QueryPool * queryPool, std::uint32_t firstQuery, std::uint32_t queryCount,
+        const Buffer * dst, std::ptrdiff_t dstOffset, std::size_t stride,
+        QueryResultFlag flags) noexcept {
+
+        flushDescriptorSets();
+
+        vkCmdCopyQueryPoolResults(
+            _handle, queryPool->getHandle(), firstQuery, queryCount,
+            dst->getHandle(), static_cast<VkDeviceSize> (dstOffset), static_cast<VkDeviceSize> (stride),
+            static_cast<VkQueryResultFlags> (flags));
+    }
+
+    void CommandBuffer::fillBuffer(const Buffer * dst, std::ptrdiff_t dstOffset, std::size_t size, std::uint32_t data) noexcept {
+        flushDescriptorSets();
+
+        vkCmdFillBuffer(_handle, dst->getHandle(), static_cast<VkDeviceSize> (dstOffset), static_cast<VkDeviceSize> (size), data);
+    }
+
+    void CommandBuffer::beginConditionalRendering(const Buffer * buffer, std::ptrdiff_t offset, bool inverted) noexcept {
+        flushDescriptorSets();
+
+        auto conditionalRenderingBI = VkConditionalRenderingBeginInfoEXT {};
+        conditionalRenderingBI.sType = VK_STRUCTURE_TYPE_CONDITIONAL_RENDERING_BEGIN_INFO_EXT;
+        conditionalRenderingBI.buffer = buffer->getHandle();
+        conditionalRenderingBI.offset = static_cast<VkDeviceSize> (offset);
+
+        if (inverted) {
+            conditionalRenderingBI.flags = VK_CONDITIONAL_RENDERING_INVERTED_BIT_EXT;
+        }
+
+        vkCmdBeginConditionalRenderingEXT(_handle, &conditionalRenderingBI);
+    }
+
+    void CommandBuffer::endConditionalRendering() noexcept {
+        flushDescriptorSets();
+
+        vkCmdEndConditionalRenderingEXT(_handle);
+    }
+
+    void CommandBuffer::beginLabel(const std::string& name, const std::array<float, 4>& color) noexcept {
+        if (!getDevice()->isDebugUtilsEnabled()) {
+            return;
+        }
+
+        auto labelI = VkDebugUtilsLabelEXT {};
+        labelI.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+        labelI.pLabelName = name.c_str();
+        std::copy(color.begin(), color.end(), labelI.color);
+
+        vkCmdBeginDebugUtilsLabelEXT(_handle, &labelI);
+    }
+
+    void CommandBuffer::endLabel() noexcept {
+        if (getDevice()->isDebugUtilsEnabled()) {
+            vkCmdEndDebugUtilsLabelEXT(_handle);
+        }
+    }
+
+    void CommandBuffer::insertLabel(const std::string& name, const std::array<float, 4>& color) noexcept {
+        if (!getDevice()->isDebugUtilsEnabled()) {
+            return;
+        }
+
+        auto labelI = VkDebugUtilsLabelEXT {};
+        labelI.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+        labelI.pLabelName = name.c_str();
+        std::copy(color.begin(), color.end(), labelI.color);
+
+        vkCmdInsertDebugUtilsLabelEXT(_handle, &labelI);
+    }
 }
@@ -0,0 +1,638 @@
+#include "mvk/CommandList.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#include "mvk/CommandBuffer.hpp"
+#include "mvk/ParallelRecorder.hpp"
+
+namespace mvk {
+    namespace {
+        constexpr std::size_t PACKET_ALIGNMENT = 8;
+
+        inline constexpr std::size_t alignPacket(std::size_t size) noexcept {
+            return (size + PACKET_ALIGNMENT - 1) / PACKET_ALIGNMENT * PACKET_ALIGNMENT;
+        }
+
+        struct BeginRenderPassCmd {
+            const Framebuffer * framebuffer;
+            SubpassContents contents;
+        };
+
+        struct NextSubpassCmd {
+            SubpassContents contents;
+        };
+
+        struct SetViewportCmd {
+            float x, y, width, height, minDepth, maxDepth;
+        };
+
+        struct SetScissorCmd {
+            int x, y, width, height;
+        };
+
+        struct BindPipelineCmd {
+            const Pipeline * pipeline;
+        };
+
+        // followed by nDynamicOffsets ints.
+        struct BindDescriptorSetCmd {
+            const Pipeline * pipeline;
+            const DescriptorSet * descriptorSet;
+            int set;
+            std::uint32_t nDynamicOffsets;
+        };
+
+        struct BindVertexBufferCmd {
+            const Buffer * buffer;
+            std::ptrdiff_t offset;
+            int binding;
+        };
+
+        struct BindIndexBufferCmd {
+            const Buffer * buffer;
+            std::ptrdiff_t offset;
+            IndexType indexType;
+        };
+
+        // followed by size bytes of data.
+        struct PushConstantsCmd {
+            const Pipeline * pipeline;
+            std::ptrdiff_t offset;
+            std::size_t size;
+            ShaderStage stages;
+        };
+
+        struct DrawCmd {
+            int vertexCount, instanceCount, firstVertex, firstInstance;
+        };
+
+        struct DrawIndexedCmd {
+            int indexCount, instanceCount, firstIndex, vertexOffset, firstInstance;
+        };
+
+        struct DrawIndirectCmd {
+            const Buffer * buffer;
+            std::ptrdiff_t offset;
+            int drawCount;
+            int stride;
+        };
+
+        struct DispatchCmd {
+            unsigned int groupsX, groupsY, groupsZ;
+        };
+
+        struct DispatchIndirectCmd {
+            const Buffer * buffer;
+            std::ptrdiff_t offset;
+        };
+
+        struct CopyBufferCmd {
+            const Buffer * src;
+            const Buffer * dst;
+            std::ptrdiff_t srcOffset;
+            std::ptrdiff_t dstOffset;
+            std::size_t size;
+        };
+
+        struct CopyBufferToImageCmd {
+            const Buffer * src;
+            const Image * dst;
+            std::ptrdiff_t bufferOffset;
+            ImageLayout layout;
+            ImageSubresourceLayers subresourceRange;
+            Offset3D offset;
+            Extent3D extent;
+        };
+
+        struct CopyImageCmd {
+            const Image * src;
+            const Image * dst;
+            ImageLayout srcLayout;
+            ImageLayout dstLayout;
+            Offset3D srcOffset;
+            Offset3D dstOffset;
+            Extent3D extent;
+            ImageSubresourceLayers srcSubresource;
+            ImageSubresourceLayers dstSubresource;
+        };
+
+        struct BlitImageCmd {
+            const Image * src;
+            const Image * dst;
+            ImageLayout srcLayout;
+            ImageLayout dstLayout;
+            Offset3D srcOffset0, srcOffset1;
+            Offset3D dstOffset0, dstOffset1;
+            ImageSubresourceLayers srcSubresource;
+            ImageSubresourceLayers dstSubresource;
+            Filter filter;
+        };
+
+        struct StageImageCmd {
+            const Image * image;
+            ImageLayout oldLayout, newLayout;
+            PipelineStageFlag srcStageMask, dstStageMask;
+            AccessFlag srcAccess, dstAccess;
+        };
+
+        // followed by the MemoryBarrier, BufferMemoryBarrier and ImageMemoryBarrier arrays; each aligned to 8 bytes.
+        struct PipelineBarrierCmd {
+            PipelineStageFlag srcStageMask;
+            PipelineStageFlag dstStageMask;
+            DependencyFlag dependencyFlags;
+            std::uint32_t memoryBarrierCount;
+            std::uint32_t bufferMemoryBarrierCount;
+            std::uint32_t imageMemoryBarrierCount;
+        };
+
+        inline bool isDraw(CommandList::Opcode opcode) noexcept {
+            switch (opcode) {
+                case CommandList::Opcode::DRAW:
+                case CommandList::Opcode::DRAW_INDEXED:
+                case CommandList::Opcode::DRAW_INDIRECT:
+                case CommandList::Opcode::DRAW_INDEXED_INDIRECT:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        // commands whose effect persists until the next command of the same kind
+        inline bool isState(CommandList::Opcode opcode) noexcept {
+            switch (opcode) {
+                case CommandList::Opcode::SET_VIEWPORT:
+                case CommandList::Opcode::SET_SCISSOR:
+                case CommandList::Opcode::BIND_PIPELINE:
+                case CommandList::Opcode::BIND_DESCRIPTOR_SET:
+                case CommandList::Opcode::BIND_VERTEX_BUFFER:
+                case CommandList::Opcode::BIND_INDEX_BUFFER:
+                case CommandList::Opcode::PUSH_CONSTANTS:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        template<class cmd_t>
+        inline const cmd_t * payload(const void * pHeader, std::size_t headerSize) noexcept {
+            return reinterpret_cast<const cmd_t *> (reinterpret_cast<const std::uint8_t *> (pHeader) + headerSize);
+        }
+    }
+
+    void * CommandList::push(Opcode opcode, std::size_t payloadSize) {
+        const auto packetSize = alignPacket(sizeof(Header)) + alignPacket(payloadSize);
+
+        while (_currentBlock < _blocks.size() && _blocks[_currentBlock].size + packetSize > _blocks[_currentBlock].capacity) {
+            _currentBlock++;
+        }
+
+        if (_currentBlock == _blocks.size()) {
+            auto block = Block {};
+            block.capacity = std::max(BLOCK_SIZE, packetSize);
+            block.data = std::make_unique<std::uint8_t[]> (block.capacity);
+            block.size = 0;
+
+            _blocks.push_back(std::move(block));
+        }
+
+        auto& block = _blocks[_currentBlock];
+        auto pPacket = block.data.get() + block.size;
+        auto pHeader = new (pPacket) Header;
+
+        pHeader->opcode = opcode;
+        pHeader->reserved = 0;
+        pHeader->size = static_cast<std::uint32_t> (packetSize);
+
+        block.size += packetSize;
+        _commandCount++;
+
+        return pPacket + alignPacket(sizeof(Header));
+    }
+
+    void CommandList::reset() noexcept {
+        for (auto& block : _blocks) {
+            block.size = 0;
+        }
+
+        _currentBlock = 0;
+        _commandCount = 0;
+    }
+
+    std::size_t CommandList::getByteSize() const noexcept {
+        std::size_t size = 0;
+
+        for (const auto& block : _blocks) {
+            size += block.size;
+        }
+
+        return size;
+    }
+
+    void CommandList::beginRenderPass(const Framebuffer * framebuffer, SubpassContents contents) {
+        auto cmd = new (push(Opcode::BEGIN_RENDER_PASS, sizeof(BeginRenderPassCmd))) BeginRenderPassCmd;
+        cmd->framebuffer = framebuffer;
+        cmd->contents = contents;
+    }
+
+    void CommandList::endRenderPass() {
+        push(Opcode::END_RENDER_PASS, 0);
+    }
+
+    void CommandList::nextSubpass(SubpassContents contents) {
+        auto cmd = new (push(Opcode::NEXT_SUBPASS, sizeof(NextSubpassCmd))) NextSubpassCmd;
+        cmd->contents = contents;
+    }
+
+    void CommandList::setViewport(float x, float y, float width, float height, float minDepth, float maxDepth) {
+        auto cmd = new (push(Opcode::SET_VIEWPORT, sizeof(SetViewportCmd))) SetViewportCmd;
+        cmd->x = x;
+        cmd->y = y;
+        cmd->width = width;
+        cmd->height = height;
+        cmd->minDepth = minDepth;
+        cmd->maxDepth = maxDepth;
+    }
+
+    void CommandList::setScissor(int x, int y, int width, int height) {
+        auto cmd = new (push(Opcode::SET_SCISSOR, sizeof(SetScissorCmd))) SetScissorCmd;
+        cmd->x = x;
+        cmd->y = y;
+        cmd->width = width;
+        cmd->height = height;
+    }
+
+    void CommandList::bindPipeline(const Pipeline * pipeline) {
+        auto cmd = new (push(Opcode::BIND_PIPELINE, sizeof(BindPipelineCmd))) BindPipelineCmd;
+        cmd->pipeline = pipeline;
+    }
+
+    void CommandList::bindDescriptorSet(const Pipeline * pipeline, int set, const DescriptorSet * descriptorSet, std::size_t nDynamicOffsets, const int * pDynamicOffsets) {
+        const auto offsetsSize = nDynamicOffsets * sizeof(int);
+        auto pData = reinterpret_cast<std::uint8_t *> (push(Opcode::BIND_DESCRIPTOR_SET, sizeof(BindDescriptorSetCmd) + offsetsSize));
+        auto cmd = new (pData) BindDescriptorSetCmd;
+        cmd->pipeline = pipeline;
+        cmd->descriptorSet = descriptorSet;
+        cmd->set = set;
+        cmd->nDynamicOffsets = static_cast<std::uint32_t> (nDynamicOffsets);
+
+        if (offsetsSize > 0) {
+            std::memcpy(pData + sizeof(BindDescriptorSetCmd), pDynamicOffsets, offsetsSize);
+        }
+    }
+
+    void CommandList::bindVertexBuffer(int binding, const Buffer * buffer, std::ptrdiff_t offset) {
+        auto cmd = new (push(Opcode::BIND_VERTEX_BUFFER, sizeof(BindVertexBufferCmd))) BindVertexBufferCmd;
+        cmd->buffer = buffer;
+        cmd->offset = offset;
+        cmd->binding = binding;
+    }
+
+    void CommandList::bindIndexBuffer(const Buffer * buffer, std::ptrdiff_t offset, IndexType indexType) {
+        auto cmd = new (push(Opcode::BIND_INDEX_BUFFER, sizeof(BindIndexBufferCmd))) BindIndexBufferCmd;
+        cmd->buffer = buffer;
+        cmd->offset = offset;
+        cmd->indexType = indexType;
+    }
+
+    void CommandList::pushConstants(const Pipeline * pipeline, ShaderStage stages, std::ptrdiff_t offset, std::size_t size, const void * data) {
+        auto pData = reinterpret_cast<std::uint8_t *> (push(Opcode::PUSH_CONSTANTS, sizeof(PushConstantsCmd) + size));
+        auto cmd = new (pData) PushConstantsCmd;
+        cmd->pipeline = pipeline;
+        cmd->offset = offset;
+        cmd->size = size;
+        cmd->stages = stages;
+
+        std::memcpy(pData + sizeof(PushConstantsCmd), data, size);
+    }
+
+    void CommandList::draw(int vertexCount, int instanceCount, int firstVertex, int firstInstance) {
+        auto cmd = new (push(Opcode::DRAW, sizeof(DrawCmd))) DrawCmd;
+        cmd->vertexCount = vertexCount;
+        cmd->instanceCount = instanceCount;
+        cmd->firstVertex = firstVertex;
+        cmd->firstInstance = firstInstance;
+    }
+
+    void CommandList::drawIndexed(int indexCount, int instanceCount, int firstIndex, int vertexOffset, int firstInstance) {
+        auto cmd = new (push(Opcode::DRAW_INDEXED, sizeof(DrawIndexedCmd))) DrawIndexedCmd;
+        cmd->indexCount = indexCount;
+        cmd->instanceCount = instanceCount;
+        cmd->firstIndex = firstIndex;
+        cmd->vertexOffset = vertexOffset;
+        cmd->firstInstance = firstInstance;
+    }
+
+    void CommandList::drawIndirect(const Buffer * buffer, std::ptrdiff_t offset, int drawCount, int stride) {
+        auto cmd = new (push(Opcode::DRAW_INDIRECT, sizeof(DrawIndirectCmd))) DrawIndirectCmd;
+        cmd->buffer = buffer;
+        cmd->offset = offset;
+        cmd->drawCount = drawCount;
+        cmd->stride = stride;
+    }
+
+    void CommandList::drawIndexedIndirect(const Buffer * buffer, std::ptrdiff_t offset, int drawCount, int stride) {
+        auto cmd = new (push(Opcode::DRAW_INDEXED_INDIRECT, sizeof(DrawIndirectCmd))) DrawIndirectCmd;
+        cmd->buffer = buffer;
+        cmd->offset = offset;
+        cmd->drawCount = drawCount;
+        cmd->stride = stride;
+    }
+
+    void CommandList::dispatch(unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ) {
+        auto cmd = new (push(Opcode::DISPATCH, sizeof(DispatchCmd))) DispatchCmd;
+        cmd->groupsX = groupsX;
+        cmd->groupsY = groupsY;
+        cmd->groupsZ = groupsZ;
+    }
+
+    void CommandList::dispatchIndirect(const Buffer * buffer, std::ptrdiff_t offset) {
+        auto cmd = new (push(Opcode::DISPATCH_INDIRECT, sizeof(DispatchIndirectCmd))) DispatchIndirectCmd;
+        cmd->buffer = buffer;
+        cmd->offset = offset;
+    }
+
+    void CommandList::copyBuffer(
+        const Buffer * src, const Buffer * dst,
+        std::ptrdiff_t srcOffset, std::ptrdiff_t dstOffset,
+        std::size_t size) {
+
+        auto cmd = new (push(Opcode::COPY_BUFFER, sizeof(CopyBufferCmd))) CopyBufferCmd;
+        cmd->src = src;
+        cmd->dst = dst;
+        cmd->srcOffset = srcOffset;
+        cmd->dstOffset = dstOffset;
+        cmd->size = size;
+    }
+
+    void CommandList::copyBufferToImage(
+        const Buffer * src, std::ptrdiff_t bufferOffset,
+        const Image * dst, ImageLayout layout,
+        const ImageSubresourceLayers& subresourceRange,
+        const Offset3D& offset, const Extent3D& extent) {
+
+        auto cmd = new (push(Opcode::COPY_BUFFER_TO_IMAGE, sizeof(CopyBufferToImageCmd))) CopyBufferToImageCmd;
+        cmd->src = src;
+        cmd->dst = dst;
+        cmd->bufferOffset = bufferOffset;
+        cmd->layout = layout;
+        cmd->subresourceRange = subresourceRange;
+        cmd->offset = offset;
+        cmd->extent = extent;
+    }
+
+    void CommandList::copyImage(
+        const Image * src, ImageLayout srcLayout,
+        const Image * dst, ImageLayout dstLayout,
+        const Offset3D& srcOffset, const Offset3D& dstOffset, const Extent3D& extent,
+        const ImageSubresourceLayers& srcSubresource,
+        const ImageSubresourceLayers& dstSubresource) {
+
+        auto cmd = new (push(Opcode::COPY_IMAGE, sizeof(CopyImageCmd))) CopyImageCmd;
+        cmd->src = src;
+        cmd->dst = dst;
+        cmd->srcLayout = srcLayout;
+        cmd->dstLayout = dstLayout;
+        cmd->srcOffset = srcOffset;
+        cmd->dstOffset = dstOffset;
+        cmd->extent = extent;
+        cmd->srcSubresource = srcSubresource;
+        cmd->dstSubresource = dstSubresource;
+    }
+
+    void CommandList::blitImage(
+        const Image * src, ImageLayout srcLayout,
+        const Image * dst, ImageLayout dstLayout,
+        const Offset3D& srcOffset0, const Offset3D& srcOffset1,
+        const Offset3D& dstOffset0, const Offset3D& dstOffset1,
+        const ImageSubresourceLayers& srcSubresource,
+        const ImageSubresourceLayers& dstSubresource,
+        Filter filter) {
+
+        auto cmd = new (push(Opcode::BLIT_IMAGE, sizeof(BlitImageCmd))) BlitImageCmd;
+        cmd->src = src;
+        cmd->dst = dst;
+        cmd->srcLayout = srcLayout;
+        cmd->dstLayout = dstLayout;
+        cmd->srcOffset0 = srcOffset0;
+        cmd->srcOffset1 = srcOffset1;
+        cmd->dstOffset0 = dstOffset0;
+        cmd->dstOffset1 = dstOffset1;
+        cmd->srcSubresource = srcSubresource;
+        cmd->dstSubresource = dstSubresource;
+        cmd->filter = filter;
+    }
+
+    void CommandList::stageImage(
+        const Image * image,
+        ImageLayout oldLayout, ImageLayout newLayout,
+        PipelineStageFlag srcStageMask, PipelineStageFlag dstStageMask,
+        AccessFlag srcAccess, AccessFlag dstAccess) {
+
+        auto cmd = new (push(Opcode::STAGE_IMAGE, sizeof(StageImageCmd))) StageImageCmd;
+        cmd->image = image;
+        cmd->oldLayout = oldLayout;
+        cmd->newLayout = newLayout;
+        cmd->srcStageMask = srcStageMask;
+        cmd->dstStageMask = dstStageMask;
+        cmd->srcAccess = srcAccess;
+        cmd->dstAccess = dstAccess;
+    }
+
+    void CommandList::pipelineBarrier(
+        PipelineStageFlag srcStageMask, PipelineStageFlag dstStageMask,
+        DependencyFlag dependencyFlags,
+        std::size_t memoryBarrierCount,
+        const MemoryBarrier * pMemoryBarriers,
+        std::size_t bufferMemoryBarrierCount,
+        const BufferMemoryBarrier * pBufferMemoryBarriers,
+        std::size_t imageMemoryBarrierCount,
+        const ImageMemoryBarrier * pImageMemoryBarriers) {
+
+        const auto headerSize = alignPacket(sizeof(PipelineBarrierCmd));
+        const auto memorySize = alignPacket(memoryBarrierCount * sizeof(MemoryBarrier));
+        const auto bufferSize = alignPacket(bufferMemoryBarrierCount * sizeof(BufferMemoryBarrier));
+        const auto imageSize = alignPacket(imageMemoryBarrierCount * sizeof(ImageMemoryBarrier));
+
+        auto pData = reinterpret_cast<std::uint8_t *> (push(Opcode::PIPELINE_BARRIER, headerSize + memorySize + bufferSize + imageSize));
+        auto cmd = new (pData) PipelineBarrierCmd;
+        cmd->srcStageMask = srcStageMask;
+        cmd->dstStageMask = dstStageMask;
+        cmd->dependencyFlags = dependencyFlags;
+        cmd->memoryBarrierCount = static_cast<std::uint32_t> (memoryBarrierCount);
+        cmd->bufferMemoryBarrierCount = static_cast<std::uint32_t> (bufferMemoryBarrierCount);
+        cmd->imageMemoryBarrierCount = static_cast<std::uint32_t> (imageMemoryBarrierCount);
+
+        pData += headerSize;
+        std::uninitialized_copy_n(pMemoryBarriers, memoryBarrierCount, reinterpret_cast<MemoryBarrier *> (pData));
+
+        pData += memorySize;
+        std::uninitialized_copy_n(pBufferMemoryBarriers, bufferMemoryBarrierCount, reinterpret_cast<BufferMemoryBarrier *> (pData));
+
+        pData += bufferSize;
+        std::uninitialized_copy_n(pImageMemoryBarriers, imageMemoryBarrierCount, reinterpret_cast<ImageMemoryBarrier *> (pData));
+    }
+
+    void CommandList::translate(CommandBuffer * commandBuffer, const Header * pHeader) {
+        constexpr auto headerSize = alignPacket(sizeof(Header));
+
+        switch (pHeader->opcode) {
+            case Opcode::BEGIN_RENDER_PASS: {
+                auto cmd = payload<BeginRenderPassCmd> (pHeader, headerSize);
+                commandBuffer->beginRenderPass(cmd->framebuffer, cmd->contents);
+            } break;
+            case Opcode::END_RENDER_PASS:
+                commandBuffer->endRenderPass();
+                break;
+            case Opcode::NEXT_SUBPASS:
+                commandBuffer->nextSubpass(payload<NextSubpassCmd> (pHeader, headerSize)->contents);
+                break;
+            case Opcode::SET_VIEWPORT: {
+                auto cmd = payload<SetViewportCmd> (pHeader, headerSize);
+                commandBuffer->setViewport(cmd->x, cmd->y, cmd->width, cmd->height, cmd->minDepth, cmd->maxDepth);
+            } break;
+            case Opcode::SET_SCISSOR: {
+                auto cmd = payload<SetScissorCmd> (pHeader, headerSize);
+                commandBuffer->setScissor(cmd->x, cmd->y, cmd->width, cmd->height);
+            } break;
+            case Opcode::BIND_PIPELINE:
+                commandBuffer->bindPipeline(payload<BindPipelineCmd> (pHeader, headerSize)->pipeline);
+                break;
+            case Opcode::BIND_DESCRIPTOR_SET: {
+                auto cmd = payload<BindDescriptorSetCmd> (pHeader, headerSize);
+                auto pDynamicOffsets = reinterpret_cast<const int *> (cmd + 1);
+
+                commandBuffer->bindDescriptorSet(cmd->pipeline, cmd->set, cmd->descriptorSet, cmd->nDynamicOffsets, pDynamicOffsets);
+            } break;
+            case Opcode::BIND_VERTEX_BUFFER: {
+                auto cmd = payload<BindVertexBufferCmd> (pHeader, headerSize);
+                commandBuffer->bindVertexBuffer(cmd->binding, cmd->buffer, cmd->offset);
+            } break;
+            case Opcode::BIND_INDEX_BUFFER: {
+                auto cmd = payload<BindIndexBufferCmd> (pHeader, headerSize);
+                commandBuffer->bindIndexBuffer(cmd->buffer, cmd->offset, cmd->indexType);
+            } break;
+            case Opcode::PUSH_CONSTANTS: {
+                auto cmd = payload<PushConstantsCmd> (pHeader, headerSize);
+                commandBuffer->pushConstants(cmd->pipeline, cmd->stages, cmd->offset, cmd->size, cmd + 1);
+            } break;
+            case Opcode::DRAW: {
+                auto cmd = payload<DrawCmd> (pHeader, headerSize);
+                commandBuffer->draw(cmd->vertexCount, cmd->instanceCount, cmd->firstVertex, cmd->firstInstance);
+            } break;
+            case Opcode::DRAW_INDEXED: {
+                auto cmd = payload<DrawIndexedCmd> (pHeader, headerSize);
+                commandBuffer->drawIndexed(cmd->indexCount, cmd->instanceCount, cmd->firstIndex, cmd->vertexOffset, cmd->firstInstance);
+            } break;
+            case Opcode::DRAW_INDIRECT: {
+                auto cmd = payload<DrawIndirectCmd> (pHeader, headerSize);
+                commandBuffer->drawIndirect(cmd->buffer, cmd->offset, cmd->drawCount, cmd->stride);
+            } break;
+            case Opcode::DRAW_INDEXED_INDIRECT: {
+                auto cmd = payload<DrawIndirectCmd> (pHeader, headerSize);
+                commandBuffer->drawIndexedIndirect(cmd->buffer, cmd->offset, cmd->drawCount, cmd->stride);
+            } break;
+            case Opcode::DISPATCH: {
+                auto cmd = payload<DispatchCmd> (pHeader, headerSize);
+                commandBuffer->dispatch(cmd->groupsX, cmd->groupsY, cmd->groupsZ);
+            } break;
+            case Opcode::DISPATCH_INDIRECT: {
+                auto cmd = payload<DispatchIndirectCmd> (pHeader, headerSize);
+                commandBuffer->dispatchIndirect(cmd->buffer, cmd->offset);
+            } break;
+            case Opcode::COPY_BUFFER: {
+                auto cmd = payload<CopyBufferCmd> (pHeader, headerSize);
+                commandBuffer->copyBuffer(cmd->src, cmd->dst, cmd->srcOffset, cmd->dstOffset, cmd->size);
+            } break;
+            case Opcode::COPY_BUFFER_TO_IMAGE: {
+                auto cmd = payload<CopyBufferToImageCmd> (pHeader, headerSize);
+                commandBuffer->copyBufferToImage(cmd->src, cmd->bufferOffset, cmd->dst, cmd->layout, cmd->subresourceRange, cmd->offset, cmd->extent);
+            } break;
+            case Opcode::COPY_IMAGE: {
+                auto cmd = payload<CopyImageCmd> (pHeader, headerSize);
+                commandBuffer->copyImage(
+                    cmd->src, cmd->srcLayout, cmd->dst, cmd->dstLayout,
+                    cmd->srcOffset, cmd->dstOffset, cmd->extent,
+                    cmd->srcSubresource, cmd->dstSubresource);
+            } break;
+            case Opcode::BLIT_IMAGE: {
+                auto cmd = payload<BlitImageCmd> (pHeader, headerSize);
+                commandBuffer->blitImage(
+                    cmd->src, cmd->srcLayout, cmd->dst, cmd->dstLayout,
+                    cmd->srcOffset0, cmd->srcOffset1, cmd->dstOffset0, cmd->dstOffset1,
+                    cmd->srcSubresource, cmd->dstSubresource, cmd->filter);
+            } break;
+            case Opcode::STAGE_IMAGE: {
+                auto cmd = payload<StageImageCmd> (pHeader, headerSize);
+                commandBuffer->stageImage(cmd->image, cmd->oldLayout, cmd->newLayout, cmd->srcStageMask, cmd->dstStageMask, cmd->srcAccess, cmd->dstAccess);
+            } break;
+            case Opcode::PIPELINE_BARRIER: {
+                auto cmd = payload<PipelineBarrierCmd> (pHeader, headerSize);
+                auto pData = reinterpret_cast<const std::uint8_t *> (cmd) + alignPacket(sizeof(PipelineBarrierCmd));
+                auto pMemoryBarriers = reinterpret_cast<const MemoryBarrier *> (pData);
+
+                pData += alignPacket(cmd->memoryBarrierCount * sizeof(MemoryBarrier));
+                auto pBufferMemoryBarriers = reinterpret_cast<const BufferMemoryBarrier *> (pData);
+
+                pData += alignPacket(cmd->bufferMemoryBarrierCount * sizeof(BufferMemoryBarrier));
+                auto pImageMemoryBarriers = reinterpret_cast<const ImageMemoryBarrier *> (pData);
+
+                commandBuffer->pipelineBarrier(
+                    cmd->srcStageMask, cmd->dstStageMask, cmd->dependencyFlags,
+                    cmd->memoryBarrierCount, pMemoryBarriers,
+                    cmd->bufferMemoryBarrierCount, pBufferMemoryBarriers,
+                    cmd->imageMemoryBarrierCount, pImageMemoryBarriers);
+            } break;
+        }
+    }
+
+    void CommandList::execute(CommandBuffer * commandBuffer) const {
+        forEachPacket([commandBuffer](const Header * pHeader) {
+            translate(commandBuffer, pHeader);
+
+            return true;
+        });
+    }
+
+    void CommandList::execute(ParallelRecorder * recorder, CommandBuffer * primary, const Framebuffer * framebuffer, int subpass) const {
+        std::size_t drawCount = 0;
+
+        forEachPacket([&drawCount](const Header * pHeader) {
+            switch (pHeader->opcode) {
+                case Opcode::BEGIN_RENDER_PASS:
+                case Opcode::END_RENDER_PASS:
+                case Opcode::NEXT_SUBPASS:
+                    throw std::runtime_error("RenderPass commands cannot be translated into secondary CommandBuffers!");
+                default:
+                    if (isDraw(pHeader->opcode)) {
+                        drawCount++;
+                    }
+
+                    return true;
+            }
+        });
+
+        recorder->record(primary, framebuffer, subpass, drawCount, [this, drawCount](CommandBuffer * commandBuffer, std::size_t first, std::size_t last) {
+            std::size_t drawIndex = 0;
+
+            forEachPacket([&](const Header * pHeader) {
+                if (isDraw(pHeader->opcode)) {
+                    if (drawIndex >= first) {
+                        translate(commandBuffer, pHeader);
+                    }
+
+                    return ++drawIndex < last || last == drawCount;
+                }
+
+                // secondary CommandBuffers inherit no state, so each range replays the state set before it
+                if (isState(pHeader->opcode) || drawIndex >= first) {
+                    translate(commandBuffer, pHeader);
+                }
+
+                return true;
+            });
+        });
+    }
+}
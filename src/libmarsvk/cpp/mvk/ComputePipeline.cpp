@@ -1,29 +1,85 @@
 #include "mvk/ComputePipeline.hpp"
 
+#include <cstdint>
+
+#include <vector>
+
 #include "mvk/Device.hpp"
 #include "mvk/PipelineCache.hpp"
 #include "mvk/Util.hpp"
 
 namespace mvk {
+    ComputePipeline::NativeCreateInfo::NativeCreateInfo(Device * device, const CreateInfo& createInfo, const PipelineLayout * layout) {
+        info = VkComputePipelineCreateInfo {};
+        info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        info.flags = static_cast<VkPipelineCreateFlags> (createInfo.flags);
+        info.layout = layout->getHandle();
+        info.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        info.stage.stage = static_cast<VkShaderStageFlagBits> (createInfo.stage.stage);
+        info.stage.pName = createInfo.stage.name.c_str();
+        info.stage.module = device->getShaderModule(createInfo.stage.moduleInfo)->getHandle();
+        info.stage.flags = static_cast<VkPipelineShaderStageCreateFlags> (createInfo.stage.flags);
+
+        const auto& specialization = createInfo.stage.specializationInfo;
+
+        specializationInfo = VkSpecializationInfo {};
+
+        if (!specialization.mapEntries.empty()) {
+            specializationMapEntries.reserve(specialization.mapEntries.size());
+
+            for (const auto& mapEntry : specialization.mapEntries) {
+                specializationMapEntries.push_back({mapEntry.constantID, mapEntry.offset, mapEntry.size});
+            }
+
+            specializationInfo.mapEntryCount = static_cast<std::uint32_t> (specializationMapEntries.size());
+            specializationInfo.pMapEntries = specializationMapEntries.data();
+            specializationInfo.dataSize = specialization.data.size();
+            specializationInfo.pData = specialization.data.data();
+
+            info.stage.pSpecializationInfo = &specializationInfo;
+        }
+
+#if defined(VK_KHR_pipeline_executable_properties)
+        if (device->isPipelineExecutableInfoEnabled()) {
+            info.flags |= VK_PIPELINE_CREATE_CAPTURE_STATISTICS_BIT_KHR;
+        }
+#endif
+    }
+
     ComputePipeline::ComputePipeline(PipelineCache * cache, const ComputePipeline::CreateInfo& createInfo) {
+        _device = cache->getDevice();
         _cache = cache;
         _info = createInfo;
+        _serial = Util::nextSerial();
 
         auto pDevice = cache->getDevice();
         
         _layout = pDevice->allocatePipelineLayout(createInfo.layoutInfo);
 
-        auto computePipelineCI = VkComputePipelineCreateInfo {};
-        computePipelineCI.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
-        computePipelineCI.flags = static_cast<VkPipelineCreateFlags> (createInfo.flags);
-        computePipelineCI.layout = _layout->getHandle();
-        computePipelineCI.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        computePipelineCI.stage.stage = static_cast<VkShaderStageFlagBits> (createInfo.stage.stage);
-        computePipelineCI.stage.pName = createInfo.stage.name.c_str();
-        computePipelineCI.stage.module = pDevice->getShaderModule(createInfo.stage.moduleInfo)->getHandle();
-        computePipelineCI.stage.flags = static_cast<VkPipelineShaderStageCreateFlags> (createInfo.stage.flags);
-
-        Util::vkAssert(vkCreateComputePipelines(pDevice->getHandle(), cache->getHandle(), 1, &computePipelineCI, nullptr, &_handle));
+        const NativeCreateInfo nativeCI(pDevice, _info, _layout);
+
+        MVK_METRICS_SCOPED_TIMER(pDevice, CREATE_PIPELINE);
+        MVK_METRICS_INCREMENT(pDevice, PIPELINES_CREATED);
+
+        Tracer::Span traceSpan(pDevice->getTracer(), "vkCreateComputePipelines", "pipeline");
+
+        Util::vkAssert(vkCreateComputePipelines(pDevice->getHandle(), cache->getHandle(), 1, &nativeCI.info, nullptr, &_handle));
+
+        pDevice->setObjectName(VK_OBJECT_TYPE_PIPELINE, _handle, createInfo.name);
+
+        cache->recordExecutableStatistics(_handle, PipelineBindPoint::COMPUTE, createInfo.name);
+    }
+
+    ComputePipeline::ComputePipeline(PipelineCache * cache, const ComputePipeline::CreateInfo& createInfo, PipelineLayout * layout, VkPipeline handle) {
+        _device = cache->getDevice();
+        _cache = cache;
+        _info = createInfo;
+        _serial = Util::nextSerial();
+        _layout = layout;
+        _handle = handle;
+
+        cache->getDevice()->setObjectName(VK_OBJECT_TYPE_PIPELINE, _handle, createInfo.name);
+        cache->recordExecutableStatistics(_handle, PipelineBindPoint::COMPUTE, createInfo.name);
     }
 
     ComputePipeline::~ComputePipeline() noexcept {
@@ -32,10 +88,12 @@ namespace mvk {
     }
 
     ComputePipeline& ComputePipeline::operator= (ComputePipeline&& from) noexcept {
+        std::swap(_device, from._device);
         std::swap(_cache, from._cache);
         std::swap(_info, from._info);
         std::swap(_layout, from._layout);
         std::swap(_handle, from._handle);
+        std::swap(_serial, from._serial);
 
         return *this;
     }
@@ -49,7 +107,7 @@ namespace mvk {
     }
 
     Device * ComputePipeline::getDevice() const noexcept {
-        return _cache->getDevice();
+        return _device;
     }
 
     PipelineCache * ComputePipeline::getPipelineCache() const noexcept {
@@ -71,4 +129,8 @@ namespace mvk {
     VkPipeline ComputePipeline::getHandle() const noexcept {
         return _handle;
     }
+
+    std::uint64_t ComputePipeline::getSerial() const noexcept {
+        return _serial;
+    }
 }
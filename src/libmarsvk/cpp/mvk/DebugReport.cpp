@@ -0,0 +1,174 @@
+#include "mvk/DebugReport.hpp"
+
+#include <cstring>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "mvk/Util.hpp"
+
+namespace mvk {
+    namespace {
+        bool isBestPractices(const char * messageIdName) noexcept {
+            return nullptr != messageIdName && nullptr != std::strstr(messageIdName, "BestPractices");
+        }
+    }
+
+    VKAPI_ATTR VkBool32 VKAPI_CALL DebugReport::callback(
+        VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
+        VkDebugUtilsMessageTypeFlagsEXT messageTypes,
+        const VkDebugUtilsMessengerCallbackDataEXT * pCallbackData,
+        void * pUserData) {
+
+        try {
+            static_cast<DebugReport *> (pUserData)->record(messageSeverity, messageTypes, *pCallbackData);
+        } catch (...) {
+            // exceptions must not cross into the layers
+        }
+
+        return VK_FALSE;
+    }
+
+    VkDebugUtilsMessengerCreateInfoEXT DebugReport::getMessengerCreateInfo() noexcept {
+        auto messengerCI = VkDebugUtilsMessengerCreateInfoEXT {};
+        messengerCI.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
+        messengerCI.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+        messengerCI.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
+        messengerCI.pfnUserCallback = &DebugReport::callback;
+        messengerCI.pUserData = this;
+
+        return messengerCI;
+    }
+
+    void DebugReport::record(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity, VkDebugUtilsMessageTypeFlagsEXT messageTypes, const VkDebugUtilsMessengerCallbackDataEXT& callbackData) {
+        const auto message = std::string(nullptr != callbackData.pMessage ? callbackData.pMessage : "");
+        const bool isError = 0 != (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT);
+        const bool isPerformance = 0 != (messageTypes & VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT) || isBestPractices(callbackData.pMessageIdName);
+
+        std::lock_guard<std::mutex> lock(_lock);
+
+        if (messageTypes & VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT) {
+            _generalCount++;
+        }
+
+        if (messageTypes & VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT) {
+            _validationCount++;
+        }
+
+        if (isError) {
+            _errorCount++;
+        }
+
+        if (isPerformance && !isError) {
+            _performanceCount++;
+
+            const auto id = (nullptr != callbackData.pMessageIdName) ? std::string(callbackData.pMessageIdName) : std::to_string(callbackData.messageIdNumber);
+            auto it = _performanceWarnings.find(id);
+
+            if (_performanceWarnings.end() == it) {
+                auto warning = PerformanceWarning {};
+                warning.messageIdName = id;
+                warning.messageIdNumber = callbackData.messageIdNumber;
+                warning.message = message;
+                warning.count = 1;
+
+                _performanceWarnings.emplace(id, std::move(warning));
+
+                std::cerr << "[PERFORMANCE] " << message << std::endl;
+            } else {
+                it->second.count++;
+            }
+        } else if (messageSeverity >= VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) {
+            std::cerr << (isError ? "[ERROR] " : "[WARNING] ") << message << std::endl;
+        }
+    }
+
+    void DebugReport::clear() noexcept {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        _performanceWarnings.clear();
+        _generalCount = 0;
+        _validationCount = 0;
+        _performanceCount = 0;
+        _errorCount = 0;
+    }
+
+    std::size_t DebugReport::getGeneralCount() const noexcept {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        return _generalCount;
+    }
+
+    std::size_t DebugReport::getValidationCount() const noexcept {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        return _validationCount;
+    }
+
+    std::size_t DebugReport::getPerformanceCount() const noexcept {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        return _performanceCount;
+    }
+
+    std::size_t DebugReport::getErrorCount() const noexcept {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        return _errorCount;
+    }
+
+    std::vector<DebugReport::PerformanceWarning> DebugReport::getPerformanceWarnings() const {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        auto out = std::vector<PerformanceWarning> ();
+        out.reserve(_performanceWarnings.size());
+
+        for (const auto& warning : _performanceWarnings) {
+            out.push_back(warning.second);
+        }
+
+        return out;
+    }
+
+    std::string DebugReport::toJSON() const {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        auto out = std::stringstream ();
+
+        out << "{\"counts\":{"
+            << "\"general\":" << _generalCount
+            << ",\"validation\":" << _validationCount
+            << ",\"performance\":" << _performanceCount
+            << ",\"errors\":" << _errorCount
+            << "},\"performanceWarnings\":[";
+
+        bool first = true;
+
+        for (const auto& warning : _performanceWarnings) {
+            out << (first ? "" : ",")
+                << "{\"id\":" << Util::escapeJSON(warning.second.messageIdName)
+                << ",\"idNumber\":" << warning.second.messageIdNumber
+                << ",\"count\":" << warning.second.count
+                << ",\"message\":" << Util::escapeJSON(warning.second.message)
+                << "}";
+
+            first = false;
+        }
+
+        out << "]}";
+
+        return out.str();
+    }
+
+    void DebugReport::save(const std::string& path) const {
+        std::ofstream file(path);
+
+        if (!file) {
+            throw std::runtime_error("Unable to open debug report file: " + path);
+        }
+
+        file << toJSON() << std::endl;
+    }
+}
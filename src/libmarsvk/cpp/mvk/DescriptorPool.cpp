@@ -38,6 +38,8 @@ namespace mvk {
 
         Util::vkAssert(vkFreeDescriptorSets(getDevice()->getHandle(), pool->_handle, 1, &setHandle));
 
+        MVK_METRICS_INCREMENT(getDevice(), DESCRIPTOR_SET_RELEASES);
+
         pool->_allocatedSets -= 1;
 
         for (auto it = _allocatedDescriptorSets.begin(); it != _allocatedDescriptorSets.end(); ++it) {
@@ -50,7 +52,7 @@ namespace mvk {
         throw std::runtime_error("Attempted to release DescriptorSet that either doesn't belong or has already been removed from this DescriptorPool!");
     }
 
-    DescriptorSet * DescriptorPool::allocate() {
+    DescriptorSet * DescriptorPool::allocate(const std::string& name) {
         auto setLayout = _descriptorSetLayout->getHandle();
 
         VkDescriptorSetAllocateInfo descriptorSetAI {};
@@ -78,6 +80,10 @@ namespace mvk {
 
         Util::vkAssert(vkAllocateDescriptorSets(pDevice->getHandle(), &descriptorSetAI, &handle));
 
+        MVK_METRICS_INCREMENT(pDevice, DESCRIPTOR_SET_ALLOCATIONS);
+
+        pDevice->setObjectName(VK_OBJECT_TYPE_DESCRIPTOR_SET, handle, name);
+
         pSelectedPool->_allocatedSets += 1;
 
         auto ptr = std::make_unique<DescriptorSet> (this, pSelectedPool->_index, handle);
@@ -98,7 +104,13 @@ namespace mvk {
 
         VkDescriptorPool handle = VK_NULL_HANDLE;
 
-        Util::vkAssert(vkCreateDescriptorPool(pDevice->getHandle(), &descriptorPoolCI, nullptr, &handle));
+        {
+            MVK_METRICS_SCOPED_TIMER(pDevice, CREATE_DESCRIPTOR_POOL);
+
+            Util::vkAssert(vkCreateDescriptorPool(pDevice->getHandle(), &descriptorPoolCI, nullptr, &handle));
+        }
+
+        MVK_METRICS_INCREMENT(pDevice, DESCRIPTOR_POOL_ALLOCATIONS);
 
         auto index = static_cast<int> (_pools.size());
         auto ptr = std::make_unique<Pool> (handle, index);
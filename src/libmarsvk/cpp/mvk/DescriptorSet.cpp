@@ -33,6 +33,8 @@ namespace mvk {
         descriptorWrite.descriptorCount = 1;
 
         vkUpdateDescriptorSets(getDevice()->getHandle(), 1, &descriptorWrite, 0, nullptr);
+
+        _writeCount++;
     }
 
     void DescriptorSet::writeImage(
@@ -55,5 +57,7 @@ namespace mvk {
         descriptorWrite.descriptorCount = 1;
 
         vkUpdateDescriptorSets(getDevice()->getHandle(), 1, &descriptorWrite, 0, nullptr);
+
+        _writeCount++;
     }
 }
@@ -39,7 +39,11 @@ namespace mvk {
 
         _handle = VK_NULL_HANDLE;
 
-        Util::vkAssert(vkCreateDescriptorSetLayout(pDevice->getHandle(), &descriptorSetLayoutCI, nullptr, &_handle));
+        {
+            MVK_METRICS_SCOPED_TIMER(pDevice, CREATE_PIPELINE_LAYOUT);
+
+            Util::vkAssert(vkCreateDescriptorSetLayout(pDevice->getHandle(), &descriptorSetLayoutCI, nullptr, &_handle));
+        }
 
         auto poolSizesByType = std::map<DescriptorType, unsigned int>();
 
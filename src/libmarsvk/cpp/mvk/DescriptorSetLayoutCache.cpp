@@ -2,8 +2,12 @@
 
 #include <stdexcept>
 
+#include "mvk/Device.hpp"
+
 namespace mvk {
     DescriptorSetLayout * DescriptorSetLayoutCache::allocateDescriptorSetLayout(const DescriptorSetLayout::CreateInfo& createInfo) {
+        std::lock_guard<std::mutex> lock(_lock);
+
         Layout * pLayout = nullptr;
 
         for (auto& layout : _layouts) {
@@ -13,10 +17,14 @@ namespace mvk {
         }
 
         if (nullptr == pLayout) {
+            MVK_METRICS_INCREMENT(getDevice(), DESCRIPTOR_SET_LAYOUT_CACHE_MISSES);
+
             auto ptr = std::make_unique<Layout> (this, createInfo);
             pLayout = ptr.get();
 
             _layouts.push_back(std::move(ptr));
+        } else {
+            MVK_METRICS_INCREMENT(getDevice(), DESCRIPTOR_SET_LAYOUT_CACHE_HITS);
         }
 
         pLayout->references += 1;
@@ -25,6 +33,8 @@ namespace mvk {
     }
 
     void DescriptorSetLayoutCache::releaseDescriptorSetLayout(DescriptorSetLayout * layout) {
+        std::lock_guard<std::mutex> lock(_lock);
+
         auto it = _layouts.begin();
 
         for (; it != _layouts.end(); ++it) {
@@ -1,24 +1,76 @@
 #include "mvk/Device.hpp"
 
 #include <cstdint>
+#include <cstdlib>
 
 #include <exception>
 #include <iostream>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "mvk/Instance.hpp"
 #include "mvk/PhysicalDevice.hpp"
 #include "mvk/Util.hpp"
 
 namespace mvk {
+    namespace {
+        template<class PipelineT, class CreateFunction>
+        std::shared_ptr<AsyncPipeline<PipelineT>> compileAsync(PipelineCompiler * compiler, CreateFunction createFunction) {
+            auto out = std::make_shared<AsyncPipeline<PipelineT>> ();
+
+            compiler->submit([out, createFunction](bool cancelled) {
+                if (cancelled) {
+                    out->complete(nullptr, std::make_exception_ptr(std::runtime_error("Pipeline compilation was cancelled by Device destruction!")));
+                    return;
+                }
+
+                try {
+                    out->complete(createFunction(), nullptr);
+                } catch (...) {
+                    out->complete(nullptr, std::current_exception());
+                }
+            });
+
+            return out;
+        }
+    }
+
     void Device::waitIdle() {
+        Tracer::Span traceSpan(getTracer(), "Device::waitIdle", "wait");
+
         Util::vkAssert(vkDeviceWaitIdle(_handle));
     }
 
+    void Device::nameObject(VkObjectType objectType, std::uint64_t handle, const std::string& name) const noexcept {
+        auto objectNameI = VkDebugUtilsObjectNameInfoEXT {};
+        objectNameI.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
+        objectNameI.objectType = objectType;
+        objectNameI.objectHandle = handle;
+        objectNameI.pObjectName = name.c_str();
+
+        vkSetDebugUtilsObjectNameEXT(_handle, &objectNameI);
+    }
+
     Device::Device(PhysicalDevice * physicalDevice, const std::set<std::string>& enabledExtensions) {
         _physicalDevice = physicalDevice;
         _enabledExtensions = enabledExtensions;
+        _metrics = std::make_unique<Metrics> ();
+        _tracer = std::make_unique<Tracer> (this);
+        _debugUtils = Instance::isExtensionEnabled("VK_EXT_debug_utils") && nullptr != vkSetDebugUtilsObjectNameEXT;
+        _pipelineExecutableInfo = false;
+
+        // the feature structs of these extensions are only understood with VK_KHR_get_physical_device_properties2
+        const bool properties2 = Instance::isExtensionEnabled("VK_KHR_get_physical_device_properties2");
+
+        if (nullptr != std::getenv("MVK_PIPELINE_STATISTICS") && properties2 && physicalDevice->isExtensionSupported("VK_KHR_pipeline_executable_properties")) {
+            _enabledExtensions.insert("VK_KHR_pipeline_executable_properties");
+        }
+
+        if (!properties2 && _enabledExtensions.erase("VK_EXT_conditional_rendering") > 0) {
+            std::cerr << "VK_EXT_conditional_rendering requires VK_KHR_get_physical_device_properties2; it is not enabled!" << std::endl;
+        }
 
         auto pdHandle = physicalDevice->getHandle();
 
@@ -47,12 +99,18 @@ namespace mvk {
 
         auto pEnabledExtensions = std::vector<const char *>();
 
-        pEnabledExtensions.reserve(enabledExtensions.size());
+        pEnabledExtensions.reserve(_enabledExtensions.size());
 
-        for (auto& extName : enabledExtensions) {
+        for (auto& extName : _enabledExtensions) {
             pEnabledExtensions.push_back(extName.c_str());
         }
 
+        const auto& supportedFeatures = physicalDevice->getFeatures();
+
+        _enabledFeatures = VkPhysicalDeviceFeatures {};
+        _enabledFeatures.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery;
+        _enabledFeatures.occlusionQueryPrecise = supportedFeatures.occlusionQueryPrecise;
+
         VkDeviceCreateInfo deviceCI {};
 
         deviceCI.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -60,6 +118,29 @@ namespace mvk {
         deviceCI.queueCreateInfoCount = pDeviceQueueCI.size();
         deviceCI.ppEnabledExtensionNames = pEnabledExtensions.data();
         deviceCI.enabledExtensionCount = pEnabledExtensions.size();
+        deviceCI.pEnabledFeatures = &_enabledFeatures;
+
+        auto conditionalRenderingFeatures = VkPhysicalDeviceConditionalRenderingFeaturesEXT {};
+        conditionalRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CONDITIONAL_RENDERING_FEATURES_EXT;
+
+        if (_enabledExtensions.end() != _enabledExtensions.find("VK_EXT_conditional_rendering")) {
+            // the conditionalRendering feature is required by the extension
+            conditionalRenderingFeatures.conditionalRendering = VK_TRUE;
+            deviceCI.pNext = &conditionalRenderingFeatures;
+        }
+
+#if defined(VK_KHR_pipeline_executable_properties)
+        auto pipelineExecutablePropertiesFeatures = VkPhysicalDevicePipelineExecutablePropertiesFeaturesKHR {};
+        pipelineExecutablePropertiesFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_EXECUTABLE_PROPERTIES_FEATURES_KHR;
+
+        if (_enabledExtensions.end() != _enabledExtensions.find("VK_KHR_pipeline_executable_properties")) {
+            // statistics are only captured with the pipelineExecutableInfo feature
+            pipelineExecutablePropertiesFeatures.pipelineExecutableInfo = VK_TRUE;
+            pipelineExecutablePropertiesFeatures.pNext = const_cast<void *> (deviceCI.pNext);
+            deviceCI.pNext = &pipelineExecutablePropertiesFeatures;
+            _pipelineExecutableInfo = true;
+        }
+#endif
 
         Util::vkAssert(vkCreateDevice(pdHandle, &deviceCI, nullptr, &_handle));
 
@@ -103,20 +184,49 @@ namespace mvk {
         _semaphorePool = std::make_unique<SemaphorePool> (this);
         _descriptorSetLayoutCache = std::make_unique<DescriptorSetLayoutCache> (this);
         _pipelineLayoutCache = std::make_unique<PipelineLayoutCache> (this);
-        _pipelineCache = std::make_unique<PipelineCache> (this);
+        _pipelineCache = std::make_unique<PipelineCache> (this, nullptr != std::getenv("MVK_PIPELINE_CACHE") ? std::getenv("MVK_PIPELINE_CACHE") : "");
+        _pipelineCompiler = std::make_unique<PipelineCompiler> ();
         _samplerCache = std::make_unique<SamplerCache> (this);
+
+        if (nullptr != std::getenv("MVK_PIPELINE_MANIFEST")) {
+            try {
+                openPipelineManifest(std::getenv("MVK_PIPELINE_MANIFEST"));
+            } catch (const std::exception& ex) {
+                std::cerr << ex.what() << std::endl;
+            }
+        }
     }
 
     Device::~Device() noexcept {
+        // finishes the running compilations and cancels the rest before the caches go away
+        _pipelineCompiler = nullptr;
+
         try {
             waitIdle();
         } catch (const std::exception& ex) {
             std::cerr << ex.what() << std::endl;
         }
+
+        if (nullptr != std::getenv("MVK_PIPELINE_STATISTICS") && nullptr != _pipelineCache) {
+            try {
+                _pipelineCache->saveExecutableStatistics(std::getenv("MVK_PIPELINE_STATISTICS"));
+            } catch (const std::exception& ex) {
+                std::cerr << ex.what() << std::endl;
+            }
+        }
         
+        if (nullptr != _pipelineManifest) {
+            try {
+                _pipelineManifest->save(_pipelineManifestPath);
+            } catch (const std::exception& ex) {
+                std::cerr << ex.what() << std::endl;
+            }
+        }
+
         _samplerCache = nullptr;
-        _pipelineLayoutCache = nullptr;
         _pipelineCache = nullptr;
+        _pipelineManifest = nullptr;
+        _pipelineLayoutCache = nullptr;
         _descriptorSetLayoutCache = nullptr;
         _semaphorePool = nullptr;
         _fencePool = nullptr;
@@ -130,34 +240,148 @@ namespace mvk {
 
     Device& Device::operator= (Device&& from) noexcept {
         std::swap(this->_allocator, from._allocator);
+        std::swap(this->_debugUtils, from._debugUtils);
         std::swap(this->_descriptorSetLayoutCache, from._descriptorSetLayoutCache);
         std::swap(this->_enabledExtensions, from._enabledExtensions);
+        std::swap(this->_enabledFeatures, from._enabledFeatures);
         std::swap(this->_fencePool, from._fencePool);
         std::swap(this->_handle, from._handle);
+        std::swap(this->_metrics, from._metrics);
         std::swap(this->_physicalDevice, from._physicalDevice);
         std::swap(this->_pipelineCache, from._pipelineCache);
+        std::swap(this->_pipelineCompiler, from._pipelineCompiler);
+        std::swap(this->_pipelineExecutableInfo, from._pipelineExecutableInfo);
         std::swap(this->_pipelineLayoutCache, from._pipelineLayoutCache);
+        std::swap(this->_pipelineManifest, from._pipelineManifest);
+        std::swap(this->_pipelineManifestPath, from._pipelineManifestPath);
         std::swap(this->_queueFamilies, from._queueFamilies);
         std::swap(this->_queueFamilyCount, from._queueFamilyCount);
         std::swap(this->_samplerCache, from._samplerCache);
         std::swap(this->_semaphorePool, from._semaphorePool);
+        std::swap(this->_tracer, from._tracer);
 
         return *this;
     }
 
     ShaderModule * Device::getShaderModule(const ShaderModule::CreateInfo& createInfo) {
-        for (const auto& module : _shaderCache) {
-            if (module->getInfo() == createInfo) {
-                return module.get();
+        {
+            std::lock_guard<std::mutex> lock(_shaderCacheLock);
+
+            auto it = _shaderCache.find(createInfo);
+
+            if (_shaderCache.end() != it) {
+                MVK_METRICS_INCREMENT(this, SHADER_MODULE_CACHE_HITS);
+
+                return it->second.get();
             }
         }
 
+        MVK_METRICS_INCREMENT(this, SHADER_MODULE_CACHE_MISSES);
+
+        // the module is created without the lock so other threads can still look up cached modules
         auto ptr = std::make_unique<ShaderModule> (this, createInfo);
-        auto out = ptr.get();
 
-        _shaderCache.push_back(std::move(ptr));
+        std::lock_guard<std::mutex> lock(_shaderCacheLock);
 
-        return out;
+        // another thread may have created the same module in the meantime; the first one is kept
+        auto& module = _shaderCache[createInfo];
+
+        if (nullptr == module) {
+            module = std::move(ptr);
+        }
+
+        return module.get();
+    }
+
+    SPtrAsyncComputePipeline Device::createPipelineAsync(const ComputePipeline::CreateInfo& createInfo) {
+        auto pCache = _pipelineCache.get();
+
+        return compileAsync<ComputePipeline> (_pipelineCompiler.get(), [pCache, createInfo] {
+            auto out = pCache->createPipeline(createInfo);
+
+            pCache->record(createInfo);
+
+            return out;
+        });
+    }
+
+    SPtrAsyncGraphicsPipeline Device::createPipelineAsync(const GraphicsPipeline::CreateInfo& createInfo, const RenderPass * renderPass) {
+        auto pCache = _pipelineCache.get();
+
+        return compileAsync<GraphicsPipeline> (_pipelineCompiler.get(), [pCache, createInfo, renderPass] {
+            auto out = pCache->createPipeline(createInfo, renderPass);
+
+            pCache->record(createInfo, renderPass);
+
+            return out;
+        });
+    }
+
+    std::size_t Device::prewarmPipelines(const PipelineManifest& manifest) {
+        auto pCache = _pipelineCache.get();
+        auto pManifest = _pipelineManifest.get();
+        auto computePipelines = manifest.getComputePipelines();
+        auto graphicsPipelines = manifest.getGraphicsPipelines();
+
+        // stale entries, such as pipelines of deleted shaders, are only a missed optimization; they are dropped
+        // from the open manifest so they are not saved and replayed again
+        for (const auto& createInfo : computePipelines) {
+            _pipelineCompiler->submit([pCache, pManifest, createInfo](bool cancelled) {
+                if (cancelled) {
+                    return;
+                }
+
+                try {
+                    pCache->prewarm(createInfo);
+                } catch (const std::exception&) {
+                    if (nullptr != pManifest) {
+                        pManifest->remove(createInfo);
+                    }
+                }
+            }, PipelineCompiler::Priority::LOW);
+        }
+
+        for (const auto& entry : graphicsPipelines) {
+            _pipelineCompiler->submit([pCache, pManifest, entry](bool cancelled) {
+                if (cancelled) {
+                    return;
+                }
+
+                auto createInfo = entry.createInfo;
+
+                if (!entry.sampleMask.empty()) {
+                    createInfo.multisampleState.pSampleMask = const_cast<unsigned int * > (entry.sampleMask.data());
+                }
+
+                try {
+                    pCache->prewarm(createInfo, entry.renderPassInfo);
+                } catch (const std::exception&) {
+                    if (nullptr != pManifest) {
+                        pManifest->remove(entry);
+                    }
+                }
+            }, PipelineCompiler::Priority::LOW);
+        }
+
+        return computePipelines.size() + graphicsPipelines.size();
+    }
+
+    void Device::openPipelineManifest(const std::string& path) {
+        if (nullptr != _pipelineManifest) {
+            throw std::runtime_error("A PipelineManifest is already open!");
+        }
+
+        auto pManifest = std::make_unique<PipelineManifest> ();
+
+        pManifest->load(path);
+
+        _pipelineManifest = std::move(pManifest);
+        _pipelineManifestPath = path;
+
+        // set before the compiler threads run, as setManifest requires
+        _pipelineCache->setManifest(_pipelineManifest.get());
+
+        prewarmPipelines(*_pipelineManifest);
     }
 
     std::vector<QueueFamily * > Device::getQueueFamilies() const noexcept {
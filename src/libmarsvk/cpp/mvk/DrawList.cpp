@@ -0,0 +1,369 @@
+#include "mvk/DrawList.hpp"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "mvk/CommandBuffer.hpp"
+#include "mvk/CommandList.hpp"
+#include "mvk/Pipeline.hpp"
+
+namespace mvk {
+    namespace {
+        constexpr unsigned int RADIX_BITS = 8;
+        constexpr std::size_t RADIX_BUCKETS = 1 << RADIX_BITS;
+        constexpr unsigned int RADIX_PASSES = 64 / RADIX_BITS;
+
+        using Histogram = std::array<std::size_t, RADIX_BUCKETS>;
+
+        inline std::uint64_t quantizeDepth(float depth) noexcept {
+            constexpr auto MAX_DEPTH = static_cast<float> ((1 << DrawList::DEPTH_BITS) - 1);
+
+            return static_cast<std::uint64_t> (std::min(std::max(depth, 0.0F), 1.0F) * MAX_DEPTH);
+        }
+    }
+
+    // A fixed set of threads that run one task at a time; starting threads for every radix pass costs more
+    // than the pass itself.
+    class DrawList::Workers {
+        using Task = std::function<void(std::size_t index)>;
+
+        std::vector<std::thread> _threads;
+        std::mutex _lock;
+        std::condition_variable _workAvailable;
+        std::condition_variable _workDone;
+        const Task * _task;
+        std::uint64_t _generation;
+        std::size_t _pending;
+        bool _shutdown;
+
+        void work(std::size_t index) {
+            std::uint64_t generation = 0;
+
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(_lock);
+
+                    _workAvailable.wait(lock, [&] { return _shutdown || generation != _generation; });
+
+                    if (_shutdown) {
+                        return;
+                    }
+
+                    generation = _generation;
+                }
+
+                (*_task) (index);
+
+                std::lock_guard<std::mutex> lock(_lock);
+
+                if (0 == --_pending) {
+                    _workDone.notify_one();
+                }
+            }
+        }
+
+    public:
+        Workers(std::size_t threadCount):
+            _task(nullptr),
+            _generation(0),
+            _pending(0),
+            _shutdown(false) {
+
+            _threads.reserve(threadCount);
+
+            for (std::size_t i = 0; i < threadCount; i++) {
+                // the calling thread runs index 0
+                _threads.emplace_back(&Workers::work, this, i + 1);
+            }
+        }
+
+        ~Workers() noexcept {
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                _shutdown = true;
+            }
+
+            _workAvailable.notify_all();
+
+            for (auto& thread : _threads) {
+                thread.join();
+            }
+        }
+
+        inline std::size_t getThreadCount() const noexcept {
+            return _threads.size() + 1;
+        }
+
+        // runs task(0) on the calling thread and task(1 ... n) on the workers, returning when all finished
+        void run(const Task& task) {
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+
+                _task = &task;
+                _pending = _threads.size();
+                _generation++;
+            }
+
+            _workAvailable.notify_all();
+
+            task(0);
+
+            std::unique_lock<std::mutex> lock(_lock);
+
+            _workDone.wait(lock, [&] { return 0 == _pending; });
+        }
+    };
+
+    DrawList::DrawList() noexcept:
+        _sorted(true),
+        _stateChangeCount(0) {}
+
+    DrawList::DrawList(DrawList&&) noexcept = default;
+
+    DrawList& DrawList::operator= (DrawList&&) noexcept = default;
+
+    DrawList::~DrawList() noexcept = default;
+
+    std::uint64_t DrawList::idOf(std::unordered_map<const void *, std::uint32_t>& ids, const void * object, unsigned int bits) {
+        if (nullptr == object) {
+            return 0;
+        }
+
+        auto it = ids.find(object);
+
+        if (ids.end() == it) {
+            // id 0 is reserved for null
+            it = ids.emplace(object, static_cast<std::uint32_t> (ids.size() + 1)).first;
+        }
+
+        return std::min<std::uint64_t> (it->second, (1ULL << bits) - 1);
+    }
+
+    void DrawList::clear() noexcept {
+        _draws.clear();
+        _keys.clear();
+        _order.clear();
+        _pipelineIds.clear();
+        _layoutIds.clear();
+        _descriptorSetIds.clear();
+        _vertexBufferIds.clear();
+        _sorted = true;
+    }
+
+    void DrawList::reserve(std::size_t drawCount) {
+        _draws.reserve(drawCount);
+        _keys.reserve(drawCount);
+        _order.reserve(drawCount);
+    }
+
+    void DrawList::add(const DrawList::Draw& draw) {
+        if (nullptr == draw.pipeline) {
+            throw std::runtime_error("DrawList::Draw requires a Pipeline!");
+        }
+
+        auto key = idOf(_pipelineIds, draw.pipeline, PIPELINE_BITS);
+
+        key = (key << LAYOUT_BITS) | idOf(_layoutIds, draw.pipeline->getPipelineLayout(), LAYOUT_BITS);
+        key = (key << DESCRIPTOR_SET_BITS) | idOf(_descriptorSetIds, draw.descriptorSet, DESCRIPTOR_SET_BITS);
+        key = (key << VERTEX_BUFFER_BITS) | idOf(_vertexBufferIds, draw.vertexBuffer, VERTEX_BUFFER_BITS);
+        key = (key << DEPTH_BITS) | quantizeDepth(draw.depth);
+
+        _order.push_back(static_cast<std::uint32_t> (_draws.size()));
+        _draws.push_back(draw);
+        _keys.push_back(key);
+        _sorted = false;
+    }
+
+    void DrawList::sort(std::size_t threadCount) {
+        if (0 == threadCount) {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        if (_draws.size() < PARALLEL_SORT_THRESHOLD) {
+            threadCount = 1;
+        }
+
+        radixSort(threadCount);
+        _sorted = true;
+    }
+
+    void DrawList::radixSort(std::size_t threadCount) {
+        const auto n = _draws.size();
+
+        _sortKeys.assign(_keys.begin(), _keys.end());
+        _scratchKeys.resize(n);
+        _scratchOrder.resize(n);
+        _order.resize(n);
+
+        std::iota(_order.begin(), _order.end(), 0);
+
+        if (threadCount > 1 && (nullptr == _workers || _workers->getThreadCount() != threadCount)) {
+            _workers = nullptr;
+            _workers = std::make_unique<Workers> (threadCount - 1);
+        }
+
+        const auto parallelFor = [&](const std::function<void(std::size_t)>& task) {
+            if (1 == threadCount) {
+                task(0);
+            } else {
+                _workers->run(task);
+            }
+        };
+
+        const auto chunkSize = (n + threadCount - 1) / threadCount;
+        auto histograms = std::vector<Histogram> (threadCount);
+
+        // LSD radix sort on (key, index) pairs kept in separate arrays so the histogram pass streams through keys only.
+        for (unsigned int pass = 0; pass < RADIX_PASSES; pass++) {
+            const auto shift = pass * RADIX_BITS;
+            const auto pSrcKeys = _sortKeys.data();
+            const auto pSrcOrder = _order.data();
+            const auto pDstKeys = _scratchKeys.data();
+            const auto pDstOrder = _scratchOrder.data();
+
+            parallelFor([&] (std::size_t t) {
+                auto& histogram = histograms[t];
+                const auto first = std::min(n, t * chunkSize);
+                const auto last = std::min(n, first + chunkSize);
+
+                histogram.fill(0);
+
+                for (auto i = first; i < last; i++) {
+                    histogram[(pSrcKeys[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+                }
+            });
+
+            // skip the pass if every key has the same digit
+            bool uniform = false;
+
+            for (std::size_t bucket = 0; bucket < RADIX_BUCKETS; bucket++) {
+                std::size_t total = 0;
+
+                for (const auto& histogram : histograms) {
+                    total += histogram[bucket];
+                }
+
+                if (total == n) {
+                    uniform = true;
+                    break;
+                } else if (total > 0) {
+                    break;
+                }
+            }
+
+            if (uniform) {
+                continue;
+            }
+
+            // convert the per-thread histograms into scatter offsets; thread order keeps the sort stable
+            std::size_t offset = 0;
+
+            for (std::size_t bucket = 0; bucket < RADIX_BUCKETS; bucket++) {
+                for (auto& histogram : histograms) {
+                    const auto count = histogram[bucket];
+
+                    histogram[bucket] = offset;
+                    offset += count;
+                }
+            }
+
+            parallelFor([&] (std::size_t t) {
+                auto& offsets = histograms[t];
+                const auto first = std::min(n, t * chunkSize);
+                const auto last = std::min(n, first + chunkSize);
+
+                for (auto i = first; i < last; i++) {
+                    const auto dst = offsets[(pSrcKeys[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+
+                    pDstKeys[dst] = pSrcKeys[i];
+                    pDstOrder[dst] = pSrcOrder[i];
+                }
+            });
+
+            std::swap(_sortKeys, _scratchKeys);
+            std::swap(_order, _scratchOrder);
+        }
+    }
+
+    template<class Target>
+    void DrawList::emit(Target * target) {
+        if (!_sorted) {
+            sort();
+        }
+
+        const Pipeline * boundPipeline = nullptr;
+        const PipelineLayout * boundLayout = nullptr;
+        auto boundDescriptorSets = std::vector<const DescriptorSet *> ();
+        const Buffer * boundVertexBuffer = nullptr;
+        const Buffer * boundIndexBuffer = nullptr;
+        auto boundIndexType = IndexType::UINT16;
+
+        _stateChangeCount = 0;
+
+        for (auto index : _order) {
+            const auto& draw = _draws[index];
+
+            if (draw.pipeline != boundPipeline) {
+                target->bindPipeline(draw.pipeline);
+                boundPipeline = draw.pipeline;
+                _stateChangeCount++;
+
+                // descriptor sets stay bound across Pipelines that share a PipelineLayout
+                const auto layout = draw.pipeline->getPipelineLayout();
+
+                if (layout != boundLayout) {
+                    boundLayout = layout;
+                    boundDescriptorSets.clear();
+                }
+            }
+
+            if (nullptr != draw.descriptorSet) {
+                const auto set = static_cast<std::size_t> (draw.set);
+
+                if (set >= boundDescriptorSets.size()) {
+                    boundDescriptorSets.resize(set + 1, nullptr);
+                }
+
+                if (draw.descriptorSet != boundDescriptorSets[set]) {
+                    target->bindDescriptorSet(draw.pipeline, draw.set, draw.descriptorSet);
+                    boundDescriptorSets[set] = draw.descriptorSet;
+                    _stateChangeCount++;
+                }
+            }
+
+            if (nullptr != draw.vertexBuffer && draw.vertexBuffer != boundVertexBuffer) {
+                target->bindVertexBuffer(0, draw.vertexBuffer);
+                boundVertexBuffer = draw.vertexBuffer;
+                _stateChangeCount++;
+            }
+
+            if (nullptr != draw.indexBuffer) {
+                if (draw.indexBuffer != boundIndexBuffer || draw.indexType != boundIndexType) {
+                    target->bindIndexBuffer(draw.indexBuffer, 0, draw.indexType);
+                    boundIndexBuffer = draw.indexBuffer;
+                    boundIndexType = draw.indexType;
+                    _stateChangeCount++;
+                }
+
+                target->drawIndexed(draw.count, draw.instanceCount, draw.first, draw.vertexOffset, draw.firstInstance);
+            } else {
+                target->draw(draw.count, draw.instanceCount, draw.first, draw.firstInstance);
+            }
+        }
+    }
+
+    void DrawList::execute(CommandBuffer * commandBuffer) {
+        emit(commandBuffer);
+    }
+
+    void DrawList::execute(CommandList * commandList) {
+        emit(commandList);
+    }
+}
@@ -42,6 +42,8 @@ namespace mvk {
     }
 
     void Fence::waitFor() {
+        Tracer::Span traceSpan(getDevice()->getTracer(), "Fence::waitFor", "wait");
+
         vkWaitForFences(getDevice()->getHandle(), 1, &_handle, VK_TRUE, ~0);
     }
 
@@ -8,8 +8,12 @@
 namespace mvk {
     Fence * FencePool::acquireFence() {
         if (_availableFences.empty()) {
+            MVK_METRICS_INCREMENT(getDevice(), FENCE_ALLOCATIONS);
+
             return allocateFence();
         } else {
+            MVK_METRICS_INCREMENT(getDevice(), FENCE_REUSES);
+
             auto out = _availableFences.front();
 
             _availableFences.pop();
@@ -28,7 +32,11 @@ namespace mvk {
 
         VkFence handle = VK_NULL_HANDLE;
 
-        Util::vkAssert(vkCreateFence(getDevice()->getHandle(), &fenceCI, nullptr, &handle));
+        {
+            MVK_METRICS_SCOPED_TIMER(getDevice(), CREATE_SYNC);
+
+            Util::vkAssert(vkCreateFence(getDevice()->getHandle(), &fenceCI, nullptr, &handle));
+        }
 
         auto ptr = std::make_unique<Fence>(this, handle);
         auto out = ptr.get();
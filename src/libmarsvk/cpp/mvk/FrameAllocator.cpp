@@ -0,0 +1,132 @@
+#include "mvk/FrameAllocator.hpp"
+
+#include <stdexcept>
+
+#include "mvk/Device.hpp"
+#include "mvk/Fence.hpp"
+#include "mvk/PhysicalDevice.hpp"
+#include "mvk/Util.hpp"
+
+namespace mvk {
+    FrameAllocator::FrameAllocator(Device * device, const FrameAllocator::CreateInfo& createInfo) {
+        _device = device;
+        _info = createInfo;
+        _frameIndex = 0;
+        _head = 0;
+
+        if (0 == createInfo.frameCount) {
+            throw std::runtime_error("FrameAllocator requires at least one frame!");
+        }
+
+        auto bufferCI = Buffer::CreateInfo {};
+        bufferCI.size = createInfo.frameSize * createInfo.frameCount;
+        bufferCI.usage = createInfo.usage;
+
+        _buffer = device->createBuffer(bufferCI, MemoryUsage::CPU_TO_GPU);
+        _pData = reinterpret_cast<std::uint8_t *> (_buffer->map());
+
+        _frames.reserve(createInfo.frameCount);
+
+        for (std::uint32_t i = 0; i < createInfo.frameCount; ++i) {
+            auto frame = Frame {};
+            frame.fence = device->acquireFence();
+            frame.inFlight = false;
+
+            _frames.push_back(frame);
+        }
+    }
+
+    FrameAllocator::~FrameAllocator() noexcept {
+        if (nullptr == _buffer) {
+            return;
+        }
+
+        for (auto& frame : _frames) {
+            if (frame.inFlight) {
+                frame.fence->waitFor();
+            }
+
+            frame.fence->release();
+        }
+
+        _buffer->unmap();
+    }
+
+    FrameAllocator& FrameAllocator::operator= (FrameAllocator&& from) noexcept {
+        std::swap(_device, from._device);
+        std::swap(_info, from._info);
+        std::swap(_buffer, from._buffer);
+        std::swap(_pData, from._pData);
+        std::swap(_frames, from._frames);
+        std::swap(_frameIndex, from._frameIndex);
+        std::swap(_head, from._head);
+
+        return *this;
+    }
+
+    void FrameAllocator::nextFrame() {
+        _frameIndex = (_frameIndex + 1) % _info.frameCount;
+        _head = 0;
+
+        auto& frame = _frames[_frameIndex];
+
+        if (frame.inFlight) {
+            frame.fence->waitFor();
+            frame.fence->reset();
+            frame.inFlight = false;
+        }
+    }
+
+    Fence * FrameAllocator::acquireFence() {
+        auto& frame = _frames[_frameIndex];
+
+        // a second submit would wait on a Fence that is already pending
+        if (frame.inFlight) {
+            throw std::runtime_error("The Fence of the current frame was already acquired!");
+        }
+
+        if (_head > 0) {
+            _buffer->flush(_frameIndex * _info.frameSize, _head);
+
+            MVK_METRICS_ADD(_device, BYTES_UPLOADED, _head);
+        }
+
+        frame.inFlight = true;
+
+        return frame.fence;
+    }
+
+    FrameAllocator::Allocation FrameAllocator::allocate(VkDeviceSize size, VkDeviceSize alignment) {
+        const auto base = _frameIndex * _info.frameSize;
+        const auto offset = Util::alignUp(base + _head, alignment > 0 ? alignment : 1);
+
+        if (offset + size > base + _info.frameSize) {
+            throw std::runtime_error("FrameAllocator frame region is exhausted!");
+        }
+
+        _head = offset + size - base;
+
+        auto allocation = Allocation {};
+        allocation.pData = _pData + offset;
+        allocation.offset = offset;
+        allocation.size = size;
+
+        return allocation;
+    }
+
+    FrameAllocator::Allocation FrameAllocator::allocateUniform(VkDeviceSize size) {
+        const auto& limits = _device->getPhysicalDevice()->getProperties().limits;
+
+        return allocate(size, limits.minUniformBufferOffsetAlignment);
+    }
+
+    FrameAllocator::Allocation FrameAllocator::allocateStorage(VkDeviceSize size) {
+        const auto& limits = _device->getPhysicalDevice()->getProperties().limits;
+
+        return allocate(size, limits.minStorageBufferOffsetAlignment);
+    }
+
+    FrameAllocator::Allocation FrameAllocator::allocateVertex(VkDeviceSize size) {
+        return allocate(size, 4 * sizeof(float));
+    }
+}
@@ -4,12 +4,14 @@
 
 #include "mvk/Device.hpp"
 #include "mvk/RenderPass.hpp"
+#include "mvk/Util.hpp"
 
 namespace mvk {
     Framebuffer::Framebuffer(const RenderPass * renderPass, const CreateInfo& createInfo, const std::vector<const ImageView *>& attachments) {
         _renderPass = renderPass;
         _info = createInfo;
         _attachments = attachments;
+        _serial = Util::nextSerial();
 
         auto vkAttachments = std::vector<VkImageView> ();
         vkAttachments.reserve(attachments.size());
@@ -27,6 +29,8 @@ namespace mvk {
         framebufferCI.height = static_cast<std::uint32_t> (createInfo.height);
         framebufferCI.layers = static_cast<std::uint32_t> (createInfo.layers);
 
+        MVK_METRICS_SCOPED_TIMER(renderPass->getDevice(), CREATE_FRAMEBUFFER);
+
         Util::vkAssert(vkCreateFramebuffer(renderPass->getDevice()->getHandle(), &framebufferCI, nullptr, &_handle));
     }
 
@@ -39,6 +43,7 @@ namespace mvk {
         std::swap(this->_handle, from._handle);
         std::swap(this->_info, from._info);
         std::swap(this->_renderPass, from._renderPass);
+        std::swap(this->_serial, from._serial);
 
         return *this;
     }
@@ -0,0 +1,221 @@
+#include "mvk/GPUProfiler.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "mvk/CommandBuffer.hpp"
+#include "mvk/Device.hpp"
+#include "mvk/PhysicalDevice.hpp"
+#include "mvk/QueueFamily.hpp"
+
+namespace mvk {
+    GPUProfiler::Scope::~Scope() noexcept {
+        if (nullptr != _profiler) {
+            _profiler->endScope(_commandBuffer, _index);
+        }
+    }
+
+    GPUProfiler::GPUProfiler(Device * device, const GPUProfiler::CreateInfo& createInfo) {
+        _device = device;
+        _info = createInfo;
+        _frameIndex = 0;
+        _frameNumber = 0;
+        _depth = 0;
+        _resolvedFrame = 0;
+        _droppedFrameCount = 0;
+
+        const auto validBits = createInfo.queueFamily->getProperties().timestampValidBits;
+
+        if (0 == validBits) {
+            throw std::runtime_error("QueueFamily does not support timestamps!");
+        }
+
+        if (0 == createInfo.frameCount || 0 == createInfo.maxScopes) {
+            throw std::runtime_error("GPUProfiler requires at least one frame and one scope!");
+        }
+
+        _timestampMask = (validBits >= 64) ? ~0ULL : ((1ULL << validBits) - 1);
+        _timestampPeriod = static_cast<double> (device->getPhysicalDevice()->getProperties().limits.timestampPeriod);
+
+        const bool gatherStatistics = QueryPipelineStatisticFlag::NONE != createInfo.pipelineStatistics && device->getEnabledFeatures().pipelineStatisticsQuery;
+
+        _frames.resize(createInfo.frameCount);
+
+        for (auto& frame : _frames) {
+            auto timestampsCI = QueryPool::CreateInfo {};
+            timestampsCI.queryType = QueryType::TIMESTAMP;
+            timestampsCI.queryCount = 2 * createInfo.maxScopes;
+
+            frame.timestamps = std::make_unique<QueryPool> (device, timestampsCI);
+
+            if (gatherStatistics) {
+                auto statisticsCI = QueryPool::CreateInfo {};
+                statisticsCI.queryType = QueryType::PIPELINE_STATISTICS;
+                statisticsCI.queryCount = createInfo.maxScopes;
+                statisticsCI.pipelineStatistics = createInfo.pipelineStatistics;
+
+                frame.statistics = std::make_unique<QueryPool> (device, statisticsCI);
+            }
+
+            frame.scopes.reserve(createInfo.maxScopes);
+            frame.frameNumber = 0;
+            frame.pending = false;
+        }
+    }
+
+    bool GPUProfiler::resolve(GPUProfiler::Frame& frame) {
+        const auto scopeCount = static_cast<std::uint32_t> (frame.scopes.size());
+
+        if (scopeCount > 0) {
+            _scratch.resize(2 * scopeCount);
+
+            if (!frame.timestamps->getResults(0, 2 * scopeCount, _scratch.data())) {
+                return false;
+            }
+        }
+
+        auto statistics = std::vector<std::uint64_t> ();
+
+        if (scopeCount > 0 && frame.statistics) {
+            statistics.resize(scopeCount * frame.statistics->getResultCount());
+
+            if (!frame.statistics->getResults(0, scopeCount, statistics.data())) {
+                return false;
+            }
+        }
+
+        frame.pending = false;
+
+        // an older frame may finish after a newer one was already resolved
+        if (frame.frameNumber < _resolvedFrame) {
+            return true;
+        }
+
+        auto& tracer = _device->getTracer();
+
+        if (tracer.isRecording()) {
+            const auto queueFamilyIndex = static_cast<std::uint32_t> (_info.queueFamily->getIndex());
+
+            for (std::uint32_t i = 0; i < scopeCount; i++) {
+                tracer.addGPUSpan(frame.scopes[i].name, queueFamilyIndex, _scratch[2 * i], _scratch[2 * i + 1], _timestampMask);
+            }
+        }
+
+        _results.clear();
+        _results.reserve(scopeCount);
+
+        for (std::uint32_t i = 0; i < scopeCount; i++) {
+            const auto& record = frame.scopes[i];
+            const auto ticks = (_scratch[2 * i + 1] - _scratch[2 * i]) & _timestampMask;
+
+            auto result = Result {};
+            result.name = record.name;
+            result.depth = record.depth;
+            result.milliseconds = static_cast<double> (ticks) * _timestampPeriod * 1E-6;
+
+            if (record.hasStatistics) {
+                const auto resultCount = frame.statistics->getResultCount();
+                const auto first = statistics.begin() + i * resultCount;
+
+                result.statistics.assign(first, first + resultCount);
+            }
+
+            _results.push_back(std::move(result));
+        }
+
+        _resolvedFrame = frame.frameNumber;
+
+        return true;
+    }
+
+    void GPUProfiler::beginFrame(CommandBuffer * commandBuffer) {
+        if (_frameNumber > 0) {
+            _frameIndex = (_frameIndex + 1) % _info.frameCount;
+        }
+
+        auto& frame = _frames[_frameIndex];
+
+        if (frame.pending && !resolve(frame)) {
+            _droppedFrameCount++;
+        }
+
+        commandBuffer->resetQueryPool(frame.timestamps.get(), 0, 2 * _info.maxScopes);
+
+        if (frame.statistics) {
+            commandBuffer->resetQueryPool(frame.statistics.get(), 0, _info.maxScopes);
+        }
+
+        frame.scopes.clear();
+        frame.frameNumber = ++_frameNumber;
+        frame.pending = true;
+        _depth = 0;
+    }
+
+    std::uint32_t GPUProfiler::beginScope(CommandBuffer * commandBuffer, const std::string& name, PipelineStageFlag stage) {
+        auto& frame = _frames[_frameIndex];
+        const auto index = static_cast<std::uint32_t> (frame.scopes.size());
+
+        if (index == _info.maxScopes) {
+            throw std::runtime_error("GPUProfiler scope limit exceeded!");
+        }
+
+        auto record = ScopeRecord {};
+        record.name = name;
+        record.depth = _depth++;
+        record.hasStatistics = frame.statistics && 0 == record.depth;
+
+        frame.scopes.push_back(std::move(record));
+
+        commandBuffer->writeTimestamp(stage, frame.timestamps.get(), 2 * index);
+
+        if (frame.scopes.back().hasStatistics) {
+            commandBuffer->beginQuery(frame.statistics.get(), index);
+        }
+
+        return index;
+    }
+
+    void GPUProfiler::endScope(CommandBuffer * commandBuffer, std::uint32_t index, PipelineStageFlag stage) {
+        auto& frame = _frames[_frameIndex];
+
+        if (frame.scopes[index].hasStatistics) {
+            commandBuffer->endQuery(frame.statistics.get(), index);
+        }
+
+        commandBuffer->writeTimestamp(stage, frame.timestamps.get(), 2 * index + 1);
+
+        _depth--;
+    }
+
+    void GPUProfiler::resolve() {
+        auto pending = std::vector<Frame *> ();
+
+        for (auto& frame : _frames) {
+            if (frame.pending && frame.frameNumber != _frameNumber) {
+                pending.push_back(&frame);
+            }
+        }
+
+        std::sort(pending.begin(), pending.end(), [] (const Frame * a, const Frame * b) {
+            return a->frameNumber < b->frameNumber;
+        });
+
+        for (auto frame : pending) {
+            if (!resolve(*frame)) {
+                break;
+            }
+        }
+    }
+
+    double GPUProfiler::getMilliseconds(const std::string& name) const noexcept {
+        double milliseconds = 0.0;
+
+        for (const auto& result : _results) {
+            if (result.name == name) {
+                milliseconds += result.milliseconds;
+            }
+        }
+
+        return milliseconds;
+    }
+}
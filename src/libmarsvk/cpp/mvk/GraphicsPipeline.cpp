@@ -1,5 +1,7 @@
 #include "mvk/GraphicsPipeline.hpp"
 
+#include <cstdint>
+
 #include <iostream>
 #include <memory>
 
@@ -9,28 +11,43 @@
 #include "mvk/Util.hpp"
 
 namespace mvk {
-    GraphicsPipeline::GraphicsPipeline(PipelineCache * cache, const GraphicsPipeline::CreateInfo& createInfo, const RenderPass * renderPass) {
-        _cache = cache;
-        _info = createInfo;
-
-        auto pDevice = cache->getDevice();
-        auto stages = std::vector<VkPipelineShaderStageCreateInfo> ();
+    GraphicsPipeline::NativeCreateInfo::NativeCreateInfo(Device * device, const CreateInfo& createInfo, const PipelineLayout * layout, const RenderPass * renderPass) {
         stages.reserve(createInfo.stages.size());
 
+        // the Vulkan structures point into these, so they must not reallocate
+        specializationMapEntries.resize(createInfo.stages.size());
+        specializationInfos.resize(createInfo.stages.size());
+
         for (const auto& stage : createInfo.stages) {
-            auto info = VkPipelineShaderStageCreateInfo {};
-            info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-            info.stage = static_cast<VkShaderStageFlagBits> (stage.stage);
-            info.pName = stage.name.c_str();
-            info.module = pDevice->getShaderModule(stage.moduleInfo)->getHandle();
-            info.flags = stage.flags;
-
-            stages.push_back(info);
-        }
+            auto stageI = VkPipelineShaderStageCreateInfo {};
+            stageI.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            stageI.stage = static_cast<VkShaderStageFlagBits> (stage.stage);
+            stageI.pName = stage.name.c_str();
+            stageI.module = device->getShaderModule(stage.moduleInfo)->getHandle();
+            stageI.flags = stage.flags;
 
-        _layout = pDevice->allocatePipelineLayout(createInfo.layoutInfo);
+            if (!stage.specializationInfo.mapEntries.empty()) {
+                auto& mapEntries = specializationMapEntries[stages.size()];
+                auto& specializationI = specializationInfos[stages.size()];
+
+                mapEntries.reserve(stage.specializationInfo.mapEntries.size());
 
-        auto multisampleState = VkPipelineMultisampleStateCreateInfo {};
+                for (const auto& mapEntry : stage.specializationInfo.mapEntries) {
+                    mapEntries.push_back({mapEntry.constantID, mapEntry.offset, mapEntry.size});
+                }
+
+                specializationI.mapEntryCount = static_cast<std::uint32_t> (mapEntries.size());
+                specializationI.pMapEntries = mapEntries.data();
+                specializationI.dataSize = stage.specializationInfo.data.size();
+                specializationI.pData = stage.specializationInfo.data.data();
+
+                stageI.pSpecializationInfo = &specializationI;
+            }
+
+            stages.push_back(stageI);
+        }
+
+        multisampleState = VkPipelineMultisampleStateCreateInfo {};
         multisampleState.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
         multisampleState.flags = createInfo.multisampleState.flags;
         multisampleState.rasterizationSamples = static_cast<VkSampleCountFlagBits> (createInfo.multisampleState.rasterizationSamples);
@@ -40,7 +57,7 @@ namespace mvk {
         multisampleState.alphaToCoverageEnable = createInfo.multisampleState.alphaToCoverageEnable ? VK_TRUE : VK_FALSE;
         multisampleState.alphaToOneEnable = createInfo.multisampleState.alphaToOneEnable ? VK_TRUE : VK_FALSE;
 
-        auto rasterizationState = VkPipelineRasterizationStateCreateInfo {};
+        rasterizationState = VkPipelineRasterizationStateCreateInfo {};
         rasterizationState.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
         rasterizationState.flags = createInfo.rasterizationState.flags;
         rasterizationState.depthClampEnable = createInfo.rasterizationState.depthClampEnable ? VK_TRUE : VK_FALSE;
@@ -54,7 +71,7 @@ namespace mvk {
         rasterizationState.depthBiasSlopeFactor = createInfo.rasterizationState.depthBiasSlopeFactor;
         rasterizationState.lineWidth = createInfo.rasterizationState.lineWidth;
 
-        auto depthStencilState = VkPipelineDepthStencilStateCreateInfo {};
+        depthStencilState = VkPipelineDepthStencilStateCreateInfo {};
         depthStencilState.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
         depthStencilState.flags = createInfo.depthStencilState.flags;
         depthStencilState.depthTestEnable = createInfo.depthStencilState.depthTestEnable ? VK_TRUE : VK_FALSE;
@@ -77,28 +94,26 @@ namespace mvk {
         deserializeStencilState(depthStencilState.front, createInfo.depthStencilState.front);
         deserializeStencilState(depthStencilState.back, createInfo.depthStencilState.back);        
 
-        auto pDynamicStates = std::vector<VkDynamicState> ();
-        pDynamicStates.reserve(2);
-        pDynamicStates.push_back(VK_DYNAMIC_STATE_SCISSOR);
-        pDynamicStates.push_back(VK_DYNAMIC_STATE_VIEWPORT);
+        dynamicStates.reserve(2);
+        dynamicStates.push_back(VK_DYNAMIC_STATE_SCISSOR);
+        dynamicStates.push_back(VK_DYNAMIC_STATE_VIEWPORT);
 
-        auto dynamicState = VkPipelineDynamicStateCreateInfo {};
+        dynamicState = VkPipelineDynamicStateCreateInfo {};
         dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-        dynamicState.dynamicStateCount = pDynamicStates.size();
-        dynamicState.pDynamicStates = pDynamicStates.data();
+        dynamicState.dynamicStateCount = dynamicStates.size();
+        dynamicState.pDynamicStates = dynamicStates.data();
 
-        auto inputAssemblyState = VkPipelineInputAssemblyStateCreateInfo {};
+        inputAssemblyState = VkPipelineInputAssemblyStateCreateInfo {};
         inputAssemblyState.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
         inputAssemblyState.flags = createInfo.inputAssemblyState.flags;
         inputAssemblyState.topology = static_cast<VkPrimitiveTopology> (createInfo.inputAssemblyState.topology);
         inputAssemblyState.primitiveRestartEnable = createInfo.inputAssemblyState.primitiveRestartEnable;
 
-        auto viewportState = VkPipelineViewportStateCreateInfo {};
+        viewportState = VkPipelineViewportStateCreateInfo {};
         viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
         viewportState.viewportCount = 1;
         viewportState.scissorCount = 1;
 
-        auto bindingDescriptions = std::vector<VkVertexInputBindingDescription> ();
         bindingDescriptions.reserve(createInfo.vertexInputState.vertexBindingDescriptions.size());
 
         for (const auto& binding : createInfo.vertexInputState.vertexBindingDescriptions) {
@@ -110,7 +125,6 @@ namespace mvk {
             bindingDescriptions.push_back(vkb);
         }
 
-        auto attributeDescriptions = std::vector<VkVertexInputAttributeDescription> ();
         attributeDescriptions.reserve(createInfo.vertexInputState.vertexAttributeDescriptions.size());
 
         for (const auto& attrib : createInfo.vertexInputState.vertexAttributeDescriptions) {
@@ -123,7 +137,7 @@ namespace mvk {
             attributeDescriptions.push_back(vka);
         }
 
-        auto vertexInputState = VkPipelineVertexInputStateCreateInfo {};
+        vertexInputState = VkPipelineVertexInputStateCreateInfo {};
         vertexInputState.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
         vertexInputState.flags = createInfo.vertexInputState.flags;
         vertexInputState.vertexBindingDescriptionCount = bindingDescriptions.size();
@@ -131,12 +145,11 @@ namespace mvk {
         vertexInputState.vertexAttributeDescriptionCount = attributeDescriptions.size();
         vertexInputState.pVertexAttributeDescriptions = attributeDescriptions.data();
 
-        auto tessellationState = VkPipelineTessellationStateCreateInfo {};
+        tessellationState = VkPipelineTessellationStateCreateInfo {};
         tessellationState.sType = VK_STRUCTURE_TYPE_PIPELINE_TESSELLATION_STATE_CREATE_INFO;
         tessellationState.flags = createInfo.tessellationState.flags;
         tessellationState.patchControlPoints = static_cast<uint32_t> (createInfo.tessellationState.patchControlPoints);
 
-        auto attachments = std::vector<VkPipelineColorBlendAttachmentState> ();
         attachments.reserve(createInfo.colorBlendState.attachments.size());
 
         for (const auto& attachment : createInfo.colorBlendState.attachments) {
@@ -153,7 +166,7 @@ namespace mvk {
             attachments.push_back(vkcb);
         }
 
-        auto colorBlendState = VkPipelineColorBlendStateCreateInfo {};
+        colorBlendState = VkPipelineColorBlendStateCreateInfo {};
         colorBlendState.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
         colorBlendState.flags = createInfo.colorBlendState.flags;
         colorBlendState.logicOpEnable = createInfo.colorBlendState.logicOpEnable ? VK_TRUE : VK_FALSE;
@@ -165,26 +178,67 @@ namespace mvk {
         colorBlendState.blendConstants[2] = createInfo.colorBlendState.blendConstants.blue;
         colorBlendState.blendConstants[3] = createInfo.colorBlendState.blendConstants.alpha;
 
-        auto graphicsPipelineCI = VkGraphicsPipelineCreateInfo {};
-        graphicsPipelineCI.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        graphicsPipelineCI.flags = createInfo.flags;
-        graphicsPipelineCI.stageCount = stages.size();
-        graphicsPipelineCI.pStages = stages.data();
-        graphicsPipelineCI.pVertexInputState = &vertexInputState;
-        graphicsPipelineCI.pInputAssemblyState = &inputAssemblyState;
-        graphicsPipelineCI.pTessellationState = &tessellationState;
-        graphicsPipelineCI.pViewportState = &viewportState;
-        graphicsPipelineCI.pRasterizationState = &rasterizationState;
-        graphicsPipelineCI.pMultisampleState = &multisampleState;
-        graphicsPipelineCI.pDepthStencilState = &depthStencilState;
-        graphicsPipelineCI.pColorBlendState = &colorBlendState;
-        graphicsPipelineCI.pDynamicState = &dynamicState;
-        graphicsPipelineCI.layout = _layout->getHandle();
-        graphicsPipelineCI.renderPass = renderPass->getHandle();
-        graphicsPipelineCI.subpass = createInfo.subpass;
+        info = VkGraphicsPipelineCreateInfo {};
+        info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        info.flags = createInfo.flags;
+        info.stageCount = stages.size();
+        info.pStages = stages.data();
+        info.pVertexInputState = &vertexInputState;
+        info.pInputAssemblyState = &inputAssemblyState;
+        info.pTessellationState = &tessellationState;
+        info.pViewportState = &viewportState;
+        info.pRasterizationState = &rasterizationState;
+        info.pMultisampleState = &multisampleState;
+        info.pDepthStencilState = &depthStencilState;
+        info.pColorBlendState = &colorBlendState;
+        info.pDynamicState = &dynamicState;
+        info.layout = layout->getHandle();
+        info.renderPass = renderPass->getHandle();
+        info.subpass = createInfo.subpass;
+
+#if defined(VK_KHR_pipeline_executable_properties)
+        if (device->isPipelineExecutableInfoEnabled()) {
+            info.flags |= VK_PIPELINE_CREATE_CAPTURE_STATISTICS_BIT_KHR;
+        }
+#endif
+    }
+
+    GraphicsPipeline::GraphicsPipeline(PipelineCache * cache, const GraphicsPipeline::CreateInfo& createInfo, const RenderPass * renderPass) {
+        _device = cache->getDevice();
+        _cache = cache;
+        _info = createInfo;
+        _serial = Util::nextSerial();
+
+        auto pDevice = cache->getDevice();
+
+        _layout = pDevice->allocatePipelineLayout(createInfo.layoutInfo);
+
+        const NativeCreateInfo nativeCI(pDevice, _info, _layout, renderPass);
 
         _handle = VK_NULL_HANDLE;
-        Util::vkAssert(vkCreateGraphicsPipelines(pDevice->getHandle(), cache->getHandle(), 1, &graphicsPipelineCI, nullptr, &_handle));
+
+        MVK_METRICS_SCOPED_TIMER(pDevice, CREATE_PIPELINE);
+        MVK_METRICS_INCREMENT(pDevice, PIPELINES_CREATED);
+
+        Tracer::Span traceSpan(pDevice->getTracer(), "vkCreateGraphicsPipelines", "pipeline");
+
+        Util::vkAssert(vkCreateGraphicsPipelines(pDevice->getHandle(), cache->getHandle(), 1, &nativeCI.info, nullptr, &_handle));
+
+        pDevice->setObjectName(VK_OBJECT_TYPE_PIPELINE, _handle, createInfo.name);
+
+        cache->recordExecutableStatistics(_handle, PipelineBindPoint::GRAPHICS, createInfo.name);
+    }
+
+    GraphicsPipeline::GraphicsPipeline(PipelineCache * cache, const GraphicsPipeline::CreateInfo& createInfo, PipelineLayout * layout, VkPipeline handle) {
+        _device = cache->getDevice();
+        _cache = cache;
+        _info = createInfo;
+        _serial = Util::nextSerial();
+        _layout = layout;
+        _handle = handle;
+
+        cache->getDevice()->setObjectName(VK_OBJECT_TYPE_PIPELINE, _handle, createInfo.name);
+        cache->recordExecutableStatistics(_handle, PipelineBindPoint::GRAPHICS, createInfo.name);
     }
 
     GraphicsPipeline::~GraphicsPipeline() noexcept {
@@ -193,8 +247,10 @@ namespace mvk {
     }
 
     GraphicsPipeline& GraphicsPipeline::operator= (GraphicsPipeline&& from) noexcept {
+        std::swap(this->_device, from._device);
         std::swap(this->_cache, from._cache);
         std::swap(this->_handle, from._handle);
+        std::swap(this->_serial, from._serial);
         std::swap(this->_info, from._info);
         std::swap(this->_layout, from._layout);
 
@@ -210,7 +266,7 @@ namespace mvk {
     }
 
     Device * GraphicsPipeline::getDevice() const noexcept {
-        return _cache->getDevice();
+        return _device;
     }
 
     PipelineCache * GraphicsPipeline::getPipelineCache() const noexcept {
@@ -232,4 +288,8 @@ namespace mvk {
     VkPipeline GraphicsPipeline::getHandle() const noexcept {
         return _handle;
     }
+
+    std::uint64_t GraphicsPipeline::getSerial() const noexcept {
+        return _serial;
+    }
 }
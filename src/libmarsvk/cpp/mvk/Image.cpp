@@ -74,6 +74,8 @@ namespace mvk {
         imageCI.extent.height = createInfo.extent.height;
         imageCI.extent.depth = createInfo.extent.depth;
 
+        MVK_METRICS_SCOPED_TIMER(device, CREATE_IMAGE);
+
         if (createInfo.exported) {
             Util::vkAssert(vkCreateImage(*device, &imageCI, nullptr, &_handle));
 
@@ -99,6 +101,8 @@ namespace mvk {
             Util::vkAssert(vmaCreateImage(device->getMemoryAllocator(), &imageCI, &allocationCI, &_handle, &_memory.local, nullptr));        
         }
 
+        device->setObjectName(VK_OBJECT_TYPE_IMAGE, _handle, createInfo.name);
+
         _external = false;   
     }
 
@@ -27,6 +27,8 @@ namespace mvk {
 
         _handle = VK_NULL_HANDLE;
 
+        MVK_METRICS_SCOPED_TIMER(pDevice, CREATE_IMAGE_VIEW);
+
         Util::vkAssert(vkCreateImageView(pDevice->getHandle(), &imageViewCI, nullptr, &_handle));
     }
 
@@ -80,6 +82,8 @@ namespace mvk {
 
         _handle = VK_NULL_HANDLE;
 
+        MVK_METRICS_SCOPED_TIMER(pDevice, CREATE_IMAGE_VIEW);
+
         Util::vkAssert(vkCreateImageView(pDevice->getHandle(), &imageViewCI, nullptr, &_handle));
     }
 
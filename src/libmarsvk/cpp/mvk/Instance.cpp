@@ -1,15 +1,16 @@
 #include "mvk/Instance.hpp"
 
 #include <cstdint>
+#include <cstdlib>
 
 #include <algorithm>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
 #include <set>
+#include <vector>
 
 #include "volk.h"
-#include <GLFW/glfw3.h>
 
 #include "mvk/PhysicalDevice.hpp"
 
@@ -17,23 +18,51 @@ namespace mvk {
     namespace {
         std::set<std::string> _enabledLayers;
         std::set<std::string> _enabledExtensions;
+        std::string _debugReportPath;
+
+        bool isExtensionAvailable(const char * layerName, const std::string& extName) {
+            std::uint32_t extensionCount = 0;
+
+            if (VK_SUCCESS != vkEnumerateInstanceExtensionProperties(layerName, &extensionCount, nullptr)) {
+                // a missing layer is reported by vkCreateInstance
+                return false;
+            }
+
+            auto extensions = std::vector<VkExtensionProperties> (extensionCount);
+
+            Util::vkAssert(vkEnumerateInstanceExtensionProperties(layerName, &extensionCount, extensions.data()));
+
+            return std::any_of(extensions.begin(), extensions.end(), [&extName](const VkExtensionProperties& extension) {
+                return extName == extension.extensionName;
+            });
+        }
+
+        // checks the implementation and the enabled layers, which may provide extensions of their own
+        bool isExtensionSupported(const std::string& extName) {
+            if (isExtensionAvailable(nullptr, extName)) {
+                return true;
+            }
+
+            return std::any_of(_enabledLayers.begin(), _enabledLayers.end(), [&extName](const std::string& layerName) {
+                return isExtensionAvailable(layerName.c_str(), extName);
+            });
+        }
     }
 
     void Instance::enableExtension(const std::string& extName) noexcept {
         _enabledExtensions.insert(extName);
     }
 
-    void Instance::enableLayer(const std::string& layerName) noexcept {
-        _enabledLayers.insert(layerName);
+    bool Instance::isExtensionEnabled(const std::string& extName) noexcept {
+        return _enabledExtensions.end() != _enabledExtensions.find(extName);
     }
 
-    void Instance::enableRequiredGLFWExtensions() noexcept {
-        uint32_t requiredGLFWExtensions = 0;
-        auto extensions = glfwGetRequiredInstanceExtensions(&requiredGLFWExtensions);
+    void Instance::setDebugReportPath(const std::string& path) noexcept {
+        _debugReportPath = path;
+    }
 
-        std::for_each(extensions, extensions + requiredGLFWExtensions, [](auto extName) {
-            _enabledExtensions.insert(extName);
-        });
+    void Instance::enableLayer(const std::string& layerName) noexcept {
+        _enabledLayers.insert(layerName);
     }
 
     Instance::Instance() {
@@ -50,8 +79,23 @@ namespace mvk {
         
 #if defined(DEBUG) || defined(NDEBUG) || defined(_DEBUG)
         _enabledLayers.insert("VK_LAYER_LUNARG_standard_validation");
+
+        if (isExtensionSupported("VK_EXT_debug_utils")) {
+            _enabledExtensions.insert("VK_EXT_debug_utils");
+        }
 #endif
 
+        // required by the Device extensions that extend the feature and property queries
+        if (isExtensionSupported("VK_KHR_get_physical_device_properties2")) {
+            _enabledExtensions.insert("VK_KHR_get_physical_device_properties2");
+        }
+
+        _debugMessenger = VK_NULL_HANDLE;
+
+        if (isExtensionEnabled("VK_EXT_debug_utils")) {
+            _debugReport = std::make_unique<DebugReport> ();
+        }
+
         auto pEnabledExtensionNames = std::vector<const char *> ();
         pEnabledExtensionNames.reserve(_enabledExtensions.size());
 
@@ -74,10 +118,22 @@ namespace mvk {
         instanceCI.ppEnabledLayerNames = pEnabledLayers.data();
         instanceCI.enabledLayerCount = pEnabledLayers.size();
 
+        // chaining the messenger also reports messages from vkCreateInstance and vkDestroyInstance
+        auto messengerCI = VkDebugUtilsMessengerCreateInfoEXT {};
+
+        if (_debugReport) {
+            messengerCI = _debugReport->getMessengerCreateInfo();
+            instanceCI.pNext = &messengerCI;
+        }
+
         Util::vkAssert(vkCreateInstance(&instanceCI, nullptr, &_handle));
         
         volkLoadInstance(_handle);
 
+        if (_debugReport) {
+            Util::vkAssert(vkCreateDebugUtilsMessengerEXT(_handle, &messengerCI, nullptr, &_debugMessenger));
+        }
+
         std::uint32_t physicalDeviceCount = 0;
         Util::vkAssert(vkEnumeratePhysicalDevices(_handle, &physicalDeviceCount, nullptr));
 
@@ -99,15 +155,40 @@ namespace mvk {
     Instance& Instance::operator= (Instance&& from) noexcept {
         std::swap(this->_handle, from._handle);
         std::swap(this->_physicalDevices, from._physicalDevices);
+        std::swap(this->_debugReport, from._debugReport);
+        std::swap(this->_debugMessenger, from._debugMessenger);
 
         return *this;
     }
 
     void Instance::free() noexcept {
         if (_handle) {
+            if (_debugMessenger) {
+                vkDestroyDebugUtilsMessengerEXT(_handle, _debugMessenger, nullptr);
+                _debugMessenger = VK_NULL_HANDLE;
+            }
+
             vkDestroyInstance(_handle, nullptr);
             _handle = VK_NULL_HANDLE;
         }
+
+        if (_debugReport) {
+            auto path = _debugReportPath;
+
+            if (path.empty() && nullptr != std::getenv("MVK_DEBUG_REPORT")) {
+                path = std::getenv("MVK_DEBUG_REPORT");
+            }
+
+            if (!path.empty()) {
+                try {
+                    _debugReport->save(path);
+                } catch (const std::exception& ex) {
+                    std::cerr << ex.what() << std::endl;
+                }
+            }
+
+            _debugReport.reset();
+        }
     }
 
     Instance& Instance::getCurrent() {
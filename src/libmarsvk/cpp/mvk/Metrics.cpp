@@ -0,0 +1,168 @@
+#include "mvk/Metrics.hpp"
+
+#include <sstream>
+
+namespace mvk {
+    namespace {
+        const char * const COUNTER_NAMES[] = {
+            "fenceAllocations",
+            "fenceReuses",
+            "semaphoreAllocations",
+            "semaphoreReuses",
+            "descriptorSetAllocations",
+            "descriptorSetReleases",
+            "descriptorPoolAllocations",
+            "descriptorSetLayoutCacheHits",
+            "descriptorSetLayoutCacheMisses",
+            "pipelineLayoutCacheHits",
+            "pipelineLayoutCacheMisses",
+            "samplerCacheHits",
+            "samplerCacheMisses",
+            "shaderModuleCacheHits",
+            "shaderModuleCacheMisses",
+            "sharedPipelineHits",
+            "sharedPipelineMisses",
+            "pipelinesCreated",
+            "queueSubmits",
+            "pipelineBarriers",
+            "bytesUploaded"
+        };
+
+        const char * const TIMER_NAMES[] = {
+            "createBuffer",
+            "createImage",
+            "createImageView",
+            "createBufferView",
+            "createPipeline",
+            "createPipelineLayout",
+            "createShaderModule",
+            "createDescriptorPool",
+            "createSampler",
+            "createSync",
+            "createRenderPass",
+            "createFramebuffer",
+            "queueSubmit"
+        };
+
+        static_assert(sizeof(COUNTER_NAMES) / sizeof(COUNTER_NAMES[0]) == static_cast<std::size_t> (Metrics::Counter::COUNT), "Every Counter must be named!");
+        static_assert(sizeof(TIMER_NAMES) / sizeof(TIMER_NAMES[0]) == static_cast<std::size_t> (Metrics::Timer::COUNT), "Every Timer must be named!");
+
+#if defined(MVK_ENABLE_METRICS)
+        inline std::size_t bucketOf(std::uint64_t value) noexcept {
+            std::size_t bucket = 0;
+
+            while (value > 1 && bucket < Metrics::HISTOGRAM_BUCKETS - 1) {
+                value >>= 1;
+                bucket++;
+            }
+
+            return bucket;
+        }
+#endif
+    }
+
+    const char * Metrics::getName(Metrics::Counter counter) noexcept {
+        return COUNTER_NAMES[static_cast<std::size_t> (counter)];
+    }
+
+    const char * Metrics::getName(Metrics::Timer timer) noexcept {
+        return TIMER_NAMES[static_cast<std::size_t> (timer)];
+    }
+
+    Metrics::Metrics() noexcept {
+        reset();
+    }
+
+    void Metrics::reset() noexcept {
+#if defined(MVK_ENABLE_METRICS)
+        for (auto& counter : _counters) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+
+        for (auto& histogram : _histograms) {
+            histogram.count.store(0, std::memory_order_relaxed);
+            histogram.sum.store(0, std::memory_order_relaxed);
+            histogram.max.store(0, std::memory_order_relaxed);
+
+            for (auto& bucket : histogram.buckets) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        _start = std::chrono::steady_clock::now();
+#endif
+    }
+
+    void Metrics::record(Metrics::Timer timer, std::uint64_t nanoseconds) noexcept {
+#if defined(MVK_ENABLE_METRICS)
+        auto& histogram = _histograms[static_cast<std::size_t> (timer)];
+
+        histogram.count.fetch_add(1, std::memory_order_relaxed);
+        histogram.sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+        histogram.buckets[bucketOf(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+
+        auto max = histogram.max.load(std::memory_order_relaxed);
+
+        while (nanoseconds > max && !histogram.max.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed)) {}
+#endif
+    }
+
+    std::uint64_t Metrics::get(Metrics::Counter counter) const noexcept {
+#if defined(MVK_ENABLE_METRICS)
+        return _counters[static_cast<std::size_t> (counter)].load(std::memory_order_relaxed);
+#else
+        return 0;
+#endif
+    }
+
+    double Metrics::getUptime() const noexcept {
+#if defined(MVK_ENABLE_METRICS)
+        return std::chrono::duration<double> (std::chrono::steady_clock::now() - _start).count();
+#else
+        return 0.0;
+#endif
+    }
+
+    std::string Metrics::toJSON() const {
+        auto out = std::stringstream ();
+
+#if defined(MVK_ENABLE_METRICS)
+        const auto uptime = getUptime();
+
+        out << "{\"enabled\":true,\"uptimeSeconds\":" << uptime << ",\"counters\":{";
+
+        for (std::size_t i = 0; i < _counters.size(); i++) {
+            out << (i > 0 ? "," : "") << "\"" << COUNTER_NAMES[i] << "\":" << _counters[i].load(std::memory_order_relaxed);
+        }
+
+        const auto submits = get(Counter::QUEUE_SUBMITS);
+
+        out << "},\"rates\":{\"queueSubmitsPerSecond\":" << (uptime > 0.0 ? submits / uptime : 0.0) << "},\"timers\":{";
+
+        for (std::size_t i = 0; i < _histograms.size(); i++) {
+            const auto& histogram = _histograms[i];
+            const auto count = histogram.count.load(std::memory_order_relaxed);
+            const auto sum = histogram.sum.load(std::memory_order_relaxed);
+
+            out << (i > 0 ? "," : "") << "\"" << TIMER_NAMES[i] << "\":{"
+                << "\"count\":" << count
+                << ",\"sumNs\":" << sum
+                << ",\"meanNs\":" << (count > 0 ? static_cast<double> (sum) / count : 0.0)
+                << ",\"maxNs\":" << histogram.max.load(std::memory_order_relaxed)
+                << ",\"buckets\":[";
+
+            for (std::size_t bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++) {
+                out << (bucket > 0 ? "," : "") << histogram.buckets[bucket].load(std::memory_order_relaxed);
+            }
+
+            out << "]}";
+        }
+
+        out << "}}";
+#else
+        out << "{\"enabled\":false}";
+#endif
+
+        return out.str();
+    }
+}
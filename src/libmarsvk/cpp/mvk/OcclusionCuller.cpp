@@ -0,0 +1,135 @@
+#include "mvk/OcclusionCuller.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "mvk/CommandBuffer.hpp"
+#include "mvk/Device.hpp"
+
+namespace mvk {
+    namespace {
+        constexpr std::size_t PREDICATE_SIZE = sizeof(std::uint32_t);
+    }
+
+    OcclusionCuller::OcclusionCuller(Device * device, const OcclusionCuller::CreateInfo& createInfo) {
+        _device = device;
+        _info = createInfo;
+        _initialized = false;
+
+        if (0 == createInfo.objectCount) {
+            throw std::runtime_error("OcclusionCuller requires at least one object!");
+        }
+
+        {
+            const auto& enabledExtensions = device->getEnabledExtensions();
+
+            _conditionalRendering = enabledExtensions.end() != enabledExtensions.find("VK_EXT_conditional_rendering");
+        }
+
+        _info.precise = createInfo.precise && device->getEnabledFeatures().occlusionQueryPrecise;
+
+        auto queryPoolCI = QueryPool::CreateInfo {};
+        queryPoolCI.queryType = QueryType::OCCLUSION;
+        queryPoolCI.queryCount = createInfo.objectCount;
+
+        _queryPool = device->createQueryPool(queryPoolCI);
+
+        auto bufferCI = Buffer::CreateInfo {};
+        bufferCI.size = createInfo.objectCount * PREDICATE_SIZE;
+        bufferCI.usage = BufferUsageFlag::TRANSFER_DST;
+
+        if (_conditionalRendering) {
+            bufferCI.usage = bufferCI.usage | BufferUsageFlag::CONDITIONAL_RENDERING;
+        }
+
+        _predicates = device->createBuffer(bufferCI, MemoryUsage::GPU_ONLY);
+        _tested.resize(createInfo.objectCount, false);
+    }
+
+    void OcclusionCuller::beginFrame(CommandBuffer * commandBuffer) {
+        const auto predicateStage = _conditionalRendering ? PipelineStageFlag::CONDITIONAL_RENDERING : PipelineStageFlag::TOP_OF_PIPE;
+        const auto predicateAccess = _conditionalRendering ? AccessFlag::CONDITIONAL_RENDERING_READ : AccessFlag::NONE;
+
+        // the previous frame must be done reading the predicates before they are overwritten
+        auto writeBarrier = MemoryBarrier {};
+        writeBarrier.srcAccessMask = predicateAccess;
+        writeBarrier.dstAccessMask = AccessFlag::TRANSFER_WRITE;
+
+        commandBuffer->pipelineBarrier(
+            predicateStage, PipelineStageFlag::TRANSFER, DependencyFlag::NONE,
+            1, &writeBarrier, 0, nullptr, 0, nullptr);
+
+        if (!_initialized) {
+            commandBuffer->fillBuffer(_predicates.get(), 0, _info.objectCount * PREDICATE_SIZE, 1);
+            _initialized = true;
+        } else {
+            // copy each run of tested objects; untested queries were never written and must not be waited on
+            std::uint32_t object = 0;
+
+            while (object < _info.objectCount) {
+                if (!_tested[object]) {
+                    object++;
+                    continue;
+                }
+
+                const auto first = object;
+
+                while (object < _info.objectCount && _tested[object]) {
+                    object++;
+                }
+
+                commandBuffer->copyQueryPoolResults(
+                    _queryPool.get(), first, object - first,
+                    _predicates.get(), first * PREDICATE_SIZE, PREDICATE_SIZE,
+                    QueryResultFlag::WAIT);
+            }
+
+            // the copies must complete before the queries are reset
+            auto copyBarrier = MemoryBarrier {};
+            copyBarrier.srcAccessMask = AccessFlag::TRANSFER_WRITE;
+            copyBarrier.dstAccessMask = AccessFlag::TRANSFER_WRITE;
+
+            commandBuffer->pipelineBarrier(
+                PipelineStageFlag::TRANSFER, PipelineStageFlag::TRANSFER, DependencyFlag::NONE,
+                1, &copyBarrier, 0, nullptr, 0, nullptr);
+        }
+
+        commandBuffer->resetQueryPool(_queryPool.get(), 0, _info.objectCount);
+
+        auto readBarrier = MemoryBarrier {};
+        readBarrier.srcAccessMask = AccessFlag::TRANSFER_WRITE;
+        readBarrier.dstAccessMask = predicateAccess;
+
+        commandBuffer->pipelineBarrier(
+            PipelineStageFlag::TRANSFER, predicateStage, DependencyFlag::NONE,
+            1, &readBarrier, 0, nullptr, 0, nullptr);
+
+        std::fill(_tested.begin(), _tested.end(), false);
+    }
+
+    void OcclusionCuller::beginQuery(CommandBuffer * commandBuffer, std::uint32_t object) {
+        if (_tested[object]) {
+            throw std::runtime_error("Object was already tested this frame!");
+        }
+
+        _tested[object] = true;
+
+        commandBuffer->beginQuery(_queryPool.get(), object, _info.precise);
+    }
+
+    void OcclusionCuller::endQuery(CommandBuffer * commandBuffer, std::uint32_t object) noexcept {
+        commandBuffer->endQuery(_queryPool.get(), object);
+    }
+
+    void OcclusionCuller::beginConditional(CommandBuffer * commandBuffer, std::uint32_t object) noexcept {
+        if (_conditionalRendering) {
+            commandBuffer->beginConditionalRendering(_predicates.get(), object * PREDICATE_SIZE);
+        }
+    }
+
+    void OcclusionCuller::endConditional(CommandBuffer * commandBuffer) noexcept {
+        if (_conditionalRendering) {
+            commandBuffer->endConditionalRendering();
+        }
+    }
+}
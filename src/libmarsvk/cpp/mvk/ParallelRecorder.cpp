@@ -0,0 +1,157 @@
+#include "mvk/ParallelRecorder.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+#include "mvk/CommandPool.hpp"
+#include "mvk/Framebuffer.hpp"
+#include "mvk/QueueFamily.hpp"
+
+namespace mvk {
+    ParallelRecorder::ParallelRecorder(const ParallelRecorder::CreateInfo& createInfo) {
+        _info = createInfo;
+        _generation = 0;
+        _pending = 0;
+        _shutdown = false;
+        _frameIndex = 0;
+        _framebuffer = nullptr;
+        _subpass = 0;
+        _recordFunction = nullptr;
+
+        if (0 == _info.threadCount) {
+            _info.threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        if (0 == _info.frameCount) {
+            _info.frameCount = 1;
+        }
+
+        _workers.reserve(_info.threadCount);
+
+        for (std::size_t i = 0; i < _info.threadCount; i++) {
+            auto worker = std::make_unique<Worker> ();
+            worker->commandBuffers.resize(_info.frameCount);
+
+            _workers.push_back(std::move(worker));
+        }
+
+        for (auto& worker : _workers) {
+            worker->thread = std::thread(&ParallelRecorder::work, this, worker.get());
+        }
+    }
+
+    ParallelRecorder::~ParallelRecorder() noexcept {
+        // the secondary CommandBuffers may still be pending
+        try {
+            _info.queueFamily->waitIdle();
+        } catch (const std::exception& ex) {
+            std::cerr << ex.what() << std::endl;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _shutdown = true;
+        }
+
+        _workAvailable.notify_all();
+
+        for (auto& worker : _workers) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+        }
+    }
+
+    void ParallelRecorder::work(Worker * worker) {
+        std::uint64_t generation = 0;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(_lock);
+
+                _workAvailable.wait(lock, [&] { return _shutdown || generation != _generation; });
+
+                if (_shutdown) {
+                    // the CommandPool of this thread is externally synchronized, so its CommandBuffers are freed here
+                    worker->commandBuffers.clear();
+                    return;
+                }
+
+                generation = _generation;
+            }
+
+            if (worker->first < worker->last) {
+                try {
+                    auto& commandBuffer = worker->commandBuffers[_frameIndex];
+
+                    if (nullptr == commandBuffer) {
+                        commandBuffer = _info.queueFamily->getCurrentCommandPool()->allocate(CommandBufferLevel::SECONDARY);
+                    } else {
+                        commandBuffer->reset();
+                    }
+
+                    commandBuffer->begin(CommandBufferUsageFlag::ONE_TIME_SUBMIT, _framebuffer, _subpass);
+                    (*_recordFunction) (commandBuffer.get(), worker->first, worker->last);
+                    commandBuffer->end();
+                } catch (...) {
+                    worker->error = std::current_exception();
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+
+                if (0 == --_pending) {
+                    _workDone.notify_one();
+                }
+            }
+        }
+    }
+
+    void ParallelRecorder::record(CommandBuffer * primary, const Framebuffer * framebuffer, int subpass, std::size_t drawCount, const RecordFunction& recordFunction) {
+        const auto nWorkers = _workers.size();
+        const auto drawsPerWorker = (drawCount + nWorkers - 1) / nWorkers;
+
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+
+            _framebuffer = framebuffer;
+            _subpass = subpass;
+            _recordFunction = &recordFunction;
+
+            for (std::size_t i = 0; i < nWorkers; i++) {
+                auto& worker = _workers[i];
+
+                worker->first = std::min(drawCount, i * drawsPerWorker);
+                worker->last = std::min(drawCount, worker->first + drawsPerWorker);
+                worker->error = nullptr;
+            }
+
+            _pending = nWorkers;
+            _generation++;
+            _workAvailable.notify_all();
+
+            _workDone.wait(lock, [&] { return 0 == _pending; });
+        }
+
+        auto secondaries = std::vector<const CommandBuffer *> ();
+        secondaries.reserve(nWorkers);
+
+        for (auto& worker : _workers) {
+            if (worker->error) {
+                std::rethrow_exception(worker->error);
+            }
+
+            if (worker->first < worker->last) {
+                secondaries.push_back(worker->commandBuffers[_frameIndex].get());
+            }
+        }
+
+        if (!secondaries.empty()) {
+            primary->executeCommands(secondaries);
+        }
+
+        _frameIndex = (_frameIndex + 1) % _info.frameCount;
+    }
+}
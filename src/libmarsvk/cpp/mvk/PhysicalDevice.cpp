@@ -44,6 +44,20 @@ namespace mvk {
         return static_cast<PhysicalDeviceType> (_properties.deviceType);
     }
 
+    bool PhysicalDevice::isExtensionSupported(const std::string& extName) const {
+        std::uint32_t extensionCount = 0;
+
+        Util::vkAssert(vkEnumerateDeviceExtensionProperties(_handle, nullptr, &extensionCount, nullptr));
+
+        auto extensions = std::vector<VkExtensionProperties> (extensionCount);
+
+        Util::vkAssert(vkEnumerateDeviceExtensionProperties(_handle, nullptr, &extensionCount, extensions.data()));
+
+        return std::any_of(extensions.begin(), extensions.end(), [&extName](const VkExtensionProperties& extension) {
+            return extName == extension.extensionName;
+        });
+    }
+
     std::string PhysicalDevice::toString() const noexcept {
         auto out = std::stringstream();
         auto version = _properties.apiVersion;
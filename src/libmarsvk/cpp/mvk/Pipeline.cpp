@@ -0,0 +1,101 @@
+#include "mvk/Pipeline.hpp"
+
+#include "volk.h"
+
+#include "mvk/Device.hpp"
+#include "mvk/Util.hpp"
+
+namespace mvk {
+    std::vector<Pipeline::ExecutableStatistics> Pipeline::getExecutableStatistics(const Device * device, VkPipeline handle) {
+        auto out = std::vector<ExecutableStatistics> ();
+
+#if defined(VK_KHR_pipeline_executable_properties)
+        if (!device->isPipelineExecutableInfoEnabled() || VK_NULL_HANDLE == handle) {
+            return out;
+        }
+
+        auto pfnGetPipelineExecutableProperties = reinterpret_cast<PFN_vkGetPipelineExecutablePropertiesKHR> (vkGetDeviceProcAddr(device->getHandle(), "vkGetPipelineExecutablePropertiesKHR"));
+        auto pfnGetPipelineExecutableStatistics = reinterpret_cast<PFN_vkGetPipelineExecutableStatisticsKHR> (vkGetDeviceProcAddr(device->getHandle(), "vkGetPipelineExecutableStatisticsKHR"));
+
+        if (nullptr == pfnGetPipelineExecutableProperties || nullptr == pfnGetPipelineExecutableStatistics) {
+            return out;
+        }
+
+        auto pipelineI = VkPipelineInfoKHR {};
+        pipelineI.sType = VK_STRUCTURE_TYPE_PIPELINE_INFO_KHR;
+        pipelineI.pipeline = handle;
+
+        std::uint32_t executableCount = 0;
+
+        Util::vkAssert(pfnGetPipelineExecutableProperties(device->getHandle(), &pipelineI, &executableCount, nullptr));
+
+        auto properties = std::vector<VkPipelineExecutablePropertiesKHR> (executableCount);
+
+        for (auto& property : properties) {
+            property.sType = VK_STRUCTURE_TYPE_PIPELINE_EXECUTABLE_PROPERTIES_KHR;
+        }
+
+        Util::vkAssert(pfnGetPipelineExecutableProperties(device->getHandle(), &pipelineI, &executableCount, properties.data()));
+
+        out.reserve(executableCount);
+
+        for (std::uint32_t i = 0; i < executableCount; i++) {
+            auto executableI = VkPipelineExecutableInfoKHR {};
+            executableI.sType = VK_STRUCTURE_TYPE_PIPELINE_EXECUTABLE_INFO_KHR;
+            executableI.pipeline = handle;
+            executableI.executableIndex = i;
+
+            std::uint32_t statisticCount = 0;
+
+            Util::vkAssert(pfnGetPipelineExecutableStatistics(device->getHandle(), &executableI, &statisticCount, nullptr));
+
+            auto statistics = std::vector<VkPipelineExecutableStatisticKHR> (statisticCount);
+
+            for (auto& statistic : statistics) {
+                statistic.sType = VK_STRUCTURE_TYPE_PIPELINE_EXECUTABLE_STATISTIC_KHR;
+            }
+
+            Util::vkAssert(pfnGetPipelineExecutableStatistics(device->getHandle(), &executableI, &statisticCount, statistics.data()));
+
+            auto executable = ExecutableStatistics {};
+            executable.name = properties[i].name;
+            executable.description = properties[i].description;
+            executable.stages = static_cast<ShaderStage> (properties[i].stages);
+            executable.subgroupSize = properties[i].subgroupSize;
+            executable.statistics.reserve(statisticCount);
+
+            for (std::uint32_t j = 0; j < statisticCount; j++) {
+                const auto& statistic = statistics[j];
+                auto stat = ExecutableStatistic {};
+                stat.name = statistic.name;
+                stat.description = statistic.description;
+
+                switch (statistic.format) {
+                    case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_BOOL32_KHR:
+                        stat.format = ExecutableStatistic::Format::BOOL32;
+                        stat.value.b32 = VK_FALSE != statistic.value.b32;
+                        break;
+                    case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_INT64_KHR:
+                        stat.format = ExecutableStatistic::Format::INT64;
+                        stat.value.i64 = statistic.value.i64;
+                        break;
+                    case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_FLOAT64_KHR:
+                        stat.format = ExecutableStatistic::Format::FLOAT64;
+                        stat.value.f64 = statistic.value.f64;
+                        break;
+                    default:
+                        stat.format = ExecutableStatistic::Format::UINT64;
+                        stat.value.u64 = statistic.value.u64;
+                        break;
+                }
+
+                executable.statistics.push_back(std::move(stat));
+            }
+
+            out.push_back(std::move(executable));
+        }
+#endif
+
+        return out;
+    }
+}
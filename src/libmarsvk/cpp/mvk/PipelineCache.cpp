@@ -2,21 +2,91 @@
 
 #include "volk.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
 #include "mvk/Device.hpp"
+#include "mvk/PhysicalDevice.hpp"
+#include "mvk/Pipeline.hpp"
+#include "mvk/PipelineManifest.hpp"
+#include "mvk/RenderPass.hpp"
+#include "mvk/Util.hpp"
 
 namespace mvk {
-    PipelineCache::PipelineCache(Device * device) {
+    namespace {
+        // reads saved VkPipelineCache data, returning nothing if the file is missing or was written by another
+        // driver or device. Drivers are required to reject such data too, but not all of them do so safely.
+        std::vector<std::uint8_t> readCacheData(const std::string& path, const VkPhysicalDeviceProperties& properties) {
+            std::ifstream file(path, std::ios::binary);
+
+            if (!file) {
+                return {};
+            }
+
+            auto data = std::vector<std::uint8_t> ((std::istreambuf_iterator<char> (file)), std::istreambuf_iterator<char> ());
+
+            // VkPipelineCacheHeaderVersionOne: headerSize, headerVersion, vendorID, deviceID, pipelineCacheUUID
+            constexpr std::size_t HEADER_SIZE = 4 * sizeof(std::uint32_t) + VK_UUID_SIZE;
+
+            if (data.size() < HEADER_SIZE) {
+                return {};
+            }
+
+            std::uint32_t header[4];
+
+            std::memcpy(header, data.data(), sizeof(header));
+
+            if (header[0] < HEADER_SIZE
+                    || VK_PIPELINE_CACHE_HEADER_VERSION_ONE != header[1]
+                    || properties.vendorID != header[2]
+                    || properties.deviceID != header[3]
+                    || 0 != std::memcmp(data.data() + sizeof(header), properties.pipelineCacheUUID, VK_UUID_SIZE)) {
+
+                return {};
+            }
+
+            return data;
+        }
+    }
+
+    PipelineCache::PipelineCache(Device * device, const std::string& path) {
         _device = device;
+        _path = path;
+        _sharedHits = 0;
+        _sharedMisses = 0;
+        _manifest = nullptr;
 
-        //TODO: restore old PipelineCache (if possible)
+        auto initialData = std::vector<std::uint8_t> ();
+
+        if (!path.empty()) {
+            initialData = readCacheData(path, device->getPhysicalDevice()->getProperties());
+        }
 
         auto pipelineCacheCI = VkPipelineCacheCreateInfo {};
         pipelineCacheCI.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        pipelineCacheCI.initialDataSize = initialData.size();
+        pipelineCacheCI.pInitialData = initialData.data();
         
         _handle = VK_NULL_HANDLE;
 
         auto result = vkCreatePipelineCache(device->getHandle(), &pipelineCacheCI, nullptr, &_handle);
 
+        if (VK_SUCCESS != result && !initialData.empty()) {
+            // the saved data is only an optimization; start empty if the driver rejects it
+            pipelineCacheCI.initialDataSize = 0;
+            pipelineCacheCI.pInitialData = nullptr;
+
+            result = vkCreatePipelineCache(device->getHandle(), &pipelineCacheCI, nullptr, &_handle);
+        }
+
         if (VK_SUCCESS != result) {
             if (VK_NULL_HANDLE != _handle) {
                 vkDestroyPipelineCache(device->getHandle(), _handle, nullptr);
@@ -26,11 +96,29 @@ namespace mvk {
     }
 
     PipelineCache::~PipelineCache() noexcept {
+        // shared pipelines that are still held elsewhere outlive this PipelineCache, so they are detached from it
+        for (auto& sharedPipeline : _sharedComputePipelines) {
+            sharedPipeline.second->_cache = nullptr;
+        }
+
+        for (auto& sharedPipeline : _sharedGraphicsPipelines) {
+            sharedPipeline.second->_cache = nullptr;
+        }
+
+        _sharedComputePipelines.clear();
+        _sharedGraphicsPipelines.clear();
+
         if (VK_NULL_HANDLE == _handle) {
             return;
         }
 
-        //TODO: serialize PipelineCache to file
+        if (!_path.empty()) {
+            try {
+                save(_path);
+            } catch (const std::exception& ex) {
+                std::cerr << ex.what() << std::endl;
+            }
+        }
 
         vkDestroyPipelineCache(_device->getHandle(), _handle, nullptr);
     }
@@ -38,7 +126,515 @@ namespace mvk {
     PipelineCache& PipelineCache::operator= (PipelineCache&& from) noexcept {
         std::swap(this->_device, from._device);
         std::swap(this->_handle, from._handle);
+        std::swap(this->_path, from._path);
+        std::swap(this->_pipelines, from._pipelines);
+        std::swap(this->_sharedComputePipelines, from._sharedComputePipelines);
+        std::swap(this->_sharedGraphicsPipelines, from._sharedGraphicsPipelines);
+        std::swap(this->_pendingComputePipelines, from._pendingComputePipelines);
+        std::swap(this->_pendingGraphicsPipelines, from._pendingGraphicsPipelines);
+        std::swap(this->_sharedHits, from._sharedHits);
+        std::swap(this->_sharedMisses, from._sharedMisses);
+        std::swap(this->_manifest, from._manifest);
 
         return *this;
     }
+
+    namespace {
+        // creates the shared pipeline of a key the caller marked as pending. The pipeline is created without
+        // holding the lock so that unrelated lookups are not blocked by compilation; threads waiting for the
+        // key are woken whether or not it succeeds.
+        template<class PipelineT, class CreateFunction>
+        std::shared_ptr<PipelineT> createShared(
+                std::unordered_map<PipelineKey, std::shared_ptr<PipelineT>>& pipelines,
+                std::unordered_set<PipelineKey>& pending,
+                std::mutex& lock,
+                std::condition_variable& ready,
+                const PipelineKey& key,
+                CreateFunction createFunction) {
+
+            auto pipeline = std::shared_ptr<PipelineT> ();
+
+            try {
+                pipeline = std::shared_ptr<PipelineT> (createFunction());
+            } catch (...) {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+
+                    pending.erase(key);
+                }
+
+                ready.notify_all();
+                throw;
+            }
+
+            {
+                std::lock_guard<std::mutex> guard(lock);
+
+                pending.erase(key);
+                pipelines.emplace(key, pipeline);
+            }
+
+            ready.notify_all();
+
+            return pipeline;
+        }
+
+        // looks up a shared pipeline. A pipeline that is being created on another thread is waited for, so
+        // requests racing a prewarm or each other compile every pipeline only once.
+        template<class PipelineT, class CreateFunction>
+        std::shared_ptr<PipelineT> getShared(
+                std::unordered_map<PipelineKey, std::shared_ptr<PipelineT>>& pipelines,
+                std::unordered_set<PipelineKey>& pending,
+                std::mutex& lock,
+                std::condition_variable& ready,
+                std::uint64_t& hits,
+                std::uint64_t& misses,
+                Device * device,
+                const PipelineKey& key,
+                CreateFunction createFunction) {
+
+            {
+                std::unique_lock<std::mutex> guard(lock);
+
+                ready.wait(guard, [&] { return 0 == pending.count(key); });
+
+                auto it = pipelines.find(key);
+
+                if (pipelines.end() != it) {
+                    hits++;
+                    MVK_METRICS_INCREMENT(device, SHARED_PIPELINE_HITS);
+
+                    return it->second;
+                }
+
+                misses++;
+                MVK_METRICS_INCREMENT(device, SHARED_PIPELINE_MISSES);
+
+                pending.insert(key);
+            }
+
+            return createShared(pipelines, pending, lock, ready, key, createFunction);
+        }
+
+        // creates a shared pipeline if none is held or being created for the key; unlike getShared this is not
+        // a request, so neither hits nor misses are counted
+        template<class PipelineT, class CreateFunction>
+        bool prewarmShared(
+                std::unordered_map<PipelineKey, std::shared_ptr<PipelineT>>& pipelines,
+                std::unordered_set<PipelineKey>& pending,
+                std::mutex& lock,
+                std::condition_variable& ready,
+                const PipelineKey& key,
+                CreateFunction createFunction) {
+
+            {
+                std::lock_guard<std::mutex> guard(lock);
+
+                if (pipelines.count(key) > 0 || !pending.insert(key).second) {
+                    return false;
+                }
+            }
+
+            createShared(pipelines, pending, lock, ready, key, createFunction);
+
+            return true;
+        }
+
+        // moves the pipelines that are only held by the map into released
+        template<class PipelineT>
+        void trimShared(std::unordered_map<PipelineKey, std::shared_ptr<PipelineT>>& pipelines, std::vector<std::shared_ptr<PipelineT>>& released) {
+            for (auto it = pipelines.begin(); it != pipelines.end();) {
+                if (1 == it->second.use_count()) {
+                    released.push_back(std::move(it->second));
+                    it = pipelines.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+
+    SPtrComputePipeline PipelineCache::getPipeline(const ComputePipeline::CreateInfo& createInfo) {
+        return getShared(_sharedComputePipelines, _pendingComputePipelines, _sharedLock, _sharedReady, _sharedHits, _sharedMisses, _device, PipelineKey(createInfo), [&] {
+            auto out = createPipeline(createInfo);
+
+            record(createInfo);
+
+            return out;
+        });
+    }
+
+    SPtrGraphicsPipeline PipelineCache::getPipeline(const GraphicsPipeline::CreateInfo& createInfo, const RenderPass * renderPass) {
+        return getShared(_sharedGraphicsPipelines, _pendingGraphicsPipelines, _sharedLock, _sharedReady, _sharedHits, _sharedMisses, _device, PipelineKey(createInfo, renderPass->getInfo()), [&] {
+            auto out = createPipeline(createInfo, renderPass);
+
+            record(createInfo, renderPass);
+
+            return out;
+        });
+    }
+
+    bool PipelineCache::prewarm(const ComputePipeline::CreateInfo& createInfo) {
+        return prewarmShared(_sharedComputePipelines, _pendingComputePipelines, _sharedLock, _sharedReady, PipelineKey(createInfo), [&] {
+            return createPipeline(createInfo);
+        });
+    }
+
+    bool PipelineCache::prewarm(const GraphicsPipeline::CreateInfo& createInfo, const RenderPass::CreateInfo& renderPassInfo) {
+        return prewarmShared(_sharedGraphicsPipelines, _pendingGraphicsPipelines, _sharedLock, _sharedReady, PipelineKey(createInfo, renderPassInfo), [&] {
+            // the RenderPass is only needed to compile; the pipeline is compatible with any matching RenderPass
+            auto pRenderPass = _device->createRenderPass(renderPassInfo);
+
+            return createPipeline(createInfo, pRenderPass.get());
+        });
+    }
+
+    void PipelineCache::record(const ComputePipeline::CreateInfo& createInfo) {
+        if (nullptr != _manifest) {
+            _manifest->record(createInfo);
+        }
+    }
+
+    void PipelineCache::record(const GraphicsPipeline::CreateInfo& createInfo, const RenderPass * renderPass) {
+        if (nullptr != _manifest) {
+            _manifest->record(createInfo, renderPass->getInfo());
+        }
+    }
+
+    std::size_t PipelineCache::trim() {
+        // the pipelines are destroyed outside of the lock; their destructors release PipelineLayouts
+        auto computePipelines = std::vector<SPtrComputePipeline> ();
+        auto graphicsPipelines = std::vector<SPtrGraphicsPipeline> ();
+
+        {
+            std::lock_guard<std::mutex> lock(_sharedLock);
+
+            trimShared(_sharedComputePipelines, computePipelines);
+            trimShared(_sharedGraphicsPipelines, graphicsPipelines);
+        }
+
+        return computePipelines.size() + graphicsPipelines.size();
+    }
+
+    PipelineCache::SharedPipelineStatistics PipelineCache::getSharedPipelineStatistics() const {
+        std::lock_guard<std::mutex> lock(_sharedLock);
+
+        auto statistics = SharedPipelineStatistics {};
+        statistics.hits = _sharedHits;
+        statistics.misses = _sharedMisses;
+        statistics.pipelineCount = _sharedComputePipelines.size() + _sharedGraphicsPipelines.size();
+
+        return statistics;
+    }
+
+    void PipelineCache::compile(std::size_t pipelineCount, const BatchInfo& batchInfo, const CompileFunction& compileFunction) {
+        if (0 == pipelineCount) {
+            return;
+        }
+
+        auto threadCount = (0 == batchInfo.threadCount) ? std::max(1u, std::thread::hardware_concurrency()) : batchInfo.threadCount;
+        const auto callSize = (0 == batchInfo.pipelinesPerCall) ? std::max<std::size_t> (1, pipelineCount / (4 * threadCount)) : batchInfo.pipelinesPerCall;
+        const auto callCount = (pipelineCount + callSize - 1) / callSize;
+
+        threadCount = std::min(threadCount, callCount);
+
+        // vkCreate*Pipelines synchronizes access to the VkPipelineCache internally; some drivers do so with a
+        // single lock, so mergeCaches gives every thread its own cache instead.
+        auto caches = std::vector<VkPipelineCache> (threadCount, _handle);
+
+        if (batchInfo.mergeCaches) {
+            auto pipelineCacheCI = VkPipelineCacheCreateInfo {};
+            pipelineCacheCI.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+
+            for (std::size_t i = 0; i < threadCount; i++) {
+                auto result = vkCreatePipelineCache(_device->getHandle(), &pipelineCacheCI, nullptr, &caches[i]);
+
+                if (VK_SUCCESS != result) {
+                    for (std::size_t j = 0; j < i; j++) {
+                        vkDestroyPipelineCache(_device->getHandle(), caches[j], nullptr);
+                    }
+
+                    Util::vkAssert(result);
+                }
+            }
+        }
+
+        std::atomic<std::size_t> nextCall(0);
+        auto errors = std::vector<std::exception_ptr> (threadCount);
+
+        auto work = [&](std::size_t threadIndex) {
+            try {
+                for (auto call = nextCall++; call < callCount; call = nextCall++) {
+                    const auto first = call * callSize;
+
+                    Util::vkAssert(compileFunction(caches[threadIndex], first, std::min(callSize, pipelineCount - first)));
+                }
+            } catch (...) {
+                errors[threadIndex] = std::current_exception();
+                nextCall = callCount;
+            }
+        };
+
+        auto threads = std::vector<std::thread> ();
+        threads.reserve(threadCount - 1);
+
+        for (std::size_t i = 1; i < threadCount; i++) {
+            threads.emplace_back(work, i);
+        }
+
+        work(0);
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        const bool failed = std::any_of(errors.begin(), errors.end(), [](const std::exception_ptr& error) { return static_cast<bool> (error); });
+
+        if (batchInfo.mergeCaches) {
+            auto result = VK_SUCCESS;
+
+            if (!failed) {
+                result = vkMergePipelineCaches(_device->getHandle(), _handle, static_cast<std::uint32_t> (caches.size()), caches.data());
+            }
+
+            for (auto cache : caches) {
+                vkDestroyPipelineCache(_device->getHandle(), cache, nullptr);
+            }
+
+            Util::vkAssert(result);
+        }
+
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    std::vector<UPtrComputePipeline> PipelineCache::createPipelines(const std::vector<ComputePipeline::CreateInfo>& createInfos, const BatchInfo& batchInfo) {
+        auto layouts = std::vector<PipelineLayout * > ();
+        auto nativeCIs = std::vector<std::unique_ptr<ComputePipeline::NativeCreateInfo>> ();
+        auto computePipelineCIs = std::vector<VkComputePipelineCreateInfo> ();
+        auto handles = std::vector<VkPipeline> (createInfos.size(), VK_NULL_HANDLE);
+
+        layouts.reserve(createInfos.size());
+        nativeCIs.reserve(createInfos.size());
+        computePipelineCIs.reserve(createInfos.size());
+
+        try {
+            // layouts and shader modules are resolved once up front so the compiler threads never contend on the cache locks
+            for (const auto& createInfo : createInfos) {
+                layouts.push_back(_device->allocatePipelineLayout(createInfo.layoutInfo));
+                nativeCIs.push_back(std::make_unique<ComputePipeline::NativeCreateInfo> (_device, createInfo, layouts.back()));
+                computePipelineCIs.push_back(nativeCIs.back()->info);
+            }
+
+            compile(createInfos.size(), batchInfo, [&](VkPipelineCache cache, std::size_t first, std::size_t count) {
+                MVK_METRICS_SCOPED_TIMER(_device, CREATE_PIPELINE);
+                MVK_METRICS_ADD(_device, PIPELINES_CREATED, count);
+
+                Tracer::Span traceSpan(_device->getTracer(), "vkCreateComputePipelines", "pipeline");
+
+                return vkCreateComputePipelines(_device->getHandle(), cache, static_cast<std::uint32_t> (count), computePipelineCIs.data() + first, nullptr, handles.data() + first);
+            });
+        } catch (...) {
+            for (auto handle : handles) {
+                if (VK_NULL_HANDLE != handle) {
+                    vkDestroyPipeline(_device->getHandle(), handle, nullptr);
+                }
+            }
+
+            for (auto layout : layouts) {
+                layout->release();
+            }
+
+            throw;
+        }
+
+        auto out = std::vector<UPtrComputePipeline> ();
+        out.reserve(createInfos.size());
+
+        for (std::size_t i = 0; i < createInfos.size(); i++) {
+            out.push_back(UPtrComputePipeline(new ComputePipeline(this, createInfos[i], layouts[i], handles[i])));
+        }
+
+        return out;
+    }
+
+    std::vector<UPtrGraphicsPipeline> PipelineCache::createPipelines(const std::vector<GraphicsPipeline::CreateInfo>& createInfos, const std::vector<const RenderPass * >& renderPasses, const BatchInfo& batchInfo) {
+        if (renderPasses.size() != createInfos.size()) {
+            throw std::runtime_error("Every GraphicsPipeline requires a RenderPass!");
+        }
+
+        auto layouts = std::vector<PipelineLayout * > ();
+        auto nativeCIs = std::vector<std::unique_ptr<GraphicsPipeline::NativeCreateInfo>> ();
+        auto graphicsPipelineCIs = std::vector<VkGraphicsPipelineCreateInfo> ();
+        auto handles = std::vector<VkPipeline> (createInfos.size(), VK_NULL_HANDLE);
+
+        layouts.reserve(createInfos.size());
+        nativeCIs.reserve(createInfos.size());
+        graphicsPipelineCIs.reserve(createInfos.size());
+
+        try {
+            // layouts and shader modules are resolved once up front so the compiler threads never contend on the cache locks
+            for (std::size_t i = 0; i < createInfos.size(); i++) {
+                layouts.push_back(_device->allocatePipelineLayout(createInfos[i].layoutInfo));
+                nativeCIs.push_back(std::make_unique<GraphicsPipeline::NativeCreateInfo> (_device, createInfos[i], layouts.back(), renderPasses[i]));
+                graphicsPipelineCIs.push_back(nativeCIs.back()->info);
+            }
+
+            compile(createInfos.size(), batchInfo, [&](VkPipelineCache cache, std::size_t first, std::size_t count) {
+                MVK_METRICS_SCOPED_TIMER(_device, CREATE_PIPELINE);
+                MVK_METRICS_ADD(_device, PIPELINES_CREATED, count);
+
+                Tracer::Span traceSpan(_device->getTracer(), "vkCreateGraphicsPipelines", "pipeline");
+
+                return vkCreateGraphicsPipelines(_device->getHandle(), cache, static_cast<std::uint32_t> (count), graphicsPipelineCIs.data() + first, nullptr, handles.data() + first);
+            });
+        } catch (...) {
+            for (auto handle : handles) {
+                if (VK_NULL_HANDLE != handle) {
+                    vkDestroyPipeline(_device->getHandle(), handle, nullptr);
+                }
+            }
+
+            for (auto layout : layouts) {
+                layout->release();
+            }
+
+            throw;
+        }
+
+        auto out = std::vector<UPtrGraphicsPipeline> ();
+        out.reserve(createInfos.size());
+
+        for (std::size_t i = 0; i < createInfos.size(); i++) {
+            out.push_back(UPtrGraphicsPipeline(new GraphicsPipeline(this, createInfos[i], layouts[i], handles[i])));
+        }
+
+        return out;
+    }
+
+    std::vector<std::uint8_t> PipelineCache::getData() const {
+        std::size_t dataSize = 0;
+
+        Util::vkAssert(vkGetPipelineCacheData(_device->getHandle(), _handle, &dataSize, nullptr));
+
+        auto data = std::vector<std::uint8_t> (dataSize);
+
+        // VK_INCOMPLETE only if pipelines were added since the size query; the data written so far is still valid
+        const auto result = vkGetPipelineCacheData(_device->getHandle(), _handle, &dataSize, data.data());
+
+        if (VK_INCOMPLETE != result) {
+            Util::vkAssert(result);
+        }
+
+        data.resize(dataSize);
+
+        return data;
+    }
+
+    void PipelineCache::save(const std::string& path) const {
+        const auto data = getData();
+
+        std::ofstream file(path, std::ios::binary);
+
+        if (!file) {
+            throw std::runtime_error("Unable to open pipeline cache file: " + path);
+        }
+
+        file.write(reinterpret_cast<const char * > (data.data()), data.size());
+
+        if (!file) {
+            throw std::runtime_error("Unable to write pipeline cache file: " + path);
+        }
+    }
+
+    void PipelineCache::recordExecutableStatistics(VkPipeline handle, PipelineBindPoint bindPoint, const std::string& name) {
+        if (!_device->isPipelineExecutableInfoEnabled()) {
+            return;
+        }
+
+        auto record = PipelineRecord {};
+        record.bindPoint = bindPoint;
+        record.name = name;
+        record.executables = Pipeline::getExecutableStatistics(_device, handle);
+
+        std::lock_guard<std::mutex> lock(_lock);
+
+        _pipelines.push_back(std::move(record));
+    }
+
+    std::string PipelineCache::executableStatisticsToJSON() const {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        auto out = std::stringstream ();
+
+        out << "{\"pipelines\":[";
+
+        bool firstPipeline = true;
+
+        for (const auto& pipeline : _pipelines) {
+            out << (firstPipeline ? "" : ",")
+                << "{\"name\":" << Util::escapeJSON(pipeline.name)
+                << ",\"bindPoint\":\"" << (PipelineBindPoint::COMPUTE == pipeline.bindPoint ? "compute" : "graphics") << "\""
+                << ",\"executables\":[";
+
+            bool firstExecutable = true;
+
+            for (const auto& executable : pipeline.executables) {
+                out << (firstExecutable ? "" : ",")
+                    << "{\"name\":" << Util::escapeJSON(executable.name)
+                    << ",\"description\":" << Util::escapeJSON(executable.description)
+                    << ",\"stages\":" << static_cast<unsigned int> (executable.stages)
+                    << ",\"subgroupSize\":" << executable.subgroupSize
+                    << ",\"statistics\":{";
+
+                bool firstStatistic = true;
+
+                for (const auto& statistic : executable.statistics) {
+                    out << (firstStatistic ? "" : ",") << Util::escapeJSON(statistic.name) << ":";
+
+                    switch (statistic.format) {
+                        case Pipeline::ExecutableStatistic::Format::BOOL32:
+                            out << (statistic.value.b32 ? "true" : "false");
+                            break;
+                        case Pipeline::ExecutableStatistic::Format::INT64:
+                            out << statistic.value.i64;
+                            break;
+                        case Pipeline::ExecutableStatistic::Format::UINT64:
+                            out << statistic.value.u64;
+                            break;
+                        case Pipeline::ExecutableStatistic::Format::FLOAT64:
+                            out << statistic.value.f64;
+                            break;
+                    }
+
+                    firstStatistic = false;
+                }
+
+                out << "}}";
+
+                firstExecutable = false;
+            }
+
+            out << "]}";
+
+            firstPipeline = false;
+        }
+
+        out << "]}";
+
+        return out.str();
+    }
+
+    void PipelineCache::saveExecutableStatistics(const std::string& path) const {
+        std::ofstream file(path);
+
+        if (!file) {
+            throw std::runtime_error("Unable to open pipeline statistics file: " + path);
+        }
+
+        file << executableStatisticsToJSON() << std::endl;
+    }
 }
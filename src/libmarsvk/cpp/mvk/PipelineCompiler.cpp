@@ -0,0 +1,96 @@
+#include "mvk/PipelineCompiler.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace mvk {
+    PipelineCompiler::PipelineCompiler(std::size_t threadCount) noexcept {
+        _threadCount = (0 == threadCount) ? std::max(1u, std::thread::hardware_concurrency() / 2) : threadCount;
+        _shutdown = false;
+    }
+
+    PipelineCompiler::~PipelineCompiler() noexcept {
+        auto cancelled = std::deque<Task> ();
+        auto cancelledLowPriority = std::deque<Task> ();
+
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+
+            _shutdown = true;
+            std::swap(cancelled, _tasks);
+            std::swap(cancelledLowPriority, _lowPriorityTasks);
+        }
+
+        std::move(cancelledLowPriority.begin(), cancelledLowPriority.end(), std::back_inserter(cancelled));
+
+        _workAvailable.notify_all();
+
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+
+        for (auto& task : cancelled) {
+            try {
+                task(true);
+            } catch (...) {
+                // nothing can be reported from a destructor
+            }
+        }
+    }
+
+    void PipelineCompiler::submit(Task task, PipelineCompiler::Priority priority) {
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+
+            if (_threads.empty()) {
+                _threads.reserve(_threadCount);
+
+                for (std::size_t i = 0; i < _threadCount; i++) {
+                    _threads.emplace_back(&PipelineCompiler::work, this);
+                }
+            }
+
+            if (Priority::LOW == priority) {
+                _lowPriorityTasks.push_back(std::move(task));
+            } else {
+                _tasks.push_back(std::move(task));
+            }
+        }
+
+        _workAvailable.notify_one();
+    }
+
+    std::size_t PipelineCompiler::getQueuedCount() const noexcept {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        return _tasks.size() + _lowPriorityTasks.size();
+    }
+
+    void PipelineCompiler::work() {
+        while (true) {
+            auto task = Task ();
+
+            {
+                std::unique_lock<std::mutex> lock(_lock);
+
+                _workAvailable.wait(lock, [this] { return _shutdown || !_tasks.empty() || !_lowPriorityTasks.empty(); });
+
+                if (_shutdown) {
+                    return;
+                }
+
+                auto& tasks = _tasks.empty() ? _lowPriorityTasks : _tasks;
+
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+
+            try {
+                task(false);
+            } catch (...) {
+                // tasks report their own errors; a throwing task must not take the thread down
+            }
+        }
+    }
+}
@@ -0,0 +1,287 @@
+#include "mvk/PipelineKey.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "mvk/ShaderModule.hpp"
+#include "mvk/Util.hpp"
+
+namespace mvk {
+    namespace {
+        // appends fixed size fields; variable length fields are prefixed with their length
+        class KeyWriter {
+            std::string& _out;
+
+        public:
+            KeyWriter(std::string& out) noexcept:
+                _out(out) {}
+
+            template<typename T>
+            void write(const T& value) {
+                static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "Only scalar values can be written directly!");
+
+                _out.append(reinterpret_cast<const char * > (&value), sizeof(T));
+            }
+
+            void write(const std::string& value) {
+                write(static_cast<std::uint64_t> (value.size()));
+                _out.append(value);
+            }
+
+            void writeBytes(const void * data, std::size_t size) {
+                write(static_cast<std::uint64_t> (size));
+                _out.append(static_cast<const char * > (data), size);
+            }
+        };
+
+        // constants are written by constantID with their values, so the order they were set in and the
+        // layout of the data do not matter
+        void writeSpecialization(KeyWriter& writer, const SpecializationInfo& specializationInfo) {
+            auto mapEntries = specializationInfo.mapEntries;
+
+            std::sort(mapEntries.begin(), mapEntries.end(), [](const SpecializationInfo::MapEntry& lhs, const SpecializationInfo::MapEntry& rhs) {
+                return lhs.constantID < rhs.constantID;
+            });
+
+            writer.write(static_cast<std::uint64_t> (mapEntries.size()));
+
+            for (const auto& mapEntry : mapEntries) {
+                if (mapEntry.offset + mapEntry.size > specializationInfo.data.size()) {
+                    throw std::runtime_error("Specialization constant is outside of the specialization data!");
+                }
+
+                writer.write(mapEntry.constantID);
+                writer.writeBytes(specializationInfo.data.data() + mapEntry.offset, mapEntry.size);
+            }
+        }
+
+        void writeStage(KeyWriter& writer, const PipelineShaderStageCreateInfo& stage) {
+            writer.write(stage.flags);
+            writer.write(stage.stage);
+            writer.write(stage.moduleInfo.flags);
+            writer.write(stage.moduleInfo.path);
+
+            // the code is identified by its content, so rebuilding a shader under the same path changes the key
+            writer.write(ShaderModule::getCodeHash(stage.moduleInfo));
+
+            writer.write(stage.name);
+
+            writeSpecialization(writer, stage.specializationInfo);
+        }
+
+        void writeLayout(KeyWriter& writer, const PipelineLayout::CreateInfo& layoutInfo) {
+            writer.write(layoutInfo.flags);
+            writer.write(static_cast<std::uint64_t> (layoutInfo.pushConstantRanges.size()));
+
+            for (const auto& range : layoutInfo.pushConstantRanges) {
+                writer.write(range.stages);
+                writer.write(range.offset);
+                writer.write(range.size);
+            }
+
+            writer.write(static_cast<std::uint64_t> (layoutInfo.setLayoutInfos.size()));
+
+            for (const auto& setLayoutInfo : layoutInfo.setLayoutInfos) {
+                writer.write(setLayoutInfo.flags);
+                writer.write(static_cast<std::uint64_t> (setLayoutInfo.bindings.size()));
+
+                for (const auto& binding : setLayoutInfo.bindings) {
+                    writer.write(binding.binding);
+                    writer.write(binding.descriptorType);
+                    writer.write(binding.descriptorCount);
+                    writer.write(binding.stages);
+                }
+            }
+        }
+
+        void writeStencilOpState(KeyWriter& writer, const StencilOpState& state) {
+            writer.write(state.failOp);
+            writer.write(state.passOp);
+            writer.write(state.depthFailOp);
+            writer.write(state.compareOp);
+            writer.write(state.compareMask);
+            writer.write(state.writeMask);
+            writer.write(state.reference);
+        }
+
+        // attachment references are compatible if the referenced attachments have the same format and sample count
+        void writeAttachmentReferences(KeyWriter& writer, const std::vector<AttachmentReference>& references, const std::vector<AttachmentDescription>& attachments) {
+            writer.write(static_cast<std::uint64_t> (references.size()));
+
+            for (const auto& reference : references) {
+                if (reference.attachment < 0 || static_cast<std::size_t> (reference.attachment) >= attachments.size()) {
+                    writer.write(false);
+                } else {
+                    const auto& attachment = attachments[reference.attachment];
+
+                    writer.write(true);
+                    writer.write(attachment.format);
+                    writer.write(attachment.samples);
+                }
+            }
+        }
+
+        void writeRenderPassCompatibility(KeyWriter& writer, const RenderPass::CreateInfo& renderPassInfo) {
+            writer.write(renderPassInfo.flags);
+            writer.write(static_cast<std::uint64_t> (renderPassInfo.subpasses.size()));
+
+            for (const auto& subpass : renderPassInfo.subpasses) {
+                writer.write(subpass.flags);
+                writer.write(subpass.pipelineBindPoint);
+
+                writeAttachmentReferences(writer, subpass.inputAttachments, renderPassInfo.attachments);
+                writeAttachmentReferences(writer, subpass.colorAttachments, renderPassInfo.attachments);
+                writeAttachmentReferences(writer, subpass.resolveAttachments, renderPassInfo.attachments);
+                writeAttachmentReferences(writer, subpass.depthStencilAttachment, renderPassInfo.attachments);
+
+                writer.write(static_cast<std::uint64_t> (subpass.preserveAttachments.size()));
+
+                for (auto preserveAttachment : subpass.preserveAttachments) {
+                    writer.write(preserveAttachment);
+                }
+            }
+
+            writer.write(static_cast<std::uint64_t> (renderPassInfo.dependencies.size()));
+
+            for (const auto& dependency : renderPassInfo.dependencies) {
+                writer.write(dependency.srcSubpass);
+                writer.write(dependency.dstSubpass);
+                writer.write(dependency.srcStageMask);
+                writer.write(dependency.dstStageMask);
+                writer.write(dependency.srcAccessMask);
+                writer.write(dependency.dstAccessMask);
+                writer.write(dependency.dependencyFlags);
+            }
+        }
+    }
+
+    PipelineKey::PipelineKey(const ComputePipeline::CreateInfo& createInfo) {
+        KeyWriter writer(_data);
+
+        writer.write('C');
+        writer.write(createInfo.flags);
+
+        writeStage(writer, createInfo.stage);
+        writeLayout(writer, createInfo.layoutInfo);
+
+        _hash = Util::fnv1a(_data.data(), _data.size());
+    }
+
+    PipelineKey::PipelineKey(const GraphicsPipeline::CreateInfo& createInfo, const RenderPass::CreateInfo& renderPassInfo) {
+        KeyWriter writer(_data);
+
+        writer.write('G');
+        writer.write(createInfo.flags);
+        writer.write(static_cast<std::uint64_t> (createInfo.stages.size()));
+
+        for (const auto& stage : createInfo.stages) {
+            writeStage(writer, stage);
+        }
+
+        writeLayout(writer, createInfo.layoutInfo);
+
+        const auto& colorBlendState = createInfo.colorBlendState;
+
+        writer.write(colorBlendState.flags);
+        writer.write(colorBlendState.logicOpEnable);
+        writer.write(colorBlendState.logicOp);
+        writer.write(static_cast<std::uint64_t> (colorBlendState.attachments.size()));
+
+        for (const auto& attachment : colorBlendState.attachments) {
+            writer.write(attachment.blendEnable);
+            writer.write(attachment.srcColorBlendFactor);
+            writer.write(attachment.dstColorBlendFactor);
+            writer.write(attachment.colorBlendOp);
+            writer.write(attachment.srcAlphaBlendFactor);
+            writer.write(attachment.dstAlphaBlendFactor);
+            writer.write(attachment.alphaBlendOp);
+            writer.write(attachment.colorWriteMask);
+        }
+
+        writer.write(colorBlendState.blendConstants.red);
+        writer.write(colorBlendState.blendConstants.green);
+        writer.write(colorBlendState.blendConstants.blue);
+        writer.write(colorBlendState.blendConstants.alpha);
+
+        const auto& depthStencilState = createInfo.depthStencilState;
+
+        writer.write(depthStencilState.flags);
+        writer.write(depthStencilState.depthTestEnable);
+        writer.write(depthStencilState.depthWriteEnable);
+        writer.write(depthStencilState.depthCompareOp);
+        writer.write(depthStencilState.depthBoundsTestEnable);
+        writer.write(depthStencilState.stencilTestEnable);
+        writeStencilOpState(writer, depthStencilState.front);
+        writeStencilOpState(writer, depthStencilState.back);
+        writer.write(depthStencilState.minDepthBounds);
+        writer.write(depthStencilState.maxDepthBounds);
+
+        writer.write(createInfo.inputAssemblyState.flags);
+        writer.write(createInfo.inputAssemblyState.topology);
+        writer.write(createInfo.inputAssemblyState.primitiveRestartEnable);
+
+        const auto& multisampleState = createInfo.multisampleState;
+
+        writer.write(multisampleState.flags);
+        writer.write(multisampleState.rasterizationSamples);
+        writer.write(multisampleState.sampleShadingEnable);
+        writer.write(multisampleState.minSampleShading);
+
+        if (nullptr == multisampleState.pSampleMask) {
+            writer.writeBytes(nullptr, 0);
+        } else {
+            // one mask word per 32 samples
+            const auto maskWords = static_cast<std::size_t> (multisampleState.rasterizationSamples + 31) / 32;
+
+            writer.writeBytes(multisampleState.pSampleMask, maskWords * sizeof(unsigned int));
+        }
+
+        writer.write(multisampleState.alphaToCoverageEnable);
+        writer.write(multisampleState.alphaToOneEnable);
+
+        const auto& rasterizationState = createInfo.rasterizationState;
+
+        writer.write(rasterizationState.flags);
+        writer.write(rasterizationState.depthClampEnable);
+        writer.write(rasterizationState.rasterizationDiscardEnable);
+        writer.write(rasterizationState.polygonMode);
+        writer.write(rasterizationState.cullMode);
+        writer.write(rasterizationState.frontFace);
+        writer.write(rasterizationState.depthBiasEnable);
+        writer.write(rasterizationState.depthBiasConstantFactor);
+        writer.write(rasterizationState.depthBiasClamp);
+        writer.write(rasterizationState.depthBiasSlopeFactor);
+        writer.write(rasterizationState.lineWidth);
+
+        writer.write(createInfo.tessellationState.flags);
+        writer.write(createInfo.tessellationState.patchControlPoints);
+
+        const auto& vertexInputState = createInfo.vertexInputState;
+
+        writer.write(vertexInputState.flags);
+        writer.write(static_cast<std::uint64_t> (vertexInputState.vertexBindingDescriptions.size()));
+
+        for (const auto& binding : vertexInputState.vertexBindingDescriptions) {
+            writer.write(binding.binding);
+            writer.write(binding.stride);
+            writer.write(binding.inputRate);
+        }
+
+        writer.write(static_cast<std::uint64_t> (vertexInputState.vertexAttributeDescriptions.size()));
+
+        for (const auto& attribute : vertexInputState.vertexAttributeDescriptions) {
+            writer.write(attribute.location);
+            writer.write(attribute.binding);
+            writer.write(attribute.format);
+            writer.write(attribute.offset);
+        }
+
+        writer.write(createInfo.subpass);
+
+        writeRenderPassCompatibility(writer, renderPassInfo);
+
+        _hash = Util::fnv1a(_data.data(), _data.size());
+    }
+}
@@ -42,6 +42,8 @@ namespace mvk {
 
         _handle = VK_NULL_HANDLE;
 
+        MVK_METRICS_SCOPED_TIMER(pDevice, CREATE_PIPELINE_LAYOUT);
+
         Util::vkAssert(vkCreatePipelineLayout(pDevice->getHandle(), &pipelineLayoutCI, nullptr, &_handle));
     }
 
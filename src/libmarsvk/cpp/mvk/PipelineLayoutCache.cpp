@@ -2,8 +2,12 @@
 
 #include <stdexcept>
 
+#include "mvk/Device.hpp"
+
 namespace mvk {
     void PipelineLayoutCache::releasePipelineLayout(PipelineLayout * layout) {
+        std::lock_guard<std::mutex> lock(_lock);
+
         auto it = _layouts.begin();
         Layout * pLayout = nullptr;
 
@@ -26,6 +30,9 @@ namespace mvk {
     }
 
     PipelineLayout * PipelineLayoutCache::allocatePipelineLayout(const PipelineLayout::CreateInfo& createInfo) {
+        // PipelineCompiler threads allocate layouts concurrently with the render thread
+        std::lock_guard<std::mutex> lock(_lock);
+
         auto it = _layouts.begin();
         Layout * pLayout = nullptr;
 
@@ -37,10 +44,14 @@ namespace mvk {
         }
 
         if (nullptr == pLayout) {
+            MVK_METRICS_INCREMENT(getDevice(), PIPELINE_LAYOUT_CACHE_MISSES);
+
             auto ptr = std::make_unique<Layout> (this, createInfo);
             pLayout = ptr.get();
 
             _layouts.push_back(std::move(ptr));
+        } else {
+            MVK_METRICS_INCREMENT(getDevice(), PIPELINE_LAYOUT_CACHE_HITS);
         }
 
         pLayout->references += 1;
@@ -0,0 +1,642 @@
+#include "mvk/PipelineManifest.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace mvk {
+    namespace {
+        constexpr std::uint32_t MANIFEST_MAGIC = 0x4D504B4D;   // "MKPM"
+        constexpr std::uint32_t MANIFEST_VERSION = 2;
+
+        // every pipeline is stored with the SPIR-V hash of each of its stages, taken when it was recorded
+        struct ComputePipelineRecord {
+            ComputePipeline::CreateInfo createInfo;
+            std::vector<std::uint64_t> codeHashes;
+        };
+
+        struct GraphicsPipelineRecord {
+            PipelineManifest::GraphicsPipelineEntry entry;
+            std::vector<std::uint64_t> codeHashes;
+        };
+
+        template<typename T>
+        using IsScalar = std::integral_constant<bool, std::is_arithmetic<T>::value || std::is_enum<T>::value>;
+
+        // Every struct is described once by a serialize function that visits its fields; the same function
+        // drives both the ManifestWriter and the ManifestReader, so the two can not disagree on the layout.
+
+        template<class Archive>
+        void serialize(Archive& ar, ShaderModule::CreateInfo& moduleInfo) {
+            ar(moduleInfo.flags);
+            ar(moduleInfo.path);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, SpecializationInfo::MapEntry& mapEntry) {
+            ar(mapEntry.constantID);
+            ar(mapEntry.offset);
+            ar(mapEntry.size);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, SpecializationInfo& specializationInfo) {
+            ar(specializationInfo.mapEntries);
+            ar(specializationInfo.data);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, PipelineShaderStageCreateInfo& stage) {
+            ar(stage.flags);
+            ar(stage.stage);
+            ar(stage.moduleInfo);
+            ar(stage.name);
+            ar(stage.specializationInfo);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, PushConstantRange& range) {
+            ar(range.stages);
+            ar(range.offset);
+            ar(range.size);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, DescriptorSetLayout::Binding& binding) {
+            ar(binding.binding);
+            ar(binding.descriptorType);
+            ar(binding.descriptorCount);
+            ar(binding.stages);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, DescriptorSetLayout::CreateInfo& setLayoutInfo) {
+            ar(setLayoutInfo.flags);
+            ar(setLayoutInfo.bindings);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, PipelineLayout::CreateInfo& layoutInfo) {
+            ar(layoutInfo.flags);
+            ar(layoutInfo.pushConstantRanges);
+            ar(layoutInfo.setLayoutInfos);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, ComputePipeline::CreateInfo& createInfo) {
+            ar(createInfo.flags);
+            ar(createInfo.stage);
+            ar(createInfo.layoutInfo);
+            ar(createInfo.name);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, Color& color) {
+            ar(color.red);
+            ar(color.green);
+            ar(color.blue);
+            ar(color.alpha);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, PipelineColorBlendAttachmentState& attachment) {
+            ar(attachment.blendEnable);
+            ar(attachment.srcColorBlendFactor);
+            ar(attachment.dstColorBlendFactor);
+            ar(attachment.colorBlendOp);
+            ar(attachment.srcAlphaBlendFactor);
+            ar(attachment.dstAlphaBlendFactor);
+            ar(attachment.alphaBlendOp);
+            ar(attachment.colorWriteMask);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, PipelineColorBlendStateCreateInfo& colorBlendState) {
+            ar(colorBlendState.flags);
+            ar(colorBlendState.logicOpEnable);
+            ar(colorBlendState.logicOp);
+            ar(colorBlendState.attachments);
+            ar(colorBlendState.blendConstants);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, StencilOpState& state) {
+            ar(state.failOp);
+            ar(state.passOp);
+            ar(state.depthFailOp);
+            ar(state.compareOp);
+            ar(state.compareMask);
+            ar(state.writeMask);
+            ar(state.reference);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, PipelineDepthStencilStateCreateInfo& depthStencilState) {
+            ar(depthStencilState.flags);
+            ar(depthStencilState.depthTestEnable);
+            ar(depthStencilState.depthWriteEnable);
+            ar(depthStencilState.depthCompareOp);
+            ar(depthStencilState.depthBoundsTestEnable);
+            ar(depthStencilState.stencilTestEnable);
+            ar(depthStencilState.front);
+            ar(depthStencilState.back);
+            ar(depthStencilState.minDepthBounds);
+            ar(depthStencilState.maxDepthBounds);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, PipelineInputAssemblyStateCreateInfo& inputAssemblyState) {
+            ar(inputAssemblyState.flags);
+            ar(inputAssemblyState.topology);
+            ar(inputAssemblyState.primitiveRestartEnable);
+        }
+
+        // the sample mask is stored next to the CreateInfo by GraphicsPipelineEntry
+        template<class Archive>
+        void serialize(Archive& ar, PipelineMultisampleStateCreateInfo& multisampleState) {
+            ar(multisampleState.flags);
+            ar(multisampleState.rasterizationSamples);
+            ar(multisampleState.sampleShadingEnable);
+            ar(multisampleState.minSampleShading);
+            ar(multisampleState.alphaToCoverageEnable);
+            ar(multisampleState.alphaToOneEnable);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, PipelineRasterizationStateCreateInfo& rasterizationState) {
+            ar(rasterizationState.flags);
+            ar(rasterizationState.depthClampEnable);
+            ar(rasterizationState.rasterizationDiscardEnable);
+            ar(rasterizationState.polygonMode);
+            ar(rasterizationState.cullMode);
+            ar(rasterizationState.frontFace);
+            ar(rasterizationState.depthBiasEnable);
+            ar(rasterizationState.depthBiasConstantFactor);
+            ar(rasterizationState.depthBiasClamp);
+            ar(rasterizationState.depthBiasSlopeFactor);
+            ar(rasterizationState.lineWidth);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, PipelineTessellationStateCreateInfo& tessellationState) {
+            ar(tessellationState.flags);
+            ar(tessellationState.patchControlPoints);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, VertexInputBindingDescription& binding) {
+            ar(binding.binding);
+            ar(binding.stride);
+            ar(binding.inputRate);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, VertexInputAttributeDescription& attribute) {
+            ar(attribute.location);
+            ar(attribute.binding);
+            ar(attribute.format);
+            ar(attribute.offset);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, PipelineVertexInputStateCreateInfo& vertexInputState) {
+            ar(vertexInputState.flags);
+            ar(vertexInputState.vertexBindingDescriptions);
+            ar(vertexInputState.vertexAttributeDescriptions);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, GraphicsPipeline::CreateInfo& createInfo) {
+            ar(createInfo.flags);
+            ar(createInfo.stages);
+            ar(createInfo.layoutInfo);
+            ar(createInfo.colorBlendState);
+            ar(createInfo.depthStencilState);
+            ar(createInfo.inputAssemblyState);
+            ar(createInfo.multisampleState);
+            ar(createInfo.rasterizationState);
+            ar(createInfo.tessellationState);
+            ar(createInfo.vertexInputState);
+            ar(createInfo.subpass);
+            ar(createInfo.name);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, AttachmentDescription& attachment) {
+            ar(attachment.flags);
+            ar(attachment.format);
+            ar(attachment.loadOp);
+            ar(attachment.storeOp);
+            ar(attachment.stencilLoadOp);
+            ar(attachment.stencilStoreOp);
+            ar(attachment.initialLayout);
+            ar(attachment.finalLayout);
+            ar(attachment.samples);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, AttachmentReference& reference) {
+            ar(reference.attachment);
+            ar(reference.layout);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, SubpassDescription& subpass) {
+            ar(subpass.flags);
+            ar(subpass.pipelineBindPoint);
+            ar(subpass.inputAttachments);
+            ar(subpass.colorAttachments);
+            ar(subpass.resolveAttachments);
+            ar(subpass.preserveAttachments);
+            ar(subpass.depthStencilAttachment);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, SubpassDependency& dependency) {
+            ar(dependency.srcSubpass);
+            ar(dependency.dstSubpass);
+            ar(dependency.srcStageMask);
+            ar(dependency.dstStageMask);
+            ar(dependency.srcAccessMask);
+            ar(dependency.dstAccessMask);
+            ar(dependency.dependencyFlags);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, RenderPass::CreateInfo& renderPassInfo) {
+            ar(renderPassInfo.flags);
+            ar(renderPassInfo.attachments);
+            ar(renderPassInfo.subpasses);
+            ar(renderPassInfo.dependencies);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, PipelineManifest::GraphicsPipelineEntry& entry) {
+            ar(entry.createInfo);
+            ar(entry.renderPassInfo);
+            ar(entry.sampleMask);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, ComputePipelineRecord& record) {
+            ar(record.createInfo);
+            ar(record.codeHashes);
+        }
+
+        template<class Archive>
+        void serialize(Archive& ar, GraphicsPipelineRecord& record) {
+            ar(record.entry);
+            ar(record.codeHashes);
+        }
+
+        class ManifestWriter {
+            std::string& _out;
+
+            template<typename T>
+            void write(T& value, std::true_type) {
+                _out.append(reinterpret_cast<const char * > (&value), sizeof(T));
+            }
+
+            template<typename T>
+            void write(T& value, std::false_type) {
+                serialize(*this, value);
+            }
+
+        public:
+            ManifestWriter(std::string& out) noexcept:
+                _out(out) {}
+
+            template<typename T>
+            void operator() (T& value) {
+                write(value, IsScalar<T> ());
+            }
+
+            void operator() (std::string& value) {
+                auto size = static_cast<std::uint64_t> (value.size());
+
+                (*this)(size);
+                _out.append(value);
+            }
+
+            template<typename T>
+            void operator() (std::vector<T>& values) {
+                auto size = static_cast<std::uint64_t> (values.size());
+
+                (*this)(size);
+
+                for (auto& value : values) {
+                    (*this)(value);
+                }
+            }
+        };
+
+        class ManifestReader {
+            const std::string& _in;
+            std::size_t _position;
+
+            const char * take(std::uint64_t size) {
+                if (size > _in.size() - _position) {
+                    throw std::runtime_error("Pipeline manifest is truncated!");
+                }
+
+                const auto out = _in.data() + _position;
+
+                _position += static_cast<std::size_t> (size);
+
+                return out;
+            }
+
+            template<typename T>
+            void read(T& value, std::true_type) {
+                std::memcpy(&value, take(sizeof(T)), sizeof(T));
+            }
+
+            template<typename T>
+            void read(T& value, std::false_type) {
+                serialize(*this, value);
+            }
+
+        public:
+            ManifestReader(const std::string& in) noexcept:
+                _in(in),
+                _position(0) {}
+
+            inline bool isEnd() const noexcept {
+                return _position == _in.size();
+            }
+
+            template<typename T>
+            void operator() (T& value) {
+                read(value, IsScalar<T> ());
+            }
+
+            void operator() (std::string& value) {
+                std::uint64_t size;
+
+                (*this)(size);
+
+                const auto pData = take(size);
+
+                value.assign(pData, static_cast<std::size_t> (size));
+            }
+
+            template<typename T>
+            void operator() (std::vector<T>& values) {
+                std::uint64_t size;
+
+                (*this)(size);
+
+                // every element takes at least one byte, so a corrupt size can not allocate past the file
+                if (size > _in.size() - _position) {
+                    throw std::runtime_error("Pipeline manifest is truncated!");
+                }
+
+                values.resize(static_cast<std::size_t> (size));
+
+                for (auto& value : values) {
+                    (*this)(value);
+                }
+            }
+        };
+
+        bool hasInMemoryCode(const PipelineShaderStageCreateInfo& stage) noexcept {
+            return nullptr != stage.moduleInfo.pCode;
+        }
+
+        std::vector<std::uint64_t> getCodeHashes(const std::vector<PipelineShaderStageCreateInfo>& stages) {
+            auto out = std::vector<std::uint64_t> ();
+
+            out.reserve(stages.size());
+
+            for (const auto& stage : stages) {
+                out.push_back(ShaderModule::getCodeHash(stage.moduleInfo));
+            }
+
+            return out;
+        }
+
+        // a shader that changed or can no longer be read makes the recorded pipeline stale
+        bool isCurrent(const std::vector<PipelineShaderStageCreateInfo>& stages, const std::vector<std::uint64_t>& codeHashes) noexcept {
+            try {
+                return codeHashes == getCodeHashes(stages);
+            } catch (const std::exception&) {
+                return false;
+            }
+        }
+
+        PipelineKey getKey(const PipelineManifest::GraphicsPipelineEntry& entry) {
+            auto createInfo = entry.createInfo;
+
+            createInfo.multisampleState.pSampleMask = entry.sampleMask.empty() ? nullptr : const_cast<unsigned int * > (entry.sampleMask.data());
+
+            return PipelineKey(createInfo, entry.renderPassInfo);
+        }
+    }
+
+    bool PipelineManifest::add(ComputePipeline::CreateInfo createInfo, std::vector<std::uint64_t> codeHashes) {
+        auto key = PipelineKey(createInfo);
+
+        std::lock_guard<std::mutex> lock(_lock);
+
+        if (!_codeHashes.emplace(std::move(key), std::move(codeHashes)).second) {
+            return false;
+        }
+
+        _computePipelines.push_back(std::move(createInfo));
+
+        return true;
+    }
+
+    bool PipelineManifest::add(PipelineManifest::GraphicsPipelineEntry entry, std::vector<std::uint64_t> codeHashes) {
+        auto key = getKey(entry);
+
+        std::lock_guard<std::mutex> lock(_lock);
+
+        if (!_codeHashes.emplace(std::move(key), std::move(codeHashes)).second) {
+            return false;
+        }
+
+        _graphicsPipelines.push_back(std::move(entry));
+
+        return true;
+    }
+
+    bool PipelineManifest::record(const ComputePipeline::CreateInfo& createInfo) {
+        if (hasInMemoryCode(createInfo.stage)) {
+            return false;
+        }
+
+        return add(createInfo, getCodeHashes({createInfo.stage}));
+    }
+
+    bool PipelineManifest::record(const GraphicsPipeline::CreateInfo& createInfo, const RenderPass::CreateInfo& renderPassInfo) {
+        for (const auto& stage : createInfo.stages) {
+            if (hasInMemoryCode(stage)) {
+                return false;
+            }
+        }
+
+        auto entry = GraphicsPipelineEntry {};
+        entry.createInfo = createInfo;
+        entry.createInfo.multisampleState.pSampleMask = nullptr;
+        entry.renderPassInfo = renderPassInfo;
+
+        if (nullptr != createInfo.multisampleState.pSampleMask) {
+            // one mask word per 32 samples
+            const auto maskWords = static_cast<std::size_t> (createInfo.multisampleState.rasterizationSamples + 31) / 32;
+
+            entry.sampleMask.assign(createInfo.multisampleState.pSampleMask, createInfo.multisampleState.pSampleMask + maskWords);
+        }
+
+        auto codeHashes = getCodeHashes(createInfo.stages);
+
+        return add(std::move(entry), std::move(codeHashes));
+    }
+
+    bool PipelineManifest::remove(const ComputePipeline::CreateInfo& createInfo) {
+        const auto key = PipelineKey(createInfo);
+
+        std::lock_guard<std::mutex> lock(_lock);
+
+        if (0 == _codeHashes.erase(key)) {
+            return false;
+        }
+
+        _computePipelines.erase(std::find_if(_computePipelines.begin(), _computePipelines.end(), [&key](const ComputePipeline::CreateInfo& recorded) {
+            return key == PipelineKey(recorded);
+        }));
+
+        return true;
+    }
+
+    bool PipelineManifest::remove(const PipelineManifest::GraphicsPipelineEntry& entry) {
+        const auto key = getKey(entry);
+
+        std::lock_guard<std::mutex> lock(_lock);
+
+        if (0 == _codeHashes.erase(key)) {
+            return false;
+        }
+
+        _graphicsPipelines.erase(std::find_if(_graphicsPipelines.begin(), _graphicsPipelines.end(), [&key](const GraphicsPipelineEntry& recorded) {
+            return key == getKey(recorded);
+        }));
+
+        return true;
+    }
+
+    std::vector<ComputePipeline::CreateInfo> PipelineManifest::getComputePipelines() const {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        return _computePipelines;
+    }
+
+    std::vector<PipelineManifest::GraphicsPipelineEntry> PipelineManifest::getGraphicsPipelines() const {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        return _graphicsPipelines;
+    }
+
+    std::size_t PipelineManifest::size() const {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        return _computePipelines.size() + _graphicsPipelines.size();
+    }
+
+    bool PipelineManifest::load(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+
+        if (!file) {
+            return false;
+        }
+
+        const auto data = std::string(std::istreambuf_iterator<char> (file), std::istreambuf_iterator<char> ());
+        auto reader = ManifestReader(data);
+        std::uint32_t magic, version;
+
+        try {
+            reader(magic);
+            reader(version);
+        } catch (const std::exception&) {
+            throw std::runtime_error("Not a pipeline manifest: " + path);
+        }
+
+        if (MANIFEST_MAGIC != magic) {
+            throw std::runtime_error("Not a pipeline manifest: " + path);
+        }
+
+        if (MANIFEST_VERSION != version) {
+            return false;
+        }
+
+        auto computePipelines = std::vector<ComputePipelineRecord> ();
+        auto graphicsPipelines = std::vector<GraphicsPipelineRecord> ();
+
+        reader(computePipelines);
+        reader(graphicsPipelines);
+
+        if (!reader.isEnd()) {
+            throw std::runtime_error("Pipeline manifest has trailing data: " + path);
+        }
+
+        // stale pipelines are dropped, so they are neither replayed nor saved again
+        for (auto& record : computePipelines) {
+            if (isCurrent({record.createInfo.stage}, record.codeHashes)) {
+                add(std::move(record.createInfo), std::move(record.codeHashes));
+            }
+        }
+
+        for (auto& record : graphicsPipelines) {
+            if (isCurrent(record.entry.createInfo.stages, record.codeHashes)) {
+                add(std::move(record.entry), std::move(record.codeHashes));
+            }
+        }
+
+        return true;
+    }
+
+    void PipelineManifest::save(const std::string& path) const {
+        auto computePipelines = std::vector<ComputePipelineRecord> ();
+        auto graphicsPipelines = std::vector<GraphicsPipelineRecord> ();
+
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+
+            computePipelines.reserve(_computePipelines.size());
+            graphicsPipelines.reserve(_graphicsPipelines.size());
+
+            for (const auto& createInfo : _computePipelines) {
+                computePipelines.push_back(ComputePipelineRecord {createInfo, _codeHashes.at(PipelineKey(createInfo))});
+            }
+
+            for (const auto& entry : _graphicsPipelines) {
+                graphicsPipelines.push_back(GraphicsPipelineRecord {entry, _codeHashes.at(getKey(entry))});
+            }
+        }
+
+        auto magic = MANIFEST_MAGIC;
+        auto version = MANIFEST_VERSION;
+
+        auto data = std::string();
+        auto writer = ManifestWriter(data);
+
+        writer(magic);
+        writer(version);
+        writer(computePipelines);
+        writer(graphicsPipelines);
+
+        std::ofstream file(path, std::ios::binary);
+
+        if (!file) {
+            throw std::runtime_error("Unable to open pipeline manifest: " + path);
+        }
+
+        file.write(data.data(), static_cast<std::streamsize> (data.size()));
+    }
+}
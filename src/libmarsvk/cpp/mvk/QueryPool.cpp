@@ -0,0 +1,78 @@
+#include "mvk/QueryPool.hpp"
+
+#include <bitset>
+#include <stdexcept>
+
+#include "mvk/Device.hpp"
+#include "mvk/Util.hpp"
+
+namespace mvk {
+    QueryPool::QueryPool(Device * device, const QueryPool::CreateInfo& createInfo) {
+        _device = device;
+        _info = createInfo;
+
+        if (QueryType::PIPELINE_STATISTICS == createInfo.queryType && !device->getEnabledFeatures().pipelineStatisticsQuery) {
+            throw std::runtime_error("Pipeline statistics queries are not supported by the Device!");
+        }
+
+        auto queryPoolCI = VkQueryPoolCreateInfo {};
+        queryPoolCI.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolCI.queryType = static_cast<VkQueryType> (createInfo.queryType);
+        queryPoolCI.queryCount = createInfo.queryCount;
+
+        if (QueryType::PIPELINE_STATISTICS == createInfo.queryType) {
+            queryPoolCI.pipelineStatistics = static_cast<VkQueryPipelineStatisticFlags> (createInfo.pipelineStatistics);
+        }
+
+        Util::vkAssert(vkCreateQueryPool(device->getHandle(), &queryPoolCI, nullptr, &_handle));
+    }
+
+    QueryPool::~QueryPool() noexcept {
+        if (VK_NULL_HANDLE == _handle) {
+            return;
+        }
+
+        vkDestroyQueryPool(_device->getHandle(), _handle, nullptr);
+    }
+
+    QueryPool& QueryPool::operator= (QueryPool&& from) noexcept {
+        std::swap(_device, from._device);
+        std::swap(_info, from._info);
+        std::swap(_handle, from._handle);
+
+        return *this;
+    }
+
+    std::uint32_t QueryPool::getResultCount() const noexcept {
+        if (QueryType::PIPELINE_STATISTICS == _info.queryType) {
+            return static_cast<std::uint32_t> (std::bitset<32> (static_cast<unsigned int> (_info.pipelineStatistics)).count());
+        }
+
+        return 1;
+    }
+
+    bool QueryPool::getResults(std::uint32_t firstQuery, std::uint32_t queryCount, std::uint64_t * pResults, bool wait) const {
+        const auto stride = getResultCount() * sizeof(std::uint64_t);
+        auto flags = static_cast<VkQueryResultFlags> (VK_QUERY_RESULT_64_BIT);
+
+        if (wait) {
+            flags |= VK_QUERY_RESULT_WAIT_BIT;
+        }
+
+        auto result = vkGetQueryPoolResults(
+            _device->getHandle(), _handle,
+            firstQuery, queryCount,
+            queryCount * stride, pResults, stride,
+            flags);
+
+        switch (result) {
+            case VK_SUCCESS:
+                return true;
+            case VK_NOT_READY:
+                return false;
+            default:
+                Util::vkAssert(result);
+                return false;
+        }
+    }
+}
@@ -1,5 +1,6 @@
 #include "mvk/Queue.hpp"
 
+#include <algorithm>
 #include <vector>
 
 #include "mvk/CommandBuffer.hpp"
@@ -27,6 +28,8 @@ namespace mvk {
     }
 
     void Queue::waitIdle() {
+        Tracer::Span traceSpan(getDevice()->getTracer(), "Queue::waitIdle", "wait");
+
         Util::vkAssert(vkQueueWaitIdle(_handle));
     }
 
@@ -37,6 +40,11 @@ namespace mvk {
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
         submitInfo.pCommandBuffers = &cmdHandle;
         submitInfo.commandBufferCount = 1;
+
+        MVK_METRICS_INCREMENT(getDevice(), QUEUE_SUBMITS);
+        MVK_METRICS_SCOPED_TIMER(getDevice(), QUEUE_SUBMIT);
+
+        Tracer::Span traceSpan(getDevice()->getTracer(), "Queue::submit", "submit");
         
         if (nullptr == fence) {
             Util::vkAssert(vkQueueSubmit(_handle, 1, &submitInfo, VK_NULL_HANDLE));
@@ -86,6 +94,11 @@ namespace mvk {
             fenceHandle = fence->getHandle();
         }
 
+        MVK_METRICS_INCREMENT(getDevice(), QUEUE_SUBMITS);
+        MVK_METRICS_SCOPED_TIMER(getDevice(), QUEUE_SUBMIT);
+
+        Tracer::Span traceSpan(getDevice()->getTracer(), "Queue::submit", "submit");
+
         Util::vkAssert(vkQueueSubmit(_handle, 1, &submitInfo, fenceHandle));
     }
 
@@ -225,4 +238,36 @@ namespace mvk {
         
         _commandBuffers.push(std::move(cmd));
     }
+
+    void Queue::beginLabel(const std::string& name, const std::array<float, 4>& color) noexcept {
+        if (!getDevice()->isDebugUtilsEnabled()) {
+            return;
+        }
+
+        auto labelI = VkDebugUtilsLabelEXT {};
+        labelI.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+        labelI.pLabelName = name.c_str();
+        std::copy(color.begin(), color.end(), labelI.color);
+
+        vkQueueBeginDebugUtilsLabelEXT(_handle, &labelI);
+    }
+
+    void Queue::endLabel() noexcept {
+        if (getDevice()->isDebugUtilsEnabled()) {
+            vkQueueEndDebugUtilsLabelEXT(_handle);
+        }
+    }
+
+    void Queue::insertLabel(const std::string& name, const std::array<float, 4>& color) noexcept {
+        if (!getDevice()->isDebugUtilsEnabled()) {
+            return;
+        }
+
+        auto labelI = VkDebugUtilsLabelEXT {};
+        labelI.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+        labelI.pLabelName = name.c_str();
+        std::copy(color.begin(), color.end(), labelI.color);
+
+        vkQueueInsertDebugUtilsLabelEXT(_handle, &labelI);
+    }
 }
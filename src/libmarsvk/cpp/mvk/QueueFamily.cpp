@@ -4,7 +4,9 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <stdexcept>
 #include <utility>
+#include <vector>
 
 #include "mvk/Device.hpp"
 #include "mvk/PhysicalDevice.hpp"
@@ -21,6 +23,7 @@ namespace mvk {
         _device = device;
         _index = queueFamilyIndex;
         _properties = properties;
+        _commandPools = std::make_unique<CommandPools> ();
 
         int nQueues = static_cast<int> (properties.queueCount);
         
@@ -34,12 +37,11 @@ namespace mvk {
             _queues.push_back(std::make_unique<Queue> (this, i));
         }
 
-        _commandPool = nullptr;
     }
 
     QueueFamily::~QueueFamily() noexcept {
-        _queues.clear();
         detach();
+        _queues.clear();
     }
 
     QueueFlag QueueFamily::getFlags() const noexcept {
@@ -55,15 +57,41 @@ namespace mvk {
     }
 
     CommandPool * QueueFamily::getCurrentCommandPool() {
-        if (_commandPool == nullptr) {
-            _commandPool = std::make_unique<CommandPool> (this, CommandPoolCreateFlag::CREATE_RESET_COMMAND_BUFFER);
+        std::lock_guard<std::mutex> lock(_commandPools->lock);
+
+        auto& commandPool = _commandPools->pools[std::this_thread::get_id()];
+
+        if (commandPool == nullptr) {
+            commandPool = std::make_unique<CommandPool> (this, CommandPoolCreateFlag::CREATE_RESET_COMMAND_BUFFER);
         }
         
-        return _commandPool.get();
+        return commandPool.get();
+    }
+
+    void QueueFamily::waitIdle() {
+        for (auto& queue : _queues) {
+            queue->waitIdle();
+        }
     }
 
     void QueueFamily::detach() noexcept {
-        _commandPool = nullptr;
-        //TODO: this should destroy thread_local storage
+        if (nullptr == _commandPools) {
+            return;
+        }
+
+        // CommandBuffers allocated from the pools may still be pending
+        try {
+            waitIdle();
+        } catch (const std::exception& ex) {
+            std::cerr << ex.what() << std::endl;
+        }
+
+        auto pools = std::map<std::thread::id, std::unique_ptr<CommandPool>> ();
+
+        {
+            std::lock_guard<std::mutex> lock(_commandPools->lock);
+
+            std::swap(pools, _commandPools->pools);
+        }
     }
 }
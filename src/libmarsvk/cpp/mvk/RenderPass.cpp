@@ -119,6 +119,8 @@ namespace mvk {
 
         _handle = VK_NULL_HANDLE;
 
+        MVK_METRICS_SCOPED_TIMER(device, CREATE_RENDER_PASS);
+
         Util::vkAssert(vkCreateRenderPass(device->getHandle(), &renderPassCI, nullptr, &_handle));
     }
 
@@ -30,6 +30,8 @@ namespace mvk {
         samplerCI.borderColor = static_cast<VkBorderColor> (createInfo.borderColor);
         samplerCI.unnormalizedCoordinates = createInfo.unnormalizedCoordinates ? VK_TRUE : VK_FALSE;
 
+        MVK_METRICS_SCOPED_TIMER(cache->getDevice(), CREATE_SAMPLER);
+
         Util::vkAssert(vkCreateSampler(cache->getDevice()->getHandle(), &samplerCI, nullptr, &_handle));
     }
 
@@ -39,10 +39,14 @@ namespace mvk {
         }
 
         if (nullptr == pSampler) {
+            MVK_METRICS_INCREMENT(getDevice(), SAMPLER_CACHE_MISSES);
+
             auto ptr = std::make_unique<SamplerInstance> (this, createInfo);
             pSampler = ptr.get();
 
             _samplers.push_back(std::move(ptr));
+        } else {
+            MVK_METRICS_INCREMENT(getDevice(), SAMPLER_CACHE_HITS);
         }
 
         pSampler->references += 1;
@@ -27,7 +27,11 @@ namespace mvk {
 
         VkSemaphore handle = VK_NULL_HANDLE;
 
-        Util::vkAssert(vkCreateSemaphore(getDevice()->getHandle(), &semaphoreCI, nullptr, &handle));
+        {
+            MVK_METRICS_SCOPED_TIMER(getDevice(), CREATE_SYNC);
+
+            Util::vkAssert(vkCreateSemaphore(getDevice()->getHandle(), &semaphoreCI, nullptr, &handle));
+        }
 
         auto ptr = std::make_unique<Semaphore> (this, handle);
         auto out = ptr.get();
@@ -39,8 +43,12 @@ namespace mvk {
 
     Semaphore * SemaphorePool::acquireSemaphore() {
         if (_availableSemaphores.empty()) {
+            MVK_METRICS_INCREMENT(getDevice(), SEMAPHORE_ALLOCATIONS);
+
             return allocateSemaphore();
         } else {
+            MVK_METRICS_INCREMENT(getDevice(), SEMAPHORE_REUSES);
+
             auto out = _availableSemaphores.front();
 
             _availableSemaphores.pop();
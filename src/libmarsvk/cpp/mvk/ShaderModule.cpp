@@ -11,13 +11,47 @@
 
 #include "volk.h"
 
+#include <fstream>
+#include <mutex>
 #include <stdexcept>
+#include <string>
+#include <unordered_map>
 
 #include "mvk/Device.hpp"
 #include "mvk/Util.hpp"
 
 namespace mvk {
     namespace {
+        struct EmbeddedCode {
+            const std::uint32_t * pCode;
+            std::size_t codeSize;
+        };
+
+        // function-local statics, since Embedded objects are constructed during static initialization
+        std::mutex& getEmbeddedLock() {
+            static std::mutex lock;
+
+            return lock;
+        }
+
+        std::unordered_map<std::string, EmbeddedCode>& getEmbeddedShaders() {
+            static std::unordered_map<std::string, EmbeddedCode> shaders;
+
+            return shaders;
+        }
+
+        std::mutex& getCodeHashLock() {
+            static std::mutex lock;
+
+            return lock;
+        }
+
+        std::unordered_map<std::string, std::uint64_t>& getCodeHashes() {
+            static std::unordered_map<std::string, std::uint64_t> codeHashes;
+
+            return codeHashes;
+        }
+
         std::size_t getFileSize(const char * fileName) noexcept {
             struct stat st;
 
@@ -25,12 +59,122 @@ namespace mvk {
 
             return st.st_size;
         }
+
+        VkShaderModule createShaderModule(Device * device, int flags, const std::uint32_t * pCode, std::size_t codeSize) {
+            VkShaderModuleCreateInfo shaderModuleCI {};
+
+            shaderModuleCI.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+            shaderModuleCI.flags = flags;
+            shaderModuleCI.pCode = pCode;
+            shaderModuleCI.codeSize = codeSize;
+
+            VkShaderModule handle = VK_NULL_HANDLE;
+
+            {
+                MVK_METRICS_SCOPED_TIMER(device, CREATE_SHADER_MODULE);
+
+                Util::vkAssert(vkCreateShaderModule(device->getHandle(), &shaderModuleCI, nullptr, &handle));
+            }
+
+            return handle;
+        }
+    }
+
+    ShaderModule::Embedded::Embedded(const char * name, const std::uint32_t * pCode, std::size_t codeSize) {
+        std::lock_guard<std::mutex> lock(getEmbeddedLock());
+
+        getEmbeddedShaders()[name] = EmbeddedCode {pCode, codeSize};
+    }
+
+    bool ShaderModule::isEmbedded(const std::string& name) {
+        std::lock_guard<std::mutex> lock(getEmbeddedLock());
+
+        return getEmbeddedShaders().count(name) > 0;
+    }
+
+    std::vector<std::uint32_t> ShaderModule::readCode(const ShaderModule::CreateInfo& info) {
+        if (nullptr != info.pCode) {
+            return std::vector<std::uint32_t> (info.pCode, info.pCode + info.codeSize / sizeof(std::uint32_t));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(getEmbeddedLock());
+
+            const auto& embeddedShaders = getEmbeddedShaders();
+            auto it = embeddedShaders.find(info.path);
+
+            if (embeddedShaders.end() != it) {
+                return std::vector<std::uint32_t> (it->second.pCode, it->second.pCode + it->second.codeSize / sizeof(std::uint32_t));
+            }
+        }
+
+        std::ifstream file(info.path, std::ios::binary | std::ios::ate);
+
+        if (!file) {
+            throw std::runtime_error("Unable to open file: " + info.path);
+        }
+
+        const auto fileSize = static_cast<std::size_t> (file.tellg());
+        auto out = std::vector<std::uint32_t> (fileSize / sizeof(std::uint32_t));
+
+        file.seekg(0);
+        file.read(reinterpret_cast<char * > (out.data()), out.size() * sizeof(std::uint32_t));
+
+        return out;
+    }
+
+    std::uint64_t ShaderModule::getCodeHash(const ShaderModule::CreateInfo& info) {
+        if (nullptr != info.pCode) {
+            return Util::fnv1a(info.pCode, info.codeSize);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(getCodeHashLock());
+
+            const auto& codeHashes = getCodeHashes();
+            auto it = codeHashes.find(info.path);
+
+            if (codeHashes.end() != it) {
+                return it->second;
+            }
+        }
+
+        // the code is read without the lock; threads that race on the same path compute the same hash
+        const auto code = readCode(info);
+        const auto hash = Util::fnv1a(code.data(), code.size() * sizeof(std::uint32_t));
+
+        std::lock_guard<std::mutex> lock(getCodeHashLock());
+
+        getCodeHashes()[info.path] = hash;
+
+        return hash;
     }
 
     ShaderModule::ShaderModule(Device * device, const ShaderModule::CreateInfo& info) {
         _device = device;
         _info = info;
 
+        if (nullptr != info.pCode) {
+            _handle = createShaderModule(device, info.flags, info.pCode, info.codeSize);
+            return;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(getEmbeddedLock());
+
+            const auto& embeddedShaders = getEmbeddedShaders();
+            auto it = embeddedShaders.find(info.path);
+
+            if (embeddedShaders.end() != it) {
+                const auto embedded = it->second;
+
+                lock.unlock();
+
+                _handle = createShaderModule(device, info.flags, embedded.pCode, embedded.codeSize);
+                return;
+            }
+        }
+
         auto fileName = info.path.c_str();
         int fd = open(fileName, O_RDONLY, 0);
 
@@ -47,17 +191,17 @@ namespace mvk {
 #endif
 
         if (MAP_FAILED == pData) {
+            close(fd);
             throw std::runtime_error("Failed to map file: " + info.path);
         }
 
-        VkShaderModuleCreateInfo shaderModuleCI {};
-
-        shaderModuleCI.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-        shaderModuleCI.flags = info.flags;
-        shaderModuleCI.pCode = static_cast<std::uint32_t * >(pData);
-        shaderModuleCI.codeSize = fileSize;
-
-        Util::vkAssert(vkCreateShaderModule(device->getHandle(), &shaderModuleCI, nullptr, &_handle));
+        try {
+            _handle = createShaderModule(device, info.flags, static_cast<std::uint32_t * >(pData), fileSize);
+        } catch (...) {
+            munmap(pData, fileSize);
+            close(fd);
+            throw;
+        }
 
         munmap(pData, fileSize);
         close(fd);
@@ -0,0 +1,639 @@
+#include "mvk/ShaderReflection.hpp"
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace mvk {
+    constexpr std::uint32_t ShaderReflection::NO_CONSTANT;
+
+    namespace {
+        constexpr std::uint32_t SPIRV_MAGIC = 0x07230203;
+        constexpr std::size_t SPIRV_HEADER_WORDS = 5;
+
+        // the subset of the SPIR-V specification needed to reflect resource interfaces
+        namespace Op {
+            constexpr std::uint32_t ENTRY_POINT = 15;
+            constexpr std::uint32_t EXECUTION_MODE = 16;
+            constexpr std::uint32_t TYPE_BOOL = 20;
+            constexpr std::uint32_t TYPE_INT = 21;
+            constexpr std::uint32_t TYPE_FLOAT = 22;
+            constexpr std::uint32_t TYPE_VECTOR = 23;
+            constexpr std::uint32_t TYPE_MATRIX = 24;
+            constexpr std::uint32_t TYPE_IMAGE = 25;
+            constexpr std::uint32_t TYPE_SAMPLER = 26;
+            constexpr std::uint32_t TYPE_SAMPLED_IMAGE = 27;
+            constexpr std::uint32_t TYPE_ARRAY = 28;
+            constexpr std::uint32_t TYPE_RUNTIME_ARRAY = 29;
+            constexpr std::uint32_t TYPE_STRUCT = 30;
+            constexpr std::uint32_t TYPE_POINTER = 32;
+            constexpr std::uint32_t CONSTANT = 43;
+            constexpr std::uint32_t CONSTANT_COMPOSITE = 44;
+            constexpr std::uint32_t SPEC_CONSTANT = 50;
+            constexpr std::uint32_t SPEC_CONSTANT_COMPOSITE = 51;
+            constexpr std::uint32_t FUNCTION = 54;
+            constexpr std::uint32_t FUNCTION_END = 56;
+            constexpr std::uint32_t FUNCTION_CALL = 57;
+            constexpr std::uint32_t VARIABLE = 59;
+            constexpr std::uint32_t DECORATE = 71;
+            constexpr std::uint32_t MEMBER_DECORATE = 72;
+            constexpr std::uint32_t EXECUTION_MODE_ID = 331;
+        }
+
+        namespace Decoration {
+            constexpr std::uint32_t SPEC_ID = 1;
+            constexpr std::uint32_t BLOCK = 2;
+            constexpr std::uint32_t BUFFER_BLOCK = 3;
+            constexpr std::uint32_t ARRAY_STRIDE = 6;
+            constexpr std::uint32_t MATRIX_STRIDE = 7;
+            constexpr std::uint32_t BUILT_IN = 11;
+            constexpr std::uint32_t BINDING = 33;
+            constexpr std::uint32_t DESCRIPTOR_SET = 34;
+            constexpr std::uint32_t OFFSET = 35;
+        }
+
+        namespace StorageClass {
+            constexpr std::uint32_t UNIFORM_CONSTANT = 0;
+            constexpr std::uint32_t UNIFORM = 2;
+            constexpr std::uint32_t PUSH_CONSTANT = 9;
+            constexpr std::uint32_t STORAGE_BUFFER = 12;
+        }
+
+        constexpr std::uint32_t BUILT_IN_WORKGROUP_SIZE = 25;
+        constexpr std::uint32_t EXECUTION_MODE_LOCAL_SIZE = 17;
+        constexpr std::uint32_t EXECUTION_MODE_LOCAL_SIZE_ID = 38;
+        constexpr std::uint32_t DIM_BUFFER = 5;
+        constexpr std::uint32_t DIM_SUBPASS_DATA = 6;
+
+        struct Decorations {
+            bool hasSet = false;
+            bool hasBinding = false;
+            bool hasSpecID = false;
+            bool block = false;
+            bool bufferBlock = false;
+            bool workgroupSize = false;
+            std::uint32_t set = 0;
+            std::uint32_t binding = 0;
+            std::uint32_t specID = 0;
+            std::uint32_t arrayStride = 0;
+        };
+
+        struct MemberDecorations {
+            bool hasOffset = false;
+            std::uint32_t offset = 0;
+            std::uint32_t matrixStride = 0;
+        };
+
+        // the instruction of a type or constant, without the result id
+        struct Instruction {
+            std::uint32_t opcode;
+            std::vector<std::uint32_t> operands;
+        };
+
+        struct Variable {
+            std::uint32_t id;
+            std::uint32_t pointerType;
+            std::uint32_t storageClass;
+        };
+
+        struct EntryPoint {
+            std::uint32_t executionModel;
+            std::uint32_t id;
+            std::string name;
+            std::vector<std::uint32_t> interface;
+        };
+
+        // the functions a function calls and the module scope variables its instructions reference
+        struct Function {
+            std::vector<std::uint32_t> calls;
+            std::unordered_set<std::uint32_t> variables;
+        };
+
+        class Module {
+        public:
+            std::unordered_map<std::uint32_t, Instruction> types;
+            std::unordered_map<std::uint32_t, Instruction> constants;
+            std::unordered_map<std::uint32_t, Decorations> decorations;
+            std::unordered_map<std::uint32_t, std::vector<MemberDecorations>> memberDecorations;
+            std::vector<Variable> variables;
+            std::unordered_set<std::uint32_t> variableIDs;
+            std::unordered_map<std::uint32_t, Function> functions;
+            std::vector<EntryPoint> entryPoints;
+            std::vector<std::pair<std::uint32_t, Instruction>> executionModes;
+
+            Module(const std::uint32_t * pCode, std::size_t wordCount) {
+                if (wordCount < SPIRV_HEADER_WORDS || SPIRV_MAGIC != pCode[0]) {
+                    throw std::runtime_error("Invalid SPIR-V code!");
+                }
+
+                _currentFunction = nullptr;
+
+                for (auto i = SPIRV_HEADER_WORDS; i < wordCount;) {
+                    const auto instructionWords = pCode[i] >> 16;
+                    const auto opcode = pCode[i] & 0xFFFF;
+
+                    if (0 == instructionWords || i + instructionWords > wordCount) {
+                        throw std::runtime_error("Invalid SPIR-V instruction!");
+                    }
+
+                    parse(opcode, pCode + i + 1, instructionWords - 1);
+
+                    i += instructionWords;
+                }
+            }
+
+            const Instruction& getType(std::uint32_t id) const {
+                auto it = types.find(id);
+
+                if (types.end() == it) {
+                    throw std::runtime_error("SPIR-V references an unknown type!");
+                }
+
+                return it->second;
+            }
+
+            std::uint32_t getConstant(std::uint32_t id) const {
+                auto it = constants.find(id);
+
+                if (constants.end() == it || it->second.operands.size() < 2) {
+                    throw std::runtime_error("SPIR-V references an unknown constant!");
+                }
+
+                // operands are the result type and the low word of the value
+                return it->second.operands[1];
+            }
+
+            Decorations getDecorations(std::uint32_t id) const {
+                auto it = decorations.find(id);
+
+                return (decorations.end() == it) ? Decorations {} : it->second;
+            }
+
+            // the module scope variables statically used by an entry point: those in its interface and those referenced
+            // by any function it calls. Before SPIR-V 1.4 the interface only lists Input and Output variables.
+            std::unordered_set<std::uint32_t> getUsedVariables(const EntryPoint& entryPoint) const {
+                auto out = std::unordered_set<std::uint32_t> (entryPoint.interface.begin(), entryPoint.interface.end());
+                auto visited = std::unordered_set<std::uint32_t> ();
+                auto pending = std::vector<std::uint32_t> {entryPoint.id};
+
+                while (!pending.empty()) {
+                    const auto functionID = pending.back();
+
+                    pending.pop_back();
+
+                    if (!visited.insert(functionID).second) {
+                        continue;
+                    }
+
+                    auto it = functions.find(functionID);
+
+                    if (functions.end() == it) {
+                        continue;
+                    }
+
+                    out.insert(it->second.variables.begin(), it->second.variables.end());
+                    pending.insert(pending.end(), it->second.calls.begin(), it->second.calls.end());
+                }
+
+                return out;
+            }
+
+            MemberDecorations getMemberDecorations(std::uint32_t id, std::size_t member) const {
+                auto it = memberDecorations.find(id);
+
+                return (memberDecorations.end() == it || member >= it->second.size()) ? MemberDecorations {} : it->second[member];
+            }
+
+            // the byte size of a type in an explicitly laid out block
+            std::uint32_t getSize(std::uint32_t typeID, std::uint32_t matrixStride = 0) const {
+                const auto& type = getType(typeID);
+
+                switch (type.opcode) {
+                    case Op::TYPE_BOOL:
+                        return 4;
+                    case Op::TYPE_INT:
+                    case Op::TYPE_FLOAT:
+                        return type.operands[0] / 8;
+                    case Op::TYPE_VECTOR:
+                        return type.operands[1] * getSize(type.operands[0]);
+                    case Op::TYPE_MATRIX:
+                        return type.operands[1] * ((0 == matrixStride) ? getSize(type.operands[0]) : matrixStride);
+                    case Op::TYPE_ARRAY: {
+                        const auto arrayStride = getDecorations(typeID).arrayStride;
+
+                        return getConstant(type.operands[1]) * ((0 == arrayStride) ? getSize(type.operands[0]) : arrayStride);
+                    }
+                    case Op::TYPE_STRUCT: {
+                        std::uint32_t size = 0;
+                        std::uint32_t offset = 0;
+
+                        for (std::size_t member = 0; member < type.operands.size(); member++) {
+                            const auto memberDecorations = getMemberDecorations(typeID, member);
+
+                            if (memberDecorations.hasOffset) {
+                                offset = memberDecorations.offset;
+                            }
+
+                            offset += getSize(type.operands[member], memberDecorations.matrixStride);
+                            size = std::max(size, offset);
+                        }
+
+                        return size;
+                    }
+                    case Op::TYPE_POINTER:
+                        return 8;
+                    default:
+                        throw std::runtime_error("SPIR-V block contains a type without a size!");
+                }
+            }
+
+        private:
+            Function * _currentFunction;
+
+            void parse(std::uint32_t opcode, const std::uint32_t * pOperands, std::size_t operandCount) {
+                auto operands = std::vector<std::uint32_t> (pOperands, pOperands + operandCount);
+
+                // any operand that names a module scope variable counts as a use; literals that happen to match an id
+                // only make the reflection conservative
+                if (nullptr != _currentFunction) {
+                    for (auto operand : operands) {
+                        if (variableIDs.count(operand) > 0) {
+                            _currentFunction->variables.insert(operand);
+                        }
+                    }
+                }
+
+                switch (opcode) {
+                    case Op::ENTRY_POINT: {
+                        auto entryPoint = EntryPoint {};
+                        entryPoint.executionModel = operands.at(0);
+                        entryPoint.id = operands.at(1);
+
+                        // the name is a nul-terminated literal string packed into the following words
+                        const auto pName = reinterpret_cast<const char * > (pOperands + 2);
+                        const auto maxLength = (operandCount - 2) * sizeof(std::uint32_t);
+
+                        entryPoint.name = std::string(pName, std::find(pName, pName + maxLength, '\0'));
+
+                        // the interface ids follow the name and its terminator, padded to a whole word
+                        const auto nameWords = entryPoint.name.size() / sizeof(std::uint32_t) + 1;
+
+                        if (2 + nameWords < operandCount) {
+                            entryPoint.interface.assign(operands.begin() + 2 + nameWords, operands.end());
+                        }
+
+                        entryPoints.push_back(std::move(entryPoint));
+                    } break;
+                    case Op::EXECUTION_MODE:
+                    case Op::EXECUTION_MODE_ID: {
+                        auto mode = Instruction {};
+                        mode.opcode = operands.at(1);
+                        mode.operands.assign(operands.begin() + 2, operands.end());
+
+                        executionModes.emplace_back(operands[0], std::move(mode));
+                    } break;
+                    case Op::TYPE_BOOL:
+                    case Op::TYPE_INT:
+                    case Op::TYPE_FLOAT:
+                    case Op::TYPE_VECTOR:
+                    case Op::TYPE_MATRIX:
+                    case Op::TYPE_IMAGE:
+                    case Op::TYPE_SAMPLER:
+                    case Op::TYPE_SAMPLED_IMAGE:
+                    case Op::TYPE_ARRAY:
+                    case Op::TYPE_RUNTIME_ARRAY:
+                    case Op::TYPE_STRUCT:
+                    case Op::TYPE_POINTER:
+                        types[operands.at(0)] = Instruction {opcode, std::vector<std::uint32_t> (operands.begin() + 1, operands.end())};
+                        break;
+                    case Op::CONSTANT:
+                    case Op::CONSTANT_COMPOSITE:
+                    case Op::SPEC_CONSTANT:
+                    case Op::SPEC_CONSTANT_COMPOSITE: {
+                        // the result type precedes the result id
+                        auto constant = Instruction {opcode, operands};
+
+                        constant.operands.erase(constant.operands.begin() + 1);
+                        constants[operands.at(1)] = std::move(constant);
+                    } break;
+                    case Op::VARIABLE:
+                        // function scope variables are never resources
+                        if (nullptr == _currentFunction) {
+                            variables.push_back(Variable {operands.at(1), operands.at(0), operands.at(2)});
+                            variableIDs.insert(operands.at(1));
+                        }
+                        break;
+                    case Op::FUNCTION:
+                        _currentFunction = &functions[operands.at(1)];
+                        break;
+                    case Op::FUNCTION_END:
+                        _currentFunction = nullptr;
+                        break;
+                    case Op::FUNCTION_CALL:
+                        if (nullptr != _currentFunction) {
+                            _currentFunction->calls.push_back(operands.at(2));
+                        }
+                        break;
+                    case Op::DECORATE: {
+                        auto& target = decorations[operands.at(0)];
+
+                        switch (operands.at(1)) {
+                            case Decoration::SPEC_ID:
+                                target.hasSpecID = true;
+                                target.specID = operands.at(2);
+                                break;
+                            case Decoration::BLOCK:
+                                target.block = true;
+                                break;
+                            case Decoration::BUFFER_BLOCK:
+                                target.bufferBlock = true;
+                                break;
+                            case Decoration::ARRAY_STRIDE:
+                                target.arrayStride = operands.at(2);
+                                break;
+                            case Decoration::BUILT_IN:
+                                target.workgroupSize = BUILT_IN_WORKGROUP_SIZE == operands.at(2);
+                                break;
+                            case Decoration::BINDING:
+                                target.hasBinding = true;
+                                target.binding = operands.at(2);
+                                break;
+                            case Decoration::DESCRIPTOR_SET:
+                                target.hasSet = true;
+                                target.set = operands.at(2);
+                                break;
+                        }
+                    } break;
+                    case Op::MEMBER_DECORATE: {
+                        auto& members = memberDecorations[operands.at(0)];
+                        const auto member = operands.at(1);
+
+                        if (members.size() <= member) {
+                            members.resize(member + 1);
+                        }
+
+                        if (Decoration::OFFSET == operands.at(2)) {
+                            members[member].hasOffset = true;
+                            members[member].offset = operands.at(3);
+                        } else if (Decoration::MATRIX_STRIDE == operands.at(2)) {
+                            members[member].matrixStride = operands.at(3);
+                        }
+                    } break;
+                }
+            }
+        };
+
+        ShaderStage toShaderStage(std::uint32_t executionModel) {
+            switch (executionModel) {
+                case 0:
+                    return ShaderStage::VERTEX;
+                case 1:
+                    return ShaderStage::TESSELLATION_CONTROL;
+                case 2:
+                    return ShaderStage::TESSELLATION_EVALUATION;
+                case 3:
+                    return ShaderStage::GEOMETRY;
+                case 4:
+                    return ShaderStage::FRAGMENT;
+                case 5:
+                    return ShaderStage::COMPUTE;
+                default:
+                    throw std::runtime_error("Unsupported SPIR-V execution model!");
+            }
+        }
+
+        DescriptorType toDescriptorType(const Module& module, std::uint32_t storageClass, std::uint32_t typeID) {
+            const auto& type = module.getType(typeID);
+
+            if (StorageClass::STORAGE_BUFFER == storageClass) {
+                return DescriptorType::STORAGE_BUFFER;
+            } else if (StorageClass::UNIFORM == storageClass) {
+                return module.getDecorations(typeID).bufferBlock ? DescriptorType::STORAGE_BUFFER : DescriptorType::UNIFORM_BUFFER;
+            }
+
+            switch (type.opcode) {
+                case Op::TYPE_SAMPLER:
+                    return DescriptorType::SAMPLER;
+                case Op::TYPE_SAMPLED_IMAGE:
+                    return DescriptorType::COMBINED_IMAGE_SAMPLER;
+                case Op::TYPE_IMAGE: {
+                    // operands are the sampled type, dim, depth, arrayed, multisampled, sampled and format
+                    const auto dim = type.operands.at(1);
+                    const bool storage = 2 == type.operands.at(5);
+
+                    if (DIM_SUBPASS_DATA == dim) {
+                        return DescriptorType::INPUT_ATTACHMENT;
+                    } else if (DIM_BUFFER == dim) {
+                        return storage ? DescriptorType::STORAGE_TEXEL_BUFFER : DescriptorType::UNIFORM_TEXEL_BUFFER;
+                    }
+
+                    return storage ? DescriptorType::STORAGE_IMAGE : DescriptorType::SAMPLED_IMAGE;
+                }
+                default:
+                    throw std::runtime_error("Unsupported SPIR-V descriptor type!");
+            }
+        }
+    }
+
+    ShaderReflection::ShaderReflection(const std::uint32_t * pCode, std::size_t codeSize, const std::string& entryPoint) {
+        const Module module(pCode, codeSize / sizeof(std::uint32_t));
+
+        auto entry = std::find_if(module.entryPoints.begin(), module.entryPoints.end(), [&entryPoint](const EntryPoint& e) {
+            return e.name == entryPoint;
+        });
+
+        if (module.entryPoints.end() == entry) {
+            throw std::runtime_error("SPIR-V has no entry point: " + entryPoint);
+        }
+
+        _stage = toShaderStage(entry->executionModel);
+        _entryPoint = entryPoint;
+        _pushConstantOffset = 0;
+        _pushConstantSize = 0;
+
+        for (std::size_t i = 0; i < 3; i++) {
+            _localSize[i] = 1;
+            _localSizeConstantIDs[i] = NO_CONSTANT;
+        }
+
+        const auto usedVariables = module.getUsedVariables(*entry);
+
+        for (const auto& variable : module.variables) {
+            if (0 == usedVariables.count(variable.id)) {
+                continue;
+            }
+
+            const auto& pointer = module.getType(variable.pointerType);
+            auto typeID = pointer.operands.at(1);
+
+            if (StorageClass::PUSH_CONSTANT == variable.storageClass) {
+                const auto& block = module.getType(typeID);
+                auto offset = module.getSize(typeID);
+
+                for (std::size_t member = 0; member < block.operands.size(); member++) {
+                    offset = std::min(offset, module.getMemberDecorations(typeID, member).offset);
+                }
+
+                _pushConstantOffset = offset;
+                _pushConstantSize = module.getSize(typeID) - offset;
+                continue;
+            }
+
+            if (StorageClass::UNIFORM_CONSTANT != variable.storageClass
+                    && StorageClass::UNIFORM != variable.storageClass
+                    && StorageClass::STORAGE_BUFFER != variable.storageClass) {
+                continue;
+            }
+
+            const auto decorations = module.getDecorations(variable.id);
+
+            if (!decorations.hasBinding) {
+                continue;
+            }
+
+            std::uint32_t count = 1;
+
+            while (true) {
+                const auto& type = module.getType(typeID);
+
+                if (Op::TYPE_ARRAY == type.opcode) {
+                    count *= module.getConstant(type.operands.at(1));
+                    typeID = type.operands.at(0);
+                } else if (Op::TYPE_RUNTIME_ARRAY == type.opcode) {
+                    throw std::runtime_error("Runtime sized descriptor arrays are not supported!");
+                } else {
+                    break;
+                }
+            }
+
+            auto descriptorBinding = DescriptorBinding {};
+            descriptorBinding.set = decorations.set;
+            descriptorBinding.binding.binding = decorations.binding;
+            descriptorBinding.binding.descriptorType = toDescriptorType(module, variable.storageClass, typeID);
+            descriptorBinding.binding.descriptorCount = count;
+            descriptorBinding.binding.stages = _stage;
+
+            _descriptorBindings.push_back(descriptorBinding);
+        }
+
+        std::sort(_descriptorBindings.begin(), _descriptorBindings.end(), [](const DescriptorBinding& lhs, const DescriptorBinding& rhs) {
+            return (lhs.set == rhs.set) ? lhs.binding.binding < rhs.binding.binding : lhs.set < rhs.set;
+        });
+
+        if (ShaderStage::COMPUTE != _stage) {
+            return;
+        }
+
+        for (const auto& mode : module.executionModes) {
+            if (mode.first != entry->id) {
+                continue;
+            }
+
+            // LocalSizeId is declared by OpExecutionModeId since SPIR-V 1.2; its operands are constant ids
+            if (EXECUTION_MODE_LOCAL_SIZE == mode.second.opcode) {
+                for (std::size_t i = 0; i < 3; i++) {
+                    _localSize[i] = mode.second.operands.at(i);
+                }
+            } else if (EXECUTION_MODE_LOCAL_SIZE_ID == mode.second.opcode) {
+                for (std::size_t i = 0; i < 3; i++) {
+                    const auto id = mode.second.operands.at(i);
+                    const auto constantDecorations = module.getDecorations(id);
+
+                    _localSize[i] = module.getConstant(id);
+                    _localSizeConstantIDs[i] = constantDecorations.hasSpecID ? constantDecorations.specID : NO_CONSTANT;
+                }
+            }
+        }
+
+        // the WorkgroupSize built-in overrides the execution mode; glslang emits it for local_size_*_id
+        for (const auto& constant : module.constants) {
+            if (!module.getDecorations(constant.first).workgroupSize) {
+                continue;
+            }
+
+            for (std::size_t i = 0; i < 3; i++) {
+                const auto id = constant.second.operands.at(1 + i);
+                const auto componentDecorations = module.getDecorations(id);
+
+                _localSize[i] = module.getConstant(id);
+                _localSizeConstantIDs[i] = componentDecorations.hasSpecID ? componentDecorations.specID : NO_CONSTANT;
+            }
+        }
+    }
+
+    ShaderReflection::ShaderReflection(const ShaderModule::CreateInfo& moduleInfo, const std::string& entryPoint) {
+        const auto code = ShaderModule::readCode(moduleInfo);
+
+        *this = ShaderReflection(code.data(), code.size() * sizeof(std::uint32_t), entryPoint);
+    }
+
+    PipelineLayout::CreateInfo ShaderReflection::createPipelineLayoutInfo(const std::vector<ShaderReflection>& reflections) {
+        auto sets = std::map<std::uint32_t, std::map<std::uint32_t, DescriptorSetLayout::Binding>> ();
+        auto pushConstantStages = static_cast<ShaderStage> (0);
+        std::uint32_t pushConstantBegin = 0xFFFFFFFF;
+        std::uint32_t pushConstantEnd = 0;
+
+        for (const auto& reflection : reflections) {
+            for (const auto& descriptorBinding : reflection.getDescriptorBindings()) {
+                auto& bindings = sets[descriptorBinding.set];
+                auto it = bindings.find(descriptorBinding.binding.binding);
+
+                if (bindings.end() == it) {
+                    bindings[descriptorBinding.binding.binding] = descriptorBinding.binding;
+                } else if (it->second.descriptorType != descriptorBinding.binding.descriptorType) {
+                    throw std::runtime_error("Shader stages declare different descriptor types for set "
+                        + std::to_string(descriptorBinding.set) + " binding " + std::to_string(descriptorBinding.binding.binding) + "!");
+                } else {
+                    it->second.descriptorCount = std::max(it->second.descriptorCount, descriptorBinding.binding.descriptorCount);
+                    it->second.stages = it->second.stages | descriptorBinding.binding.stages;
+                }
+            }
+
+            if (reflection.getPushConstantSize() > 0) {
+                pushConstantStages = pushConstantStages | reflection.getStage();
+                pushConstantBegin = std::min(pushConstantBegin, reflection.getPushConstantOffset());
+                pushConstantEnd = std::max(pushConstantEnd, reflection.getPushConstantOffset() + reflection.getPushConstantSize());
+            }
+        }
+
+        auto out = PipelineLayout::CreateInfo {};
+
+        if (!sets.empty()) {
+            // PipelineLayouts address sets by position, so unused set indices get empty DescriptorSetLayouts
+            out.setLayoutInfos.resize(sets.rbegin()->first + 1);
+
+            for (const auto& set : sets) {
+                auto& bindings = out.setLayoutInfos[set.first].bindings;
+
+                for (const auto& binding : set.second) {
+                    bindings.push_back(binding.second);
+                }
+            }
+        }
+
+        if (pushConstantEnd > 0) {
+            auto range = PushConstantRange {};
+            range.stages = pushConstantStages;
+            range.offset = static_cast<int> (pushConstantBegin);
+            range.size = pushConstantEnd - pushConstantBegin;
+
+            out.pushConstantRanges.push_back(range);
+        }
+
+        return out;
+    }
+
+    PipelineLayout::CreateInfo ShaderReflection::createPipelineLayoutInfo(const std::vector<PipelineShaderStageCreateInfo>& stages) {
+        auto reflections = std::vector<ShaderReflection> ();
+        reflections.reserve(stages.size());
+
+        for (const auto& stage : stages) {
+            reflections.emplace_back(stage.moduleInfo, stage.name);
+        }
+
+        return createPipelineLayoutInfo(reflections);
+    }
+}
@@ -1,8 +1,20 @@
 #include "mvk/Surface.hpp"
 
+#include <cstdint>
+
 #include "mvk/Instance.hpp"
 
 namespace mvk {
+    // kept with the other GLFW calls so programs that never open a window do not need to link GLFW
+    void Instance::enableRequiredGLFWExtensions() noexcept {
+        std::uint32_t requiredGLFWExtensions = 0;
+        auto extensions = glfwGetRequiredInstanceExtensions(&requiredGLFWExtensions);
+
+        for (std::uint32_t i = 0; i < requiredGLFWExtensions; i++) {
+            enableExtension(extensions[i]);
+        }
+    }
+
     Surface::Surface(Instance& instance, GLFWwindow * window) noexcept {
         glfwCreateWindowSurface(instance, window, nullptr, &_handle);
         _instance = &instance;
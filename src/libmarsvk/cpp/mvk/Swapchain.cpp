@@ -79,6 +79,7 @@ namespace mvk {
         std::swap(this->_images, from._images);
         std::swap(this->_info, from._info);
         std::swap(this->_presentMode, from._presentMode);
+        std::swap(this->_serial, from._serial);
         std::swap(this->_support, from._support);
         std::swap(this->_width, from._width);
 
@@ -180,6 +181,7 @@ namespace mvk {
         }
 
         _handle = newHandle;
+        _serial = Util::nextSerial();
 
         vkGetSwapchainImagesKHR(pDevice->getHandle(), _handle, &imageCount, nullptr);
 
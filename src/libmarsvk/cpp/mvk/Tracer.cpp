@@ -0,0 +1,282 @@
+#include "mvk/Tracer.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+#include "mvk/CommandBuffer.hpp"
+#include "mvk/CommandPool.hpp"
+#include "mvk/Device.hpp"
+#include "mvk/Fence.hpp"
+#include "mvk/PhysicalDevice.hpp"
+#include "mvk/Queue.hpp"
+#include "mvk/QueueFamily.hpp"
+#include "mvk/QueryPool.hpp"
+#include "mvk/Util.hpp"
+
+namespace mvk {
+    namespace {
+        constexpr std::uint32_t CPU_PID = 1;
+        constexpr std::uint32_t GPU_PID = 2;
+
+        inline double toMicroseconds(std::int64_t nanoseconds) noexcept {
+            return static_cast<double> (nanoseconds) * 1E-3;
+        }
+    }
+
+    Tracer::Tracer(Device * device) noexcept:
+        _device(device),
+        _recording(false),
+        _maxEvents(0),
+        _droppedEventCount(0),
+        _origin(now()),
+        _calibrated(false),
+        _calibrationTicks(0),
+        _calibrationTime(0),
+        _calibrationUncertainty(0),
+        _timestampPeriod(static_cast<double> (device->getPhysicalDevice()->getProperties().limits.timestampPeriod)) {}
+
+    void Tracer::start(std::size_t maxEvents) {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        _events.clear();
+        _events.reserve(std::min<std::size_t> (maxEvents, 1 << 16));
+        _maxEvents = maxEvents;
+        _droppedEventCount = 0;
+        _origin = now();
+        _recording.store(true, std::memory_order_relaxed);
+    }
+
+    void Tracer::stop() noexcept {
+        _recording.store(false, std::memory_order_relaxed);
+    }
+
+    void Tracer::push(Tracer::Event&& event) {
+        if (_events.size() >= _maxEvents) {
+            _droppedEventCount++;
+        } else {
+            _events.push_back(std::move(event));
+        }
+    }
+
+    bool Tracer::calibrateWithExtension() {
+#if defined(VK_EXT_calibrated_timestamps) && defined(__linux__)
+        const auto& enabledExtensions = _device->getEnabledExtensions();
+
+        if (enabledExtensions.end() == enabledExtensions.find("VK_EXT_calibrated_timestamps")) {
+            return false;
+        }
+
+        auto pfnGetCalibratedTimestamps = reinterpret_cast<PFN_vkGetCalibratedTimestampsEXT> (vkGetDeviceProcAddr(_device->getHandle(), "vkGetCalibratedTimestampsEXT"));
+
+        if (nullptr == pfnGetCalibratedTimestamps) {
+            return false;
+        }
+
+        // steady_clock is CLOCK_MONOTONIC on Linux
+        VkCalibratedTimestampInfoEXT timestampInfos[2] {};
+        timestampInfos[0].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+        timestampInfos[0].timeDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+        timestampInfos[1].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+        timestampInfos[1].timeDomain = VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT;
+
+        std::uint64_t timestamps[2] {};
+        std::uint64_t maxDeviation = 0;
+
+        if (VK_SUCCESS != pfnGetCalibratedTimestamps(_device->getHandle(), 2, timestampInfos, timestamps, &maxDeviation)) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(_lock);
+
+        _calibrationTicks = timestamps[0];
+        _calibrationTime = static_cast<std::int64_t> (timestamps[1]);
+        _calibrationUncertainty = static_cast<std::int64_t> (maxDeviation);
+        _calibrated = true;
+
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void Tracer::calibrate(Queue * queue) {
+        auto queueFamily = queue->getQueueFamily();
+
+        if (0 == queueFamily->getProperties().timestampValidBits) {
+            throw std::runtime_error("QueueFamily does not support timestamps!");
+        }
+
+        if (calibrateWithExtension()) {
+            return;
+        }
+
+        auto queryPoolCI = QueryPool::CreateInfo {};
+        queryPoolCI.queryType = QueryType::TIMESTAMP;
+        queryPoolCI.queryCount = 1;
+
+        auto queryPool = std::make_unique<QueryPool> (_device, queryPoolCI);
+        auto commandBuffer = queueFamily->getCurrentCommandPool()->allocate();
+
+        commandBuffer->begin(CommandBufferUsageFlag::ONE_TIME_SUBMIT);
+        commandBuffer->resetQueryPool(queryPool.get(), 0, 1);
+        commandBuffer->writeTimestamp(PipelineStageFlag::TOP_OF_PIPE, queryPool.get(), 0);
+        commandBuffer->end();
+
+        auto fence = _device->acquireFence();
+
+        const auto before = now();
+
+        queue->submit(commandBuffer.get(), fence);
+        fence->waitFor();
+
+        const auto after = now();
+
+        fence->reset();
+        fence->release();
+
+        std::uint64_t ticks = 0;
+
+        queryPool->getResults(0, 1, &ticks, true);
+
+        std::lock_guard<std::mutex> lock(_lock);
+
+        _calibrationTicks = ticks;
+        _calibrationTime = before + (after - before) / 2;
+        _calibrationUncertainty = (after - before) / 2;
+        _calibrated = true;
+    }
+
+    bool Tracer::isCalibrated() const noexcept {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        return _calibrated;
+    }
+
+    std::int64_t Tracer::getCalibrationUncertainty() const noexcept {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        return _calibrationUncertainty;
+    }
+
+    void Tracer::addSpan(const std::string& name, const char * category, std::int64_t start, std::int64_t end) {
+        if (!isRecording()) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(_lock);
+
+        const auto threadId = std::this_thread::get_id();
+        auto it = _threadIds.find(threadId);
+
+        if (_threadIds.end() == it) {
+            it = _threadIds.emplace(threadId, static_cast<std::uint32_t> (_threadIds.size() + 1)).first;
+        }
+
+        auto event = Event {};
+        event.name = name;
+        event.category = category;
+        event.pid = CPU_PID;
+        event.tid = it->second;
+        event.start = start;
+        event.end = end;
+
+        push(std::move(event));
+    }
+
+    void Tracer::addGPUSpan(const std::string& name, std::uint32_t queueFamilyIndex, std::uint64_t beginTicks, std::uint64_t endTicks, std::uint64_t timestampMask) {
+        if (!isRecording()) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(_lock);
+
+        if (!_calibrated) {
+            _droppedEventCount++;
+            return;
+        }
+
+        // timestamps may wrap when fewer than 64 bits are valid, so work with masked differences from the calibration point
+        const auto toTime = [&] (std::uint64_t ticks) {
+            auto delta = static_cast<std::int64_t> ((ticks - _calibrationTicks) & timestampMask);
+
+            if (~0ULL != timestampMask && static_cast<std::uint64_t> (delta) > (timestampMask >> 1)) {
+                delta -= static_cast<std::int64_t> (timestampMask) + 1;
+            }
+
+            return _calibrationTime + static_cast<std::int64_t> (static_cast<double> (delta) * _timestampPeriod);
+        };
+
+        auto event = Event {};
+        event.name = name;
+        event.category = "gpu";
+        event.pid = GPU_PID;
+        event.tid = queueFamilyIndex;
+        event.start = toTime(beginTicks);
+        event.end = event.start + static_cast<std::int64_t> (static_cast<double> ((endTicks - beginTicks) & timestampMask) * _timestampPeriod);
+
+        push(std::move(event));
+    }
+
+    std::size_t Tracer::getDroppedEventCount() const noexcept {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        return _droppedEventCount;
+    }
+
+    std::string Tracer::toJSON() const {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        auto out = std::stringstream ();
+        out << std::fixed << std::setprecision(3);
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << CPU_PID << ",\"tid\":0,\"args\":{\"name\":\"CPU\"}}";
+        out << ",{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << GPU_PID << ",\"tid\":0,\"args\":{\"name\":\"GPU\"}}";
+
+        for (const auto& threadId : _threadIds) {
+            out << ",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << CPU_PID << ",\"tid\":" << threadId.second
+                << ",\"args\":{\"name\":\"Thread " << threadId.second << "\"}}";
+        }
+
+        auto queueFamilies = std::set<std::uint32_t> ();
+
+        for (const auto& event : _events) {
+            if (GPU_PID == event.pid) {
+                queueFamilies.insert(event.tid);
+            }
+        }
+
+        for (auto queueFamily : queueFamilies) {
+            out << ",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << GPU_PID << ",\"tid\":" << queueFamily
+                << ",\"args\":{\"name\":\"QueueFamily " << queueFamily << "\"}}";
+        }
+
+        for (const auto& event : _events) {
+            out << ",{\"name\":" << Util::escapeJSON(event.name)
+                << ",\"cat\":\"" << event.category << "\",\"ph\":\"X\""
+                << ",\"pid\":" << event.pid
+                << ",\"tid\":" << event.tid
+                << ",\"ts\":" << toMicroseconds(event.start - _origin)
+                << ",\"dur\":" << toMicroseconds(std::max<std::int64_t> (event.end - event.start, 0))
+                << "}";
+        }
+
+        out << "]}";
+
+        return out.str();
+    }
+
+    void Tracer::save(const std::string& path) const {
+        std::ofstream file(path);
+
+        if (!file) {
+            throw std::runtime_error("Unable to open trace file: " + path);
+        }
+
+        file << toJSON();
+    }
+}
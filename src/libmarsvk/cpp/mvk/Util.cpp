@@ -1,10 +1,59 @@
 #include "mvk/Util.hpp"
 
+#include <atomic>
 #include <stdexcept>
 #include <sstream>
 
 namespace mvk {
     namespace Util {
+        std::uint64_t nextSerial() noexcept {
+            static std::atomic<std::uint64_t> serial(0);
+
+            return ++serial;
+        }
+
+        std::uint64_t fnv1a(const void * data, std::size_t size) noexcept {
+            constexpr std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+            constexpr std::uint64_t FNV_PRIME = 1099511628211ULL;
+
+            const auto bytes = static_cast<const std::uint8_t * > (data);
+            auto hash = FNV_OFFSET_BASIS;
+
+            for (std::size_t i = 0; i < size; i++) {
+                hash ^= bytes[i];
+                hash *= FNV_PRIME;
+            }
+
+            return hash;
+        }
+
+        std::string escapeJSON(const std::string& value) {
+            auto out = std::string ();
+            out.reserve(value.size() + 2);
+            out.push_back('"');
+
+            for (auto c : value) {
+                switch (c) {
+                    case '"':
+                        out += "\\\"";
+                        break;
+                    case '\\':
+                        out += "\\\\";
+                        break;
+                    case '\n':
+                        out += "\\n";
+                        break;
+                    default:
+                        out.push_back(static_cast<unsigned char> (c) < 0x20 ? ' ' : c);
+                        break;
+                }
+            }
+
+            out.push_back('"');
+
+            return out;
+        }
+
         void vkAssert(VkResult result) {
             if (VK_SUCCESS != result) {
                 throw std::runtime_error(translateVulkanResult(result));
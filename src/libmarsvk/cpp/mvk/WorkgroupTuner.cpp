@@ -0,0 +1,255 @@
+#include "mvk/WorkgroupTuner.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include "mvk/CommandBuffer.hpp"
+#include "mvk/Device.hpp"
+#include "mvk/PhysicalDevice.hpp"
+#include "mvk/PipelineKey.hpp"
+#include "mvk/QueueFamily.hpp"
+#include "mvk/ShaderModule.hpp"
+
+namespace mvk {
+    namespace {
+        const std::vector<std::uint32_t> DEFAULT_CANDIDATES = {32, 64, 128, 256, 512, 1024};
+        constexpr std::uint32_t DEFAULT_RUNS = 5;
+    }
+
+    WorkgroupTuner::WorkgroupTuner(Device * device, const WorkgroupTuner::CreateInfo& createInfo) {
+        _device = device;
+        _info = createInfo;
+
+        if (_info.candidates.empty()) {
+            _info.candidates = DEFAULT_CANDIDATES;
+        }
+
+        if (0 == _info.runs) {
+            _info.runs = DEFAULT_RUNS;
+        }
+
+        const auto validBits = createInfo.queueFamily->getProperties().timestampValidBits;
+
+        if (0 == validBits) {
+            throw std::runtime_error("QueueFamily does not support timestamps!");
+        }
+
+        _timestampMask = (validBits >= 64) ? ~0ULL : ((1ULL << validBits) - 1);
+        _timestampPeriod = static_cast<double> (device->getPhysicalDevice()->getProperties().limits.timestampPeriod);
+
+        load();
+    }
+
+    WorkgroupTuner::TableKey WorkgroupTuner::getKey(const ComputePipeline::CreateInfo& createInfo) const {
+        // the workgroup size constant is the tuned value, so it is not part of the kernel identity
+        auto kernelCI = createInfo;
+        auto& mapEntries = kernelCI.stage.specializationInfo.mapEntries;
+        const auto constantID = _info.constantID;
+
+        mapEntries.erase(std::remove_if(mapEntries.begin(), mapEntries.end(), [constantID](const SpecializationInfo::MapEntry& entry) {
+            return entry.constantID == constantID;
+        }), mapEntries.end());
+
+        auto kernel = std::stringstream ();
+
+        // the code hash is also part of the PipelineKey; it is written separately so rebuilt shaders are visible in the table
+        kernel << createInfo.stage.moduleInfo.path << ":" << createInfo.stage.name << ":" << std::hex << std::setfill('0')
+            << std::setw(16) << ShaderModule::getCodeHash(createInfo.stage.moduleInfo) << ":"
+            << std::setw(16) << PipelineKey(kernelCI).getHash();
+
+        const auto& properties = _device->getPhysicalDevice()->getProperties();
+
+        return TableKey(properties.vendorID, properties.deviceID, properties.driverVersion, kernel.str());
+    }
+
+    ComputePipeline::CreateInfo WorkgroupTuner::specialize(const ComputePipeline::CreateInfo& createInfo, std::uint32_t workgroupSize) const {
+        auto out = createInfo;
+
+        out.stage.specializationInfo.set(_info.constantID, workgroupSize);
+
+        return out;
+    }
+
+    double WorkgroupTuner::time(const ComputePipeline * pipeline, std::uint32_t workgroupSize, const RecordFunction& recordFunction) {
+        const auto queryCount = 2 * _info.runs;
+
+        auto queryPoolCI = QueryPool::CreateInfo {};
+        queryPoolCI.queryType = QueryType::TIMESTAMP;
+        queryPoolCI.queryCount = queryCount;
+
+        auto pQueryPool = _device->createQueryPool(queryPoolCI);
+        auto pCommandBuffer = _info.queueFamily->getCurrentCommandPool()->allocate();
+
+        // consecutive runs are serialized, so every timestamp pair only covers its own run
+        auto barrier = MemoryBarrier {};
+        barrier.srcAccessMask = AccessFlag::SHADER_WRITE;
+        barrier.dstAccessMask = AccessFlag::SHADER_READ | AccessFlag::SHADER_WRITE;
+
+        pCommandBuffer->begin(CommandBufferUsageFlag::ONE_TIME_SUBMIT);
+        pCommandBuffer->resetQueryPool(pQueryPool, 0, queryCount);
+        pCommandBuffer->bindPipeline(pipeline);
+
+        // run 0 is not timed; it warms up the caches and clocks
+        for (std::uint32_t run = 0; run <= _info.runs; run++) {
+            // written once the previous run has left the compute stage; TOP_OF_PIPE is not ordered after it
+            if (run > 0) {
+                pCommandBuffer->writeTimestamp(PipelineStageFlag::COMPUTE_SHADER, pQueryPool, 2 * (run - 1));
+            }
+
+            recordFunction(pCommandBuffer.get(), pipeline, workgroupSize);
+
+            if (run > 0) {
+                pCommandBuffer->writeTimestamp(PipelineStageFlag::BOTTOM_OF_PIPE, pQueryPool, 2 * (run - 1) + 1);
+            }
+
+            pCommandBuffer->pipelineBarrier(PipelineStageFlag::COMPUTE_SHADER, PipelineStageFlag::COMPUTE_SHADER, DependencyFlag::NONE, 1, &barrier, 0, nullptr, 0, nullptr);
+        }
+
+        pCommandBuffer->end();
+
+        auto pFence = _device->acquireFence();
+
+        try {
+            _info.queueFamily->getQueue(0)->submit(pCommandBuffer, pFence);
+            pFence->waitFor();
+            pFence->reset();
+        } catch (...) {
+            pFence->release();
+            throw;
+        }
+
+        pFence->release();
+
+        auto timestamps = std::vector<std::uint64_t> (queryCount);
+
+        pQueryPool->getResults(0, queryCount, timestamps.data(), true);
+
+        auto samples = std::vector<double> ();
+        samples.reserve(_info.runs);
+
+        for (std::uint32_t run = 0; run < _info.runs; run++) {
+            const auto ticks = (timestamps[2 * run + 1] - timestamps[2 * run]) & _timestampMask;
+
+            samples.push_back(static_cast<double> (ticks) * _timestampPeriod * 1E-6);
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        return samples[samples.size() / 2];
+    }
+
+    WorkgroupTuner::Result WorkgroupTuner::tune(const ComputePipeline::CreateInfo& createInfo, const RecordFunction& recordFunction) {
+        const auto key = getKey(createInfo);
+        auto it = _table.find(key);
+
+        if (_table.end() != it) {
+            auto result = Result {};
+            result.workgroupSize = it->second.workgroupSize;
+            result.milliseconds = it->second.milliseconds;
+            result.cached = true;
+
+            return result;
+        }
+
+        const auto& limits = _device->getPhysicalDevice()->getProperties().limits;
+        auto best = TableEntry {};
+        bool found = false;
+
+        for (auto candidate : _info.candidates) {
+            if (0 == candidate || candidate > limits.maxComputeWorkGroupSize[0] || candidate > limits.maxComputeWorkGroupInvocations) {
+                continue;
+            }
+
+            auto pPipeline = ComputePipeline::unique_null();
+
+            try {
+                pPipeline = _device->createPipeline(specialize(createInfo, candidate));
+            } catch (const std::exception&) {
+                // a candidate may exceed the shared memory or register limits of the kernel
+                continue;
+            }
+
+            const auto milliseconds = time(pPipeline.get(), candidate, recordFunction);
+
+            if (!found || milliseconds < best.milliseconds) {
+                best.workgroupSize = candidate;
+                best.milliseconds = milliseconds;
+                found = true;
+            }
+        }
+
+        if (!found) {
+            throw std::runtime_error("No workgroup size candidate could be timed!");
+        }
+
+        _table[key] = best;
+
+        save();
+
+        auto result = Result {};
+        result.workgroupSize = best.workgroupSize;
+        result.milliseconds = best.milliseconds;
+        result.cached = false;
+
+        return result;
+    }
+
+    std::uint32_t WorkgroupTuner::lookup(const ComputePipeline::CreateInfo& createInfo, std::uint32_t defaultSize) const {
+        auto it = _table.find(getKey(createInfo));
+
+        return (_table.end() == it) ? defaultSize : it->second.workgroupSize;
+    }
+
+    // The table has one entry per line: vendorID deviceID driverVersion workgroupSize milliseconds kernel.
+    // Entries of other devices are kept, so a single file can be shared between machines.
+    void WorkgroupTuner::load() {
+        if (_info.path.empty()) {
+            return;
+        }
+
+        std::ifstream file(_info.path);
+
+        if (!file) {
+            return;
+        }
+
+        auto line = std::string();
+
+        while (std::getline(file, line)) {
+            auto stream = std::stringstream(line);
+            std::uint32_t vendorID, deviceID, driverVersion;
+            auto entry = TableEntry {};
+            auto kernel = std::string();
+
+            // the kernel is the rest of the line, since shader paths may contain spaces
+            if (!(stream >> vendorID >> deviceID >> driverVersion >> entry.workgroupSize >> entry.milliseconds) || !std::getline(stream >> std::ws, kernel)) {
+                continue;
+            }
+
+            _table[TableKey(vendorID, deviceID, driverVersion, kernel)] = entry;
+        }
+    }
+
+    void WorkgroupTuner::save() const {
+        if (_info.path.empty()) {
+            return;
+        }
+
+        std::ofstream file(_info.path);
+
+        if (!file) {
+            throw std::runtime_error("Unable to open workgroup tuning file: " + _info.path);
+        }
+
+        file << std::setprecision(6);
+
+        for (const auto& entry : _table) {
+            file << std::get<0> (entry.first) << " " << std::get<1> (entry.first) << " " << std::get<2> (entry.first)
+                << " " << entry.second.workgroupSize << " " << entry.second.milliseconds
+                << " " << std::get<3> (entry.first) << "\n";
+        }
+    }
+}
@@ -34,7 +34,8 @@ namespace mvk {
         HOST_READ = VK_ACCESS_HOST_READ_BIT,                                            /*!< Read access by a host operation. */
         HOST_WRITE = VK_ACCESS_HOST_WRITE_BIT,                                          /*!< Write access by a host operation. */
         MEMORY_READ = VK_ACCESS_MEMORY_READ_BIT,                                        /*!< Read access to entities external of Vulkan. */
-        MEMORY_WRITE = VK_ACCESS_MEMORY_WRITE_BIT                                       /*!< Write access to entities external to Vulkan. */
+        MEMORY_WRITE = VK_ACCESS_MEMORY_WRITE_BIT,                                      /*!< Write access to entities external to Vulkan. */
+        CONDITIONAL_RENDERING_READ = VK_ACCESS_CONDITIONAL_RENDERING_READ_BIT_EXT       /*!< Read access to a predicate as part of conditional rendering. Requires VK_EXT_conditional_rendering. */
     };
 
     inline constexpr AccessFlag operator| (AccessFlag lhs, AccessFlag rhs) noexcept {
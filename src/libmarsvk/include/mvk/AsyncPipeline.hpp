@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace mvk {
+    class ComputePipeline;
+    class GraphicsPipeline;
+
+    template<class PipelineT>
+    class AsyncPipeline;
+
+    //! A shared-ptr wrapper for a ComputePipeline that is compiled in the background.
+    using SPtrAsyncComputePipeline = std::shared_ptr<AsyncPipeline<ComputePipeline>>;
+
+    //! A shared-ptr wrapper for a GraphicsPipeline that is compiled in the background.
+    using SPtrAsyncGraphicsPipeline = std::shared_ptr<AsyncPipeline<GraphicsPipeline>>;
+
+    //! A pipeline that becomes ready once it has been compiled in the background.
+    /*!
+        AsyncPipelines are returned by Device::createPipelineAsync. Until the PipelineCompiler finishes, get
+        returns nullptr; the render thread can then skip the draw or bind a fallback pipeline instead of
+        stalling on the compilation. Checking readiness is a single atomic load.
+    */
+    template<class PipelineT>
+    class AsyncPipeline {
+        mutable std::mutex _lock;
+        mutable std::condition_variable _finishedCondition;
+        std::unique_ptr<PipelineT> _pipeline;
+        std::exception_ptr _error;
+        std::atomic<PipelineT * > _ready;
+        std::atomic<bool> _finished;
+
+        AsyncPipeline(const AsyncPipeline&) = delete;
+        AsyncPipeline& operator= (const AsyncPipeline&) = delete;
+
+    public:
+        //! Constructs an AsyncPipeline that is not ready.
+        AsyncPipeline() noexcept:
+            _ready(nullptr),
+            _finished(false) {}
+
+        //! Stores the result of the compilation and wakes any waiting thread. This is called by the PipelineCompiler.
+        /*!
+            \param pipeline is the compiled pipeline, or nullptr if the compilation failed.
+            \param error is the exception thrown by the compilation, if any.
+        */
+        void complete(std::unique_ptr<PipelineT> pipeline, std::exception_ptr error) noexcept {
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+
+                _pipeline = std::move(pipeline);
+                _error = error;
+                _ready.store(_pipeline.get(), std::memory_order_release);
+                _finished.store(true, std::memory_order_release);
+            }
+
+            _finishedCondition.notify_all();
+        }
+
+        //! Checks if the pipeline was compiled and can be bound.
+        /*!
+            \return true if the pipeline is ready.
+        */
+        inline bool isReady() const noexcept {
+            return nullptr != _ready.load(std::memory_order_acquire);
+        }
+
+        //! Checks if the compilation has finished, whether or not it succeeded.
+        /*!
+            \return true if the compilation has finished.
+        */
+        inline bool isFinished() const noexcept {
+            return _finished.load(std::memory_order_acquire);
+        }
+
+        //! Checks if the compilation failed. The error is thrown by wait.
+        /*!
+            \return true if the compilation finished without a pipeline.
+        */
+        inline bool isFailed() const noexcept {
+            return isFinished() && !isReady();
+        }
+
+        //! Retrieves the pipeline without blocking.
+        /*!
+            \return the pipeline, or nullptr if it is not ready.
+        */
+        inline PipelineT * get() const noexcept {
+            return _ready.load(std::memory_order_acquire);
+        }
+
+        //! Retrieves the pipeline or a substitute without blocking.
+        /*!
+            \param fallback is the pipeline to use until this one is ready.
+            \return the pipeline if it is ready, otherwise fallback.
+        */
+        inline PipelineT * getOr(PipelineT * fallback) const noexcept {
+            auto out = get();
+
+            return (nullptr != out) ? out : fallback;
+        }
+
+        //! Blocks until the compilation has finished.
+        /*!
+            Any exception thrown by the compilation is rethrown here.
+
+            \return the pipeline.
+        */
+        PipelineT * wait() const {
+            std::unique_lock<std::mutex> lock(_lock);
+
+            _finishedCondition.wait(lock, [this] { return _finished.load(std::memory_order_acquire); });
+
+            if (_error) {
+                std::rethrow_exception(_error);
+            }
+
+            return _pipeline.get();
+        }
+    };
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 
 #include "volk.h"
 #include "vk_mem_alloc.h"
@@ -8,6 +9,7 @@
 #include <functional>
 #include <memory>
 #include <set>
+#include <string>
 #include <utility>
 
 #include "mvk/BufferUsageFlag.hpp"
@@ -40,6 +42,7 @@ namespace mvk {
             SharingMode sharingMode;                    /*!< Sharing limitations for the Buffer. */
             std::set<QueueFamily * > queueFamilies;     /*!< Set of QueueFamily objects that can use the Buffer. */
             bool exported;                              /*!< Specifies if the memory should be exported. */         
+            std::string name;                           /*!< Optional name shown by debuggers and profilers. Only used if VK_EXT_debug_utils is enabled. */
         };
 
         //! Constant used when referring to the entire length of a Buffer.
@@ -56,7 +59,9 @@ namespace mvk {
     private:
         Device * _device;
         VkBuffer _handle;
+        std::uint64_t _serial;
         CreateInfo _info;
+        MemoryUsage _memoryUsage;
 
         union {
             VmaAllocation local;
@@ -80,7 +85,8 @@ namespace mvk {
          */
         Buffer() noexcept:
             _device(nullptr),
-            _handle(VK_NULL_HANDLE) {}
+            _handle(VK_NULL_HANDLE),
+            _serial(0) {}
 
         //! Constructs a new Buffer.
         /*!
@@ -118,6 +124,16 @@ namespace mvk {
             return _handle;
         }
 
+        //! Retrieves the serial number of the Buffer.
+        /*!
+            Unlike the Vulkan handle, the serial number is never reused by a Buffer created after this one is destroyed.
+
+            \return the serial number, or 0 for a null Buffer.
+         */
+        inline std::uint64_t getSerial() const noexcept {
+            return _serial;
+        }
+
         //! Retrieves the parent Vulkan Device.
         /*!
             \return the device.
@@ -134,6 +150,14 @@ namespace mvk {
             return _info;
         }
 
+        //! Retrieves the MemoryUsage the Buffer was allocated with.
+        /*!
+            \return the MemoryUsage.
+         */
+        inline MemoryUsage getMemoryUsage() const noexcept {
+            return _memoryUsage;
+        }
+
         //! Maps the Memory object used by this Buffer and returns the memory pointer.
         /*!
             \return the mapped memory pointer.
@@ -143,6 +167,15 @@ namespace mvk {
         //! Unmaps the Memory object used by this Buffer.
         void unmap() noexcept;
 
+        //! Flushes a range of mapped memory so that host writes become visible to the Device.
+        /*!
+            This is only required for memory that is not host-coherent; on coherent memory it is a no-op.
+
+            \param offset is the offset into the Buffer, in bytes.
+            \param size is the size of the range, in bytes. WHOLE_SIZE flushes to the end of the Buffer.
+         */
+        void flush(VkDeviceSize offset = 0, VkDeviceSize size = WHOLE_SIZE) noexcept;
+
         //! Temporarily maps the Memory object and applies a function to it while its mapped.
         /*!
             \param fn the function to apply to the Memory.
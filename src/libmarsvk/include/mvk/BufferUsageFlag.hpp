@@ -16,7 +16,8 @@ namespace mvk {
         STORAGE_BUFFER = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,                /*!< Specifies that the Buffer can be bound as a Storage Buffer. */
         INDEX_BUFFER = VK_BUFFER_USAGE_INDEX_BUFFER_BIT,                    /*!< Specifies that the Buffer can be bound as an Index Buffer for draw operations. */
         VERTEX_BUFFER = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,                  /*!< Specifies that the Buffer can be bound as a Vertex Buffer for draw operations. */
-        INDIRECT_BUFFER = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT               /*!< Specifies that the Buffer can be bound as an Indirect Command Buffer for draw or compute operations. */
+        INDIRECT_BUFFER = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,              /*!< Specifies that the Buffer can be bound as an Indirect Command Buffer for draw or compute operations. */
+        CONDITIONAL_RENDERING = VK_BUFFER_USAGE_CONDITIONAL_RENDERING_BIT_EXT /*!< Specifies that the Buffer can be used as the predicate of conditional rendering. Requires VK_EXT_conditional_rendering. */
     };
 
     inline constexpr BufferUsageFlag operator| (BufferUsageFlag lhs, BufferUsageFlag rhs) noexcept {
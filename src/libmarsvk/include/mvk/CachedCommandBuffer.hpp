@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "volk.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "mvk/CommandBuffer.hpp"
+#include "mvk/CommandBufferUsageFlag.hpp"
+
+namespace mvk {
+    class Buffer;
+    class CommandPool;
+    class DescriptorSet;
+    class Framebuffer;
+    class Pipeline;
+    class Swapchain;
+
+    class CachedCommandBuffer;
+
+    using UPtrCachedCommandBuffer = std::unique_ptr<CachedCommandBuffer>;
+
+    //! A CommandBuffer that is recorded once and only re-recorded when the objects it references change.
+    /*!
+        Each tracked object contributes a key built from its serial number (and write count or extent
+        where relevant). Serial numbers are never reused, so a destroyed and recreated object is always detected. A snapshot of the keys is taken when the CommandBuffer is recorded;
+        if any key differs on the next request the CommandBuffer is considered stale and is recorded again.
+
+        Objects tracked by raw pointer must outlive the CachedCommandBuffer. Objects that are replaced
+        wholesale should be tracked by their owning unique_ptr so that recreation is detected.
+
+        Re-recording resets the CommandBuffer; the caller must ensure no pending submission still uses it.
+     */
+    class CachedCommandBuffer {
+    public:
+        //! Function that records the command sequence.
+        using RecordFunction = std::function<void(CommandBuffer * commandBuffer)>;
+
+        //! Constructs a CachedCommandBuffer-typed unique_ptr pointing to null.
+        /*!
+            \return unique_ptr<CachedCommandBuffer> pointing to nullptr.
+         */
+        static inline UPtrCachedCommandBuffer unique_null() {
+            return std::unique_ptr<CachedCommandBuffer> ();
+        }
+
+    private:
+        struct Dependency {
+            std::function<std::uint64_t()> key;
+            std::uint64_t recordedKey;
+        };
+
+        UPtrCommandBuffer _commandBuffer;
+        CommandBufferUsageFlag _flags;
+        RecordFunction _recordFunction;
+        std::vector<Dependency> _dependencies;
+        bool _invalidated;
+        std::size_t _recordCount;
+
+        CachedCommandBuffer(const CachedCommandBuffer&) = delete;
+        CachedCommandBuffer& operator= (const CachedCommandBuffer&) = delete;
+
+        void track(std::function<std::uint64_t()> key);
+
+    public:
+        //! Constructs a new CachedCommandBuffer.
+        /*!
+            The CommandBuffer is not recorded until it is first requested.
+
+            \param pool is the CommandPool to allocate the primary CommandBuffer from.
+            \param flags is the usage behavior used each time the CommandBuffer is recorded.
+            \param recordFunction is the function that records the command sequence.
+         */
+        CachedCommandBuffer(CommandPool * pool, CommandBufferUsageFlag flags, RecordFunction recordFunction);
+
+        //! Deletes the CachedCommandBuffer and releases the CommandBuffer.
+        ~CachedCommandBuffer() noexcept = default;
+
+        //! Tracks a Buffer referenced by the recording.
+        void track(const Buffer * buffer);
+
+        //! Tracks a Pipeline referenced by the recording.
+        void track(const Pipeline * pipeline);
+
+        //! Tracks a Framebuffer referenced by the recording.
+        void track(const Framebuffer * framebuffer);
+
+        //! Tracks a DescriptorSet referenced by the recording. Descriptor writes also mark the recording as stale.
+        void track(const DescriptorSet * descriptorSet);
+
+        //! Tracks a Swapchain referenced by the recording. Swapchain::resize marks the recording as stale.
+        void track(const Swapchain * swapchain);
+
+        //! Tracks an object through its owning unique_ptr.
+        /*!
+            Replacing the object held by the unique_ptr marks the recording as stale.
+
+            \param object is the unique_ptr that owns the object. It must outlive the CachedCommandBuffer.
+         */
+        template<class T>
+        inline void track(const std::unique_ptr<T>& object) {
+            track([&object] () -> std::uint64_t {
+                auto pObject = object.get();
+
+                return (nullptr == pObject) ? 0 : keyOf(pObject);
+            });
+        }
+
+        //! Computes the key of a tracked object.
+        static std::uint64_t keyOf(const Buffer * buffer) noexcept;
+
+        static std::uint64_t keyOf(const Pipeline * pipeline) noexcept;
+
+        static std::uint64_t keyOf(const Framebuffer * framebuffer) noexcept;
+
+        static std::uint64_t keyOf(const DescriptorSet * descriptorSet) noexcept;
+
+        static std::uint64_t keyOf(const Swapchain * swapchain) noexcept;
+
+        //! Explicitly marks the recording as stale.
+        inline void invalidate() noexcept {
+            _invalidated = true;
+        }
+
+        //! Checks if the recording no longer matches the tracked objects.
+        /*!
+            \return true if the CommandBuffer must be recorded before it is used.
+         */
+        bool isStale() const;
+
+        //! Retrieves the number of times the CommandBuffer has been recorded.
+        /*!
+            \return the record count.
+         */
+        inline std::size_t getRecordCount() const noexcept {
+            return _recordCount;
+        }
+
+        //! Retrieves the CommandBuffer, recording it first if it is stale.
+        /*!
+            \return the CommandBuffer.
+         */
+        CommandBuffer * getCommandBuffer();
+    };
+}
@@ -1,12 +1,18 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include "volk.h"
 
+#include <array>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "mvk/AccessFlag.hpp"
+#include "mvk/AsyncPipeline.hpp"
 #include "mvk/BufferMemoryBarrier.hpp"
 #include "mvk/ClearValue.hpp"
 #include "mvk/CommandBufferUsageFlag.hpp"
@@ -21,6 +27,7 @@
 #include "mvk/IndexType.hpp"
 #include "mvk/MemoryBarrier.hpp"
 #include "mvk/PipelineStageFlag.hpp"
+#include "mvk/QueryResultFlag.hpp"
 #include "mvk/Offset2D.hpp"
 #include "mvk/Offset3D.hpp"
 #include "mvk/Rect2D.hpp"
@@ -36,6 +43,7 @@ namespace mvk {
     class Framebuffer;
     class Image;
     class Pipeline;
+    class QueryPool;
     class RenderPass;
 
     class CommandBuffer;
@@ -52,14 +60,74 @@ namespace mvk {
         See: <a href="https://www.khronos.org/registry/vulkan/specs/1.1-extensions/man/html/VkCommandBuffer.html">VkCommandBuffer</a>
     */
     class CommandBuffer {
+        static constexpr std::size_t MAX_SHADOW_SETS = 8;
+        static constexpr std::size_t MAX_SHADOW_BINDINGS = 16;
+        static constexpr std::size_t MAX_SHADOW_BIND_POINTS = 2;
+
+        // Last state sent to the driver; used to drop redundant binds.
+        struct ShadowState {
+            VkPipeline pipelines[MAX_SHADOW_BIND_POINTS];
+            VkPipelineLayout layouts[MAX_SHADOW_BIND_POINTS];
+            VkDescriptorSet descriptorSets[MAX_SHADOW_BIND_POINTS][MAX_SHADOW_SETS];
+            VkBuffer vertexBuffers[MAX_SHADOW_BINDINGS];
+            VkDeviceSize vertexOffsets[MAX_SHADOW_BINDINGS];
+            VkBuffer indexBuffer;
+            VkDeviceSize indexOffset;
+            VkIndexType indexType;
+            bool hasViewport;
+            VkViewport viewport;
+            bool hasScissor;
+            VkRect2D scissor;
+
+            // consecutive descriptor set binds waiting to be merged into a single call.
+            VkPipelineBindPoint pendingBindPoint;
+            VkPipelineLayout pendingLayout;
+            std::uint32_t pendingFirstSet;
+            std::vector<VkDescriptorSet> pendingSets;
+            std::vector<std::uint32_t> pendingDynamicOffsets;
+
+            std::size_t redundantCalls;
+        };
+
         CommandPool * _pool;
         CommandBufferLevel _level;
         VkCommandBuffer _handle;
+        std::unique_ptr<ShadowState> _shadowState;
+        std::int64_t _recordStart;
 
         CommandBuffer(const CommandBuffer&) = delete;
         CommandBuffer& operator=(const CommandBuffer&) = delete;
 
+        void clearShadowState() noexcept;
+
+        void flushDescriptorSets() noexcept;
+
+        void bindDescriptorSets(VkPipelineBindPoint bindPoint, VkPipelineLayout layout, std::uint32_t firstSet, VkDescriptorSet set, std::size_t nDynamicOffsets, const std::uint32_t * pDynamicOffsets) noexcept;
+
     public:
+        //! Ends a debug label region when it goes out of scope.
+        class Label {
+            CommandBuffer * _commandBuffer;
+
+            Label(const Label&) = delete;
+            Label& operator= (const Label&) = delete;
+
+            Label(CommandBuffer * commandBuffer) noexcept:
+                _commandBuffer(commandBuffer) {}
+
+            friend class CommandBuffer;
+
+        public:
+            Label(Label&& from) noexcept:
+                _commandBuffer(std::exchange(from._commandBuffer, nullptr)) {}
+
+            ~Label() noexcept {
+                if (nullptr != _commandBuffer) {
+                    _commandBuffer->endLabel();
+                }
+            }
+        };
+
         //! Constructs a CommandBuffer typed unique_ptr pointing to nothing.
         /*!
             \return the CommandBuffer-typed unique_ptr pointing to nullptr.
@@ -71,7 +139,8 @@ namespace mvk {
         //! Constructs a CommandBuffer holding nothing.
         CommandBuffer() noexcept:
             _pool(nullptr),
-            _handle(VK_NULL_HANDLE) {}
+            _handle(VK_NULL_HANDLE),
+            _recordStart(0) {}
 
         //! Constructs a new CommandBuffer.
         /*!
@@ -82,7 +151,8 @@ namespace mvk {
         CommandBuffer(CommandPool * pool, CommandBufferLevel level, VkCommandBuffer handle) noexcept:
             _pool(pool),
             _level(level),
-            _handle(handle) {}
+            _handle(handle),
+            _recordStart(0) {}
 
         //! Move-constructs the CommandBuffer.
         /*!
@@ -91,7 +161,9 @@ namespace mvk {
         CommandBuffer(CommandBuffer&& from) noexcept:
             _pool(std::move(from._pool)),
             _level(std::move(from._level)),
-            _handle(std::exchange(from._handle, nullptr)) {}
+            _handle(std::exchange(from._handle, nullptr)),
+            _shadowState(std::move(from._shadowState)),
+            _recordStart(std::move(from._recordStart)) {}
 
         //! Move-assigns the CommandBuffer.
         /*!
@@ -140,6 +212,32 @@ namespace mvk {
             return _level;
         }
 
+        //! Enables or disables shadow state tracking.
+        /*!
+            While enabled, the CommandBuffer remembers the bound Pipeline, DescriptorSets, vertex and index Buffers,
+            viewport and scissor. Binds that repeat the current state are dropped and consecutive DescriptorSet binds
+            are merged into a single vkCmdBindDescriptorSets. The state is forgotten on begin and executeCommands.
+
+            \param enabled is true to enable shadow state tracking.
+        */
+        void setShadowStateEnabled(bool enabled);
+
+        //! Checks if shadow state tracking is enabled.
+        /*!
+            \return true if shadow state tracking is enabled.
+        */
+        inline bool isShadowStateEnabled() const noexcept {
+            return nullptr != _shadowState;
+        }
+
+        //! Retrieves the number of calls dropped or merged by shadow state tracking since it was enabled.
+        /*!
+            \return the number of redundant calls.
+        */
+        inline std::size_t getRedundantCallCount() const noexcept {
+            return _shadowState ? _shadowState->redundantCalls : 0;
+        }
+
         void beginRenderPass(const Framebuffer * framebuffer, SubpassContents contents = SubpassContents::INLINE) noexcept;
 
         inline void beginRenderPass(const std::unique_ptr<Framebuffer>& framebuffer, SubpassContents contents = SubpassContents::INLINE) noexcept {
@@ -198,6 +296,44 @@ namespace mvk {
 
         void begin(CommandBufferUsageFlag flags);
 
+        //! Begins recording a secondary CommandBuffer that will execute entirely inside a RenderPass.
+        /*!
+            RENDER_PASS_CONTINUE is implied.
+
+            \param flags is the usage behavior of the CommandBuffer.
+            \param renderPass is the RenderPass the CommandBuffer will be compatible with.
+            \param subpass is the index of the subpass the CommandBuffer will be executed within.
+            \param framebuffer is the Framebuffer the CommandBuffer will render to. This may be null if it is not known.
+        */
+        void begin(CommandBufferUsageFlag flags, const RenderPass * renderPass, int subpass, const Framebuffer * framebuffer = nullptr);
+
+        //! Begins recording a secondary CommandBuffer that will execute entirely inside a RenderPass.
+        /*!
+            This function retrieves the RenderPass from the Framebuffer and chains the RenderPass variant.
+        */
+        void begin(CommandBufferUsageFlag flags, const Framebuffer * framebuffer, int subpass = 0);
+
+        //! Records the execution of secondary CommandBuffers.
+        /*!
+            See: <a href="https://www.khronos.org/registry/vulkan/specs/1.1-extensions/man/html/vkCmdExecuteCommands.html">vkCmdExecuteCommands</a>
+
+            \param commandBufferCount is the number of secondary CommandBuffers.
+            \param pCommandBuffers is the array of secondary CommandBuffers.
+        */
+        void executeCommands(std::size_t commandBufferCount, const CommandBuffer * const * pCommandBuffers) noexcept;
+
+        inline void executeCommands(const CommandBuffer * commandBuffer) noexcept {
+            executeCommands(1, &commandBuffer);
+        }
+
+        inline void executeCommands(const std::unique_ptr<CommandBuffer>& commandBuffer) noexcept {
+            executeCommands(commandBuffer.get());
+        }
+
+        inline void executeCommands(const std::vector<const CommandBuffer *>& commandBuffers) noexcept {
+            executeCommands(commandBuffers.size(), commandBuffers.data());
+        }
+
         void bindDescriptorSet(const Pipeline * pipeline, int set, const DescriptorSet * descriptorSet) noexcept;
 
         template<class PipelineT>
@@ -219,6 +355,26 @@ namespace mvk {
             bindPipeline(pipeline.get());
         }
 
+        //! Binds a pipeline created by Device::createPipelineAsync, or a fallback until it is ready.
+        /*!
+            \param pipeline is the AsyncPipeline.
+            \param fallback is the pipeline bound while the AsyncPipeline is not ready. It may be nullptr.
+            \return false if nothing was bound; the caller should skip the work that depends on the pipeline.
+        */
+        template<class PipelineT>
+        inline bool bindPipeline(const std::shared_ptr<AsyncPipeline<PipelineT>>& pipeline, const PipelineT * fallback = nullptr) noexcept {
+            const PipelineT * ready = pipeline->get();
+            const PipelineT * bound = (nullptr != ready) ? ready : fallback;
+
+            if (nullptr == bound) {
+                return false;
+            }
+
+            bindPipeline(bound);
+
+            return true;
+        }
+
         void dispatch(unsigned int groupsX, unsigned int groupsY = 1, unsigned int groupsZ = 1) noexcept;
 
         void dispatchIndirect(const Buffer * buffer, std::ptrdiff_t offset) noexcept;
@@ -263,6 +419,21 @@ namespace mvk {
             copyBufferToImage(src.get(), bufferOffset, dst.get(), layout, subresourceRange, offset, extent);
         }
 
+        void copyImageToBuffer(
+            const Image * src, ImageLayout layout,
+            const ImageSubresourceLayers& subresourceRange,
+            const Offset3D& offset, const Extent3D& extent,
+            const Buffer * dst, std::ptrdiff_t bufferOffset) noexcept;
+
+        inline void copyImageToBuffer(
+            const std::unique_ptr<Image>& src, ImageLayout layout,
+            const ImageSubresourceLayers& subresourceRange,
+            const Offset3D& offset, const Extent3D& extent,
+            const std::unique_ptr<Buffer>& dst, std::ptrdiff_t bufferOffset) noexcept {
+
+            copyImageToBuffer(src.get(), layout, subresourceRange, offset, extent, dst.get(), bufferOffset);
+        }
+
         void copyImage(
             const Image * src, ImageLayout srcLayout,
             const Image * dst, ImageLayout dstLayout,
@@ -370,5 +541,111 @@ namespace mvk {
                 bufferMemoryBarriers.size(), bufferMemoryBarriers.data(), 
                 imageMemoryBarriers.size(), imageMemoryBarriers.data());
         }
+
+        //! Resets a range of queries to the unavailable state. Must be recorded outside of a RenderPass.
+        void resetQueryPool(const QueryPool * queryPool, std::uint32_t firstQuery, std::uint32_t queryCount) noexcept;
+
+        inline void resetQueryPool(const std::unique_ptr<QueryPool>& queryPool, std::uint32_t firstQuery, std::uint32_t queryCount) noexcept {
+            resetQueryPool(queryPool.get(), firstQuery, queryCount);
+        }
+
+        //! Begins an occlusion or pipeline statistics query.
+        /*!
+            \param queryPool is the QueryPool that manages the query.
+            \param query is the index of the query.
+            \param precise requests an exact sample count from an occlusion query. Requires the occlusionQueryPrecise feature.
+        */
+        void beginQuery(const QueryPool * queryPool, std::uint32_t query, bool precise = false) noexcept;
+
+        inline void beginQuery(const std::unique_ptr<QueryPool>& queryPool, std::uint32_t query, bool precise = false) noexcept {
+            beginQuery(queryPool.get(), query, precise);
+        }
+
+        //! Ends an occlusion or pipeline statistics query.
+        void endQuery(const QueryPool * queryPool, std::uint32_t query) noexcept;
+
+        inline void endQuery(const std::unique_ptr<QueryPool>& queryPool, std::uint32_t query) noexcept {
+            endQuery(queryPool.get(), query);
+        }
+
+        //! Writes a timestamp once all previous commands have completed the pipeline stage.
+        /*!
+            \param stage is the pipeline stage to wait for.
+            \param queryPool is the QueryPool that manages the timestamp query.
+            \param query is the index of the query.
+        */
+        void writeTimestamp(PipelineStageFlag stage, const QueryPool * queryPool, std::uint32_t query) noexcept;
+
+        inline void writeTimestamp(PipelineStageFlag stage, const std::unique_ptr<QueryPool>& queryPool, std::uint32_t query) noexcept {
+            writeTimestamp(stage, queryPool.get(), query);
+        }
+
+        //! Copies the results of a range of queries into a Buffer.
+        /*!
+            \param queryPool is the QueryPool that manages the queries.
+            \param firstQuery is the index of the first query.
+            \param queryCount is the number of queries.
+            \param dst is the Buffer to write the results into.
+            \param dstOffset is the offset into the Buffer, in bytes.
+            \param stride is the distance between the results of consecutive queries, in bytes.
+            \param flags specifies how and when the results are written.
+        */
+        void copyQueryPoolResults(
+            const QueryPool * queryPool, std::uint32_t firstQuery, std::uint32_t queryCount,
+            const Buffer * dst, std::ptrdiff_t dstOffset, std::size_t stride,
+            QueryResultFlag flags) noexcept;
+
+        //! Fills a range of a Buffer with a repeated 32bit value. Must be recorded outside of a RenderPass.
+        void fillBuffer(const Buffer * dst, std::ptrdiff_t dstOffset, std::size_t size, std::uint32_t data) noexcept;
+
+        inline void fillBuffer(const std::unique_ptr<Buffer>& dst, std::ptrdiff_t dstOffset, std::size_t size, std::uint32_t data) noexcept {
+            fillBuffer(dst.get(), dstOffset, size, data);
+        }
+
+        //! Begins a conditional rendering block. Requires VK_EXT_conditional_rendering.
+        /*!
+            Draws and dispatches inside the block are discarded if the 32bit predicate is zero.
+
+            \param buffer is the Buffer holding the predicate. It must be created with BufferUsageFlag::CONDITIONAL_RENDERING.
+            \param offset is the offset of the predicate, in bytes. It must be a multiple of 4.
+            \param inverted discards the commands if the predicate is non-zero instead.
+        */
+        void beginConditionalRendering(const Buffer * buffer, std::ptrdiff_t offset, bool inverted = false) noexcept;
+
+        //! Ends the current conditional rendering block.
+        void endConditionalRendering() noexcept;
+
+        //! Begins a named region shown by debuggers and profilers.
+        /*!
+            This records nothing if VK_EXT_debug_utils is not enabled.
+
+            \param name is the name of the region.
+            \param color is the RGBA color of the region. All zeros lets the tool pick.
+        */
+        void beginLabel(const std::string& name, const std::array<float, 4>& color = {}) noexcept;
+
+        //! Ends the most recently begun named region.
+        void endLabel() noexcept;
+
+        //! Inserts a single named marker shown by debuggers and profilers.
+        /*!
+            This records nothing if VK_EXT_debug_utils is not enabled.
+
+            \param name is the name of the marker.
+            \param color is the RGBA color of the marker. All zeros lets the tool pick.
+        */
+        void insertLabel(const std::string& name, const std::array<float, 4>& color = {}) noexcept;
+
+        //! Begins a named region that ends when the returned object is destroyed.
+        /*!
+            \param name is the name of the region.
+            \param color is the RGBA color of the region.
+            \return the Label.
+        */
+        inline Label label(const std::string& name, const std::array<float, 4>& color = {}) noexcept {
+            beginLabel(name, color);
+
+            return Label(this);
+        }
     };
 }
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <memory>
+#include <vector>
+
+#include "mvk/AccessFlag.hpp"
+#include "mvk/BufferMemoryBarrier.hpp"
+#include "mvk/DependencyFlag.hpp"
+#include "mvk/Filter.hpp"
+#include "mvk/ImageLayout.hpp"
+#include "mvk/ImageMemoryBarrier.hpp"
+#include "mvk/ImageSubresourceLayers.hpp"
+#include "mvk/IndexType.hpp"
+#include "mvk/Extent3D.hpp"
+#include "mvk/MemoryBarrier.hpp"
+#include "mvk/Offset3D.hpp"
+#include "mvk/PipelineStageFlag.hpp"
+#include "mvk/ShaderStage.hpp"
+#include "mvk/SubpassContents.hpp"
+
+namespace mvk {
+    class Buffer;
+    class CommandBuffer;
+    class DescriptorSet;
+    class Framebuffer;
+    class Image;
+    class ParallelRecorder;
+    class Pipeline;
+
+    class CommandList;
+
+    using UPtrCommandList = std::unique_ptr<CommandList>;
+
+    //! A compact, API-agnostic list of encoded commands.
+    /*!
+        Commands are encoded into a byte stream allocated from an arena of fixed-size blocks. Encoding
+        never calls into Vulkan, so any thread may build a CommandList. The list is later translated
+        into CommandBuffer calls with execute; translation does not modify the list, so the same list
+        may be executed many times and by several threads at once.
+
+        Objects referenced by the commands are stored as pointers and must outlive every execution.
+     */
+    class CommandList {
+    public:
+        //! The encoded command types.
+        enum class Opcode : std::uint16_t {
+            BEGIN_RENDER_PASS,
+            END_RENDER_PASS,
+            NEXT_SUBPASS,
+            SET_VIEWPORT,
+            SET_SCISSOR,
+            BIND_PIPELINE,
+            BIND_DESCRIPTOR_SET,
+            BIND_VERTEX_BUFFER,
+            BIND_INDEX_BUFFER,
+            PUSH_CONSTANTS,
+            DRAW,
+            DRAW_INDEXED,
+            DRAW_INDIRECT,
+            DRAW_INDEXED_INDIRECT,
+            DISPATCH,
+            DISPATCH_INDIRECT,
+            COPY_BUFFER,
+            COPY_BUFFER_TO_IMAGE,
+            COPY_IMAGE,
+            BLIT_IMAGE,
+            STAGE_IMAGE,
+            PIPELINE_BARRIER
+        };
+
+        //! The default size of each arena block, in bytes.
+        static constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+
+        //! Constructs a CommandList-typed unique_ptr pointing to null.
+        /*!
+            \return unique_ptr<CommandList> pointing to nullptr.
+         */
+        static inline UPtrCommandList unique_null() {
+            return std::unique_ptr<CommandList> ();
+        }
+
+    private:
+        struct Header {
+            Opcode opcode;
+            std::uint16_t reserved;
+            std::uint32_t size;
+        };
+
+        struct Block {
+            std::unique_ptr<std::uint8_t[]> data;
+            std::size_t size;
+            std::size_t capacity;
+        };
+
+        std::vector<Block> _blocks;
+        std::size_t _currentBlock;
+        std::size_t _commandCount;
+
+        CommandList(const CommandList&) = delete;
+        CommandList& operator= (const CommandList&) = delete;
+
+        void * push(Opcode opcode, std::size_t payloadSize);
+
+        // invokes fn on each encoded command, in order, until it returns false
+        template<class packet_fn>
+        inline void forEachPacket(packet_fn fn) const {
+            for (std::size_t blockIndex = 0; blockIndex < _blocks.size() && blockIndex <= _currentBlock; blockIndex++) {
+                const auto& block = _blocks[blockIndex];
+                const auto pBegin = block.data.get();
+                const auto pEnd = pBegin + block.size;
+
+                for (auto pPacket = pBegin; pPacket < pEnd; ) {
+                    const auto pHeader = reinterpret_cast<const Header *> (pPacket);
+
+                    if (!fn(pHeader)) {
+                        return;
+                    }
+
+                    pPacket += pHeader->size;
+                }
+            }
+        }
+
+        static void translate(CommandBuffer * commandBuffer, const Header * pHeader);
+
+    public:
+        //! Constructs an empty CommandList. No memory is allocated until the first command is encoded.
+        CommandList() noexcept:
+            _currentBlock(0),
+            _commandCount(0) {}
+
+        //! Move-constructs a CommandList.
+        CommandList(CommandList&&) noexcept = default;
+
+        //! Move-assigns a CommandList.
+        CommandList& operator= (CommandList&&) noexcept = default;
+
+        //! Deletes the CommandList and releases the arena.
+        ~CommandList() noexcept = default;
+
+        //! Clears all encoded commands. The arena is kept for reuse.
+        void reset() noexcept;
+
+        //! Retrieves the number of encoded commands.
+        /*!
+            \return the command count.
+         */
+        inline std::size_t getCommandCount() const noexcept {
+            return _commandCount;
+        }
+
+        //! Retrieves the number of bytes used by the encoded commands.
+        /*!
+            \return the encoded size in bytes.
+         */
+        std::size_t getByteSize() const noexcept;
+
+        //! Translates every encoded command into calls on a CommandBuffer.
+        /*!
+            \param commandBuffer is the CommandBuffer to record into. It must be in the recording state.
+         */
+        void execute(CommandBuffer * commandBuffer) const;
+
+        inline void execute(const std::unique_ptr<CommandBuffer>& commandBuffer) const {
+            execute(commandBuffer.get());
+        }
+
+        //! Translates the encoded commands of a single subpass in parallel.
+        /*!
+            The draws are split into contiguous ranges, one per worker of the ParallelRecorder, and each range is
+            translated into a secondary CommandBuffer that the primary CommandBuffer then executes in order.
+            Secondary CommandBuffers inherit no state, so the viewport, scissor, binding and push constant
+            commands that precede a range are translated again for it. Other commands go to the range of the
+            draw that follows them; a list without draws records nothing. RenderPass commands are not valid in
+            secondary CommandBuffers, so lists that contain them are rejected with std::runtime_error.
+
+            \param recorder is the ParallelRecorder that owns the worker threads.
+            \param primary is the primary CommandBuffer. It must be inside a RenderPass begun with SubpassContents::SECONDARY_COMMAND_BUFFERS.
+            \param framebuffer is the Framebuffer the RenderPass was begun with.
+            \param subpass is the index of the current subpass.
+         */
+        void execute(ParallelRecorder * recorder, CommandBuffer * primary, const Framebuffer * framebuffer, int subpass) const;
+
+        void beginRenderPass(const Framebuffer * framebuffer, SubpassContents contents = SubpassContents::INLINE);
+
+        void endRenderPass();
+
+        void nextSubpass(SubpassContents contents = SubpassContents::INLINE);
+
+        void setViewport(float x, float y, float width, float height, float minDepth, float maxDepth);
+
+        void setScissor(int x, int y, int width, int height);
+
+        void bindPipeline(const Pipeline * pipeline);
+
+        template<class PipelineT>
+        inline void bindPipeline(const std::unique_ptr<PipelineT>& pipeline) {
+            bindPipeline(pipeline.get());
+        }
+
+        void bindDescriptorSet(const Pipeline * pipeline, int set, const DescriptorSet * descriptorSet, std::size_t nDynamicOffsets = 0, const int * pDynamicOffsets = nullptr);
+
+        template<class PipelineT>
+        inline void bindDescriptorSet(const std::unique_ptr<PipelineT>& pipeline, int set, const DescriptorSet * descriptorSet, std::size_t nDynamicOffsets = 0, const int * pDynamicOffsets = nullptr) {
+            bindDescriptorSet(pipeline.get(), set, descriptorSet, nDynamicOffsets, pDynamicOffsets);
+        }
+
+        void bindVertexBuffer(int binding, const Buffer * buffer, std::ptrdiff_t offset = 0);
+
+        inline void bindVertexBuffer(int binding, const std::unique_ptr<Buffer>& buffer, std::ptrdiff_t offset = 0) {
+            bindVertexBuffer(binding, buffer.get(), offset);
+        }
+
+        void bindIndexBuffer(const Buffer * buffer, std::ptrdiff_t offset, IndexType indexType);
+
+        inline void bindIndexBuffer(const std::unique_ptr<Buffer>& buffer, std::ptrdiff_t offset, IndexType indexType) {
+            bindIndexBuffer(buffer.get(), offset, indexType);
+        }
+
+        //! Encodes a push constant update. The data is copied into the CommandList.
+        void pushConstants(const Pipeline * pipeline, ShaderStage stages, std::ptrdiff_t offset, std::size_t size, const void * data);
+
+        template<class PipelineT>
+        inline void pushConstants(const std::unique_ptr<PipelineT>& pipeline, ShaderStage stages, std::ptrdiff_t offset, std::size_t size, const void * data) {
+            pushConstants(pipeline.get(), stages, offset, size, data);
+        }
+
+        void draw(int vertexCount, int instanceCount = 1, int firstVertex = 0, int firstInstance = 0);
+
+        void drawIndexed(int indexCount, int instanceCount = 1, int firstIndex = 0, int vertexOffset = 0, int firstInstance = 0);
+
+        void drawIndirect(const Buffer * buffer, std::ptrdiff_t offset, int drawCount, int stride);
+
+        void drawIndexedIndirect(const Buffer * buffer, std::ptrdiff_t offset, int drawCount, int stride);
+
+        void dispatch(unsigned int groupsX, unsigned int groupsY = 1, unsigned int groupsZ = 1);
+
+        void dispatchIndirect(const Buffer * buffer, std::ptrdiff_t offset);
+
+        void copyBuffer(
+            const Buffer * src, const Buffer * dst,
+            std::ptrdiff_t srcOffset, std::ptrdiff_t dstOffset,
+            std::size_t size);
+
+        void copyBufferToImage(
+            const Buffer * src, std::ptrdiff_t bufferOffset,
+            const Image * dst, ImageLayout layout,
+            const ImageSubresourceLayers& subresourceRange,
+            const Offset3D& offset, const Extent3D& extent);
+
+        void copyImage(
+            const Image * src, ImageLayout srcLayout,
+            const Image * dst, ImageLayout dstLayout,
+            const Offset3D& srcOffset, const Offset3D& dstOffset, const Extent3D& extent,
+            const ImageSubresourceLayers& srcSubresource,
+            const ImageSubresourceLayers& dstSubresource);
+
+        void blitImage(
+            const Image * src, ImageLayout srcLayout,
+            const Image * dst, ImageLayout dstLayout,
+            const Offset3D& srcOffset0, const Offset3D& srcOffset1,
+            const Offset3D& dstOffset0, const Offset3D& dstOffset1,
+            const ImageSubresourceLayers& srcSubresource,
+            const ImageSubresourceLayers& dstSubresource,
+            Filter filter = Filter::LINEAR);
+
+        void stageImage(
+            const Image * image,
+            ImageLayout oldLayout, ImageLayout newLayout,
+            PipelineStageFlag srcStageMask, PipelineStageFlag dstStageMask,
+            AccessFlag srcAccess, AccessFlag dstAccess);
+
+        //! Encodes a pipeline barrier. The barrier arrays are copied into the CommandList.
+        void pipelineBarrier(
+            PipelineStageFlag srcStageMask, PipelineStageFlag dstStageMask,
+            DependencyFlag dependencyFlags,
+            std::size_t memoryBarrierCount,
+            const MemoryBarrier * pMemoryBarriers,
+            std::size_t bufferMemoryBarrierCount,
+            const BufferMemoryBarrier * pBufferMemoryBarriers,
+            std::size_t imageMemoryBarrierCount,
+            const ImageMemoryBarrier * pImageMemoryBarriers);
+
+        inline void pipelineBarrier(
+            PipelineStageFlag srcStageMask, PipelineStageFlag dstStageMask,
+            DependencyFlag dependencyFlags,
+            const std::vector<MemoryBarrier>& memoryBarriers,
+            const std::vector<BufferMemoryBarrier>& bufferMemoryBarriers,
+            const std::vector<ImageMemoryBarrier>& imageMemoryBarriers) {
+
+            pipelineBarrier(
+                srcStageMask, dstStageMask,
+                dependencyFlags,
+                memoryBarriers.size(), memoryBarriers.data(),
+                bufferMemoryBarriers.size(), bufferMemoryBarriers.data(),
+                imageMemoryBarriers.size(), imageMemoryBarriers.data());
+        }
+    };
+}
@@ -5,6 +5,7 @@
 #include <memory>
 #include <utility>
 
+#include "mvk/CachedCommandBuffer.hpp"
 #include "mvk/CommandBuffer.hpp"
 #include "mvk/CommandBufferLevel.hpp"
 #include "mvk/CommandPoolCreateFlag.hpp"
@@ -119,6 +120,16 @@ namespace mvk {
             \param level is the level of the CommandBuffer.
             \return unique_ptr pointing to the newly allocated CommandBuffer.
         */
-        UPtrCommandBuffer allocate(CommandBufferLevel level = CommandBufferLevel::PRIMARY);        
+        UPtrCommandBuffer allocate(CommandBufferLevel level = CommandBufferLevel::PRIMARY);
+
+        //! Allocates a CachedCommandBuffer
+        /*!
+            \param flags is the usage behavior used each time the CommandBuffer is recorded.
+            \param recordFunction is the function that records the command sequence.
+            \return unique_ptr pointing to the newly allocated CachedCommandBuffer.
+        */
+        inline UPtrCachedCommandBuffer allocateCached(CommandBufferUsageFlag flags, CachedCommandBuffer::RecordFunction recordFunction) {
+            return std::make_unique<CachedCommandBuffer> (this, flags, std::move(recordFunction));
+        }
     };
 }
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "volk.h"
 
@@ -21,6 +24,9 @@ namespace mvk {
     //! A unique-ptr wrapper for a ComputePipeline object.
     using UPtrComputePipeline = std::unique_ptr<ComputePipeline>;
 
+    //! A shared-ptr wrapper for a ComputePipeline object.
+    using SPtrComputePipeline = std::shared_ptr<ComputePipeline>;
+
     //! A Pipeline object for Compute operations.
     /*!
         ComputePipelines consist of a single static compute shader stage and the pipeline layout.
@@ -34,6 +40,7 @@ namespace mvk {
             unsigned int flags;                     /*!< Additional construction parameters. */
             PipelineShaderStageCreateInfo stage;    /*!< The stage describing the compute shader. */
             PipelineLayout::CreateInfo layoutInfo;  /*!< The PipelineLayout descriptor struct. */
+            std::string name;                       /*!< Optional name shown by debuggers and profilers. Only used if VK_EXT_debug_utils is enabled. */
         };
 
         //! Constructs a ComputePipeline-typed unique_ptr pointing to null.
@@ -45,8 +52,22 @@ namespace mvk {
         }
 
     private:
+        //! The Vulkan construction parameters and the storage they point into.
+        struct NativeCreateInfo {
+            std::vector<VkSpecializationMapEntry> specializationMapEntries;
+            VkSpecializationInfo specializationInfo;
+            VkComputePipelineCreateInfo info;
+
+            NativeCreateInfo(Device * device, const CreateInfo& createInfo, const PipelineLayout * layout);
+
+            NativeCreateInfo(const NativeCreateInfo&) = delete;
+            NativeCreateInfo& operator= (const NativeCreateInfo&) = delete;
+        };
+
         CreateInfo _info;
         VkPipeline _handle;
+        std::uint64_t _serial;
+        Device * _device;
         PipelineCache * _cache;
         PipelineLayout * _layout;
 
@@ -54,10 +75,17 @@ namespace mvk {
 
         ComputePipeline& operator= (const ComputePipeline&) = delete;
 
+        // adopts a pipeline compiled by PipelineCache::createPipelines
+        ComputePipeline(PipelineCache * cache, const CreateInfo& createInfo, PipelineLayout * layout, VkPipeline handle);
+
+        friend class PipelineCache;
+
     public:
         //! Constructs a ComputePipeline object holding nothing.
         ComputePipeline() :
             _handle(VK_NULL_HANDLE),
+            _serial(0),
+            _device(nullptr),
             _cache(nullptr),
             _layout(nullptr) {}
 
@@ -75,6 +103,8 @@ namespace mvk {
         ComputePipeline(ComputePipeline&& from) noexcept:
             _info(std::move(from._info)),
             _handle(std::exchange(from._handle, nullptr)),
+            _serial(std::exchange(from._serial, 0)),
+            _device(std::move(from._device)),
             _cache(std::move(from._cache)),
             _layout(std::move(from._layout)) {}
 
@@ -141,6 +171,12 @@ namespace mvk {
         */
         virtual VkPipeline getHandle() const noexcept;
 
+        //! Retrieves the serial number.
+        /*!
+            \return the serial number.
+        */
+        virtual std::uint64_t getSerial() const noexcept;
+
         //! Implicitly casts to the underlying Vulkan handle.
         inline operator VkPipeline() const noexcept {
             return getHandle();
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "volk.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mvk {
+    class DebugReport;
+
+    using UPtrDebugReport = std::unique_ptr<DebugReport>;
+
+    //! Collects the messages reported through VK_EXT_debug_utils.
+    /*!
+        Every message is counted by type. Performance warnings, which are messages of the PERFORMANCE
+        type or from the best-practices checks of the validation layers, are deduplicated by message ID
+        and counted, so a run can be compared against a known set of warnings. Other warnings and
+        errors are written to std::cerr, since installing a messenger replaces the default output of
+        the layers.
+     */
+    class DebugReport {
+    public:
+        //! A deduplicated performance warning.
+        struct PerformanceWarning {
+            std::string messageIdName;      /*!< The name of the message ID, or the number if the layer did not name it. */
+            std::int32_t messageIdNumber;   /*!< The number of the message ID. */
+            std::string message;            /*!< The text of the first occurrence. */
+            std::size_t count;              /*!< The number of occurrences. */
+        };
+
+        //! Constructs a DebugReport-typed unique_ptr pointing to null.
+        /*!
+            \return unique_ptr<DebugReport> pointing to nullptr.
+         */
+        static inline UPtrDebugReport unique_null() {
+            return std::unique_ptr<DebugReport> ();
+        }
+
+        //! The callback passed to vkCreateDebugUtilsMessengerEXT. pUserData must point to the DebugReport.
+        static VKAPI_ATTR VkBool32 VKAPI_CALL callback(
+            VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
+            VkDebugUtilsMessageTypeFlagsEXT messageTypes,
+            const VkDebugUtilsMessengerCallbackDataEXT * pCallbackData,
+            void * pUserData);
+
+    private:
+        mutable std::mutex _lock;
+        std::map<std::string, PerformanceWarning> _performanceWarnings;
+        std::size_t _generalCount;
+        std::size_t _validationCount;
+        std::size_t _performanceCount;
+        std::size_t _errorCount;
+
+        DebugReport(const DebugReport&) = delete;
+        DebugReport& operator= (const DebugReport&) = delete;
+
+    public:
+        //! Constructs an empty DebugReport.
+        DebugReport() noexcept:
+            _generalCount(0),
+            _validationCount(0),
+            _performanceCount(0),
+            _errorCount(0) {}
+
+        //! Fills the parameters of a messenger that reports into this DebugReport.
+        /*!
+            \return the create info. It may also be chained into VkInstanceCreateInfo to report messages of vkCreateInstance.
+         */
+        VkDebugUtilsMessengerCreateInfoEXT getMessengerCreateInfo() noexcept;
+
+        //! Records a message.
+        /*!
+            \param messageSeverity is the severity of the message.
+            \param messageTypes is the type bitmask of the message.
+            \param callbackData is the message.
+         */
+        void record(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity, VkDebugUtilsMessageTypeFlagsEXT messageTypes, const VkDebugUtilsMessengerCallbackDataEXT& callbackData);
+
+        //! Clears every count and performance warning.
+        void clear() noexcept;
+
+        //! Retrieves the number of GENERAL messages.
+        std::size_t getGeneralCount() const noexcept;
+
+        //! Retrieves the number of VALIDATION messages.
+        std::size_t getValidationCount() const noexcept;
+
+        //! Retrieves the number of performance warnings, including repeats.
+        std::size_t getPerformanceCount() const noexcept;
+
+        //! Retrieves the number of ERROR severity messages.
+        std::size_t getErrorCount() const noexcept;
+
+        //! Retrieves the deduplicated performance warnings.
+        /*!
+            \return the warnings, sorted by message ID name.
+         */
+        std::vector<PerformanceWarning> getPerformanceWarnings() const;
+
+        //! Captures the counts and performance warnings as a JSON object.
+        /*!
+            \return the JSON text.
+         */
+        std::string toJSON() const;
+
+        //! Writes the JSON report to a file.
+        /*!
+            \param path is the path of the file.
+         */
+        void save(const std::string& path) const;
+    };
+}
@@ -4,6 +4,7 @@
 
 #include <memory>
 #include <set>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -93,9 +94,10 @@ namespace mvk {
 
         //! Allocates a new DescriptorSet.
         /*!
+            \param name is an optional name shown by debuggers and profilers. Only used if VK_EXT_debug_utils is enabled.
             \return the DescriptorSet.
         */
-        DescriptorSet * allocate();
+        DescriptorSet * allocate(const std::string& name = std::string());
 
         //! Retrieves the Device.
         /*!
@@ -9,6 +9,7 @@
 
 #include "mvk/DescriptorType.hpp"
 #include "mvk/ImageLayout.hpp"
+#include "mvk/Util.hpp"
 
 namespace mvk {
     class Buffer;
@@ -22,6 +23,8 @@ namespace mvk {
         VkDescriptorSet _handle;
         DescriptorPool * _pool;
         int _poolIndex;
+        std::uint64_t _serial;
+        std::uint64_t _writeCount;
 
         DescriptorSet(const DescriptorSet&) = delete;
         DescriptorSet& operator= (const DescriptorSet&) = delete;
@@ -31,7 +34,9 @@ namespace mvk {
         DescriptorSet() noexcept:
             _handle(VK_NULL_HANDLE),
             _pool(nullptr),
-            _poolIndex(-1) {}
+            _poolIndex(-1),
+            _serial(0),
+            _writeCount(0) {}
 
         //! Constructs a DescriptorSet object by wrapping an externally allocated Vulkan handle.
         /*!
@@ -42,7 +47,9 @@ namespace mvk {
         DescriptorSet(DescriptorPool * pool, int poolIndex, VkDescriptorSet handle) noexcept:
             _handle(handle),
             _pool(pool),
-            _poolIndex(poolIndex) {}
+            _poolIndex(poolIndex),
+            _serial(Util::nextSerial()),
+            _writeCount(0) {}
 
         //! Move-constructs the DescriptorSet.
         /*!
@@ -51,7 +58,9 @@ namespace mvk {
         DescriptorSet(DescriptorSet&& from) noexcept:
             _handle(std::exchange(from._handle, nullptr)),
             _pool(std::move(from._pool)),
-            _poolIndex(std::move(from._poolIndex)) {}
+            _poolIndex(std::move(from._poolIndex)),
+            _serial(std::exchange(from._serial, 0)),
+            _writeCount(std::move(from._writeCount)) {}
 
         //! Move-assigns the DescriptorSet.
         /*!
@@ -88,6 +97,26 @@ namespace mvk {
             return _handle;
         }
 
+        //! Retrieves the serial number of the DescriptorSet.
+        /*!
+            DescriptorSet handles are reused by the DescriptorPool, but the serial number is unique to this allocation.
+
+            \return the serial number, or 0 for an empty DescriptorSet.
+        */
+        inline std::uint64_t getSerial() const noexcept {
+            return _serial;
+        }
+
+        //! Retrieves the number of descriptor writes made to the DescriptorSet.
+        /*!
+            Writing a DescriptorSet invalidates any CommandBuffer that has it bound, so this can be used to detect stale recordings.
+
+            \return the write count.
+        */
+        inline std::uint64_t getWriteCount() const noexcept {
+            return _writeCount;
+        }
+
         //! Retrieves the Device.
         /*!
             \return the Device.
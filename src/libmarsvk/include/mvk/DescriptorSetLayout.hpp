@@ -130,10 +130,11 @@ namespace mvk {
 
         //! Allocates a DescriptorSet from the assigned DescriptorPool.
         /*!
+            \param name is an optional name shown by debuggers and profilers. Only used if VK_EXT_debug_utils is enabled.
             \return the allocated DescriptorSet.
         */
-        inline DescriptorSet * allocate() {
-            return _pool->allocate();
+        inline DescriptorSet * allocate(const std::string& name = std::string()) {
+            return _pool->allocate(name);
         }
     };
 
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <utility>
 #include <vector>
 
 #include "mvk/DescriptorSetLayout.hpp"
@@ -22,6 +24,7 @@ namespace mvk {
         };
 
         std::vector<std::unique_ptr<Layout>> _layouts;
+        std::mutex _lock;
 
     public:
         //! Constructs an empty DescriptorSetLayoutCache.
@@ -39,10 +42,17 @@ namespace mvk {
         /*!
             \param from the other DescriptorSetLayoutCache.
         */
-        DescriptorSetLayoutCache& operator= (DescriptorSetLayoutCache&& from) = default;
+        DescriptorSetLayoutCache& operator= (DescriptorSetLayoutCache&& from) noexcept {
+            std::swap(_device, from._device);
+            std::swap(_layouts, from._layouts);
+
+            return *this;
+        }
 
         //! Allocates a DescriptorSetLayout
         /*!
+            This may be called from any thread.
+
             \param createInfo the construction parameters for the DescriptorSetLayout.
             \return the allocated DescriptorSetLayout. A compatible previously allocated DescriptorSetLayout may be returned instead.
         */
@@ -7,26 +7,39 @@
 #include "vk_mem_alloc.h"
 
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "mvk/AsyncPipeline.hpp"
 #include "mvk/Buffer.hpp"
 #include "mvk/ComputePipeline.hpp"
 #include "mvk/DescriptorSetLayoutCache.hpp"
 #include "mvk/Device.hpp"
 #include "mvk/FencePool.hpp"
+#include "mvk/FrameAllocator.hpp"
+#include "mvk/GPUProfiler.hpp"
 #include "mvk/Image.hpp"
 #include "mvk/MemoryUsage.hpp"
+#include "mvk/Metrics.hpp"
+#include "mvk/OcclusionCuller.hpp"
+#include "mvk/ParallelRecorder.hpp"
 #include "mvk/PipelineCache.hpp"
+#include "mvk/PipelineCompiler.hpp"
 #include "mvk/PipelineLayoutCache.hpp"
+#include "mvk/PipelineManifest.hpp"
+#include "mvk/QueryPool.hpp"
 #include "mvk/QueueFamily.hpp"
 #include "mvk/RenderPass.hpp"
 #include "mvk/SamplerCache.hpp"
 #include "mvk/SemaphorePool.hpp"
 #include "mvk/ShaderModule.hpp"
 #include "mvk/Swapchain.hpp"
+#include "mvk/Tracer.hpp"
+#include "mvk/WorkgroupTuner.hpp"
 
 namespace mvk {
     class PhysicalDevice;
@@ -40,30 +53,44 @@ namespace mvk {
         PhysicalDevice * _physicalDevice;
         VkDevice _handle;
         std::set<std::string> _enabledExtensions;
+        VkPhysicalDeviceFeatures _enabledFeatures;
         std::vector<std::unique_ptr<QueueFamily>> _queueFamilies;
         std::uint32_t _queueFamilyCount;
-        std::vector<std::unique_ptr<ShaderModule>> _shaderCache;
+        std::unordered_map<ShaderModule::CreateInfo, std::unique_ptr<ShaderModule>> _shaderCache;
+        std::mutex _shaderCacheLock;
         std::unique_ptr<FencePool> _fencePool;
         std::unique_ptr<SemaphorePool> _semaphorePool;
         std::unique_ptr<DescriptorSetLayoutCache> _descriptorSetLayoutCache;
         std::unique_ptr<PipelineLayoutCache> _pipelineLayoutCache;
         std::unique_ptr<PipelineCache> _pipelineCache;
+        std::unique_ptr<PipelineCompiler> _pipelineCompiler;
+        std::unique_ptr<PipelineManifest> _pipelineManifest;
+        std::string _pipelineManifestPath;
         std::unique_ptr<SamplerCache> _samplerCache;
+        std::unique_ptr<Metrics> _metrics;
+        std::unique_ptr<Tracer> _tracer;
         VmaAllocator _allocator;
+        bool _debugUtils;
+        bool _pipelineExecutableInfo;
 
         Device(const Device&) = delete;
         Device& operator=(const Device&) = delete;
 
+        void nameObject(VkObjectType objectType, std::uint64_t handle, const std::string& name) const noexcept;
+
     public:
         //! Constructs an empty Device.
         Device() noexcept: 
             _handle(VK_NULL_HANDLE),
-            _physicalDevice(nullptr) {}
+            _physicalDevice(nullptr),
+            _debugUtils(false),
+            _pipelineExecutableInfo(false) {}
 
         Device(Device&& from) noexcept:
             _physicalDevice(std::move(from._physicalDevice)),
             _handle(std::exchange(from._handle, nullptr)),
             _enabledExtensions(std::move(from._enabledExtensions)),
+            _enabledFeatures(std::move(from._enabledFeatures)),
             _queueFamilies(std::move(from._queueFamilies)),
             _queueFamilyCount(std::move(from._queueFamilyCount)),
             _shaderCache(std::move(from._shaderCache)),
@@ -72,13 +99,21 @@ namespace mvk {
             _descriptorSetLayoutCache(std::move(from._descriptorSetLayoutCache)),
             _pipelineLayoutCache(std::move(from._pipelineLayoutCache)),
             _pipelineCache(std::move(from._pipelineCache)),
+            _pipelineCompiler(std::move(from._pipelineCompiler)),
+            _pipelineManifest(std::move(from._pipelineManifest)),
+            _pipelineManifestPath(std::move(from._pipelineManifestPath)),
             _samplerCache(std::move(from._samplerCache)),
-            _allocator(std::exchange(from._allocator, nullptr)) {}
+            _metrics(std::move(from._metrics)),
+            _tracer(std::move(from._tracer)),
+            _allocator(std::exchange(from._allocator, nullptr)),
+            _debugUtils(std::move(from._debugUtils)),
+            _pipelineExecutableInfo(std::move(from._pipelineExecutableInfo)) {}
 
         //! Constructs a Device object.
         /*!
             \param physicalDevice the Vulkan device to use. Generally this is a GPU.
             \param enabledExtensions is a set of all extensions to enable at Device construction.
+            VK_EXT_conditional_rendering is dropped if the Instance does not have VK_KHR_get_physical_device_properties2.
         */
         Device(PhysicalDevice * physicalDevice, const std::set<std::string>& enabledExtensions);
 
@@ -98,6 +133,16 @@ namespace mvk {
             return _enabledExtensions;
         }
 
+        //! Retrieves the features enabled on construction.
+        /*!
+            Optional features used by the library (such as pipeline statistics queries) are enabled when supported.
+
+            \return the enabled features.
+        */
+        inline const VkPhysicalDeviceFeatures& getEnabledFeatures() const noexcept {
+            return _enabledFeatures;
+        }
+
         //! Retrieves the PhysicalDevice.
         /*!
             \return the PhysicalDevice.
@@ -152,6 +197,72 @@ namespace mvk {
             return _semaphorePool->acquireSemaphore();
         }
 
+        //! Retrieves the Metrics registry.
+        /*!
+            Values are only collected when the library is built with MVK_ENABLE_METRICS.
+
+            \return the Metrics registry.
+        */
+        inline Metrics& getMetrics() const noexcept {
+            return *_metrics;
+        }
+
+        //! Checks if objects and commands can be labeled for debuggers and profilers.
+        /*!
+            \return true if VK_EXT_debug_utils was enabled on the Instance.
+        */
+        inline bool isDebugUtilsEnabled() const noexcept {
+            return _debugUtils;
+        }
+
+        //! Retrieves the PipelineCache every pipeline of this Device is created from.
+        /*!
+            If the MVK_PIPELINE_CACHE environment variable is set, the driver data of the PipelineCache is loaded
+            from that path and saved back to it when the Device is deleted.
+
+            \return the PipelineCache.
+        */
+        inline PipelineCache * getPipelineCache() const noexcept {
+            return _pipelineCache.get();
+        }
+
+        //! Checks if pipelines capture executable statistics.
+        /*!
+            VK_KHR_pipeline_executable_properties is also enabled, if it and the Instance extension
+            VK_KHR_get_physical_device_properties2 are supported, when the MVK_PIPELINE_STATISTICS
+            environment variable is set. The statistics of every pipeline are then written to that path when the
+            Device is deleted.
+
+            \return true if VK_KHR_pipeline_executable_properties was enabled on the Device.
+        */
+        inline bool isPipelineExecutableInfoEnabled() const noexcept {
+            return _pipelineExecutableInfo;
+        }
+
+        //! Names a Vulkan object for debuggers and profilers.
+        /*!
+            This does nothing if VK_EXT_debug_utils is not enabled or the name is empty.
+
+            \param objectType is the type of the object.
+            \param handle is the Vulkan handle of the object.
+            \param name is the name.
+        */
+        template<typename Handle>
+        inline void setObjectName(VkObjectType objectType, Handle handle, const std::string& name) const noexcept {
+            if (_debugUtils && !name.empty()) {
+                // non-dispatchable handles are pointers on 64bit platforms and integers elsewhere
+                nameObject(objectType, (std::uint64_t) handle, name);
+            }
+        }
+
+        //! Retrieves the Tracer.
+        /*!
+            \return the Tracer.
+        */
+        inline Tracer& getTracer() const noexcept {
+            return *_tracer;
+        }
+
         //! Retrieves the memory allocator.
         /*!
             /return the memory allocator.
@@ -170,6 +281,24 @@ namespace mvk {
             return std::make_unique<Buffer> (this, info, memoryUsage);
         }
 
+        //! Constructs a new FrameAllocator.
+        /*!
+            \param createInfo is the construction parameters.
+            \return the new FrameAllocator wrapped in a unique_ptr.
+        */
+        inline UPtrFrameAllocator createFrameAllocator(const FrameAllocator::CreateInfo& createInfo) {
+            return std::make_unique<FrameAllocator> (this, createInfo);
+        }
+
+        //! Constructs a new GPUProfiler.
+        /*!
+            \param createInfo is the construction parameters.
+            \return the new GPUProfiler wrapped in a unique_ptr.
+        */
+        inline UPtrGPUProfiler createGPUProfiler(const GPUProfiler::CreateInfo& createInfo) {
+            return std::make_unique<GPUProfiler> (this, createInfo);
+        }
+
         //! Constructs a new Image object.
         /*!
             \param info is the construction parameters.
@@ -229,6 +358,149 @@ namespace mvk {
             return createPipeline(createInfo, renderPass.get());
         }
 
+        //! Retrieves a ComputePipeline that is shared with every other caller using an equivalent CreateInfo.
+        /*!
+            \param createInfo is the construction parameters.
+            \return the shared ComputePipeline.
+        */
+        inline SPtrComputePipeline getPipeline(const ComputePipeline::CreateInfo& createInfo) {
+            return _pipelineCache->getPipeline(createInfo);
+        }
+
+        //! Retrieves a GraphicsPipeline that is shared with every other caller using an equivalent CreateInfo and a compatible RenderPass.
+        /*!
+            \param createInfo is the construction parameters.
+            \param renderPass is a pointer to the RenderPass used by the pipeline.
+            \return the shared GraphicsPipeline.
+        */
+        inline SPtrGraphicsPipeline getPipeline(const GraphicsPipeline::CreateInfo& createInfo, const RenderPass * renderPass) {
+            return _pipelineCache->getPipeline(createInfo, renderPass);
+        }
+
+        //! Retrieves a shared GraphicsPipeline.
+        /*!
+            This function unwraps the unique_ptr for the RenderPass and chains the raw pointer variant.
+        */
+        inline SPtrGraphicsPipeline getPipeline(const GraphicsPipeline::CreateInfo& createInfo, const std::unique_ptr<RenderPass>& renderPass) {
+            return getPipeline(createInfo, renderPass.get());
+        }
+
+        //! Creates a ComputePipeline on a background thread.
+        /*!
+            The PipelineLayout and ShaderModule are resolved on the background thread as well, so the calling
+            thread never blocks on shader loading or compilation. Callers check AsyncPipeline::isReady and skip
+            the work or use a fallback pipeline until then.
+
+            \param createInfo is the construction parameters.
+            \return the AsyncPipeline that becomes ready when the compilation finishes.
+        */
+        SPtrAsyncComputePipeline createPipelineAsync(const ComputePipeline::CreateInfo& createInfo);
+
+        //! Creates a GraphicsPipeline on a background thread.
+        /*!
+            The PipelineLayout and ShaderModules are resolved on the background thread as well.
+
+            \param createInfo is the construction parameters.
+            \param renderPass is the RenderPass used by the pipeline. It must live until the AsyncPipeline is finished.
+            \return the AsyncPipeline that becomes ready when the compilation finishes.
+        */
+        SPtrAsyncGraphicsPipeline createPipelineAsync(const GraphicsPipeline::CreateInfo& createInfo, const RenderPass * renderPass);
+
+        //! Creates a GraphicsPipeline on a background thread.
+        /*!
+            This function unwraps the unique_ptr for the RenderPass and chains the raw pointer variant.
+        */
+        inline SPtrAsyncGraphicsPipeline createPipelineAsync(const GraphicsPipeline::CreateInfo& createInfo, const std::unique_ptr<RenderPass>& renderPass) {
+            return createPipelineAsync(createInfo, renderPass.get());
+        }
+
+        //! Retrieves the PipelineCompiler that runs createPipelineAsync.
+        /*!
+            \return the PipelineCompiler.
+        */
+        inline PipelineCompiler& getPipelineCompiler() const noexcept {
+            return *_pipelineCompiler;
+        }
+
+        //! Queues every pipeline of a PipelineManifest for compilation on the PipelineCompiler threads.
+        /*!
+            The pipelines become shared pipelines of the PipelineCache, so getPipeline returns them without
+            compiling. Entries that fail to compile, for example because a shader no longer exists, are skipped
+            and removed from the manifest opened by openPipelineManifest.
+            The pipelines are queued with low priority, so pipelines requested with createPipelineAsync start
+            first, and getPipeline waits for a prewarm of the same pipeline that is already running.
+
+            \param manifest is the PipelineManifest. It is copied, so it does not need to outlive the compilation.
+            \return the number of queued pipelines.
+        */
+        std::size_t prewarmPipelines(const PipelineManifest& manifest);
+
+        //! Loads a PipelineManifest, prewarms its pipelines and records the pipelines requested afterwards with getPipeline or createPipelineAsync.
+        /*!
+            The manifest is saved back to the file when the Device is destroyed, so the pipelines of one run are
+            compiled before they are needed in the next. This is done automatically for the path in the
+            MVK_PIPELINE_MANIFEST environment variable.
+
+            \param path is the path of the manifest file. A missing file starts an empty manifest.
+        */
+        void openPipelineManifest(const std::string& path);
+
+        //! Retrieves the PipelineManifest opened by openPipelineManifest.
+        /*!
+            \return the PipelineManifest; nullptr if no manifest was opened.
+        */
+        inline PipelineManifest * getPipelineManifest() const noexcept {
+            return _pipelineManifest.get();
+        }
+
+        //! Creates many ComputePipelines, compiling them in parallel.
+        /*!
+            \param createInfos is the construction parameters of every pipeline.
+            \param batchInfo controls the compiler threads.
+            \return the ComputePipelines in the order of createInfos.
+        */
+        inline std::vector<UPtrComputePipeline> createPipelines(const std::vector<ComputePipeline::CreateInfo>& createInfos, const PipelineCache::BatchInfo& batchInfo = PipelineCache::BatchInfo {}) {
+            return _pipelineCache->createPipelines(createInfos, batchInfo);
+        }
+
+        //! Creates many GraphicsPipelines that are used in the same RenderPass, compiling them in parallel.
+        /*!
+            \param createInfos is the construction parameters of every pipeline.
+            \param renderPass is the RenderPass used by the pipelines.
+            \param batchInfo controls the compiler threads.
+            \return the GraphicsPipelines in the order of createInfos.
+        */
+        inline std::vector<UPtrGraphicsPipeline> createPipelines(const std::vector<GraphicsPipeline::CreateInfo>& createInfos, const RenderPass * renderPass, const PipelineCache::BatchInfo& batchInfo = PipelineCache::BatchInfo {}) {
+            return _pipelineCache->createPipelines(createInfos, renderPass, batchInfo);
+        }
+
+        //! Creates a new OcclusionCuller.
+        /*!
+            \param createInfo is the construction parameters.
+            \return the new OcclusionCuller wrapped in a unique_ptr.
+        */
+        inline UPtrOcclusionCuller createOcclusionCuller(const OcclusionCuller::CreateInfo& createInfo) {
+            return std::make_unique<OcclusionCuller> (this, createInfo);
+        }
+
+        //! Creates a new ParallelRecorder.
+        /*!
+            \param createInfo is the construction parameters.
+            \return the new ParallelRecorder wrapped in a unique_ptr.
+        */
+        inline UPtrParallelRecorder createParallelRecorder(const ParallelRecorder::CreateInfo& createInfo) {
+            return std::make_unique<ParallelRecorder> (createInfo);
+        }
+
+        //! Constructs a new QueryPool.
+        /*!
+            \param createInfo is the construction parameters.
+            \return the new QueryPool wrapped in a unique_ptr.
+        */
+        inline UPtrQueryPool createQueryPool(const QueryPool::CreateInfo& createInfo) {
+            return std::make_unique<QueryPool> (this, createInfo);
+        }
+
         //! Creates a new RenderPass.
         /*!
             \param createInfo is the construction parameters.
@@ -247,6 +519,15 @@ namespace mvk {
             return std::make_unique<Swapchain> (this, createInfo);
         }
 
+        //! Creates a new WorkgroupTuner.
+        /*!
+            \param createInfo is the construction parameters.
+            \return the new WorkgroupTuner wrapped in a unique_ptr.
+        */
+        inline UPtrWorkgroupTuner createWorkgroupTuner(const WorkgroupTuner::CreateInfo& createInfo) {
+            return std::make_unique<WorkgroupTuner> (this, createInfo);
+        }
+
         //! Allocates a new Sampler.
         /*!
             Allocates or reuses a new Sampler from the SamplerCache.
@@ -266,6 +547,10 @@ namespace mvk {
 
         //! Retrieves a ShaderModule.
         /*!
+            ShaderModules are loaded on first use and cached. This may be called from any thread.
+            A path that names an embedded shader (see ShaderModule::Embedded) uses the embedded code
+            instead of reading the file.
+
             \param createInfo is the ShaderModule construction parameters.
             \return the ShaderModule.
         */
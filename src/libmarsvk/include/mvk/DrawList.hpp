@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "mvk/IndexType.hpp"
+
+namespace mvk {
+    class Buffer;
+    class CommandBuffer;
+    class CommandList;
+    class DescriptorSet;
+    class Pipeline;
+
+    class DrawList;
+
+    using UPtrDrawList = std::unique_ptr<DrawList>;
+
+    //! A list of draws that is sorted to minimize state changes before it is recorded.
+    /*!
+        Each draw is assigned a 64bit sort key packed from (most significant first) its Pipeline,
+        PipelineLayout, DescriptorSet, vertex Buffer and quantized depth. Objects are mapped to small ids
+        in the order they are first seen, so the key never depends on addresses. The draws are radix
+        sorted by key and recorded binding each piece of state only when it changes.
+
+        Ids that overflow their field share a bucket; this only reduces the sort quality, the recorded
+        state is always tracked by object.
+     */
+    class DrawList {
+    public:
+        //! A single draw.
+        struct Draw {
+            const Pipeline * pipeline;              /*!< The Pipeline to draw with. */
+            const DescriptorSet * descriptorSet;    /*!< The DescriptorSet to bind. May be null. */
+            int set;                                /*!< The set index the DescriptorSet is bound to. */
+            const Buffer * vertexBuffer;            /*!< The vertex Buffer bound to binding 0. May be null. */
+            const Buffer * indexBuffer;             /*!< The index Buffer. If null the draw is not indexed. */
+            IndexType indexType;                    /*!< The type of the indices in the index Buffer. */
+            int count;                              /*!< The number of vertices or indices to draw. */
+            int instanceCount;                      /*!< The number of instances to draw. */
+            int first;                              /*!< The first vertex or index to draw. */
+            int vertexOffset;                       /*!< The value added to each index. Ignored if not indexed. */
+            int firstInstance;                      /*!< The first instance to draw. */
+            float depth;                            /*!< The view depth in [0, 1]; draws with equal state are ordered front to back. */
+        };
+
+        static constexpr unsigned int PIPELINE_BITS = 12;
+        static constexpr unsigned int LAYOUT_BITS = 8;
+        static constexpr unsigned int DESCRIPTOR_SET_BITS = 16;
+        static constexpr unsigned int VERTEX_BUFFER_BITS = 12;
+        static constexpr unsigned int DEPTH_BITS = 16;
+
+        //! Lists with at least this many draws are sorted with multiple threads.
+        /*!
+            The sort threads are started by the first parallel sort and kept until the DrawList is destroyed.
+         */
+        static constexpr std::size_t PARALLEL_SORT_THRESHOLD = 64 * 1024;
+
+        //! Constructs a DrawList-typed unique_ptr pointing to null.
+        /*!
+            \return unique_ptr<DrawList> pointing to nullptr.
+         */
+        static inline UPtrDrawList unique_null() {
+            return std::unique_ptr<DrawList> ();
+        }
+
+    private:
+        class Workers;
+
+        std::vector<Draw> _draws;
+        std::vector<std::uint64_t> _keys;
+        std::vector<std::uint32_t> _order;
+        std::vector<std::uint64_t> _sortKeys;
+        std::vector<std::uint64_t> _scratchKeys;
+        std::vector<std::uint32_t> _scratchOrder;
+        std::unordered_map<const void *, std::uint32_t> _pipelineIds;
+        std::unordered_map<const void *, std::uint32_t> _layoutIds;
+        std::unordered_map<const void *, std::uint32_t> _descriptorSetIds;
+        std::unordered_map<const void *, std::uint32_t> _vertexBufferIds;
+        bool _sorted;
+        std::size_t _stateChangeCount;
+        std::unique_ptr<Workers> _workers;
+
+        DrawList(const DrawList&) = delete;
+        DrawList& operator= (const DrawList&) = delete;
+
+        static std::uint64_t idOf(std::unordered_map<const void *, std::uint32_t>& ids, const void * object, unsigned int bits);
+
+        void radixSort(std::size_t threadCount);
+
+        template<class Target>
+        void emit(Target * target);
+
+    public:
+        //! Constructs an empty DrawList.
+        DrawList() noexcept;
+
+        //! Move-constructs a DrawList.
+        DrawList(DrawList&&) noexcept;
+
+        //! Move-assigns a DrawList.
+        DrawList& operator= (DrawList&&) noexcept;
+
+        //! Deletes the DrawList and stops its sort threads.
+        ~DrawList() noexcept;
+
+        //! Removes every draw. The allocations are kept for reuse.
+        void clear() noexcept;
+
+        //! Reserves space for draws.
+        /*!
+            \param drawCount is the number of draws to reserve space for.
+         */
+        void reserve(std::size_t drawCount);
+
+        //! Adds a draw and computes its sort key.
+        /*!
+            Draws without a Pipeline are rejected with std::runtime_error.
+
+            \param draw is the draw. Every referenced object must outlive the recording.
+         */
+        void add(const Draw& draw);
+
+        //! Sorts the draws by their sort key. The sort is stable.
+        /*!
+            \param threadCount is the maximum number of threads to sort with. 0 selects the number of hardware threads.
+         */
+        void sort(std::size_t threadCount = 0);
+
+        //! Records the draws into a CommandBuffer, sorting first if needed.
+        /*!
+            \param commandBuffer is the CommandBuffer. It must be inside a subpass.
+         */
+        void execute(CommandBuffer * commandBuffer);
+
+        inline void execute(const std::unique_ptr<CommandBuffer>& commandBuffer) {
+            execute(commandBuffer.get());
+        }
+
+        //! Encodes the draws into a CommandList, sorting first if needed.
+        /*!
+            \param commandList is the CommandList.
+         */
+        void execute(CommandList * commandList);
+
+        //! Retrieves the number of draws.
+        /*!
+            \return the draw count.
+         */
+        inline std::size_t getDrawCount() const noexcept {
+            return _draws.size();
+        }
+
+        //! Retrieves the sort key of a draw.
+        /*!
+            \param index is the index the draw was added at.
+            \return the sort key.
+         */
+        inline std::uint64_t getSortKey(std::size_t index) const noexcept {
+            return _keys[index];
+        }
+
+        //! Retrieves the number of binds issued by the last execute.
+        /*!
+            \return the number of Pipeline, DescriptorSet, vertex Buffer and index Buffer binds.
+         */
+        inline std::size_t getStateChangeCount() const noexcept {
+            return _stateChangeCount;
+        }
+    };
+}
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "volk.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "mvk/Buffer.hpp"
+#include "mvk/BufferUsageFlag.hpp"
+
+namespace mvk {
+    class Device;
+    class Fence;
+
+    class FrameAllocator;
+
+    using UPtrFrameAllocator = std::unique_ptr<FrameAllocator>;
+
+    //! Per-frame linear allocator over a single persistently mapped Buffer.
+    /*!
+        The Buffer is split into one region per frame in flight. Allocations are bumped linearly
+        through the current region and are never freed individually; the whole region is recycled
+        once the Fence guarding it has signaled. This allows a single DescriptorSet bound with
+        dynamic offsets to serve any number of draws without creating Buffers or writing descriptors.
+     */
+    class FrameAllocator {
+    public:
+        //! Parameter structure specifying how to construct a new FrameAllocator.
+        struct CreateInfo {
+            VkDeviceSize frameSize;     /*!< The size of each frame region, in bytes. */
+            std::uint32_t frameCount;   /*!< The number of frame regions; generally the number of frames in flight. */
+            BufferUsageFlag usage;      /*!< Bitmask specifying how the allocations will be used. */
+        };
+
+        //! A sub-allocation of the current frame region.
+        struct Allocation {
+            void * pData;               /*!< Host pointer to the mapped memory of the allocation. */
+            VkDeviceSize offset;        /*!< Offset of the allocation from the start of the Buffer, in bytes. */
+            VkDeviceSize size;          /*!< The size of the allocation, in bytes. */
+
+            //! Retrieves the offset as a dynamic offset suitable for CommandBuffer::bindDescriptorSet.
+            inline int getDynamicOffset() const noexcept {
+                return static_cast<int> (offset);
+            }
+        };
+
+        //! Constructs a FrameAllocator-typed unique_ptr pointing to null.
+        /*!
+            \return unique_ptr<FrameAllocator> pointing to nullptr.
+         */
+        static inline UPtrFrameAllocator unique_null() {
+            return std::unique_ptr<FrameAllocator> ();
+        }
+
+    private:
+        struct Frame {
+            Fence * fence;
+            bool inFlight;
+        };
+
+        Device * _device;
+        CreateInfo _info;
+        UPtrBuffer _buffer;
+        std::uint8_t * _pData;
+        std::vector<Frame> _frames;
+        std::uint32_t _frameIndex;
+        VkDeviceSize _head;
+
+        FrameAllocator(const FrameAllocator&) = delete;
+        FrameAllocator& operator= (const FrameAllocator&) = delete;
+
+    public:
+        //! Constructs an empty FrameAllocator.
+        FrameAllocator() noexcept:
+            _device(nullptr),
+            _pData(nullptr),
+            _frameIndex(0),
+            _head(0) {}
+
+        //! Constructs a new FrameAllocator.
+        /*!
+            \param device is the Device used to create the Buffer and acquire the frame Fences.
+            \param createInfo is the construction parameters.
+         */
+        FrameAllocator(Device * device, const CreateInfo& createInfo);
+
+        //! Move-constructs a FrameAllocator.
+        /*!
+            \param from the other FrameAllocator.
+         */
+        FrameAllocator(FrameAllocator&& from) noexcept:
+            _device(std::move(from._device)),
+            _info(std::move(from._info)),
+            _buffer(std::move(from._buffer)),
+            _pData(std::exchange(from._pData, nullptr)),
+            _frames(std::move(from._frames)),
+            _frameIndex(std::move(from._frameIndex)),
+            _head(std::move(from._head)) {}
+
+        //! Deletes the FrameAllocator and releases the Buffer and frame Fences.
+        ~FrameAllocator() noexcept;
+
+        //! Move-assigns a FrameAllocator.
+        /*!
+            \param from the other FrameAllocator.
+         */
+        FrameAllocator& operator= (FrameAllocator&& from) noexcept;
+
+        //! Retrieves the parent Device.
+        /*!
+            \return the Device.
+         */
+        inline Device * getDevice() const noexcept {
+            return _device;
+        }
+
+        //! Retrieves the construction parameters.
+        /*!
+            \return the reference to an immutable copy of the parameter struct.
+         */
+        inline const CreateInfo& getInfo() const noexcept {
+            return _info;
+        }
+
+        //! Retrieves the Buffer backing all frame regions.
+        /*!
+            This is the Buffer that should be written into the DescriptorSet or bound as a vertex Buffer.
+
+            \return the Buffer.
+         */
+        inline Buffer * getBuffer() const noexcept {
+            return _buffer.get();
+        }
+
+        //! Retrieves the index of the current frame region.
+        /*!
+            \return the frame index.
+         */
+        inline std::uint32_t getFrameIndex() const noexcept {
+            return _frameIndex;
+        }
+
+        //! Retrieves the number of bytes allocated from the current frame region.
+        /*!
+            \return the bytes used.
+         */
+        inline VkDeviceSize getBytesUsed() const noexcept {
+            return _head;
+        }
+
+        //! Advances to the next frame region.
+        /*!
+            If the next frame region is still in use by the Device, this waits for its Fence to signal
+            before recycling it. All allocations made from that region become invalid.
+         */
+        void nextFrame();
+
+        //! Retrieves the Fence guarding the current frame region.
+        /*!
+            The Fence must be passed to the Queue submission that consumes this frame's allocations.
+            Any pending host writes are flushed and the region is marked as in flight. The Fence can only be
+            acquired once per frame; a second call throws until nextFrame is called.
+
+            \return the Fence.
+         */
+        Fence * acquireFence();
+
+        //! Allocates a range of the current frame region.
+        /*!
+            \param size is the size of the allocation, in bytes.
+            \param alignment is the required alignment of the offset, in bytes.
+            \return the Allocation.
+         */
+        Allocation allocate(VkDeviceSize size, VkDeviceSize alignment);
+
+        //! Allocates a range of the current frame region suitable for use as uniform data.
+        /*!
+            The offset honors PhysicalDevice minUniformBufferOffsetAlignment.
+
+            \param size is the size of the allocation, in bytes.
+            \return the Allocation.
+         */
+        Allocation allocateUniform(VkDeviceSize size);
+
+        //! Allocates a range of the current frame region suitable for use as storage data.
+        /*!
+            The offset honors PhysicalDevice minStorageBufferOffsetAlignment.
+
+            \param size is the size of the allocation, in bytes.
+            \return the Allocation.
+         */
+        Allocation allocateStorage(VkDeviceSize size);
+
+        //! Allocates a range of the current frame region suitable for use as vertex data.
+        /*!
+            \param size is the size of the allocation, in bytes.
+            \return the Allocation.
+         */
+        Allocation allocateVertex(VkDeviceSize size);
+
+        //! Allocates and copies a value into the current frame region as uniform data.
+        /*!
+            \param value is the value to copy.
+            \return the Allocation.
+         */
+        template<class T>
+        inline Allocation pushUniform(const T& value) {
+            auto allocation = allocateUniform(sizeof(T));
+
+            *reinterpret_cast<T *> (allocation.pData) = value;
+
+            return allocation;
+        }
+    };
+}
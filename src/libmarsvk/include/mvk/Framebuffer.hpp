@@ -3,6 +3,7 @@
 #include "volk.h"
 
 #include <cstddef>
+#include <cstdint>
 
 #include "mvk/ImageView.hpp"
 
@@ -26,6 +27,7 @@ namespace mvk {
 
     private:
         VkFramebuffer _handle;
+        std::uint64_t _serial;
         CreateInfo _info;
         const RenderPass * _renderPass;
         std::vector<const ImageView *> _attachments;
@@ -40,6 +42,7 @@ namespace mvk {
         //! Creates an empty Framebuffer object.
         Framebuffer() noexcept:
             _handle(VK_NULL_HANDLE),
+            _serial(0),
             _renderPass(nullptr) {}
 
         //! Creates a Framebuffer object.
@@ -63,6 +66,7 @@ namespace mvk {
         */
         Framebuffer(Framebuffer&& from) noexcept:
             _handle(std::exchange(from._handle, nullptr)),
+            _serial(std::exchange(from._serial, 0)),
             _info(std::move(from._info)),
             _renderPass(std::move(from._renderPass)),
             _attachments(std::move(from._attachments)) {}
@@ -89,6 +93,14 @@ namespace mvk {
             return _handle;
         }
 
+        //! Retrieves the serial number of the Framebuffer.
+        /*!
+            \return the serial number, or 0 for an empty Framebuffer. It is never reused by another Framebuffer.
+        */
+        inline std::uint64_t getSerial() const noexcept {
+            return _serial;
+        }
+
         //! Retrieves an attachment.
         /*!
             \param index is the attachment index.
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mvk/PipelineStageFlag.hpp"
+#include "mvk/QueryPipelineStatisticFlag.hpp"
+#include "mvk/QueryPool.hpp"
+
+namespace mvk {
+    class CommandBuffer;
+    class Device;
+    class QueueFamily;
+
+    class GPUProfiler;
+
+    using UPtrGPUProfiler = std::unique_ptr<GPUProfiler>;
+
+    //! Measures the GPU time of named scopes with timestamp queries.
+    /*!
+        Each frame in flight owns its own QueryPools. Results are read back without waiting once the
+        Device has finished the frame, so reading them never stalls; they are therefore frameCount
+        frames behind the frame being recorded. If a frame is still not available when its QueryPools
+        are reused, its results are dropped.
+
+        Scopes may nest. When pipeline statistics are enabled they are only gathered for outermost
+        scopes, since queries of the same type may not be active at the same time. A scope that is
+        inside a RenderPass must begin and end in the same subpass.
+     */
+    class GPUProfiler {
+    public:
+        //! Parameter structure specifying how to construct a new GPUProfiler.
+        struct CreateInfo {
+            QueueFamily * queueFamily;                      /*!< The QueueFamily the profiled CommandBuffers are submitted to. */
+            std::uint32_t frameCount;                       /*!< The number of frames in flight. Results are resolved this many frames late. */
+            std::uint32_t maxScopes;                        /*!< The maximum number of scopes per frame. */
+            QueryPipelineStatisticFlag pipelineStatistics;  /*!< The pipeline statistics gathered for outermost scopes. NONE disables pipeline statistics. */
+        };
+
+        //! The resolved measurements of a scope.
+        struct Result {
+            std::string name;                       /*!< The name of the scope. */
+            std::uint32_t depth;                    /*!< The nesting depth of the scope; 0 for outermost scopes. */
+            double milliseconds;                    /*!< The GPU time between the beginning and end of the scope. */
+            std::vector<std::uint64_t> statistics;  /*!< The pipeline statistics in bit order of CreateInfo::pipelineStatistics. Empty if not gathered. */
+        };
+
+        //! Ends a scope when it goes out of scope.
+        class Scope {
+            GPUProfiler * _profiler;
+            CommandBuffer * _commandBuffer;
+            std::uint32_t _index;
+
+            Scope(const Scope&) = delete;
+            Scope& operator= (const Scope&) = delete;
+
+            Scope(GPUProfiler * profiler, CommandBuffer * commandBuffer, std::uint32_t index) noexcept:
+                _profiler(profiler),
+                _commandBuffer(commandBuffer),
+                _index(index) {}
+
+            friend class GPUProfiler;
+
+        public:
+            Scope(Scope&& from) noexcept:
+                _profiler(std::exchange(from._profiler, nullptr)),
+                _commandBuffer(std::move(from._commandBuffer)),
+                _index(std::move(from._index)) {}
+
+            ~Scope() noexcept;
+        };
+
+        //! Constructs a GPUProfiler-typed unique_ptr pointing to null.
+        /*!
+            \return unique_ptr<GPUProfiler> pointing to nullptr.
+         */
+        static inline UPtrGPUProfiler unique_null() {
+            return std::unique_ptr<GPUProfiler> ();
+        }
+
+    private:
+        struct ScopeRecord {
+            std::string name;
+            std::uint32_t depth;
+            bool hasStatistics;
+        };
+
+        struct Frame {
+            UPtrQueryPool timestamps;
+            UPtrQueryPool statistics;
+            std::vector<ScopeRecord> scopes;
+            std::uint64_t frameNumber;
+            bool pending;
+        };
+
+        Device * _device;
+        CreateInfo _info;
+        std::vector<Frame> _frames;
+        std::uint32_t _frameIndex;
+        std::uint64_t _frameNumber;
+        std::uint32_t _depth;
+        double _timestampPeriod;
+        std::uint64_t _timestampMask;
+        std::vector<Result> _results;
+        std::uint64_t _resolvedFrame;
+        std::size_t _droppedFrameCount;
+        std::vector<std::uint64_t> _scratch;
+
+        GPUProfiler(const GPUProfiler&) = delete;
+        GPUProfiler& operator= (const GPUProfiler&) = delete;
+
+        bool resolve(Frame& frame);
+
+    public:
+        //! Constructs a new GPUProfiler.
+        /*!
+            \param device is the Device used to create the QueryPools.
+            \param createInfo is the construction parameters.
+         */
+        GPUProfiler(Device * device, const CreateInfo& createInfo);
+
+        //! Deletes the GPUProfiler and releases the QueryPools.
+        ~GPUProfiler() noexcept = default;
+
+        //! Retrieves the parent Device.
+        /*!
+            \return the Device.
+         */
+        inline Device * getDevice() const noexcept {
+            return _device;
+        }
+
+        //! Retrieves the construction parameters.
+        /*!
+            \return the reference to an immutable copy of the parameter struct.
+         */
+        inline const CreateInfo& getInfo() const noexcept {
+            return _info;
+        }
+
+        //! Starts a new frame.
+        /*!
+            The QueryPools of the oldest frame are resolved (if available) and reset. This must be
+            recorded outside of a RenderPass, before any scope of the frame.
+
+            \param commandBuffer is the first CommandBuffer of the frame.
+         */
+        void beginFrame(CommandBuffer * commandBuffer);
+
+        //! Begins a named scope.
+        /*!
+            \param commandBuffer is the CommandBuffer to record the timestamp into.
+            \param name is the name of the scope.
+            \param stage is the pipeline stage the beginning timestamp waits for.
+            \return the index of the scope, used to end it.
+         */
+        std::uint32_t beginScope(CommandBuffer * commandBuffer, const std::string& name, PipelineStageFlag stage = PipelineStageFlag::TOP_OF_PIPE);
+
+        //! Ends a scope.
+        /*!
+            \param commandBuffer is the CommandBuffer to record the timestamp into.
+            \param index is the index returned by beginScope.
+            \param stage is the pipeline stage the ending timestamp waits for.
+         */
+        void endScope(CommandBuffer * commandBuffer, std::uint32_t index, PipelineStageFlag stage = PipelineStageFlag::BOTTOM_OF_PIPE);
+
+        //! Begins a named scope that ends when the returned object is destroyed.
+        /*!
+            \param commandBuffer is the CommandBuffer to record the timestamps into.
+            \param name is the name of the scope.
+            \return the Scope.
+         */
+        inline Scope scope(CommandBuffer * commandBuffer, const std::string& name) {
+            return Scope(this, commandBuffer, beginScope(commandBuffer, name));
+        }
+
+        //! Reads back every frame that the Device has finished, without waiting.
+        void resolve();
+
+        //! Retrieves the results of the most recently resolved frame.
+        /*!
+            \return the results in the order the scopes were begun.
+         */
+        inline const std::vector<Result>& getResults() const noexcept {
+            return _results;
+        }
+
+        //! Retrieves the GPU time of a named scope in the most recently resolved frame.
+        /*!
+            \param name is the name of the scope.
+            \return the sum of the times of every scope with that name, in milliseconds.
+         */
+        double getMilliseconds(const std::string& name) const noexcept;
+
+        //! Retrieves the number of the most recently resolved frame.
+        /*!
+            \return the frame number; 0 if no frame has been resolved.
+         */
+        inline std::uint64_t getResolvedFrame() const noexcept {
+            return _resolvedFrame;
+        }
+
+        //! Retrieves the number of frames whose results were dropped because they were not available in time.
+        /*!
+            \return the dropped frame count.
+         */
+        inline std::size_t getDroppedFrameCount() const noexcept {
+            return _droppedFrameCount;
+        }
+    };
+}
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 
 #include "volk.h"
 
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -28,6 +30,8 @@ namespace mvk {
 
     using UPtrGraphicsPipeline = std::unique_ptr<GraphicsPipeline>;
 
+    using SPtrGraphicsPipeline = std::shared_ptr<GraphicsPipeline>;
+
     //! A Pipeline object for use in a GraphicsPipeline.
     class GraphicsPipeline : public virtual Pipeline {
     public:
@@ -43,6 +47,7 @@ namespace mvk {
             PipelineTessellationStateCreateInfo tessellationState;
             PipelineVertexInputStateCreateInfo vertexInputState;
             int subpass;
+            std::string name;   /*!< Optional name shown by debuggers and profilers. Only used if VK_EXT_debug_utils is enabled. */
         };
 
         static inline UPtrGraphicsPipeline unique_null() {
@@ -50,14 +55,47 @@ namespace mvk {
         }
 
     private:
+        //! The Vulkan construction parameters and the storage they point into.
+        struct NativeCreateInfo {
+            std::vector<VkPipelineShaderStageCreateInfo> stages;
+            std::vector<std::vector<VkSpecializationMapEntry>> specializationMapEntries;
+            std::vector<VkSpecializationInfo> specializationInfos;
+            VkPipelineMultisampleStateCreateInfo multisampleState;
+            VkPipelineRasterizationStateCreateInfo rasterizationState;
+            VkPipelineDepthStencilStateCreateInfo depthStencilState;
+            std::vector<VkDynamicState> dynamicStates;
+            VkPipelineDynamicStateCreateInfo dynamicState;
+            VkPipelineInputAssemblyStateCreateInfo inputAssemblyState;
+            VkPipelineViewportStateCreateInfo viewportState;
+            std::vector<VkVertexInputBindingDescription> bindingDescriptions;
+            std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
+            VkPipelineVertexInputStateCreateInfo vertexInputState;
+            VkPipelineTessellationStateCreateInfo tessellationState;
+            std::vector<VkPipelineColorBlendAttachmentState> attachments;
+            VkPipelineColorBlendStateCreateInfo colorBlendState;
+            VkGraphicsPipelineCreateInfo info;
+
+            NativeCreateInfo(Device * device, const CreateInfo& createInfo, const PipelineLayout * layout, const RenderPass * renderPass);
+
+            NativeCreateInfo(const NativeCreateInfo&) = delete;
+            NativeCreateInfo& operator= (const NativeCreateInfo&) = delete;
+        };
+
         VkPipeline _handle;
+        std::uint64_t _serial;
         CreateInfo _info;
+        Device * _device;
         PipelineCache * _cache;
         PipelineLayout * _layout;
 
         GraphicsPipeline(const GraphicsPipeline&) = delete;
         GraphicsPipeline& operator= (const GraphicsPipeline&) = delete;
 
+        // adopts a pipeline compiled by PipelineCache::createPipelines
+        GraphicsPipeline(PipelineCache * cache, const CreateInfo& createInfo, PipelineLayout * layout, VkPipeline handle);
+
+        friend class PipelineCache;
+
     public:
         //! The user-defined metadata.
         std::shared_ptr<void> userData;
@@ -65,6 +103,8 @@ namespace mvk {
         //! Creates an empty GraphicsPipeline.
         GraphicsPipeline() noexcept:
             _handle(VK_NULL_HANDLE),
+            _serial(0),
+            _device(nullptr),
             _cache(nullptr),
             _layout(nullptr) {}
 
@@ -78,7 +118,9 @@ namespace mvk {
 
         GraphicsPipeline(GraphicsPipeline&& from) noexcept:
             _handle(std::exchange(from._handle, nullptr)),
+            _serial(std::exchange(from._serial, 0)),
             _info(std::move(from._info)),
+            _device(std::move(from._device)),
             _cache(std::move(from._cache)),
             _layout(std::move(from._layout)) {}
 
@@ -136,6 +178,12 @@ namespace mvk {
         */
         virtual VkPipeline getHandle() const noexcept;
 
+        //! Retrieves the serial number.
+        /*!
+            \return the serial number.
+        */
+        virtual std::uint64_t getSerial() const noexcept;
+
         //! Implicitly casts to the underlying Vulkan handle.
         inline operator VkPipeline() const noexcept {
             return getHandle();
@@ -5,6 +5,7 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -44,6 +45,7 @@ namespace mvk {
             std::vector<QueueFamily *> queueFamilies;   /*!< Set of QueueFamilies that can access the Image. */
             ImageLayout initialLayout;                  /*!< Initial Layout of the Image. This should be UNDEFINED unless the image was constructed as LINEAR tiling. */
             bool exported;                              /*!< Specifies if the backing memory should be exported */
+            std::string name;                           /*!< Optional name shown by debuggers and profilers. Only used if VK_EXT_debug_utils is enabled. */
         };
 
         //! Constructs a Image-typed unique_ptr pointing to nothing.
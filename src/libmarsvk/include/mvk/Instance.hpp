@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 
+#include "mvk/DebugReport.hpp"
 #include "mvk/InstanceLayer.hpp"
 #include "mvk/PhysicalDevice.hpp"
 #include "mvk/Util.hpp"
@@ -18,6 +19,8 @@ namespace mvk {
     class Instance {
         VkInstance _handle;
         std::vector<PhysicalDevice> _physicalDevices;
+        std::unique_ptr<DebugReport> _debugReport;
+        VkDebugUtilsMessengerEXT _debugMessenger;
 
         Instance();
 
@@ -29,7 +32,10 @@ namespace mvk {
 
         public:
             Instance(Instance&& from) noexcept:
-                _handle(std::exchange(from._handle, nullptr)) {}
+                _handle(std::exchange(from._handle, nullptr)),
+                _physicalDevices(std::move(from._physicalDevices)),
+                _debugReport(std::move(from._debugReport)),
+                _debugMessenger(std::exchange(from._debugMessenger, nullptr)) {}
 
             Instance& operator= (Instance&& from) noexcept;
 
@@ -57,6 +63,7 @@ namespace mvk {
             /*!
                 The extensions required by GLFW are system dependent.
                 The application may terminate if an extension is not available.
+                Applications calling this or creating a Surface must link GLFW.
                 This method is only valid if the Instance has not yet been initialized.
             */
             static void enableRequiredGLFWExtensions() noexcept;
@@ -69,6 +76,21 @@ namespace mvk {
             */
             static void enableExtension(const std::string& extension) noexcept;
 
+            //! Checks if an extension was enabled by name.
+            /*!
+                \param extension the name of the extension.
+                \return true if the extension was enabled.
+            */
+            static bool isExtensionEnabled(const std::string& extension) noexcept;
+
+            //! Sets the file the DebugReport is written to when the Instance is freed.
+            /*!
+                If no path is set, the MVK_DEBUG_REPORT environment variable is used instead.
+                Nothing is written if neither is set or VK_EXT_debug_utils is not enabled.
+                \param path the path of the JSON report.
+            */
+            static void setDebugReportPath(const std::string& path) noexcept;
+
             //! Retrieves the current Instance.
             /*!
                 This will initialize the Instance if it has not yet been initialized.
@@ -117,6 +139,15 @@ namespace mvk {
                 return _physicalDevices;
             }
 
+            //! Retrieves the DebugReport collecting validation and performance messages.
+            /*!
+                VK_EXT_debug_utils is enabled automatically alongside the validation layers in debug builds.
+                \return the DebugReport; nullptr if VK_EXT_debug_utils is not enabled.
+            */
+            inline DebugReport * getDebugReport() const noexcept {
+                return _debugReport.get();
+            }
+
             //! Implicitly casts the Instance to a Vulkan Instance handle.
             inline operator VkInstance() const noexcept {
                 return _handle;
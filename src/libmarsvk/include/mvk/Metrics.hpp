@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace mvk {
+    class Metrics;
+
+    using UPtrMetrics = std::unique_ptr<Metrics>;
+
+    //! Registry of counters and histograms describing how the library behaves under load.
+    /*!
+        Every Device owns a Metrics registry. All updates use relaxed atomics so they may be made from
+        any thread without locking.
+
+        Collection is only compiled in when MVK_ENABLE_METRICS is defined (gradle -Pmetrics). Otherwise
+        the MVK_METRICS_* macros expand to nothing, the registry holds no storage and snapshots report
+        that metrics are disabled.
+     */
+    class Metrics {
+    public:
+        //! The counters tracked by the registry.
+        enum class Counter : unsigned int {
+            FENCE_ALLOCATIONS,                  /*!< Fences created by the FencePool. */
+            FENCE_REUSES,                       /*!< Fences acquired from the FencePool without creating one. */
+            SEMAPHORE_ALLOCATIONS,              /*!< Semaphores created by the SemaphorePool. */
+            SEMAPHORE_REUSES,                   /*!< Semaphores acquired from the SemaphorePool without creating one. */
+            DESCRIPTOR_SET_ALLOCATIONS,         /*!< DescriptorSets allocated from DescriptorPools. */
+            DESCRIPTOR_SET_RELEASES,            /*!< DescriptorSets returned to DescriptorPools. */
+            DESCRIPTOR_POOL_ALLOCATIONS,        /*!< Vulkan descriptor pools created because every existing pool was full. */
+            DESCRIPTOR_SET_LAYOUT_CACHE_HITS,   /*!< DescriptorSetLayouts found in the DescriptorSetLayoutCache. */
+            DESCRIPTOR_SET_LAYOUT_CACHE_MISSES, /*!< DescriptorSetLayouts created by the DescriptorSetLayoutCache. */
+            PIPELINE_LAYOUT_CACHE_HITS,         /*!< PipelineLayouts found in the PipelineLayoutCache. */
+            PIPELINE_LAYOUT_CACHE_MISSES,       /*!< PipelineLayouts created by the PipelineLayoutCache. */
+            SAMPLER_CACHE_HITS,                 /*!< Samplers found in the SamplerCache. */
+            SAMPLER_CACHE_MISSES,               /*!< Samplers created by the SamplerCache. */
+            SHADER_MODULE_CACHE_HITS,           /*!< ShaderModules found in the Device shader cache. */
+            SHADER_MODULE_CACHE_MISSES,         /*!< ShaderModules created by the Device shader cache. */
+            SHARED_PIPELINE_HITS,               /*!< Shared pipelines found in the PipelineCache. */
+            SHARED_PIPELINE_MISSES,             /*!< Shared pipelines created by the PipelineCache. */
+            PIPELINES_CREATED,                  /*!< Pipelines created through the PipelineCache. */
+            QUEUE_SUBMITS,                      /*!< Calls to vkQueueSubmit. */
+            PIPELINE_BARRIERS,                  /*!< Pipeline barriers recorded, including image layout transitions. */
+            BYTES_UPLOADED,                     /*!< Bytes written by the host for the Device: FrameAllocator data and copies from host-visible Buffers. */
+            COUNT
+        };
+
+        //! The timers tracked by the registry. Each timer is a histogram of durations in nanoseconds.
+        enum class Timer : unsigned int {
+            CREATE_BUFFER,                      /*!< Time spent creating Buffers, including memory allocation. */
+            CREATE_IMAGE,                       /*!< Time spent creating Images, including memory allocation. */
+            CREATE_IMAGE_VIEW,                  /*!< Time spent in vkCreateImageView. */
+            CREATE_BUFFER_VIEW,                 /*!< Time spent in vkCreateBufferView. */
+            CREATE_PIPELINE,                    /*!< Time spent in vkCreateGraphicsPipelines and vkCreateComputePipelines. */
+            CREATE_PIPELINE_LAYOUT,             /*!< Time spent in vkCreatePipelineLayout and vkCreateDescriptorSetLayout. */
+            CREATE_SHADER_MODULE,               /*!< Time spent in vkCreateShaderModule. */
+            CREATE_DESCRIPTOR_POOL,             /*!< Time spent in vkCreateDescriptorPool. */
+            CREATE_SAMPLER,                     /*!< Time spent in vkCreateSampler. */
+            CREATE_SYNC,                        /*!< Time spent in vkCreateFence and vkCreateSemaphore. */
+            CREATE_RENDER_PASS,                 /*!< Time spent in vkCreateRenderPass. */
+            CREATE_FRAMEBUFFER,                 /*!< Time spent in vkCreateFramebuffer. */
+            QUEUE_SUBMIT,                       /*!< Time spent in vkQueueSubmit. */
+            COUNT
+        };
+
+        //! Number of power-of-two buckets in each histogram.
+        static constexpr std::size_t HISTOGRAM_BUCKETS = 40;
+
+        //! Records the time between its construction and destruction into a Timer.
+        class ScopedTimer {
+            Metrics * _metrics;
+            Timer _timer;
+            std::chrono::steady_clock::time_point _start;
+
+            ScopedTimer(const ScopedTimer&) = delete;
+            ScopedTimer& operator= (const ScopedTimer&) = delete;
+
+        public:
+            ScopedTimer(Metrics& metrics, Timer timer) noexcept:
+                _metrics(&metrics),
+                _timer(timer),
+                _start(std::chrono::steady_clock::now()) {}
+
+            ~ScopedTimer() noexcept {
+                const auto elapsed = std::chrono::steady_clock::now() - _start;
+
+                _metrics->record(_timer, static_cast<std::uint64_t> (std::chrono::duration_cast<std::chrono::nanoseconds> (elapsed).count()));
+            }
+        };
+
+        //! Retrieves the name of a Counter as it appears in snapshots.
+        static const char * getName(Counter counter) noexcept;
+
+        //! Retrieves the name of a Timer as it appears in snapshots.
+        static const char * getName(Timer timer) noexcept;
+
+        //! Checks if collection was compiled in.
+        /*!
+            \return true if MVK_ENABLE_METRICS was defined.
+         */
+        static constexpr bool isEnabled() noexcept {
+#if defined(MVK_ENABLE_METRICS)
+            return true;
+#else
+            return false;
+#endif
+        }
+
+    private:
+#if defined(MVK_ENABLE_METRICS)
+        struct Histogram {
+            std::atomic<std::uint64_t> count;
+            std::atomic<std::uint64_t> sum;
+            std::atomic<std::uint64_t> max;
+            std::array<std::atomic<std::uint64_t>, HISTOGRAM_BUCKETS> buckets;
+        };
+
+        std::array<std::atomic<std::uint64_t>, static_cast<std::size_t> (Counter::COUNT)> _counters;
+        std::array<Histogram, static_cast<std::size_t> (Timer::COUNT)> _histograms;
+        std::chrono::steady_clock::time_point _start;
+#endif
+
+        Metrics(const Metrics&) = delete;
+        Metrics& operator= (const Metrics&) = delete;
+
+    public:
+        //! Constructs a Metrics registry with every value cleared.
+        Metrics() noexcept;
+
+        //! Clears every counter and histogram and restarts the uptime.
+        void reset() noexcept;
+
+        //! Adds to a counter.
+        /*!
+            \param counter is the counter.
+            \param value is the amount to add.
+         */
+        inline void add(Counter counter, std::uint64_t value = 1) noexcept {
+#if defined(MVK_ENABLE_METRICS)
+            _counters[static_cast<std::size_t> (counter)].fetch_add(value, std::memory_order_relaxed);
+#endif
+        }
+
+        //! Records a duration.
+        /*!
+            \param timer is the timer.
+            \param nanoseconds is the duration, in nanoseconds.
+         */
+        void record(Timer timer, std::uint64_t nanoseconds) noexcept;
+
+        //! Retrieves the current value of a counter.
+        /*!
+            \param counter is the counter.
+            \return the value; always 0 if collection is disabled.
+         */
+        std::uint64_t get(Counter counter) const noexcept;
+
+        //! Retrieves the number of seconds since the registry was constructed or reset.
+        /*!
+            \return the uptime in seconds; always 0 if collection is disabled.
+         */
+        double getUptime() const noexcept;
+
+        //! Captures every counter and histogram as a JSON object.
+        /*!
+            The snapshot holds the uptime, every counter, derived rates (such as submits per second) and,
+            for every timer, its count, sum, mean and max in nanoseconds along with the power-of-two bucket counts.
+
+            \return the JSON text.
+         */
+        std::string toJSON() const;
+    };
+}
+
+#if defined(MVK_ENABLE_METRICS)
+//! Adds a value to a Metrics::Counter of a Device.
+#define MVK_METRICS_ADD(device, counter, value) ((device)->getMetrics().add(::mvk::Metrics::Counter::counter, (value)))
+
+//! Times the rest of the enclosing scope into a Metrics::Timer of a Device.
+#define MVK_METRICS_SCOPED_TIMER(device, timer) ::mvk::Metrics::ScopedTimer mvkMetricsScopedTimer((device)->getMetrics(), ::mvk::Metrics::Timer::timer)
+#else
+#define MVK_METRICS_ADD(device, counter, value) ((void) 0)
+
+#define MVK_METRICS_SCOPED_TIMER(device, timer) ((void) 0)
+#endif
+
+//! Increments a Metrics::Counter of a Device.
+#define MVK_METRICS_INCREMENT(device, counter) MVK_METRICS_ADD(device, counter, 1)
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "volk.h"
+
+#include <memory>
+#include <vector>
+
+#include "mvk/Buffer.hpp"
+#include "mvk/QueryPool.hpp"
+
+namespace mvk {
+    class CommandBuffer;
+    class Device;
+
+    class OcclusionCuller;
+
+    using UPtrOcclusionCuller = std::unique_ptr<OcclusionCuller>;
+
+    //! GPU-side visibility culling with occlusion queries and conditional rendering.
+    /*!
+        Each object owns one occlusion query slot and one 32bit predicate inside a shared predicate
+        Buffer. At the start of each frame the query results of the previous frame are copied into
+        the predicates on the GPU, so the host never reads them back. Draws wrapped in beginConditional
+        and endConditional are then discarded by the GPU if the object was not visible last frame.
+
+        The occlusion test should draw a conservative proxy (such as a bounding box) that is not itself
+        predicated; otherwise an object that becomes hidden can never become visible again. Objects
+        that are not tested in a frame keep their previous predicate. The first frame treats every
+        object as visible.
+
+        If VK_EXT_conditional_rendering is not enabled on the Device, beginConditional and endConditional
+        record nothing and every object is drawn.
+
+        All frames must be submitted to the same Queue in order.
+     */
+    class OcclusionCuller {
+    public:
+        //! Parameter structure specifying how to construct a new OcclusionCuller.
+        struct CreateInfo {
+            std::uint32_t objectCount;  /*!< The number of objects. */
+            bool precise;               /*!< Requests exact sample counts. Ignored if the occlusionQueryPrecise feature is not enabled. */
+        };
+
+        //! Constructs an OcclusionCuller-typed unique_ptr pointing to null.
+        /*!
+            \return unique_ptr<OcclusionCuller> pointing to nullptr.
+         */
+        static inline UPtrOcclusionCuller unique_null() {
+            return std::unique_ptr<OcclusionCuller> ();
+        }
+
+    private:
+        Device * _device;
+        CreateInfo _info;
+        UPtrQueryPool _queryPool;
+        UPtrBuffer _predicates;
+        std::vector<bool> _tested;
+        bool _initialized;
+        bool _conditionalRendering;
+
+        OcclusionCuller(const OcclusionCuller&) = delete;
+        OcclusionCuller& operator= (const OcclusionCuller&) = delete;
+
+    public:
+        //! Constructs a new OcclusionCuller.
+        /*!
+            \param device is the Device used to create the QueryPool and predicate Buffer.
+            \param createInfo is the construction parameters.
+         */
+        OcclusionCuller(Device * device, const CreateInfo& createInfo);
+
+        //! Deletes the OcclusionCuller and releases the QueryPool and predicate Buffer.
+        ~OcclusionCuller() noexcept = default;
+
+        //! Retrieves the parent Device.
+        /*!
+            \return the Device.
+         */
+        inline Device * getDevice() const noexcept {
+            return _device;
+        }
+
+        //! Retrieves the construction parameters.
+        /*!
+            \return the reference to an immutable copy of the parameter struct.
+         */
+        inline const CreateInfo& getInfo() const noexcept {
+            return _info;
+        }
+
+        //! Retrieves the QueryPool holding one occlusion query per object.
+        /*!
+            \return the QueryPool.
+         */
+        inline QueryPool * getQueryPool() const noexcept {
+            return _queryPool.get();
+        }
+
+        //! Retrieves the Buffer holding one 32bit predicate per object.
+        /*!
+            \return the predicate Buffer.
+         */
+        inline Buffer * getPredicateBuffer() const noexcept {
+            return _predicates.get();
+        }
+
+        //! Checks if draws are predicated on the GPU.
+        /*!
+            \return true if VK_EXT_conditional_rendering is enabled on the Device.
+         */
+        inline bool isConditionalRenderingEnabled() const noexcept {
+            return _conditionalRendering;
+        }
+
+        //! Updates the predicates from the previous frame and resets the queries.
+        /*!
+            This must be recorded outside of a RenderPass, before any query or conditional draw of the frame.
+
+            \param commandBuffer is the CommandBuffer to record into.
+         */
+        void beginFrame(CommandBuffer * commandBuffer);
+
+        //! Begins the occlusion test of an object.
+        /*!
+            \param commandBuffer is the CommandBuffer to record into. It must be inside a subpass.
+            \param object is the index of the object.
+         */
+        void beginQuery(CommandBuffer * commandBuffer, std::uint32_t object);
+
+        //! Ends the occlusion test of an object.
+        /*!
+            \param commandBuffer is the CommandBuffer to record into.
+            \param object is the index of the object.
+         */
+        void endQuery(CommandBuffer * commandBuffer, std::uint32_t object) noexcept;
+
+        //! Begins a block of draws that are discarded if the object was not visible last frame.
+        /*!
+            \param commandBuffer is the CommandBuffer to record into.
+            \param object is the index of the object.
+         */
+        void beginConditional(CommandBuffer * commandBuffer, std::uint32_t object) noexcept;
+
+        //! Ends the block of conditional draws.
+        /*!
+            \param commandBuffer is the CommandBuffer to record into.
+         */
+        void endConditional(CommandBuffer * commandBuffer) noexcept;
+    };
+}
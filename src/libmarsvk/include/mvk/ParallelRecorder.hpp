@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "volk.h"
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "mvk/CommandBuffer.hpp"
+#include "mvk/CommandBufferUsageFlag.hpp"
+
+namespace mvk {
+    class Framebuffer;
+    class QueueFamily;
+
+    class ParallelRecorder;
+
+    using UPtrParallelRecorder = std::unique_ptr<ParallelRecorder>;
+
+    //! Splits the draws of a single subpass across worker threads.
+    /*!
+        Each worker thread records a range of the draws into a secondary CommandBuffer allocated from
+        the CommandPool owned by that thread. The secondary CommandBuffers are then executed in order
+        by the primary CommandBuffer.
+
+        The secondary CommandBuffers are reused every frameCount calls to record; the caller must ensure
+        the submission that consumed them has completed by then.
+     */
+    class ParallelRecorder {
+    public:
+        //! Parameter structure specifying how to construct a new ParallelRecorder.
+        struct CreateInfo {
+            QueueFamily * queueFamily;  /*!< The QueueFamily the CommandBuffers will be submitted to. */
+            std::size_t threadCount;    /*!< The number of worker threads. 0 selects the number of hardware threads. */
+            std::uint32_t frameCount;   /*!< The number of sets of secondary CommandBuffers; generally the number of frames in flight. */
+        };
+
+        //! Function that records the draws [first, last) into a secondary CommandBuffer.
+        using RecordFunction = std::function<void(CommandBuffer * commandBuffer, std::size_t first, std::size_t last)>;
+
+        //! Constructs a ParallelRecorder-typed unique_ptr pointing to null.
+        /*!
+            \return unique_ptr<ParallelRecorder> pointing to nullptr.
+         */
+        static inline UPtrParallelRecorder unique_null() {
+            return std::unique_ptr<ParallelRecorder> ();
+        }
+
+    private:
+        struct Worker {
+            std::thread thread;
+            std::vector<UPtrCommandBuffer> commandBuffers;
+            std::size_t first;
+            std::size_t last;
+            std::exception_ptr error;
+        };
+
+        CreateInfo _info;
+        std::vector<std::unique_ptr<Worker>> _workers;
+        std::mutex _lock;
+        std::condition_variable _workAvailable;
+        std::condition_variable _workDone;
+        std::uint64_t _generation;
+        std::size_t _pending;
+        bool _shutdown;
+        std::uint32_t _frameIndex;
+        const Framebuffer * _framebuffer;
+        int _subpass;
+        const RecordFunction * _recordFunction;
+
+        ParallelRecorder(const ParallelRecorder&) = delete;
+        ParallelRecorder& operator= (const ParallelRecorder&) = delete;
+
+        void work(Worker * worker);
+
+    public:
+        //! Constructs a new ParallelRecorder and starts its worker threads.
+        /*!
+            \param createInfo is the construction parameters.
+         */
+        ParallelRecorder(const CreateInfo& createInfo);
+
+        //! Waits for the QueueFamily to go idle, then stops the worker threads and frees the secondary CommandBuffers.
+        ~ParallelRecorder() noexcept;
+
+        //! Retrieves the construction parameters.
+        /*!
+            \return the reference to an immutable copy of the parameter struct.
+         */
+        inline const CreateInfo& getInfo() const noexcept {
+            return _info;
+        }
+
+        //! Retrieves the number of worker threads.
+        /*!
+            \return the number of worker threads.
+         */
+        inline std::size_t getThreadCount() const noexcept {
+            return _workers.size();
+        }
+
+        //! Records draws in parallel and executes them in the primary CommandBuffer.
+        /*!
+            The primary CommandBuffer must be inside a RenderPass begun with SubpassContents::SECONDARY_COMMAND_BUFFERS.
+            This call blocks until all workers have finished recording. Any exception thrown by the RecordFunction
+            is rethrown here.
+
+            \param primary is the primary CommandBuffer that executes the secondary CommandBuffers.
+            \param framebuffer is the Framebuffer the RenderPass was begun with.
+            \param subpass is the index of the current subpass.
+            \param drawCount is the number of draws to split across the workers.
+            \param recordFunction is the function invoked by each worker with its range of draws.
+         */
+        void record(CommandBuffer * primary, const Framebuffer * framebuffer, int subpass, std::size_t drawCount, const RecordFunction& recordFunction);
+
+        inline void record(const std::unique_ptr<CommandBuffer>& primary, const std::unique_ptr<Framebuffer>& framebuffer, int subpass, std::size_t drawCount, const RecordFunction& recordFunction) {
+            record(primary.get(), framebuffer.get(), subpass, drawCount, recordFunction);
+        }
+    };
+}
@@ -38,6 +38,13 @@ namespace mvk {
 
         PhysicalDeviceType getPhysicalDeviceType() const noexcept;
 
+        //! Checks if the PhysicalDevice supports a device extension.
+        /*!
+            \param extName is the name of the extension.
+            \return true if the extension can be enabled on a Device.
+        */
+        bool isExtensionSupported(const std::string& extName) const;
+
         inline std::unique_ptr<Device> createDevice(const std::set<std::string>& enabledExtensions) {
             return std::make_unique<Device> (this, enabledExtensions);
         }
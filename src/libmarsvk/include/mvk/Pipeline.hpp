@@ -1,12 +1,15 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 
 #include "volk.h"
 
+#include <string>
 #include <vector>
 
 #include "mvk/PipelineBindPoint.hpp"
+#include "mvk/ShaderStage.hpp"
 
 namespace mvk {
     class DescriptorSetLayout;
@@ -16,6 +19,48 @@ namespace mvk {
 
     class Pipeline {
     public:
+        //! A statistic reported by the driver for a single pipeline executable.
+        struct ExecutableStatistic {
+            //! The type of the value.
+            enum class Format {
+                BOOL32,
+                INT64,
+                UINT64,
+                FLOAT64
+            };
+
+            std::string name;           /*!< The short name of the statistic, such as "Register Count". */
+            std::string description;    /*!< The description of the statistic. */
+            Format format;              /*!< Selects the active member of value. */
+
+            union {
+                bool b32;
+                std::int64_t i64;
+                std::uint64_t u64;
+                double f64;
+            } value;                    /*!< The value of the statistic. */
+        };
+
+        //! The statistics of a pipeline executable, which is usually a single compiled shader stage.
+        struct ExecutableStatistics {
+            std::string name;                               /*!< The name the driver gives the executable. */
+            std::string description;                        /*!< The description of the executable. */
+            ShaderStage stages;                             /*!< The shader stages compiled into the executable. */
+            std::uint32_t subgroupSize;                     /*!< The subgroup size the executable runs with, or 0 if not applicable. */
+            std::vector<ExecutableStatistic> statistics;    /*!< Driver specific statistics such as register, instruction and spill counts. */
+        };
+
+        //! Queries the executable statistics of a Vulkan pipeline.
+        /*!
+            Statistics are only available for pipelines created while VK_KHR_pipeline_executable_properties
+            was enabled on the Device; every ComputePipeline and GraphicsPipeline then captures them.
+
+            \param device is the Device that created the pipeline.
+            \param handle is the pipeline.
+            \return one entry per executable, or an empty vector if the statistics were not captured.
+        */
+        static std::vector<ExecutableStatistics> getExecutableStatistics(const Device * device, VkPipeline handle);
+
         virtual PipelineBindPoint getBindPoint() const noexcept = 0;
 
         virtual void release() = 0;
@@ -31,5 +76,22 @@ namespace mvk {
         virtual std::vector<DescriptorSetLayout * > getDescriptorSetLayouts() const noexcept = 0;
 
         virtual VkPipeline getHandle() const noexcept = 0;
+
+        //! Retrieves the serial number of the Pipeline.
+        /*!
+            Serial numbers are unique for the lifetime of the process, so unlike Vulkan handles they are never
+            reused by a Pipeline created after this one is destroyed.
+
+            \return the serial number, or 0 for an empty Pipeline.
+        */
+        virtual std::uint64_t getSerial() const noexcept = 0;
+
+        //! Queries the executable statistics of this Pipeline.
+        /*!
+            \return one entry per executable, or an empty vector if the statistics were not captured.
+        */
+        inline std::vector<ExecutableStatistics> getExecutableStatistics() const {
+            return getExecutableStatistics(getDevice(), getHandle());
+        }
     };
 }
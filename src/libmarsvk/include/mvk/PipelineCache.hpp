@@ -1,35 +1,110 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include "volk.h"
 
+#include <condition_variable>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "mvk/ComputePipeline.hpp"
 #include "mvk/GraphicsPipeline.hpp"
+#include "mvk/PipelineKey.hpp"
+#include "mvk/RenderPass.hpp"
 
 namespace mvk {
     class Device;
+    class PipelineManifest;
     class RenderPass;
 
     class PipelineCache {
+    public:
+        //! Parameters controlling how createPipelines compiles a batch of pipelines.
+        struct BatchInfo {
+            std::size_t threadCount;        /*!< The number of compiler threads, including the calling thread. 0 selects the number of hardware threads. */
+            std::size_t pipelinesPerCall;   /*!< The number of pipelines passed to each vkCreate*Pipelines call. 0 gives every thread about 4 calls. */
+            bool mergeCaches;               /*!< Compile into a VkPipelineCache per thread and merge them into this PipelineCache afterwards instead of sharing it. */
+        };
+
+        //! Usage statistics of the shared pipelines returned by getPipeline.
+        struct SharedPipelineStatistics {
+            std::uint64_t hits;             /*!< The number of getPipeline calls that returned an existing pipeline. */
+            std::uint64_t misses;           /*!< The number of getPipeline calls that created a pipeline. */
+            std::size_t pipelineCount;      /*!< The number of shared pipelines currently held. */
+
+            //! Retrieves the fraction of getPipeline calls that returned an existing pipeline.
+            inline double getHitRate() const noexcept {
+                return (0 == hits + misses) ? 0.0 : static_cast<double> (hits) / static_cast<double> (hits + misses);
+            }
+        };
+
+    private:
+        struct PipelineRecord {
+            PipelineBindPoint bindPoint;
+            std::string name;
+            std::vector<Pipeline::ExecutableStatistics> executables;
+        };
+
         Device * _device;
         VkPipelineCache _handle;
+        std::string _path;
+        mutable std::mutex _lock;
+        std::vector<PipelineRecord> _pipelines;
+        std::unordered_map<PipelineKey, SPtrComputePipeline> _sharedComputePipelines;
+        std::unordered_map<PipelineKey, SPtrGraphicsPipeline> _sharedGraphicsPipelines;
+        std::unordered_set<PipelineKey> _pendingComputePipelines;
+        std::unordered_set<PipelineKey> _pendingGraphicsPipelines;
+        mutable std::mutex _sharedLock;
+        std::condition_variable _sharedReady;
+        std::uint64_t _sharedHits;
+        std::uint64_t _sharedMisses;
+        PipelineManifest * _manifest;
 
         PipelineCache(const PipelineCache&) = delete;
 
         PipelineCache& operator= (const PipelineCache&) = delete;
 
+        // compiles the pipelines [first, first + count) into the given VkPipelineCache
+        using CompileFunction = std::function<VkResult(VkPipelineCache cache, std::size_t first, std::size_t count)>;
+
+        void compile(std::size_t pipelineCount, const BatchInfo& batchInfo, const CompileFunction& compileFunction);
+
     public:
         PipelineCache() noexcept:
             _device(nullptr),
-            _handle(VK_NULL_HANDLE) {}
+            _handle(VK_NULL_HANDLE),
+            _sharedHits(0),
+            _sharedMisses(0),
+            _manifest(nullptr) {}
             
-        PipelineCache(Device * device);
+        //! Constructs a PipelineCache.
+        /*!
+            \param device is the Device.
+            \param path is the file the VkPipelineCache data is loaded from and saved to when the PipelineCache is
+            deleted. Data of another driver or device is ignored, as is a missing file. If empty, nothing is loaded or saved.
+        */
+        PipelineCache(Device * device, const std::string& path = std::string());
 
         PipelineCache(PipelineCache&& from) noexcept:
             _device(std::move(from._device)),
-            _handle(std::exchange(from._handle, nullptr)) {}        
+            _handle(std::exchange(from._handle, nullptr)),
+            _path(std::move(from._path)),
+            _pipelines(std::move(from._pipelines)),
+            _sharedComputePipelines(std::move(from._sharedComputePipelines)),
+            _sharedGraphicsPipelines(std::move(from._sharedGraphicsPipelines)),
+            _pendingComputePipelines(std::move(from._pendingComputePipelines)),
+            _pendingGraphicsPipelines(std::move(from._pendingGraphicsPipelines)),
+            _sharedHits(std::exchange(from._sharedHits, 0)),
+            _sharedMisses(std::exchange(from._sharedMisses, 0)),
+            _manifest(std::exchange(from._manifest, nullptr)) {}
 
         ~PipelineCache() noexcept;
 
@@ -43,6 +118,128 @@ namespace mvk {
             return std::make_unique<GraphicsPipeline> (this, createInfo, renderPass);
         }
 
+        //! Creates many ComputePipelines at once.
+        /*!
+            The PipelineLayouts and ShaderModules are resolved on the calling thread; the pipelines are then
+            compiled with multi-pipeline vkCreateComputePipelines calls spread across a pool of threads.
+            If any pipeline fails to compile, every pipeline of the batch is destroyed and the error is thrown.
+
+            \param createInfos is the construction parameters of every pipeline.
+            \param batchInfo controls the threads and the number of pipelines per call.
+            \return the ComputePipelines in the order of createInfos.
+        */
+        std::vector<UPtrComputePipeline> createPipelines(const std::vector<ComputePipeline::CreateInfo>& createInfos, const BatchInfo& batchInfo = BatchInfo {});
+
+        //! Creates many GraphicsPipelines at once.
+        /*!
+            The PipelineLayouts and ShaderModules are resolved on the calling thread; the pipelines are then
+            compiled with multi-pipeline vkCreateGraphicsPipelines calls spread across a pool of threads.
+            If any pipeline fails to compile, every pipeline of the batch is destroyed and the error is thrown.
+
+            \param createInfos is the construction parameters of every pipeline.
+            \param renderPasses is the RenderPass of each pipeline, in the order of createInfos.
+            \param batchInfo controls the threads and the number of pipelines per call.
+            \return the GraphicsPipelines in the order of createInfos.
+        */
+        std::vector<UPtrGraphicsPipeline> createPipelines(const std::vector<GraphicsPipeline::CreateInfo>& createInfos, const std::vector<const RenderPass * >& renderPasses, const BatchInfo& batchInfo = BatchInfo {});
+
+        //! Creates many GraphicsPipelines that are used in the same RenderPass.
+        inline std::vector<UPtrGraphicsPipeline> createPipelines(const std::vector<GraphicsPipeline::CreateInfo>& createInfos, const RenderPass * renderPass, const BatchInfo& batchInfo = BatchInfo {}) {
+            return createPipelines(createInfos, std::vector<const RenderPass * > (createInfos.size(), renderPass), batchInfo);
+        }
+
+        //! Retrieves a ComputePipeline that is shared by every caller with an equivalent CreateInfo.
+        /*!
+            The pipelines are keyed by a PipelineKey of the full CreateInfo, so requests that only differ by
+            their debug name return the same pipeline. The pipeline stays alive while any caller holds it and
+            until trim is called after the last caller released it. If the same pipeline is being compiled on
+            another thread, for example by prewarm, this waits for it instead of compiling it again.
+
+            A shared pipeline that is still held when the PipelineCache is destroyed is detached from it: its
+            getPipelineCache returns nullptr, and it must still be released before the Device is destroyed.
+
+            \param createInfo is the construction parameters of the ComputePipeline.
+            \return the shared ComputePipeline.
+        */
+        SPtrComputePipeline getPipeline(const ComputePipeline::CreateInfo& createInfo);
+
+        //! Retrieves a GraphicsPipeline that is shared by every caller with an equivalent CreateInfo.
+        /*!
+            The pipelines are keyed by a PipelineKey of the full CreateInfo and the compatibility class of the
+            RenderPass, so a pipeline is reused with any compatible RenderPass.
+
+            \param createInfo is the construction parameters of the GraphicsPipeline.
+            \param renderPass is the RenderPass the GraphicsPipeline is used in.
+            \return the shared GraphicsPipeline.
+        */
+        SPtrGraphicsPipeline getPipeline(const GraphicsPipeline::CreateInfo& createInfo, const RenderPass * renderPass);
+
+        //! Destroys the shared pipelines that are no longer held outside of this PipelineCache.
+        /*!
+            \return the number of destroyed pipelines.
+        */
+        std::size_t trim();
+
+        //! Creates the shared ComputePipeline of a CreateInfo ahead of its first getPipeline call.
+        /*!
+            This does not count as a hit or miss in the SharedPipelineStatistics.
+
+            \param createInfo is the construction parameters of the ComputePipeline.
+            \return true if the pipeline was created; false if it was already held or being created.
+        */
+        bool prewarm(const ComputePipeline::CreateInfo& createInfo);
+
+        //! Creates the shared GraphicsPipeline of a CreateInfo ahead of its first getPipeline call.
+        /*!
+            The pipeline is compiled against a temporary RenderPass, so it is returned by getPipeline for any
+            compatible RenderPass. This does not count as a hit or miss in the SharedPipelineStatistics.
+
+            \param createInfo is the construction parameters of the GraphicsPipeline.
+            \param renderPassInfo is the construction parameters of a RenderPass the pipeline is used in.
+            \return true if the pipeline was created; false if it was already held or being created.
+        */
+        bool prewarm(const GraphicsPipeline::CreateInfo& createInfo, const RenderPass::CreateInfo& renderPassInfo);
+
+        //! Records the pipelines the application requests into a PipelineManifest.
+        /*!
+            Pipelines created by getPipeline and by the asynchronous creation of the Device are recorded once they
+            compiled. Direct createPipeline and createPipelines calls are not recorded; they are used for one-off
+            pipelines such as WorkgroupTuner candidates, which would otherwise grow the manifest without bound.
+            It must be set before pipelines are created on other threads.
+
+            \param manifest is the PipelineManifest. It must outlive this PipelineCache. nullptr stops recording.
+        */
+        inline void setManifest(PipelineManifest * manifest) noexcept {
+            _manifest = manifest;
+        }
+
+        //! Retrieves the PipelineManifest pipelines are recorded into.
+        /*!
+            \return the PipelineManifest; nullptr if pipelines are not recorded.
+        */
+        inline PipelineManifest * getManifest() const noexcept {
+            return _manifest;
+        }
+
+        //! Records a ComputePipeline into the PipelineManifest. Does nothing if no manifest is set.
+        /*!
+            \param createInfo is the construction parameters of a pipeline that was created successfully.
+        */
+        void record(const ComputePipeline::CreateInfo& createInfo);
+
+        //! Records a GraphicsPipeline into the PipelineManifest. Does nothing if no manifest is set.
+        /*!
+            \param createInfo is the construction parameters of a pipeline that was created successfully.
+            \param renderPass is the RenderPass the pipeline was created for.
+        */
+        void record(const GraphicsPipeline::CreateInfo& createInfo, const RenderPass * renderPass);
+
+        //! Retrieves the usage statistics of the shared pipelines.
+        /*!
+            \return the statistics.
+        */
+        SharedPipelineStatistics getSharedPipelineStatistics() const;
+
         inline Device * getDevice() const noexcept {
             return _device;
         }
@@ -50,5 +247,53 @@ namespace mvk {
         inline VkPipelineCache getHandle() const noexcept {
             return _handle;
         }
+
+        //! Retrieves the file the VkPipelineCache data is saved to.
+        /*!
+            \return the path; empty if the data is not saved.
+        */
+        inline const std::string& getPath() const noexcept {
+            return _path;
+        }
+
+        //! Retrieves the data of the VkPipelineCache.
+        /*!
+            The data holds the compiled pipelines in the format of the driver, so it can only be loaded on the
+            same driver version and device.
+
+            \return the data.
+        */
+        std::vector<std::uint8_t> getData() const;
+
+        //! Writes the data of the VkPipelineCache to a file.
+        /*!
+            \param path is the path of the file.
+        */
+        void save(const std::string& path) const;
+
+        //! Captures the executable statistics of a pipeline created from this PipelineCache. This is called by the pipeline constructors.
+        /*!
+            This does nothing unless VK_KHR_pipeline_executable_properties is enabled on the Device.
+
+            \param handle is the pipeline.
+            \param bindPoint is the type of the pipeline.
+            \param name is the debug name of the pipeline. It may be empty.
+        */
+        void recordExecutableStatistics(VkPipeline handle, PipelineBindPoint bindPoint, const std::string& name);
+
+        //! Dumps the executable statistics of every pipeline created from this PipelineCache as JSON.
+        /*!
+            The statistics are captured on creation, so pipelines that were already destroyed are included.
+            Comparing dumps between builds catches register, instruction and spill count regressions.
+
+            \return the JSON text.
+        */
+        std::string executableStatisticsToJSON() const;
+
+        //! Writes the executable statistics of every pipeline as JSON to a file.
+        /*!
+            \param path is the path of the file.
+        */
+        void saveExecutableStatistics(const std::string& path) const;
     };
 }
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mvk {
+    //! A pool of background threads that create pipelines off the render thread.
+    /*!
+        Every Device owns a PipelineCompiler; it is used by Device::createPipelineAsync. The threads are
+        started by the first submitted task, so a Device that never creates pipelines asynchronously does
+        not start any.
+    */
+    class PipelineCompiler {
+    public:
+        //! A unit of work. cancelled is true if the PipelineCompiler was destroyed before the task started.
+        using Task = std::function<void(bool cancelled)>;
+
+        //! The order in which queued tasks are started.
+        enum class Priority {
+            NORMAL, /*!< Pipelines the application is waiting for. */
+            LOW     /*!< Speculative work such as prewarming; started only while no NORMAL task is queued. */
+        };
+
+    private:
+        std::size_t _threadCount;
+        std::vector<std::thread> _threads;
+        std::deque<Task> _tasks;
+        std::deque<Task> _lowPriorityTasks;
+        mutable std::mutex _lock;
+        std::condition_variable _workAvailable;
+        bool _shutdown;
+
+        PipelineCompiler(const PipelineCompiler&) = delete;
+        PipelineCompiler& operator= (const PipelineCompiler&) = delete;
+
+        void work();
+
+    public:
+        //! Constructs a PipelineCompiler.
+        /*!
+            \param threadCount is the number of background threads. 0 selects half of the hardware threads.
+        */
+        PipelineCompiler(std::size_t threadCount = 0) noexcept;
+
+        //! Finishes the running tasks, cancels the queued tasks and stops the threads.
+        ~PipelineCompiler() noexcept;
+
+        //! Queues a task. Tasks of the same priority are started in submission order.
+        /*!
+            \param task is the task.
+            \param priority is the priority of the task. Running tasks are never interrupted.
+        */
+        void submit(Task task, Priority priority = Priority::NORMAL);
+
+        //! Retrieves the number of tasks that have not started yet.
+        /*!
+            \return the number of queued tasks.
+        */
+        std::size_t getQueuedCount() const noexcept;
+
+        //! Retrieves the number of background threads.
+        /*!
+            \return the number of threads.
+        */
+        inline std::size_t getThreadCount() const noexcept {
+            return _threadCount;
+        }
+    };
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <functional>
+#include <string>
+
+#include "mvk/ComputePipeline.hpp"
+#include "mvk/GraphicsPipeline.hpp"
+#include "mvk/RenderPass.hpp"
+
+namespace mvk {
+    //! A canonical encoding of everything that affects the code compiled for a pipeline.
+    /*!
+        Two create infos produce equal PipelineKeys exactly when the pipelines built from them are interchangeable.
+        Debug names are not part of the key. Shader stages are encoded with the hash of their SPIR-V code, so
+        building a key reads the code of file-backed shaders the first time their path is used. GraphicsPipelines only encode the compatibility class of their
+        RenderPass: the formats and sample counts of the referenced attachments and the subpass structure, but not
+        load and store operations or image layouts.
+
+        The hash is the 64bit FNV-1a of the encoding, so it is stable between runs of the same build.
+    */
+    class PipelineKey {
+        std::string _data;
+        std::uint64_t _hash;
+
+    public:
+        //! Constructs an empty PipelineKey.
+        PipelineKey() noexcept:
+            _hash(0) {}
+
+        //! Constructs the PipelineKey of a ComputePipeline.
+        /*!
+            \param createInfo is the construction parameters of the ComputePipeline.
+        */
+        explicit PipelineKey(const ComputePipeline::CreateInfo& createInfo);
+
+        //! Constructs the PipelineKey of a GraphicsPipeline.
+        /*!
+            \param createInfo is the construction parameters of the GraphicsPipeline.
+            \param renderPassInfo is the construction parameters of the RenderPass it is used in.
+        */
+        PipelineKey(const GraphicsPipeline::CreateInfo& createInfo, const RenderPass::CreateInfo& renderPassInfo);
+
+        //! Retrieves the hash of the encoding.
+        /*!
+            \return the hash.
+        */
+        inline std::uint64_t getHash() const noexcept {
+            return _hash;
+        }
+
+        //! Retrieves the encoding.
+        /*!
+            \return the encoded bytes.
+        */
+        inline const std::string& getData() const noexcept {
+            return _data;
+        }
+    };
+
+    inline bool operator== (const PipelineKey& lhs, const PipelineKey& rhs) noexcept {
+        return lhs.getHash() == rhs.getHash() && lhs.getData() == rhs.getData();
+    }
+
+    inline bool operator!= (const PipelineKey& lhs, const PipelineKey& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+}
+
+namespace std {
+    template<>
+    struct hash<mvk::PipelineKey> {
+        inline std::size_t operator() (const mvk::PipelineKey& key) const noexcept {
+            return static_cast<std::size_t> (key.getHash());
+        }
+    };
+}
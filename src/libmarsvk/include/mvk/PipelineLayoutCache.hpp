@@ -1,6 +1,8 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <utility>
 #include <vector>
 
 #include "mvk/PipelineLayout.hpp"
@@ -21,6 +23,7 @@ namespace mvk {
 
         Device * _device;
         std::vector<std::unique_ptr<Layout>> _layouts;
+        std::mutex _lock;
 
         PipelineLayoutCache(const PipelineLayoutCache&) = delete;
         PipelineLayoutCache& operator= (const PipelineLayoutCache&) = delete;
@@ -32,9 +35,16 @@ namespace mvk {
         PipelineLayoutCache(Device * device) noexcept:
             _device(device) {}
 
-        PipelineLayoutCache(PipelineLayoutCache&&) = default;
+        PipelineLayoutCache(PipelineLayoutCache&& from) noexcept:
+            _device(std::move(from._device)),
+            _layouts(std::move(from._layouts)) {}
 
-        PipelineLayoutCache& operator= (PipelineLayoutCache&& from) = default;
+        PipelineLayoutCache& operator= (PipelineLayoutCache&& from) noexcept {
+            std::swap(_device, from._device);
+            std::swap(_layouts, from._layouts);
+
+            return *this;
+        }
         
         void releasePipelineLayout(PipelineLayout * layout);
 
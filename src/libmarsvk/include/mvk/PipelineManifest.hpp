@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "mvk/ComputePipeline.hpp"
+#include "mvk/GraphicsPipeline.hpp"
+#include "mvk/PipelineKey.hpp"
+#include "mvk/RenderPass.hpp"
+
+namespace mvk {
+    //! A list of the pipelines an application creates, used to compile them again before they are requested.
+    /*!
+        Every pipeline is stored once with its full construction parameters; equivalent CreateInfos are
+        deduplicated by their PipelineKey. GraphicsPipelines are stored with the RenderPass they were created
+        for, so they can be compiled against a compatible RenderPass without the application.
+
+        Shaders are stored by path, which covers both files and embedded shaders, together with the hash of
+        their SPIR-V when the pipeline was recorded. A pipeline whose shaders changed or can no longer be read
+        is stale; it is skipped when the manifest is loaded. Pipelines with SPIR-V code that is only held in
+        memory (ShaderModule::CreateInfo::pCode) are not recorded: the hash would identify the code, but the
+        code itself is not stored, so they can never be replayed.
+
+        The file format is a compact binary dump in the byte order of the machine that wrote it. It is meant
+        to be recorded and replayed by the same build of an application.
+     */
+    class PipelineManifest {
+    public:
+        //! A recorded GraphicsPipeline.
+        struct GraphicsPipelineEntry {
+            GraphicsPipeline::CreateInfo createInfo;    /*!< The construction parameters. multisampleState.pSampleMask is always null. */
+            RenderPass::CreateInfo renderPassInfo;      /*!< The construction parameters of the RenderPass the pipeline was created for. */
+            std::vector<unsigned int> sampleMask;       /*!< The sample mask words; empty if the pipeline has no sample mask. */
+        };
+
+    private:
+        mutable std::mutex _lock;
+        std::unordered_map<PipelineKey, std::vector<std::uint64_t>> _codeHashes;
+        std::vector<ComputePipeline::CreateInfo> _computePipelines;
+        std::vector<GraphicsPipelineEntry> _graphicsPipelines;
+
+        PipelineManifest(const PipelineManifest&) = delete;
+        PipelineManifest& operator= (const PipelineManifest&) = delete;
+
+        bool add(ComputePipeline::CreateInfo createInfo, std::vector<std::uint64_t> codeHashes);
+
+        bool add(GraphicsPipelineEntry entry, std::vector<std::uint64_t> codeHashes);
+
+    public:
+        //! Constructs an empty PipelineManifest.
+        PipelineManifest() = default;
+
+        //! Records a ComputePipeline.
+        /*!
+            \param createInfo is the construction parameters of the pipeline.
+            \return true if the pipeline was added; false if it was already recorded or uses in-memory code.
+         */
+        bool record(const ComputePipeline::CreateInfo& createInfo);
+
+        //! Records a GraphicsPipeline.
+        /*!
+            \param createInfo is the construction parameters of the pipeline.
+            \param renderPassInfo is the construction parameters of the RenderPass the pipeline is used in.
+            \return true if the pipeline was added; false if it was already recorded or uses in-memory code.
+         */
+        bool record(const GraphicsPipeline::CreateInfo& createInfo, const RenderPass::CreateInfo& renderPassInfo);
+
+        //! Removes a recorded ComputePipeline.
+        /*!
+            \param createInfo is the construction parameters of the pipeline.
+            \return true if the pipeline was removed; false if it was not recorded.
+         */
+        bool remove(const ComputePipeline::CreateInfo& createInfo);
+
+        //! Removes a recorded GraphicsPipeline.
+        /*!
+            \param entry is the entry of the pipeline, as returned by getGraphicsPipelines.
+            \return true if the pipeline was removed; false if it was not recorded.
+         */
+        bool remove(const GraphicsPipelineEntry& entry);
+
+        //! Retrieves a copy of the recorded ComputePipelines.
+        /*!
+            \return the construction parameters in recording order.
+         */
+        std::vector<ComputePipeline::CreateInfo> getComputePipelines() const;
+
+        //! Retrieves a copy of the recorded GraphicsPipelines.
+        /*!
+            \return the entries in recording order.
+         */
+        std::vector<GraphicsPipelineEntry> getGraphicsPipelines() const;
+
+        //! Retrieves the number of recorded pipelines.
+        /*!
+            \return the number of pipelines.
+         */
+        std::size_t size() const;
+
+        //! Adds the pipelines of a manifest file to this PipelineManifest.
+        /*!
+            A missing file or a file written by another version of the format is not an error; nothing is added.
+            Stale pipelines, whose shaders no longer hash to the recorded value, are not added either.
+
+            \param path is the path of the file.
+            \return true if the file was read.
+         */
+        bool load(const std::string& path);
+
+        //! Writes every recorded pipeline to a file.
+        /*!
+            \param path is the path of the file.
+         */
+        void save(const std::string& path) const;
+    };
+}
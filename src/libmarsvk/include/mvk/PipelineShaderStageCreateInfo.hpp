@@ -4,6 +4,7 @@
 
 #include "mvk/ShaderModule.hpp"
 #include "mvk/ShaderStage.hpp"
+#include "mvk/SpecializationInfo.hpp"
 
 namespace mvk {
     struct PipelineShaderStageCreateInfo {
@@ -11,7 +12,7 @@ namespace mvk {
         ShaderStage stage;
         ShaderModule::CreateInfo moduleInfo;
         std::string name;
-        //specializationInfo
+        SpecializationInfo specializationInfo;
 
         static inline PipelineShaderStageCreateInfo init(mvk::ShaderStage stage, const std::string& path, const std::string& name = "main") noexcept {
             auto out = PipelineShaderStageCreateInfo {};
@@ -19,7 +19,8 @@ namespace mvk {
         COLOR_ATTACHMENT_OUTPUT_BIT = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
         COMPUTE_SHADER = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
         TRANSFER = VK_PIPELINE_STAGE_TRANSFER_BIT,
-        BOTTOM_OF_PIPE = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT
+        BOTTOM_OF_PIPE = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        CONDITIONAL_RENDERING = VK_PIPELINE_STAGE_CONDITIONAL_RENDERING_BIT_EXT
     };
 
     inline constexpr PipelineStageFlag operator| (PipelineStageFlag lhs, PipelineStageFlag rhs) noexcept {
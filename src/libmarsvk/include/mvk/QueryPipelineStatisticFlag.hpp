@@ -0,0 +1,32 @@
+#pragma once
+
+#include "volk.h"
+
+namespace mvk {
+    //! Bitmask specifying the counters returned by a pipeline statistics query.
+    /*!
+        See: <a href="https://www.khronos.org/registry/vulkan/specs/1.1-extensions/man/html/VkQueryPipelineStatisticFlagBits.html">VkQueryPipelineStatisticFlagBits</a>
+    */
+    enum class QueryPipelineStatisticFlag : unsigned int {
+        NONE = 0,                                                                                                               /*!< Specifies no counters. */
+        INPUT_ASSEMBLY_VERTICES = VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT,                                      /*!< Counts the vertices processed by the input assembly stage. */
+        INPUT_ASSEMBLY_PRIMITIVES = VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT,                                  /*!< Counts the primitives processed by the input assembly stage. */
+        VERTEX_SHADER_INVOCATIONS = VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT,                                  /*!< Counts the vertex shader invocations. */
+        GEOMETRY_SHADER_INVOCATIONS = VK_QUERY_PIPELINE_STATISTIC_GEOMETRY_SHADER_INVOCATIONS_BIT,                              /*!< Counts the geometry shader invocations. */
+        GEOMETRY_SHADER_PRIMITIVES = VK_QUERY_PIPELINE_STATISTIC_GEOMETRY_SHADER_PRIMITIVES_BIT,                                /*!< Counts the primitives generated by geometry shader invocations. */
+        CLIPPING_INVOCATIONS = VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT,                                            /*!< Counts the primitives processed by the clipping stage. */
+        CLIPPING_PRIMITIVES = VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT,                                              /*!< Counts the primitives output by the clipping stage. */
+        FRAGMENT_SHADER_INVOCATIONS = VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT,                              /*!< Counts the fragment shader invocations. */
+        TESSELLATION_CONTROL_SHADER_PATCHES = VK_QUERY_PIPELINE_STATISTIC_TESSELLATION_CONTROL_SHADER_PATCHES_BIT,              /*!< Counts the patches processed by the tessellation control shader. */
+        TESSELLATION_EVALUATION_SHADER_INVOCATIONS = VK_QUERY_PIPELINE_STATISTIC_TESSELLATION_EVALUATION_SHADER_INVOCATIONS_BIT,/*!< Counts the tessellation evaluation shader invocations. */
+        COMPUTE_SHADER_INVOCATIONS = VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT                                 /*!< Counts the compute shader invocations. */
+    };
+
+    inline constexpr QueryPipelineStatisticFlag operator| (QueryPipelineStatisticFlag lhs, QueryPipelineStatisticFlag rhs) noexcept {
+        return static_cast<QueryPipelineStatisticFlag> (static_cast<unsigned int> (lhs) | static_cast<unsigned int> (rhs));
+    }
+
+    inline constexpr QueryPipelineStatisticFlag operator& (QueryPipelineStatisticFlag lhs, QueryPipelineStatisticFlag rhs) noexcept {
+        return static_cast<QueryPipelineStatisticFlag> (static_cast<unsigned int> (lhs) & static_cast<unsigned int> (rhs));
+    }
+}
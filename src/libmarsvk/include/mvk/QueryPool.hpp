@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "volk.h"
+
+#include <memory>
+#include <utility>
+
+#include "mvk/QueryPipelineStatisticFlag.hpp"
+#include "mvk/QueryType.hpp"
+
+namespace mvk {
+    class Device;
+
+    class QueryPool;
+
+    using UPtrQueryPool = std::unique_ptr<QueryPool>;
+
+    //! A QueryPool object manages a fixed number of queries of a single type.
+    /*!
+        Queries are reset, begun, ended and written through the CommandBuffer. Results are read back
+        by the host with getResults.
+     */
+    class QueryPool {
+    public:
+        //! Parameter structure specifying how to construct a new QueryPool.
+        struct CreateInfo {
+            QueryType queryType;                            /*!< The type of queries managed by the QueryPool. */
+            std::uint32_t queryCount;                       /*!< The number of queries managed by the QueryPool. */
+            QueryPipelineStatisticFlag pipelineStatistics;  /*!< The counters returned by each query. Ignored unless queryType is PIPELINE_STATISTICS. */
+        };
+
+        //! Constructs a QueryPool-typed unique_ptr pointing to null.
+        /*!
+            \return unique_ptr<QueryPool> pointing to nullptr.
+         */
+        static inline UPtrQueryPool unique_null() {
+            return std::unique_ptr<QueryPool> ();
+        }
+
+    private:
+        Device * _device;
+        CreateInfo _info;
+        VkQueryPool _handle;
+
+        QueryPool(const QueryPool&) = delete;
+        QueryPool& operator= (const QueryPool&) = delete;
+
+    public:
+        //! Constructs an empty QueryPool.
+        QueryPool() noexcept:
+            _device(nullptr),
+            _handle(VK_NULL_HANDLE) {}
+
+        //! Constructs a new QueryPool.
+        /*!
+            \param device is the Device that will own the QueryPool.
+            \param createInfo is the construction parameters.
+         */
+        QueryPool(Device * device, const CreateInfo& createInfo);
+
+        //! Move-constructs a QueryPool.
+        /*!
+            \param from the other QueryPool.
+         */
+        QueryPool(QueryPool&& from) noexcept:
+            _device(std::move(from._device)),
+            _info(std::move(from._info)),
+            _handle(std::exchange(from._handle, nullptr)) {}
+
+        //! Deletes the QueryPool and releases all resources.
+        ~QueryPool() noexcept;
+
+        //! Move-assigns a QueryPool.
+        /*!
+            \param from the other QueryPool.
+         */
+        QueryPool& operator= (QueryPool&& from) noexcept;
+
+        //! Retrieves the parent Device.
+        /*!
+            \return the Device.
+         */
+        inline Device * getDevice() const noexcept {
+            return _device;
+        }
+
+        //! Retrieves the construction parameters.
+        /*!
+            \return the reference to an immutable copy of the parameter struct.
+         */
+        inline const CreateInfo& getInfo() const noexcept {
+            return _info;
+        }
+
+        //! Retrieves the underlying Vulkan handle.
+        /*!
+            \return the handle.
+         */
+        inline VkQueryPool getHandle() const noexcept {
+            return _handle;
+        }
+
+        //! Implicitly casts to the underlying Vulkan handle.
+        inline operator VkQueryPool() const noexcept {
+            return _handle;
+        }
+
+        //! Retrieves the number of 64bit values written for each query.
+        /*!
+            \return 1 for occlusion and timestamp queries; the number of enabled counters for pipeline statistics queries.
+         */
+        std::uint32_t getResultCount() const noexcept;
+
+        //! Reads back the results of a range of queries.
+        /*!
+            \param firstQuery is the index of the first query.
+            \param queryCount is the number of queries.
+            \param pResults is the array that receives queryCount * getResultCount() 64bit values.
+            \param wait specifies if the call should block until the results are available.
+            \return true if the results were written; false if any of the queries was not yet available.
+         */
+        bool getResults(std::uint32_t firstQuery, std::uint32_t queryCount, std::uint64_t * pResults, bool wait = false) const;
+    };
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "volk.h"
+
+namespace mvk {
+    //! Bitmask specifying how and when query results are returned.
+    /*!
+        See: <a href="https://www.khronos.org/registry/vulkan/specs/1.1-extensions/man/html/VkQueryResultFlagBits.html">VkQueryResultFlagBits</a>
+    */
+    enum class QueryResultFlag : unsigned int {
+        NONE = 0,                                                       /*!< Results are written as 32bit unsigned ints and unavailable queries are skipped. */
+        RESULT_64 = VK_QUERY_RESULT_64_BIT,                             /*!< Specifies that the results are written as 64bit unsigned ints. */
+        WAIT = VK_QUERY_RESULT_WAIT_BIT,                                /*!< Specifies that the results are waited for before they are written. */
+        WITH_AVAILABILITY = VK_QUERY_RESULT_WITH_AVAILABILITY_BIT,      /*!< Specifies that the availability status is written after each result. */
+        PARTIAL = VK_QUERY_RESULT_PARTIAL_BIT                           /*!< Specifies that partial results are acceptable. */
+    };
+
+    inline constexpr QueryResultFlag operator| (QueryResultFlag lhs, QueryResultFlag rhs) noexcept {
+        return static_cast<QueryResultFlag> (static_cast<unsigned int> (lhs) | static_cast<unsigned int> (rhs));
+    }
+
+    inline constexpr QueryResultFlag operator& (QueryResultFlag lhs, QueryResultFlag rhs) noexcept {
+        return static_cast<QueryResultFlag> (static_cast<unsigned int> (lhs) & static_cast<unsigned int> (rhs));
+    }
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "volk.h"
+
+namespace mvk {
+    //! Specifies the type of queries managed by a QueryPool.
+    /*!
+        See: <a href="https://www.khronos.org/registry/vulkan/specs/1.1-extensions/man/html/VkQueryType.html">VkQueryType</a>
+    */
+    enum class QueryType : unsigned int {
+        OCCLUSION = VK_QUERY_TYPE_OCCLUSION,                      /*!< Specifies an occlusion query; the result is the number of samples that passed the depth and stencil tests. */
+        PIPELINE_STATISTICS = VK_QUERY_TYPE_PIPELINE_STATISTICS,  /*!< Specifies a pipeline statistics query; requires the pipelineStatisticsQuery feature. */
+        TIMESTAMP = VK_QUERY_TYPE_TIMESTAMP                       /*!< Specifies a timestamp query. */
+    };
+}
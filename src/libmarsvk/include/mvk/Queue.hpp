@@ -2,8 +2,10 @@
 
 #include "volk.h"
 
+#include <array>
 #include <memory>
 #include <queue>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -43,6 +45,29 @@ namespace mvk {
             PipelineStageFlag srcStageMask;
         };
 
+        //! Ends a debug label region when it goes out of scope.
+        class Label {
+            Queue * _queue;
+
+            Label(const Label&) = delete;
+            Label& operator= (const Label&) = delete;
+
+            Label(Queue * queue) noexcept:
+                _queue(queue) {}
+
+            friend class Queue;
+
+        public:
+            Label(Label&& from) noexcept:
+                _queue(std::exchange(from._queue, nullptr)) {}
+
+            ~Label() noexcept {
+                if (nullptr != _queue) {
+                    _queue->endLabel();
+                }
+            }
+        };
+
     private:
         struct InternalCommandBuffer {
             std::unique_ptr<CommandBuffer> commandBuffer;
@@ -102,5 +127,38 @@ namespace mvk {
         inline void present(const PresentInfo& presentInfo) {
             present(presentInfo, presentInfo.swapchain->acquireNextImage());
         }
+
+        //! Opens a labeled region of queue operations for debuggers and profilers.
+        /*!
+            Does nothing if VK_EXT_debug_utils is not enabled. Each call must be matched by endLabel.
+
+            \param name is the name of the region.
+            \param color is the RGBA color of the region; all zero lets the tool choose.
+         */
+        void beginLabel(const std::string& name, const std::array<float, 4>& color = {}) noexcept;
+
+        //! Closes the region opened by the last beginLabel.
+        void endLabel() noexcept;
+
+        //! Marks a single point between queue operations for debuggers and profilers.
+        /*!
+            Does nothing if VK_EXT_debug_utils is not enabled.
+
+            \param name is the name of the marker.
+            \param color is the RGBA color of the marker; all zero lets the tool choose.
+         */
+        void insertLabel(const std::string& name, const std::array<float, 4>& color = {}) noexcept;
+
+        //! Opens a labeled region that is closed when the returned Label is destroyed.
+        /*!
+            \param name is the name of the region.
+            \param color is the RGBA color of the region; all zero lets the tool choose.
+            \return the Label that closes the region.
+         */
+        inline Label label(const std::string& name, const std::array<float, 4>& color = {}) noexcept {
+            beginLabel(name, color);
+
+            return Label(this);
+        }
     };
 }
@@ -4,8 +4,11 @@
 
 #include "volk.h"
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -23,8 +26,14 @@ namespace mvk {
         VkQueueFamilyProperties _properties;
         std::vector<std::unique_ptr<Queue>> _queues;
 
-        //TODO: this should be thread_local
-        std::unique_ptr<CommandPool> _commandPool;
+        // CommandPools are externally synchronized; so each thread records from its own. The pools are kept until
+        // the QueueFamily is detached, so CommandBuffers that are still pending stay valid after their thread exits.
+        struct CommandPools {
+            std::mutex lock;
+            std::map<std::thread::id, std::unique_ptr<CommandPool>> pools;
+        };
+
+        std::unique_ptr<CommandPools> _commandPools;
 
         QueueFamily(const QueueFamily&) = delete;
         QueueFamily& operator= (const QueueFamily&) = delete;
@@ -40,7 +49,8 @@ namespace mvk {
             _index(std::move(from._index)),
             _device(std::move(from._device)),
             _properties(std::move(from._properties)),
-            _queues(std::move(from._queues)) {}
+            _queues(std::move(from._queues)),
+            _commandPools(std::move(from._commandPools)) {}
 
         ~QueueFamily() noexcept;
 
@@ -48,6 +58,14 @@ namespace mvk {
 
         QueueFlag getFlags() const noexcept;
 
+        //! Retrieves the CommandPool owned by the calling thread.
+        /*!
+            The CommandPool is created on first use by each thread and is owned by the QueueFamily; it is destroyed
+            when the QueueFamily is detached, after its Queues are idle. A thread that reuses the id of an exited
+            thread inherits its CommandPool.
+
+            \return the CommandPool.
+        */
         CommandPool * getCurrentCommandPool();
 
         bool canPresent(const Surface * surface) const;
@@ -76,6 +94,10 @@ namespace mvk {
             return _queues.size();
         }
 
+        //! Waits for all Queues of the QueueFamily to finish their work.
+        void waitIdle();
+
+        //! Waits for the Queues to go idle and destroys the CommandPools of every thread.
         void detach() noexcept;
     };
 }
@@ -1,9 +1,14 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include "volk.h"
 
+#include <functional>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace mvk {
     class Device;
@@ -12,9 +17,52 @@ namespace mvk {
     public:
         struct CreateInfo {
             int flags;
-            std::string path;
+            std::string path;               /*!< The path of the SPIR-V file, or the name of an embedded shader. */
+            const std::uint32_t * pCode;    /*!< SPIR-V code in memory. If set, path is only used as a name and no file is read. */
+            std::size_t codeSize;           /*!< The size of pCode in bytes. */
+        };
+
+        //! Registers SPIR-V code that is compiled into the binary under a name.
+        /*!
+            ShaderModules created from a path that matches the name of an embedded shader use the embedded
+            code instead of reading the file. The headers generated by the embeddedShaders make target
+            declare one Embedded per shader, named after the path of its .spv file.
+        */
+        class Embedded {
+        public:
+            //! Registers the code. The code must stay valid for the lifetime of the program.
+            /*!
+                \param name is the name of the shader.
+                \param pCode is the SPIR-V code.
+                \param codeSize is the size of pCode in bytes.
+            */
+            Embedded(const char * name, const std::uint32_t * pCode, std::size_t codeSize);
         };
 
+        //! Checks if a shader is embedded under a name.
+        /*!
+            \param name is the name of the shader.
+            \return true if the shader is embedded.
+        */
+        static bool isEmbedded(const std::string& name);
+
+        //! Reads the SPIR-V code of a shader from the same source a ShaderModule would use.
+        /*!
+            \param info is the ShaderModule construction parameters.
+            \return a copy of the code.
+        */
+        static std::vector<std::uint32_t> readCode(const CreateInfo& info);
+
+        //! Computes the 64bit FNV-1a hash of the SPIR-V code of a shader.
+        /*!
+            In-memory code is hashed on every call. The code of files and embedded shaders is read and hashed
+            once per path, like Device only loads the ShaderModule of a path once.
+
+            \param info is the ShaderModule construction parameters.
+            \return the hash of the code.
+        */
+        static std::uint64_t getCodeHash(const CreateInfo& info);
+
     private:
         VkShaderModule _handle;
         CreateInfo _info;
@@ -53,6 +101,20 @@ namespace mvk {
     };
 
     inline bool operator==(const ShaderModule::CreateInfo& lhs, const ShaderModule::CreateInfo& rhs) noexcept {
-        return lhs.flags == rhs.flags && lhs.path == rhs.path;
+        return lhs.flags == rhs.flags && lhs.path == rhs.path && lhs.pCode == rhs.pCode && lhs.codeSize == rhs.codeSize;
     }
-}
\ No newline at end of file
+}
+
+namespace std {
+    template<>
+    struct hash<mvk::ShaderModule::CreateInfo> {
+        inline std::size_t operator() (const mvk::ShaderModule::CreateInfo& info) const noexcept {
+            auto out = hash<std::string> () (info.path);
+
+            out ^= hash<const std::uint32_t *> () (info.pCode) + 0x9E3779B9 + (out << 6) + (out >> 2);
+            out ^= static_cast<std::size_t> (info.codeSize) + static_cast<std::size_t> (info.flags) + 0x9E3779B9 + (out << 6) + (out >> 2);
+
+            return out;
+        }
+    };
+}
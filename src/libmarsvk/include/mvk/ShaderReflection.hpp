@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#include "mvk/DescriptorSetLayout.hpp"
+#include "mvk/PipelineLayout.hpp"
+#include "mvk/PipelineShaderStageCreateInfo.hpp"
+#include "mvk/ShaderModule.hpp"
+#include "mvk/ShaderStage.hpp"
+
+namespace mvk {
+    //! The resource interface of a single shader entry point, read from its SPIR-V.
+    /*!
+        Descriptors are reported with their set, binding, type and array size. Only the descriptors and push
+        constants the entry point statically uses are included: those listed in its interface and those
+        referenced by any function it calls. Buffers are never reported as dynamic, since SPIR-V does not
+        distinguish them.
+
+        createPipelineLayoutInfo merges the reflections of every stage into a canonical PipelineLayout::CreateInfo:
+        one DescriptorSetLayout per set index up to the highest used set, bindings sorted by binding number and
+        a single push constant range covering every stage. Pipelines with equivalent shader interfaces therefore
+        share PipelineLayouts in the PipelineLayoutCache and can bind each other's DescriptorSets.
+     */
+    class ShaderReflection {
+    public:
+        //! Marks a local size dimension that is not set by a specialization constant.
+        static constexpr std::uint32_t NO_CONSTANT = 0xFFFFFFFF;
+
+        //! A descriptor used by the entry point.
+        struct DescriptorBinding {
+            std::uint32_t set;                      /*!< The descriptor set index. */
+            DescriptorSetLayout::Binding binding;   /*!< The binding. The stages are the stage of the entry point. */
+        };
+
+    private:
+        ShaderStage _stage;
+        std::string _entryPoint;
+        std::vector<DescriptorBinding> _descriptorBindings;
+        std::uint32_t _pushConstantOffset;
+        std::uint32_t _pushConstantSize;
+        std::uint32_t _localSize[3];
+        std::uint32_t _localSizeConstantIDs[3];
+
+    public:
+        //! Reflects an entry point of SPIR-V code.
+        /*!
+            \param pCode is the SPIR-V code.
+            \param codeSize is the size of pCode in bytes.
+            \param entryPoint is the name of the entry point.
+         */
+        ShaderReflection(const std::uint32_t * pCode, std::size_t codeSize, const std::string& entryPoint = "main");
+
+        //! Reflects an entry point of the code a ShaderModule would be created from.
+        /*!
+            \param moduleInfo is the ShaderModule construction parameters.
+            \param entryPoint is the name of the entry point.
+         */
+        ShaderReflection(const ShaderModule::CreateInfo& moduleInfo, const std::string& entryPoint = "main");
+
+        //! Retrieves the stage of the entry point.
+        /*!
+            \return the ShaderStage.
+         */
+        inline ShaderStage getStage() const noexcept {
+            return _stage;
+        }
+
+        //! Retrieves the name of the entry point.
+        /*!
+            \return the name.
+         */
+        inline const std::string& getEntryPoint() const noexcept {
+            return _entryPoint;
+        }
+
+        //! Retrieves the descriptors used by the entry point.
+        /*!
+            \return the descriptors sorted by set and binding.
+         */
+        inline const std::vector<DescriptorBinding>& getDescriptorBindings() const noexcept {
+            return _descriptorBindings;
+        }
+
+        //! Retrieves the byte offset of the first push constant member.
+        /*!
+            \return the offset; 0 if the shader has no push constants.
+         */
+        inline std::uint32_t getPushConstantOffset() const noexcept {
+            return _pushConstantOffset;
+        }
+
+        //! Retrieves the byte size of the push constants, starting at the push constant offset.
+        /*!
+            \return the size; 0 if the shader has no push constants.
+         */
+        inline std::uint32_t getPushConstantSize() const noexcept {
+            return _pushConstantSize;
+        }
+
+        //! Retrieves the local workgroup size of a compute shader.
+        /*!
+            Dimensions that are set by specialization constants report the default value of the constant.
+
+            \param dimension is 0 for x, 1 for y or 2 for z.
+            \return the size; 1 for other stages.
+         */
+        inline std::uint32_t getLocalSize(std::size_t dimension) const noexcept {
+            return _localSize[dimension];
+        }
+
+        //! Retrieves the specialization constant that sets a dimension of the local workgroup size.
+        /*!
+            \param dimension is 0 for x, 1 for y or 2 for z.
+            \return the constant_id; NO_CONSTANT if the dimension is fixed.
+         */
+        inline std::uint32_t getLocalSizeConstantID(std::size_t dimension) const noexcept {
+            return _localSizeConstantIDs[dimension];
+        }
+
+        //! Merges the interfaces of the stages of a pipeline into a canonical PipelineLayout::CreateInfo.
+        /*!
+            Descriptors that are declared by several stages are merged; their types must match.
+
+            \param reflections is the reflection of every stage.
+            \return the PipelineLayout construction parameters.
+         */
+        static PipelineLayout::CreateInfo createPipelineLayoutInfo(const std::vector<ShaderReflection>& reflections);
+
+        //! Reflects every stage and merges their interfaces into a canonical PipelineLayout::CreateInfo.
+        /*!
+            \param stages is the shader stages of the pipeline.
+            \return the PipelineLayout construction parameters.
+         */
+        static PipelineLayout::CreateInfo createPipelineLayoutInfo(const std::vector<PipelineShaderStageCreateInfo>& stages);
+
+        //! Reflects a single stage into a canonical PipelineLayout::CreateInfo.
+        /*!
+            \param stage is the shader stage of the pipeline, usually a compute shader.
+            \return the PipelineLayout construction parameters.
+         */
+        static inline PipelineLayout::CreateInfo createPipelineLayoutInfo(const PipelineShaderStageCreateInfo& stage) {
+            return createPipelineLayoutInfo(std::vector<PipelineShaderStageCreateInfo> {stage});
+        }
+    };
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace mvk {
+    //! Values that replace the specialization constants of a shader stage when the pipeline is created.
+    /*!
+        Constants are usually added with set, which packs the value into data. Setting the same constantID
+        again replaces its value. The order constants are set in does not affect the PipelineKey, so
+        equivalent SpecializationInfos share pipelines.
+    */
+    struct SpecializationInfo {
+        //! Locates the value of a single specialization constant in data.
+        struct MapEntry {
+            std::uint32_t constantID;   /*!< The constant_id of the specialization constant. */
+            std::uint32_t offset;       /*!< The byte offset of the value in data. */
+            std::size_t size;           /*!< The byte size of the value. */
+        };
+
+        std::vector<MapEntry> mapEntries;   /*!< The specialization constants to replace. No constants are replaced if this is empty. */
+        std::vector<std::uint8_t> data;     /*!< The packed values of every specialization constant. */
+
+        //! Sets the value of a specialization constant.
+        /*!
+            bool values are stored as 32bit integers, since SPIR-V boolean constants are specialized with a VkBool32.
+
+            \param constantID is the constant_id of the specialization constant.
+            \param value is the value. The type must match the type of the constant in the shader.
+            \return this SpecializationInfo, so calls can be chained.
+        */
+        template<typename T>
+        SpecializationInfo& set(std::uint32_t constantID, T value) {
+            static_assert(std::is_arithmetic<T>::value, "Specialization constants must be scalars!");
+
+            using StoredT = typename std::conditional<std::is_same<T, bool>::value, std::uint32_t, T>::type;
+
+            const auto stored = static_cast<StoredT> (value);
+            auto entry = std::find_if(mapEntries.begin(), mapEntries.end(), [constantID](const MapEntry& e) { return e.constantID == constantID; });
+
+            if (mapEntries.end() == entry) {
+                auto newEntry = MapEntry {};
+                newEntry.constantID = constantID;
+                newEntry.offset = static_cast<std::uint32_t> (data.size());
+                newEntry.size = sizeof(StoredT);
+
+                data.resize(data.size() + sizeof(StoredT));
+                mapEntries.push_back(newEntry);
+                entry = mapEntries.end() - 1;
+            } else if (sizeof(StoredT) != entry->size) {
+                throw std::runtime_error("Specialization constant was already set with a different size!");
+            }
+
+            std::memcpy(data.data() + entry->offset, &stored, sizeof(StoredT));
+
+            return *this;
+        }
+
+        //! Retrieves the value of a specialization constant.
+        /*!
+            \param constantID is the constant_id of the specialization constant.
+            \param defaultValue is returned if the constant is not set.
+            \return the value.
+        */
+        template<typename T>
+        T get(std::uint32_t constantID, T defaultValue = T()) const {
+            static_assert(std::is_arithmetic<T>::value, "Specialization constants must be scalars!");
+
+            using StoredT = typename std::conditional<std::is_same<T, bool>::value, std::uint32_t, T>::type;
+
+            for (const auto& entry : mapEntries) {
+                if (entry.constantID == constantID) {
+                    if (sizeof(StoredT) != entry.size) {
+                        throw std::runtime_error("Specialization constant was set with a different size!");
+                    }
+
+                    auto stored = StoredT();
+
+                    std::memcpy(&stored, data.data() + entry.offset, sizeof(StoredT));
+
+                    return static_cast<T> (stored);
+                }
+            }
+
+            return defaultValue;
+        }
+
+        //! Checks if a specialization constant is set.
+        /*!
+            \param constantID is the constant_id of the specialization constant.
+            \return true if the constant is set.
+        */
+        inline bool isSet(std::uint32_t constantID) const noexcept {
+            return std::any_of(mapEntries.begin(), mapEntries.end(), [constantID](const MapEntry& e) { return e.constantID == constantID; });
+        }
+    };
+}
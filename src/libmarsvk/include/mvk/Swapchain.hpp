@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 #include "volk.h"
 
 #include "mvk/PresentMode.hpp"
@@ -57,6 +59,7 @@ namespace mvk {
         CreateInfo _info;
         Device * _device;
         VkSwapchainKHR _handle;
+        std::uint64_t _serial;
         VkPresentModeKHR _presentMode;
         Support _support;
         int _width;
@@ -71,12 +74,14 @@ namespace mvk {
 
         Swapchain() noexcept:
             _device(nullptr),
-            _handle(VK_NULL_HANDLE) {}
+            _handle(VK_NULL_HANDLE),
+            _serial(0) {}
 
         Swapchain(Device * device, const CreateInfo& createInfo) noexcept:
             _info(createInfo),
             _device(device),
             _handle(VK_NULL_HANDLE),
+            _serial(0),
             _presentMode(VK_PRESENT_MODE_FIFO_KHR),
             _support(),
             _width(0),
@@ -87,6 +92,7 @@ namespace mvk {
             _info(std::move(from._info)),
             _device(std::move(from._device)),
             _handle(std::exchange(from._handle, nullptr)),
+            _serial(std::exchange(from._serial, 0)),
             _presentMode(std::move(from._presentMode)),
             _support(std::move(from._support)),
             _width(std::move(from._width)),
@@ -120,6 +126,11 @@ namespace mvk {
             return _handle;
         }
 
+        //! Retrieves the serial number of the current swapchain; every resize assigns a new one.
+        inline std::uint64_t getSerial() const noexcept {
+            return _serial;
+        }
+
         inline Device * getDevice() const noexcept {
             return _device;
         }
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace mvk {
+    class Device;
+    class Queue;
+
+    class Tracer;
+
+    using UPtrTracer = std::unique_ptr<Tracer>;
+
+    //! Records a timeline of CPU and GPU spans and exports it as Chrome trace-event JSON.
+    /*!
+        Every Device owns a Tracer. While recording, the library emits CPU spans for queue submits,
+        CommandBuffer recording, pipeline creation and Fence waits; applications may add their own
+        with Span. GPU spans are added from timestamp queries, such as those resolved by a GPUProfiler.
+
+        GPU timestamps are mapped onto the CPU timeline with a calibration point. If
+        VK_EXT_calibrated_timestamps is enabled on the Device, the device and CLOCK_MONOTONIC clocks
+        are sampled together. Otherwise a single timestamp is written by a one-off submit and is
+        assumed to lie halfway between the submit and the Fence wait returning. Since the clocks drift
+        apart, calibrate should be called again every few seconds on long captures.
+
+        The output loads in chrome://tracing and in Perfetto. CPU spans appear under the "CPU" process
+        with one track per thread; GPU spans appear under the "GPU" process with one track per QueueFamily.
+
+        When not recording, a Span costs a single relaxed atomic load.
+     */
+    class Tracer {
+    public:
+        //! Records the time between its construction and destruction as a CPU span.
+        class Span {
+            Tracer * _tracer;
+            const char * _name;
+            const char * _category;
+            std::int64_t _start;
+
+            Span(const Span&) = delete;
+            Span& operator= (const Span&) = delete;
+
+        public:
+            //! Begins a CPU span.
+            /*!
+                \param tracer is the Tracer to record into.
+                \param name is the name of the span. It must outlive the Tracer; a string literal is expected.
+                \param category is the category of the span. It must outlive the Tracer.
+             */
+            Span(Tracer& tracer, const char * name, const char * category = "cpu") noexcept:
+                _tracer(tracer.isRecording() ? &tracer : nullptr),
+                _name(name),
+                _category(category),
+                _start(nullptr != _tracer ? now() : 0) {}
+
+            ~Span() noexcept {
+                if (nullptr != _tracer) {
+                    _tracer->addSpan(_name, _category, _start, now());
+                }
+            }
+        };
+
+        //! Constructs a Tracer-typed unique_ptr pointing to null.
+        /*!
+            \return unique_ptr<Tracer> pointing to nullptr.
+         */
+        static inline UPtrTracer unique_null() {
+            return std::unique_ptr<Tracer> ();
+        }
+
+        //! Retrieves the current CPU time on the clock used by every span.
+        /*!
+            \return the time in nanoseconds.
+         */
+        static inline std::int64_t now() noexcept {
+            return std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+    private:
+        struct Event {
+            std::string name;
+            const char * category;
+            std::uint32_t pid;
+            std::uint32_t tid;
+            std::int64_t start;
+            std::int64_t end;
+        };
+
+        Device * _device;
+        std::atomic<bool> _recording;
+        mutable std::mutex _lock;
+        std::vector<Event> _events;
+        std::size_t _maxEvents;
+        std::size_t _droppedEventCount;
+        std::unordered_map<std::thread::id, std::uint32_t> _threadIds;
+        std::int64_t _origin;
+
+        bool _calibrated;
+        std::uint64_t _calibrationTicks;
+        std::int64_t _calibrationTime;
+        std::int64_t _calibrationUncertainty;
+        double _timestampPeriod;
+
+        Tracer(const Tracer&) = delete;
+        Tracer& operator= (const Tracer&) = delete;
+
+        void push(Event&& event);
+
+        bool calibrateWithExtension();
+
+    public:
+        //! Constructs a new Tracer that is not recording.
+        /*!
+            \param device is the Device that owns the Tracer.
+         */
+        Tracer(Device * device) noexcept;
+
+        //! Retrieves the parent Device.
+        /*!
+            \return the Device.
+         */
+        inline Device * getDevice() const noexcept {
+            return _device;
+        }
+
+        //! Checks if spans are being recorded.
+        /*!
+            \return true if recording.
+         */
+        inline bool isRecording() const noexcept {
+            return _recording.load(std::memory_order_relaxed);
+        }
+
+        //! Discards any previous spans and begins recording.
+        /*!
+            \param maxEvents is the maximum number of spans kept. Further spans are counted and dropped.
+         */
+        void start(std::size_t maxEvents = 1 << 20);
+
+        //! Stops recording. The recorded spans are kept until the next start.
+        void stop() noexcept;
+
+        //! Maps the timestamps of a Queue onto the CPU timeline.
+        /*!
+            Without VK_EXT_calibrated_timestamps this submits a single timestamp to the Queue and waits for it.
+            GPU spans added before the first calibration are dropped.
+
+            \param queue is a Queue whose QueueFamily supports timestamps.
+         */
+        void calibrate(Queue * queue);
+
+        //! Checks if GPU timestamps can be mapped onto the CPU timeline.
+        /*!
+            \return true if calibrate has been called.
+         */
+        bool isCalibrated() const noexcept;
+
+        //! Retrieves the worst-case error of the most recent calibration.
+        /*!
+            \return the uncertainty in nanoseconds.
+         */
+        std::int64_t getCalibrationUncertainty() const noexcept;
+
+        //! Adds a CPU span on the calling thread.
+        /*!
+            \param name is the name of the span.
+            \param category is the category of the span. It must outlive the Tracer.
+            \param start is the beginning of the span, as returned by now.
+            \param end is the end of the span, as returned by now.
+         */
+        void addSpan(const std::string& name, const char * category, std::int64_t start, std::int64_t end);
+
+        //! Adds a GPU span measured with timestamp queries.
+        /*!
+            \param name is the name of the span.
+            \param queueFamilyIndex is the index of the QueueFamily the timestamps were written on.
+            \param beginTicks is the raw timestamp at the beginning of the span.
+            \param endTicks is the raw timestamp at the end of the span.
+            \param timestampMask is the mask of valid timestamp bits of the QueueFamily.
+         */
+        void addGPUSpan(const std::string& name, std::uint32_t queueFamilyIndex, std::uint64_t beginTicks, std::uint64_t endTicks, std::uint64_t timestampMask = ~0ULL);
+
+        //! Retrieves the number of spans dropped because the event limit was reached or the Tracer was not calibrated.
+        /*!
+            \return the dropped span count.
+         */
+        std::size_t getDroppedEventCount() const noexcept;
+
+        //! Exports the recorded spans as Chrome trace-event JSON.
+        /*!
+            \return the JSON text.
+         */
+        std::string toJSON() const;
+
+        //! Writes the recorded spans as Chrome trace-event JSON to a file.
+        /*!
+            \param path is the path of the file.
+         */
+        void save(const std::string& path) const;
+    };
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include "volk.h"
 
 #include <algorithm>
@@ -24,8 +27,16 @@ namespace mvk {
             return a & (~b - 1);
         }
 
+        //! Generates a process-wide unique serial number; 0 is never returned.
+        std::uint64_t nextSerial() noexcept;
+
+        //! Computes the 64bit FNV-1a hash of a range of bytes; the result is stable between runs.
+        std::uint64_t fnv1a(const void * data, std::size_t size) noexcept;
+
         std::string translateVulkanResult(VkResult result);
 
+        std::string escapeJSON(const std::string& value);
+
         void vkAssert(VkResult result);
 
         inline constexpr AspectFlag aspect(Format format) noexcept {
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "mvk/ComputePipeline.hpp"
+
+namespace mvk {
+    class CommandBuffer;
+    class Device;
+    class QueueFamily;
+
+    class WorkgroupTuner;
+
+    using UPtrWorkgroupTuner = std::unique_ptr<WorkgroupTuner>;
+
+    //! Selects the fastest workgroup size of compute kernels by timing them on the Device.
+    /*!
+        The workgroup size is passed to the kernel through a specialization constant, so a single SPIR-V
+        module is compiled once per candidate. Every candidate is timed with timestamp queries and the
+        fastest is stored in a table keyed by the vendor, device ID and driver version of the PhysicalDevice
+        and by the kernel. The table is saved to a file, so later runs reuse the choice without timing.
+
+        Kernels are identified by their shader path, entry point, the hash of their SPIR-V code and the
+        PipelineKey of the CreateInfo without the workgroup size constant; rebuilding the shader or changing
+        the layout or any other constant tunes again.
+     */
+    class WorkgroupTuner {
+    public:
+        //! Parameter structure specifying how to construct a new WorkgroupTuner.
+        struct CreateInfo {
+            QueueFamily * queueFamily;              /*!< The QueueFamily the timing runs are submitted to. It must support compute and timestamps. */
+            std::string path;                       /*!< The file of the tuning table. The table is only kept in memory if this is empty. */
+            std::uint32_t constantID;               /*!< The constant_id of the specialization constant that receives the workgroup size. */
+            std::vector<std::uint32_t> candidates;  /*!< The workgroup sizes to try. Empty selects the powers of two from 32 to 1024. */
+            std::uint32_t runs;                     /*!< The number of timed runs of each candidate; the median is compared. 0 selects 5. */
+        };
+
+        //! Records one run of the kernel. The pipeline of the candidate is already bound.
+        /*!
+            DescriptorSets allocated from the layouts of any candidate pipeline can be bound, since every
+            candidate shares the same PipelineLayout.
+         */
+        using RecordFunction = std::function<void(CommandBuffer * commandBuffer, const ComputePipeline * pipeline, std::uint32_t workgroupSize)>;
+
+        //! The selected workgroup size of a kernel.
+        struct Result {
+            std::uint32_t workgroupSize;    /*!< The fastest workgroup size. */
+            double milliseconds;            /*!< The median GPU time of one run with that size when it was tuned. */
+            bool cached;                    /*!< true if the result was read from the table instead of being timed. */
+        };
+
+        //! Constructs a WorkgroupTuner-typed unique_ptr pointing to null.
+        /*!
+            \return unique_ptr<WorkgroupTuner> pointing to nullptr.
+         */
+        static inline UPtrWorkgroupTuner unique_null() {
+            return std::unique_ptr<WorkgroupTuner> ();
+        }
+
+    private:
+        using TableKey = std::tuple<std::uint32_t, std::uint32_t, std::uint32_t, std::string>;
+
+        struct TableEntry {
+            std::uint32_t workgroupSize;
+            double milliseconds;
+        };
+
+        Device * _device;
+        CreateInfo _info;
+        double _timestampPeriod;
+        std::uint64_t _timestampMask;
+        std::map<TableKey, TableEntry> _table;
+
+        WorkgroupTuner(const WorkgroupTuner&) = delete;
+        WorkgroupTuner& operator= (const WorkgroupTuner&) = delete;
+
+        TableKey getKey(const ComputePipeline::CreateInfo& createInfo) const;
+
+        double time(const ComputePipeline * pipeline, std::uint32_t workgroupSize, const RecordFunction& recordFunction);
+
+        void load();
+
+    public:
+        //! Constructs a new WorkgroupTuner and reads the tuning table.
+        /*!
+            A missing table file is not an error; it is created by the first tune.
+
+            \param device is the Device the kernels are timed on.
+            \param createInfo is the construction parameters.
+         */
+        WorkgroupTuner(Device * device, const CreateInfo& createInfo);
+
+        //! Deletes the WorkgroupTuner.
+        ~WorkgroupTuner() noexcept = default;
+
+        //! Retrieves the parent Device.
+        /*!
+            \return the Device.
+         */
+        inline Device * getDevice() const noexcept {
+            return _device;
+        }
+
+        //! Retrieves the construction parameters.
+        /*!
+            \return the reference to an immutable copy of the parameter struct.
+         */
+        inline const CreateInfo& getInfo() const noexcept {
+            return _info;
+        }
+
+        //! Selects the workgroup size of a kernel, timing the candidates if the table has no entry yet.
+        /*!
+            Candidates that exceed the workgroup limits of the Device or fail to compile are skipped.
+            Errors while recording, submitting or reading back a timing run are thrown to the caller.
+            The new entry is saved to the table file immediately.
+
+            \param createInfo is the construction parameters of the kernel. The workgroup size constant is ignored.
+            \param recordFunction records one run of the kernel on representative input.
+            \return the selected workgroup size.
+         */
+        Result tune(const ComputePipeline::CreateInfo& createInfo, const RecordFunction& recordFunction);
+
+        //! Looks up the stored workgroup size of a kernel without timing.
+        /*!
+            \param createInfo is the construction parameters of the kernel.
+            \param defaultSize is returned if the kernel has not been tuned on this Device.
+            \return the workgroup size.
+         */
+        std::uint32_t lookup(const ComputePipeline::CreateInfo& createInfo, std::uint32_t defaultSize) const;
+
+        //! Sets the workgroup size constant of a kernel.
+        /*!
+            \param createInfo is the construction parameters of the kernel.
+            \param workgroupSize is the workgroup size.
+            \return a copy of createInfo with the workgroup size constant set.
+         */
+        ComputePipeline::CreateInfo specialize(const ComputePipeline::CreateInfo& createInfo, std::uint32_t workgroupSize) const;
+
+        //! Writes the tuning table to the file. This does nothing if CreateInfo::path is empty.
+        void save() const;
+    };
+}
@@ -0,0 +1,146 @@
+#include <cstddef>
+#include <cstdlib>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "mvk/Instance.hpp"
+#include "mvk/PipelineCache.hpp"
+
+// Offline pipeline prewarming.
+//
+// usage: pipelineWarmer [--device N] [--cache PATH] MANIFEST...
+//
+// Compiles every pipeline recorded in the manifests (see Device::openPipelineManifest) on this
+// machine. Run at build time, it checks that every pipeline production used still compiles against
+// the current shaders. With --cache, the compiled pipelines are written as VkPipelineCache data to
+// PATH; an application started with MVK_PIPELINE_CACHE=PATH on the same driver and device then
+// loads them instead of compiling. The exit status is non-zero if a manifest can not be read or a
+// pipeline fails to compile.
+//
+// The gradle task prewarmPipelines builds and runs this with the manifest given by -Pmanifest and
+// the cache given by -PpipelineCache.
+
+struct Options {
+    std::ptrdiff_t device = 0;
+    std::string cachePath;
+    std::vector<std::string> manifests;
+};
+
+Options parseOptions(int argc, char ** argv) {
+    auto options = Options {};
+
+    for (int i = 1; i < argc; i++) {
+        const auto arg = std::string(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if ("--device" == arg && hasValue) {
+            options.device = std::atoi(argv[++i]);
+        } else if ("--cache" == arg && hasValue) {
+            options.cachePath = argv[++i];
+        } else if (0 == arg.compare(0, 2, "--")) {
+            throw std::runtime_error("Unknown argument: " + arg);
+        } else {
+            options.manifests.push_back(arg);
+        }
+    }
+
+    if (options.manifests.empty()) {
+        throw std::runtime_error("usage: pipelineWarmer [--device N] [--cache PATH] MANIFEST...");
+    }
+
+    return options;
+}
+
+struct Totals {
+    std::size_t compiled = 0;
+    std::size_t duplicates = 0;
+    std::size_t failed = 0;
+};
+
+// compiles one entry and reports failures with the debug name and the shaders of the pipeline
+template<class PrewarmFunction>
+void warm(Totals& totals, const std::string& name, const std::vector<mvk::PipelineShaderStageCreateInfo>& stages, PrewarmFunction prewarmFunction) {
+    try {
+        if (prewarmFunction()) {
+            totals.compiled++;
+        } else {
+            totals.duplicates++;
+        }
+    } catch (const std::exception& ex) {
+        totals.failed++;
+
+        std::cerr << "Failed to compile pipeline \"" << name << "\" (";
+
+        for (std::size_t i = 0; i < stages.size(); i++) {
+            std::cerr << (i > 0 ? ", " : "") << stages[i].moduleInfo.path << ":" << stages[i].name;
+        }
+
+        std::cerr << "): " << ex.what() << std::endl;
+    }
+}
+
+int main(int argc, char ** argv) {
+    const auto options = parseOptions(argc, argv);
+
+    auto& instance = mvk::Instance::getCurrent();
+    auto& physicalDevice = instance.getPhysicalDevice(options.device);
+    auto pDevice = physicalDevice.createDevice();
+
+    // a PipelineCache of its own, so the output only holds the pipelines of the manifests
+    mvk::PipelineCache cache(pDevice.get());
+    auto pCache = &cache;
+
+    std::cout << physicalDevice.toString() << std::endl;
+
+    auto totals = Totals {};
+    bool unreadable = false;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (const auto& path : options.manifests) {
+        mvk::PipelineManifest manifest;
+
+        if (!manifest.load(path)) {
+            std::cerr << "Unable to read pipeline manifest: " << path << std::endl;
+            unreadable = true;
+            continue;
+        }
+
+        std::cout << path << ": " << manifest.size() << " pipelines" << std::endl;
+
+        for (const auto& createInfo : manifest.getComputePipelines()) {
+            warm(totals, createInfo.name, {createInfo.stage}, [&] {
+                return pCache->prewarm(createInfo);
+            });
+        }
+
+        for (auto& entry : manifest.getGraphicsPipelines()) {
+            if (!entry.sampleMask.empty()) {
+                entry.createInfo.multisampleState.pSampleMask = entry.sampleMask.data();
+            }
+
+            warm(totals, entry.createInfo.name, entry.createInfo.stages, [&] {
+                return pCache->prewarm(entry.createInfo, entry.renderPassInfo);
+            });
+        }
+    }
+
+    const auto seconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+
+    if (!options.cachePath.empty()) {
+        cache.save(options.cachePath);
+
+        std::cout << "Wrote " << options.cachePath << std::endl;
+    }
+
+    std::cout << totals.compiled << " compiled, "
+        << totals.duplicates << " duplicates, "
+        << totals.failed << " failed in "
+        << std::fixed << std::setprecision(2) << seconds << " s" << std::endl;
+
+    return (unreadable || totals.failed > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,364 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mvk/Instance.hpp"
+
+// Multithreaded scaling stress test for libmarsvk.
+//
+// usage: stress [--device N] [--threads N] [--iterations N] [--buffer-size BYTES] [--csv]
+//
+// For every thread count from 1 to --threads (the core count by default) each thread runs
+// --iterations iterations of: create a Buffer, allocate a CommandBuffer from its own CommandPool,
+// allocate and write a DescriptorSet, record a fill and a barrier, submit to the shared Queue and
+// wait for its Fence. The throughput, the latency percentiles of an iteration and the share of the
+// wall time each serialization point was held are reported per thread count.
+//
+// The library leaves these objects externally synchronized, so the test guards them itself:
+//  - Queue: vkQueueSubmit requires external synchronization of the VkQueue.
+//  - DescriptorPool: identical layouts are deduplicated by the DescriptorSetLayoutCache, so every
+//    thread allocates from the one unsynchronized DescriptorPool behind the shared layout.
+//  - FencePool: Device::acquireFence and Fence::release share the Device's unsynchronized FencePool.
+// The SamplerCache of the Device is unsynchronized as well and is not used here. The DescriptorSetLayoutCache,
+// PipelineLayoutCache, shader cache, QueueFamily::getCurrentCommandPool and the memory allocator lock
+// internally and are not timed.
+
+struct Options {
+    std::ptrdiff_t device = 0;
+    std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t iterations = 500;
+    std::size_t bufferSize = 64 * 1024;
+    bool csv = false;
+};
+
+// A mutex that records how long it was waited for and held.
+class TimedLock {
+    std::mutex _mutex;
+    std::atomic<std::uint64_t> _waitNs;
+    std::atomic<std::uint64_t> _holdNs;
+
+public:
+    TimedLock() noexcept:
+        _waitNs(0),
+        _holdNs(0) {}
+
+    template<typename Fn>
+    auto with(Fn fn) -> decltype(fn()) {
+        using clock = std::chrono::steady_clock;
+
+        const auto start = clock::now();
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto acquired = clock::now();
+
+        struct Hold {
+            TimedLock * owner;
+            clock::time_point start;
+            ~Hold() {
+                owner->_holdNs += std::chrono::duration_cast<std::chrono::nanoseconds> (clock::now() - start).count();
+            }
+        } hold {this, acquired};
+
+        _waitNs += std::chrono::duration_cast<std::chrono::nanoseconds> (acquired - start).count();
+
+        return fn();
+    }
+
+    void reset() noexcept {
+        _waitNs = 0;
+        _holdNs = 0;
+    }
+
+    double getWaitSeconds() const noexcept {
+        return _waitNs * 1e-9;
+    }
+
+    double getHoldSeconds() const noexcept {
+        return _holdNs * 1e-9;
+    }
+};
+
+struct SharedState {
+    mvk::Device * device;
+    mvk::Queue * queue;
+    mvk::DescriptorSetLayout * setLayout;
+    TimedLock queueLock;
+    TimedLock descriptorLock;
+    TimedLock fenceLock;
+};
+
+struct Step {
+    std::size_t threads;
+    double seconds;
+    double iterationsPerSecond;
+    double p50Ms;
+    double p99Ms;
+    double p999Ms;
+    double maxMs;
+    double queueHeld;
+    double descriptorHeld;
+    double fenceHeld;
+    double lockWaitMs;
+};
+
+void runThread(SharedState& shared, const Options& options, std::uint32_t seed, std::vector<double>& latencies) {
+    auto pCommandPool = shared.queue->getQueueFamily()->getCurrentCommandPool();
+
+    auto bufferCI = mvk::Buffer::CreateInfo {};
+    bufferCI.usage = mvk::BufferUsageFlag::STORAGE_BUFFER | mvk::BufferUsageFlag::TRANSFER_DST;
+    bufferCI.size = options.bufferSize;
+
+    auto barrier = mvk::BufferMemoryBarrier {};
+    barrier.srcAccessMask = mvk::AccessFlag::TRANSFER_WRITE;
+    barrier.dstAccessMask = mvk::AccessFlag::SHADER_READ;
+    barrier.offset = 0;
+    barrier.size = mvk::Buffer::WHOLE_SIZE;
+
+    latencies.reserve(options.iterations);
+
+    for (std::size_t i = 0; i < options.iterations; i++) {
+        const auto start = std::chrono::steady_clock::now();
+
+        auto pBuffer = shared.device->createBuffer(bufferCI, mvk::MemoryUsage::GPU_ONLY);
+        auto pCommandBuffer = pCommandPool->allocate();
+        auto pDescriptorSet = shared.descriptorLock.with([&] { return shared.setLayout->allocate(); });
+
+        pDescriptorSet->writeBuffer(mvk::DescriptorType::STORAGE_BUFFER, 0, pBuffer.get());
+
+        barrier.buffer = pBuffer.get();
+
+        pCommandBuffer->begin(mvk::CommandBufferUsageFlag::ONE_TIME_SUBMIT);
+        pCommandBuffer->fillBuffer(pBuffer, 0, options.bufferSize, seed + static_cast<std::uint32_t> (i));
+        pCommandBuffer->pipelineBarrier(
+            mvk::PipelineStageFlag::TRANSFER, mvk::PipelineStageFlag::COMPUTE_SHADER,
+            mvk::DependencyFlag::NONE,
+            0, nullptr,
+            1, &barrier,
+            0, nullptr);
+        pCommandBuffer->end();
+
+        auto pFence = shared.fenceLock.with([&] { return shared.device->acquireFence(); });
+
+        shared.queueLock.with([&] { shared.queue->submit(pCommandBuffer, pFence); });
+
+        pFence->waitFor();
+        pFence->reset();
+
+        shared.fenceLock.with([&] { pFence->release(); });
+        shared.descriptorLock.with([&] { pDescriptorSet->release(); });
+
+        latencies.push_back(std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now() - start).count());
+    }
+}
+
+Step runStep(SharedState& shared, const Options& options, std::size_t threadCount) {
+    shared.queueLock.reset();
+    shared.descriptorLock.reset();
+    shared.fenceLock.reset();
+
+    auto latencies = std::vector<std::vector<double>> (threadCount);
+    auto threads = std::vector<std::thread> ();
+    auto errors = std::vector<std::string> (threadCount);
+    std::atomic<bool> go(false);
+
+    threads.reserve(threadCount);
+
+    for (std::size_t t = 0; t < threadCount; t++) {
+        threads.emplace_back([&, t] {
+            while (!go) {
+                std::this_thread::yield();
+            }
+
+            try {
+                runThread(shared, options, static_cast<std::uint32_t> (t << 24), latencies[t]);
+            } catch (const std::exception& ex) {
+                errors[t] = ex.what();
+            }
+        });
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    go = true;
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto seconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+
+    for (const auto& error : errors) {
+        if (!error.empty()) {
+            throw std::runtime_error("Stress thread failed: " + error);
+        }
+    }
+
+    auto all = std::vector<double> ();
+
+    for (const auto& threadLatencies : latencies) {
+        all.insert(all.end(), threadLatencies.begin(), threadLatencies.end());
+    }
+
+    std::sort(all.begin(), all.end());
+
+    auto percentile = [&](double p) {
+        return all[std::min(all.size() - 1, static_cast<std::size_t> (all.size() * p))];
+    };
+
+    auto step = Step {};
+    step.threads = threadCount;
+    step.seconds = seconds;
+    step.iterationsPerSecond = all.size() / seconds;
+    step.p50Ms = percentile(0.5);
+    step.p99Ms = percentile(0.99);
+    step.p999Ms = percentile(0.999);
+    step.maxMs = all.back();
+    step.queueHeld = shared.queueLock.getHoldSeconds() / seconds;
+    step.descriptorHeld = shared.descriptorLock.getHoldSeconds() / seconds;
+    step.fenceHeld = shared.fenceLock.getHoldSeconds() / seconds;
+    step.lockWaitMs = 1000.0 * (shared.queueLock.getWaitSeconds() + shared.descriptorLock.getWaitSeconds() + shared.fenceLock.getWaitSeconds()) / all.size();
+
+    return step;
+}
+
+Options parseOptions(int argc, char ** argv) {
+    auto options = Options {};
+
+    for (int i = 1; i < argc; i++) {
+        const auto arg = std::string(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if ("--device" == arg && hasValue) {
+            options.device = std::atoi(argv[++i]);
+        } else if ("--threads" == arg && hasValue) {
+            options.threads = std::max(1, std::atoi(argv[++i]));
+        } else if ("--iterations" == arg && hasValue) {
+            options.iterations = std::max(1, std::atoi(argv[++i]));
+        } else if ("--buffer-size" == arg && hasValue) {
+            // vkCmdFillBuffer requires a multiple of 4
+            options.bufferSize = std::max(4, std::atoi(argv[++i]) & ~3);
+        } else if ("--csv" == arg) {
+            options.csv = true;
+        } else {
+            throw std::runtime_error("Unknown argument: " + arg);
+        }
+    }
+
+    return options;
+}
+
+int main(int argc, char ** argv) {
+    const auto options = parseOptions(argc, argv);
+
+    auto& instance = mvk::Instance::getCurrent();
+    auto& physicalDevice = instance.getPhysicalDevice(options.device);
+    auto pDevice = physicalDevice.createDevice();
+
+    auto pQueueFamily = pDevice->getQueueFamily(0);
+
+    auto setLayoutInfo = mvk::DescriptorSetLayout::CreateInfo {};
+
+    {
+        auto dslBinding = mvk::DescriptorSetLayout::Binding {};
+        dslBinding.stages = mvk::ShaderStage::COMPUTE;
+        dslBinding.descriptorType = mvk::DescriptorType::STORAGE_BUFFER;
+        dslBinding.descriptorCount = 1;
+        dslBinding.binding = 0;
+
+        setLayoutInfo.bindings.push_back(dslBinding);
+    }
+
+    SharedState shared;
+    shared.device = pDevice.get();
+    shared.queue = pQueueFamily->getQueue(0);
+    // every thread allocates its DescriptorSets from the pool of this one layout
+    shared.setLayout = pDevice->allocateDescriptorSetLayout(setLayoutInfo);
+
+    auto threadCounts = std::vector<std::size_t> ();
+
+    for (std::size_t n = 1; n < options.threads; n *= 2) {
+        threadCounts.push_back(n);
+    }
+
+    threadCounts.push_back(options.threads);
+
+    if (options.csv) {
+        std::cout << "threads,seconds,iterations_per_s,speedup,p50_ms,p99_ms,p999_ms,max_ms,queue_held,descriptor_held,fence_held,lock_wait_ms" << std::endl;
+    } else {
+        std::cout << physicalDevice.toString() << std::endl;
+        std::cout << options.iterations << " iterations per thread, " << options.bufferSize << " byte buffers\n" << std::endl;
+        std::cout << std::setw(8) << "threads"
+            << std::setw(12) << "iter/s"
+            << std::setw(9) << "speedup"
+            << std::setw(10) << "p50 ms"
+            << std::setw(10) << "p99 ms"
+            << std::setw(10) << "p99.9 ms"
+            << std::setw(10) << "max ms"
+            << std::setw(9) << "queue"
+            << std::setw(9) << "dpool"
+            << std::setw(9) << "fences"
+            << std::setw(12) << "wait ms/it" << std::endl;
+    }
+
+    double baseline = 0.0;
+    auto steps = std::vector<Step> ();
+
+    for (auto threadCount : threadCounts) {
+        const auto step = runStep(shared, options, threadCount);
+
+        if (1 == threadCount) {
+            baseline = step.iterationsPerSecond;
+        }
+
+        const auto speedup = step.iterationsPerSecond / baseline;
+
+        if (options.csv) {
+            std::cout << step.threads << ',' << step.seconds << ',' << step.iterationsPerSecond << ',' << speedup
+                << ',' << step.p50Ms << ',' << step.p99Ms << ',' << step.p999Ms << ',' << step.maxMs
+                << ',' << step.queueHeld << ',' << step.descriptorHeld << ',' << step.fenceHeld
+                << ',' << step.lockWaitMs << std::endl;
+        } else {
+            std::cout << std::fixed
+                << std::setw(8) << step.threads
+                << std::setw(12) << std::setprecision(0) << step.iterationsPerSecond
+                << std::setw(8) << std::setprecision(2) << speedup << "x"
+                << std::setw(10) << std::setprecision(3) << step.p50Ms
+                << std::setw(10) << step.p99Ms
+                << std::setw(10) << step.p999Ms
+                << std::setw(10) << step.maxMs
+                << std::setw(8) << std::setprecision(1) << step.queueHeld * 100.0 << "%"
+                << std::setw(8) << step.descriptorHeld * 100.0 << "%"
+                << std::setw(8) << step.fenceHeld * 100.0 << "%"
+                << std::setw(12) << std::setprecision(4) << step.lockWaitMs << std::endl;
+        }
+
+        steps.push_back(step);
+    }
+
+    if (!options.csv) {
+        const auto& last = steps.back();
+
+        std::cout << "\nSerialization points (share of wall time held at " << last.threads << " threads):" << std::endl;
+        std::cout << "  queue   " << std::setprecision(1) << last.queueHeld * 100.0 << "%  vkQueueSubmit is externally synchronized; all threads share one Queue." << std::endl;
+        std::cout << "  dpool   " << last.descriptorHeld * 100.0 << "%  the DescriptorSetLayoutCache shares one unsynchronized DescriptorPool per layout." << std::endl;
+        std::cout << "  fences  " << last.fenceHeld * 100.0 << "%  the Device's FencePool is unsynchronized." << std::endl;
+        std::cout << "  Unmeasured: the SamplerCache of the Device is unsynchronized and not used; the layout caches, the shader cache," << std::endl;
+        std::cout << "  getCurrentCommandPool and the memory allocator lock internally." << std::endl;
+        std::cout << "  A lock held close to 100% of the wall time caps the speedup regardless of the thread count." << std::endl;
+    }
+
+    shared.setLayout->release();
+    pQueueFamily->detach();
+
+    return 0;
+}
@@ -1,104 +1,419 @@
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
 #include <algorithm>
+#include <chrono>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "mvk/Instance.hpp"
+#include "mvk/ShaderReflection.hpp"
+
+#if defined(MVK_EMBED_SHADERS)
+#include "testCompute/square.comp.spv.hpp"
+#endif
+
+// Compute throughput benchmark.
+//
+// Squares a buffer of vec4s and sweeps the data size, the workgroup size (through specialization
+// constant 0), the memory type and the number of dispatches per submit. Every configuration reports
+// the upload, dispatch and readback times separately:
+//
+//   upload    host memcpy into the input Buffer; for GPU_ONLY also the staging copy and its Fence wait.
+//   dispatch  submit of the recorded dispatches until the Fence signals.
+//   readback  host memcpy out of the output Buffer; for GPU_ONLY also the staging copy and its Fence wait.
+//
+// usage: testCompute [--sizes 4K,1M,...] [--workgroups 32,64,...] [--memory cpu,gpu] [--dispatches 1,16,...]
+//                    [--repeats N] [--max-traffic BYTES] [--device N] [--csv] [--validate] [--autotune PATH]
+//
+// --autotune replaces the workgroup sizes with the one selected by a WorkgroupTuner. The tuner times the
+// kernel on a GPU_ONLY buffer of AUTOTUNE_SIZE bytes and stores its choice in the table at PATH, so
+// later runs on the same device and driver skip the timing.
 
-constexpr unsigned int WORKGROUP_SIZE = 32;
-constexpr unsigned int DATA_SIZE = 32;
 constexpr int INPUT_BUFFER_BINDING = 0;
 constexpr int OUTPUT_BUFFER_BINDING = 1;
+constexpr std::uint32_t WORKGROUP_SIZE_CONSTANT_ID = 0;
+constexpr VkDeviceSize ELEMENT_SIZE = 4 * sizeof(float);
+constexpr VkDeviceSize AUTOTUNE_SIZE = 16ULL << 20;
 
-int main(int argc, char ** argv) {
-    mvk::Instance::enableLayer(mvk::InstanceLayer::STANDARD_VALIDATION);
-    //mvk::Instance::enableLayer(mvk::InstanceLayer::API_DUMP);
+struct Options {
+    std::vector<VkDeviceSize> sizes = {4ULL << 10, 64ULL << 10, 1ULL << 20, 16ULL << 20, 256ULL << 20};
+    std::vector<std::uint32_t> workgroupSizes = {32, 64, 128, 256};
+    std::vector<mvk::MemoryUsage> memoryUsages = {mvk::MemoryUsage::CPU_ONLY, mvk::MemoryUsage::GPU_ONLY};
+    std::vector<std::uint32_t> dispatchCounts = {1, 16, 256};
+    std::size_t repeats = 5;
+    VkDeviceSize maxTraffic = 4ULL << 30;
+    std::ptrdiff_t device = 0;
+    bool csv = false;
+    bool validate = false;
+    std::string autotunePath;
+};
 
-    auto& instance = mvk::Instance::getCurrent();
-    auto& physicalDevice = instance.getPhysicalDevice(0);
-    auto pDevice = physicalDevice.createDevice();
+// Parses sizes such as 4096, 64K, 16M or 1G.
+VkDeviceSize parseSize(const std::string& text) {
+    auto end = std::size_t(0);
+    auto value = static_cast<VkDeviceSize> (std::stoull(text, &end));
 
-    auto bufferCI = mvk::Buffer::CreateInfo {};
-    bufferCI.usage = mvk::BufferUsageFlag::STORAGE_BUFFER;
-    bufferCI.size = DATA_SIZE * sizeof(float);
+    if (end < text.size()) {
+        switch (text[end]) {
+            case 'G': case 'g':
+                value <<= 10;
+                // fall through
+            case 'M': case 'm':
+                value <<= 10;
+                // fall through
+            case 'K': case 'k':
+                value <<= 10;
+                break;
+            default:
+                throw std::runtime_error("Invalid size: " + text);
+        }
+    }
+
+    return value;
+}
 
-    auto pInputBuffer = pDevice->createBuffer(bufferCI, mvk::MemoryUsage::CPU_ONLY);
+template<typename T, typename ParseFn>
+std::vector<T> parseList(const std::string& text, ParseFn parse) {
+    auto out = std::vector<T> ();
+    auto stream = std::stringstream(text);
+    auto item = std::string();
 
-    std::cout << "Compute Shader Squaring\n";
-    std::cout << "Inputs: [";
+    while (std::getline(stream, item, ',')) {
+        out.push_back(parse(item));
+    }
 
-    pInputBuffer->mapping<float> ([&](auto pData) {
-        for (unsigned int i = 0; i < DATA_SIZE; i++) {
-            pData[i] = static_cast<float> (i);
-            std::cout << std::dec << i << ", ";
+    return out;
+}
+
+Options parseOptions(int argc, char ** argv) {
+    auto options = Options {};
+
+    for (int i = 1; i < argc; i++) {
+        const auto arg = std::string(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if ("--sizes" == arg && hasValue) {
+            options.sizes = parseList<VkDeviceSize> (argv[++i], parseSize);
+        } else if ("--workgroups" == arg && hasValue) {
+            options.workgroupSizes = parseList<std::uint32_t> (argv[++i], [](const std::string& item) {
+                return static_cast<std::uint32_t> (std::stoul(item));
+            });
+        } else if ("--memory" == arg && hasValue) {
+            options.memoryUsages = parseList<mvk::MemoryUsage> (argv[++i], [](const std::string& item) {
+                if ("cpu" == item) {
+                    return mvk::MemoryUsage::CPU_ONLY;
+                } else if ("gpu" == item) {
+                    return mvk::MemoryUsage::GPU_ONLY;
+                }
+
+                throw std::runtime_error("Invalid memory type: " + item);
+            });
+        } else if ("--dispatches" == arg && hasValue) {
+            options.dispatchCounts = parseList<std::uint32_t> (argv[++i], [](const std::string& item) {
+                return static_cast<std::uint32_t> (std::stoul(item));
+            });
+        } else if ("--repeats" == arg && hasValue) {
+            options.repeats = std::max(1, std::atoi(argv[++i]));
+        } else if ("--max-traffic" == arg && hasValue) {
+            options.maxTraffic = parseSize(argv[++i]);
+        } else if ("--device" == arg && hasValue) {
+            options.device = std::atoi(argv[++i]);
+        } else if ("--csv" == arg) {
+            options.csv = true;
+        } else if ("--validate" == arg) {
+            options.validate = true;
+        } else if ("--autotune" == arg && hasValue) {
+            options.autotunePath = argv[++i];
+        } else {
+            throw std::runtime_error("Unknown argument: " + arg);
         }
-    });
+    }
 
-    std::cout << "]" << std::endl;
+    return options;
+}
 
-    auto pOutputBuffer = pDevice->createBuffer(bufferCI, mvk::MemoryUsage::CPU_ONLY);
+// Makes the writes of srcStage visible to dstStage. Separate submits are not ordered for memory without it.
+void memoryBarrier(mvk::CommandBuffer * commandBuffer, mvk::PipelineStageFlag srcStage, mvk::PipelineStageFlag dstStage, mvk::AccessFlag srcAccess, mvk::AccessFlag dstAccess) {
+    auto barrier = mvk::MemoryBarrier {};
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
 
-    auto pipelineCI = mvk::ComputePipeline::CreateInfo {};
-    pipelineCI.stage.name = "main";
-    pipelineCI.stage.stage = mvk::ShaderStage::COMPUTE;
-    pipelineCI.stage.moduleInfo.path = "shaders/testCompute/square.comp.spv";
+    commandBuffer->pipelineBarrier(srcStage, dstStage, mvk::DependencyFlag::NONE, 1, &barrier, 0, nullptr, 0, nullptr);
+}
 
-    {
-        auto setLayoutInfo = mvk::DescriptorSetLayout::CreateInfo {};
-    
-        {
-            auto dslBinding = mvk::DescriptorSetLayout::Binding {};
-            dslBinding.stages = mvk::ShaderStage::COMPUTE;
-            dslBinding.descriptorType = mvk::DescriptorType::STORAGE_BUFFER;
-            dslBinding.descriptorCount = 1;
-            dslBinding.binding = INPUT_BUFFER_BINDING;
+double median(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
 
-            setLayoutInfo.bindings.push_back(dslBinding);
+    return samples[samples.size() / 2];
+}
 
-            dslBinding.binding = OUTPUT_BUFFER_BINDING;
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+}
 
-            setLayoutInfo.bindings.push_back(dslBinding);
-        }
+double toGBps(VkDeviceSize bytes, double seconds) {
+    return seconds > 0.0 ? static_cast<double> (bytes) / seconds * 1E-9 : 0.0;
+}
 
-        pipelineCI.layoutInfo.setLayoutInfos.push_back(setLayoutInfo);
-    }
+int main(int argc, char ** argv) {
+    const auto options = parseOptions(argc, argv);
 
-    auto pPipeline = pDevice->createPipeline(pipelineCI);
-    auto pDescriptorSet = pPipeline->getDescriptorSetLayout(0)->allocate();
+    if (options.validate) {
+        mvk::Instance::enableLayer(mvk::InstanceLayer::STANDARD_VALIDATION);
+    }
 
-    pDescriptorSet->writeBuffer(mvk::DescriptorType::STORAGE_BUFFER, INPUT_BUFFER_BINDING, pInputBuffer);
-    pDescriptorSet->writeBuffer(mvk::DescriptorType::STORAGE_BUFFER, OUTPUT_BUFFER_BINDING, pOutputBuffer);
+    auto& instance = mvk::Instance::getCurrent();
+    auto& physicalDevice = instance.getPhysicalDevice(options.device);
+    auto pDevice = physicalDevice.createDevice();
+    const auto& limits = physicalDevice.getProperties().limits;
 
     auto pQueueFamily = pDevice->getQueueFamily(0);
     auto pQueue = pQueueFamily->getQueue(0);
+    auto pCommandPool = pQueueFamily->getCurrentCommandPool();
     auto pFence = pDevice->acquireFence();
 
-    {
-        auto pCommandBuffer = pQueueFamily->getCurrentCommandPool()->allocate();
+    const auto submitAndWait = [&](const mvk::CommandBuffer * commandBuffer) {
+        pQueue->submit(commandBuffer, pFence);
+        pFence->waitFor();
+        pFence->reset();
+    };
 
-        pCommandBuffer->begin(mvk::CommandBufferUsageFlag::ONE_TIME_SUBMIT);
-        pCommandBuffer->bindPipeline(pPipeline);
-        pCommandBuffer->bindDescriptorSet(pPipeline, 0, pDescriptorSet);
+    auto kernelCI = mvk::ComputePipeline::CreateInfo {};
+    kernelCI.stage.name = "main";
+    kernelCI.stage.stage = mvk::ShaderStage::COMPUTE;
+    kernelCI.stage.moduleInfo.path = "shaders/testCompute/square.comp.spv";
+    // the layout is read from the SPIR-V, so it always matches the bindings declared by the kernel
+    kernelCI.layoutInfo = mvk::ShaderReflection::createPipelineLayoutInfo(kernelCI.stage);
 
-        auto gX = std::max(1u, DATA_SIZE / WORKGROUP_SIZE);
+    auto workgroupSizes = options.workgroupSizes;
 
-        pCommandBuffer->dispatch(gX);
-        pCommandBuffer->end();
+    if (!options.autotunePath.empty()) {
+        auto tunerCI = mvk::WorkgroupTuner::CreateInfo {};
+        tunerCI.queueFamily = pQueueFamily;
+        tunerCI.path = options.autotunePath;
+        tunerCI.constantID = WORKGROUP_SIZE_CONSTANT_ID;
 
-        pQueue->submit(pCommandBuffer.get(), pFence);
-        pFence->waitFor();
-        pFence->reset();
-    }
+        auto pTuner = pDevice->createWorkgroupTuner(tunerCI);
+
+        const auto size = std::min<VkDeviceSize> (AUTOTUNE_SIZE, limits.maxStorageBufferRange - limits.maxStorageBufferRange % ELEMENT_SIZE);
+        const auto elementCount = size / ELEMENT_SIZE;
 
-    std::cout << "Output: [";
+        auto bufferCI = mvk::Buffer::CreateInfo {};
+        bufferCI.usage = mvk::BufferUsageFlag::STORAGE_BUFFER;
+        bufferCI.size = size;
 
-    pOutputBuffer->mapping<float>([&](auto pData) {
-        std::for_each(pData, pData + DATA_SIZE, [](auto data) {
-            std::cout << data << ", ";
+        auto pInputBuffer = pDevice->createBuffer(bufferCI, mvk::MemoryUsage::GPU_ONLY);
+        auto pOutputBuffer = pDevice->createBuffer(bufferCI, mvk::MemoryUsage::GPU_ONLY);
+        auto pSetLayout = pDevice->allocateDescriptorSetLayout(kernelCI.layoutInfo.setLayoutInfos[0]);
+        auto pDescriptorSet = pSetLayout->allocate();
+
+        pDescriptorSet->writeBuffer(mvk::DescriptorType::STORAGE_BUFFER, INPUT_BUFFER_BINDING, pInputBuffer);
+        pDescriptorSet->writeBuffer(mvk::DescriptorType::STORAGE_BUFFER, OUTPUT_BUFFER_BINDING, pOutputBuffer);
+
+        const auto result = pTuner->tune(kernelCI, [&](mvk::CommandBuffer * commandBuffer, const mvk::ComputePipeline * pipeline, std::uint32_t workgroupSize) {
+            const auto groupCount = (elementCount + workgroupSize - 1) / workgroupSize;
+            const auto groupsX = static_cast<std::uint32_t> (std::min<VkDeviceSize> (groupCount, limits.maxComputeWorkGroupCount[0]));
+            const auto groupsY = static_cast<std::uint32_t> ((groupCount + groupsX - 1) / groupsX);
+
+            commandBuffer->bindDescriptorSet(pipeline, 0, pDescriptorSet);
+            commandBuffer->dispatch(groupsX, groupsY);
         });
-    });
 
-    std::cout << "]" << std::endl;
+        pDescriptorSet->release();
+        pSetLayout->release();
+
+        std::cerr << "Autotuned workgroup size: " << result.workgroupSize << " (" << result.milliseconds << " ms"
+            << (result.cached ? ", cached" : "") << ")" << std::endl;
+
+        workgroupSizes = {result.workgroupSize};
+    }
+
+    if (options.csv) {
+        std::cout << "bytes,workgroupSize,memory,dispatchesPerSubmit,uploadMs,uploadGBps,dispatchMs,dispatchGBps,dispatchesPerSecond,readbackMs,readbackGBps" << std::endl;
+    } else {
+        std::cout << physicalDevice.toString() << "\n"
+            << std::setw(12) << "bytes" << std::setw(6) << "wg" << std::setw(5) << "mem" << std::setw(7) << "disp"
+            << std::setw(12) << "upload ms" << std::setw(9) << "GB/s"
+            << std::setw(12) << "dispatch ms" << std::setw(9) << "GB/s" << std::setw(12) << "disp/s"
+            << std::setw(12) << "readback ms" << std::setw(9) << "GB/s" << std::endl;
+    }
+
+    for (auto workgroupSize : workgroupSizes) {
+        if (workgroupSize > limits.maxComputeWorkGroupSize[0] || workgroupSize > limits.maxComputeWorkGroupInvocations) {
+            std::cerr << "Skipping workgroup size " << workgroupSize << ": exceeds device limits" << std::endl;
+            continue;
+        }
+
+        auto pipelineCI = kernelCI;
+        pipelineCI.stage.specializationInfo.set<std::uint32_t> (WORKGROUP_SIZE_CONSTANT_ID, workgroupSize);
+
+        auto pPipeline = pDevice->createPipeline(pipelineCI);
+
+        for (auto size : options.sizes) {
+            size = std::max(ELEMENT_SIZE, size - size % ELEMENT_SIZE);
+
+            if (size > limits.maxStorageBufferRange) {
+                std::cerr << "Skipping " << size << " bytes: exceeds maxStorageBufferRange" << std::endl;
+                continue;
+            }
+
+            const auto elementCount = size / ELEMENT_SIZE;
+            const auto groupCount = (elementCount + workgroupSize - 1) / workgroupSize;
+            const auto groupsX = static_cast<std::uint32_t> (std::min<VkDeviceSize> (groupCount, limits.maxComputeWorkGroupCount[0]));
+            const auto groupsY = static_cast<std::uint32_t> ((groupCount + groupsX - 1) / groupsX);
+
+            auto hostInput = std::vector<float> (elementCount * 4);
+            auto hostOutput = std::vector<float> (elementCount * 4);
+
+            for (std::size_t i = 0; i < hostInput.size(); i++) {
+                hostInput[i] = static_cast<float> (i % 1024);
+            }
+
+            for (auto memoryUsage : options.memoryUsages) {
+                const bool staged = mvk::MemoryUsage::GPU_ONLY == memoryUsage;
+
+                auto bufferCI = mvk::Buffer::CreateInfo {};
+                bufferCI.usage = mvk::BufferUsageFlag::STORAGE_BUFFER | mvk::BufferUsageFlag::TRANSFER_SRC | mvk::BufferUsageFlag::TRANSFER_DST;
+                bufferCI.size = size;
+
+                auto pInputBuffer = pDevice->createBuffer(bufferCI, memoryUsage);
+                auto pOutputBuffer = pDevice->createBuffer(bufferCI, memoryUsage);
+                auto pUploadBuffer = mvk::Buffer::unique_null();
+                auto pReadbackBuffer = mvk::Buffer::unique_null();
+                auto pUploadCommands = mvk::CommandBuffer::unique_null();
+                auto pReadbackCommands = mvk::CommandBuffer::unique_null();
+
+                if (staged) {
+                    auto stagingCI = mvk::Buffer::CreateInfo {};
+                    stagingCI.usage = mvk::BufferUsageFlag::TRANSFER_SRC;
+                    stagingCI.size = size;
+
+                    pUploadBuffer = pDevice->createBuffer(stagingCI, mvk::MemoryUsage::CPU_ONLY);
+
+                    stagingCI.usage = mvk::BufferUsageFlag::TRANSFER_DST;
+
+                    pReadbackBuffer = pDevice->createBuffer(stagingCI, mvk::MemoryUsage::GPU_TO_CPU);
+
+                    pUploadCommands = pCommandPool->allocate();
+                    pUploadCommands->begin(mvk::CommandBufferUsageFlag::SIMULTANEOUS_USE);
+                    pUploadCommands->copyBuffer(pUploadBuffer, pInputBuffer, 0, 0, size);
+                    memoryBarrier(pUploadCommands.get(), mvk::PipelineStageFlag::TRANSFER, mvk::PipelineStageFlag::COMPUTE_SHADER, mvk::AccessFlag::TRANSFER_WRITE, mvk::AccessFlag::SHADER_READ);
+                    pUploadCommands->end();
+
+                    pReadbackCommands = pCommandPool->allocate();
+                    pReadbackCommands->begin(mvk::CommandBufferUsageFlag::SIMULTANEOUS_USE);
+                    memoryBarrier(pReadbackCommands.get(), mvk::PipelineStageFlag::COMPUTE_SHADER, mvk::PipelineStageFlag::TRANSFER, mvk::AccessFlag::SHADER_WRITE, mvk::AccessFlag::TRANSFER_READ);
+                    pReadbackCommands->copyBuffer(pOutputBuffer, pReadbackBuffer, 0, 0, size);
+                    memoryBarrier(pReadbackCommands.get(), mvk::PipelineStageFlag::TRANSFER, mvk::PipelineStageFlag::HOST, mvk::AccessFlag::TRANSFER_WRITE, mvk::AccessFlag::HOST_READ);
+                    pReadbackCommands->end();
+                }
+
+                auto pDescriptorSet = pPipeline->getDescriptorSetLayout(0)->allocate();
+
+                pDescriptorSet->writeBuffer(mvk::DescriptorType::STORAGE_BUFFER, INPUT_BUFFER_BINDING, pInputBuffer);
+                pDescriptorSet->writeBuffer(mvk::DescriptorType::STORAGE_BUFFER, OUTPUT_BUFFER_BINDING, pOutputBuffer);
+
+                auto pUploadData = (staged ? pUploadBuffer : pInputBuffer)->map();
+                auto pReadbackData = (staged ? pReadbackBuffer : pOutputBuffer)->map();
+
+                for (auto dispatchCount : options.dispatchCounts) {
+                    if (size * dispatchCount > options.maxTraffic) {
+                        continue;
+                    }
+
+                    auto pDispatchCommands = pCommandPool->allocate();
+
+                    pDispatchCommands->begin(mvk::CommandBufferUsageFlag::SIMULTANEOUS_USE);
+                    pDispatchCommands->bindPipeline(pPipeline);
+                    pDispatchCommands->bindDescriptorSet(pPipeline, 0, pDescriptorSet);
+
+                    // every dispatch writes the same values, so they may overlap without barriers
+                    for (std::uint32_t i = 0; i < dispatchCount; i++) {
+                        pDispatchCommands->dispatch(groupsX, groupsY);
+                    }
+
+                    if (!staged) {
+                        memoryBarrier(pDispatchCommands.get(), mvk::PipelineStageFlag::COMPUTE_SHADER, mvk::PipelineStageFlag::HOST, mvk::AccessFlag::SHADER_WRITE, mvk::AccessFlag::HOST_READ);
+                    }
+
+                    pDispatchCommands->end();
+
+                    auto uploadTimes = std::vector<double> ();
+                    auto dispatchTimes = std::vector<double> ();
+                    auto readbackTimes = std::vector<double> ();
+
+                    for (std::size_t repeat = 0; repeat < options.repeats; repeat++) {
+                        auto start = std::chrono::steady_clock::now();
+
+                        std::memcpy(pUploadData, hostInput.data(), size);
+
+                        if (staged) {
+                            submitAndWait(pUploadCommands.get());
+                        }
+
+                        uploadTimes.push_back(secondsSince(start));
+
+                        start = std::chrono::steady_clock::now();
+
+                        submitAndWait(pDispatchCommands.get());
+
+                        dispatchTimes.push_back(secondsSince(start));
+
+                        start = std::chrono::steady_clock::now();
+
+                        if (staged) {
+                            submitAndWait(pReadbackCommands.get());
+                        }
+
+                        std::memcpy(hostOutput.data(), pReadbackData, size);
+
+                        readbackTimes.push_back(secondsSince(start));
+                    }
+
+                    for (std::size_t i = 0; i < hostOutput.size(); i += std::max<std::size_t> (1, hostOutput.size() / 64)) {
+                        if (hostOutput[i] != hostInput[i] * hostInput[i]) {
+                            throw std::runtime_error("Readback mismatch at element " + std::to_string(i / 4) + "!");
+                        }
+                    }
+
+                    const auto uploadTime = median(uploadTimes);
+                    const auto dispatchTime = median(dispatchTimes);
+                    const auto readbackTime = median(readbackTimes);
+                    const auto memoryName = staged ? "gpu" : "cpu";
+
+                    // each dispatch reads and writes the whole buffer
+                    const auto dispatchGBps = toGBps(2 * size * dispatchCount, dispatchTime);
+                    const auto dispatchesPerSecond = dispatchTime > 0.0 ? dispatchCount / dispatchTime : 0.0;
+
+                    if (options.csv) {
+                        std::cout << size << "," << workgroupSize << "," << memoryName << "," << dispatchCount
+                            << "," << uploadTime * 1E3 << "," << toGBps(size, uploadTime)
+                            << "," << dispatchTime * 1E3 << "," << dispatchGBps << "," << dispatchesPerSecond
+                            << "," << readbackTime * 1E3 << "," << toGBps(size, readbackTime) << std::endl;
+                    } else {
+                        std::cout << std::fixed << std::setprecision(3)
+                            << std::setw(12) << size << std::setw(6) << workgroupSize << std::setw(5) << memoryName << std::setw(7) << dispatchCount
+                            << std::setw(12) << uploadTime * 1E3 << std::setw(9) << toGBps(size, uploadTime)
+                            << std::setw(12) << dispatchTime * 1E3 << std::setw(9) << dispatchGBps << std::setw(12) << std::setprecision(0) << dispatchesPerSecond
+                            << std::setprecision(3) << std::setw(12) << readbackTime * 1E3 << std::setw(9) << toGBps(size, readbackTime) << std::endl;
+                    }
+                }
+
+                (staged ? pUploadBuffer : pInputBuffer)->unmap();
+                (staged ? pReadbackBuffer : pOutputBuffer)->unmap();
+
+                pDescriptorSet->release();
+            }
+        }
+    }
 
+    pFence->release();
     pQueueFamily->detach();
 
     return 0;
@@ -3,9 +3,13 @@
 
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
+#include <cmath>
 
 #include <algorithm>
+#include <chrono>
 #include <stdexcept>
+#include <string>
 #include <queue>
 #include <vector>
 
@@ -14,70 +18,34 @@
 #include "mvk/ImageView.hpp"
 #include "mvk/Surface.hpp"
 
+#if defined(MVK_EMBED_SHADERS)
+#include "testDraw/tris2D_colored.frag.spv.hpp"
+#include "testDraw/tris2D_colored.vert.spv.hpp"
+#endif
+
+// usage: testDraw [--headless [--triangles N] [--draws N] [--frames N] [--device N]]
+//
+// The headless mode renders into an offscreen Image without GLFW, a window or a Swapchain, so it
+// runs on render nodes and software drivers such as lavapipe. It draws a grid of triangles split
+// evenly across the draws of every frame and reports frames per second, draws per second and the
+// CPU time spent recording each frame. The last frame is read back once and checked.
+
 constexpr int WINDOW_WIDTH = 640;
 constexpr int WINDOW_HEIGHT = 480;
+constexpr std::uint32_t FRAMES_IN_FLIGHT = 2;
 
 struct __attribute__ ((packed)) Vertex {
     float x, y;
     unsigned int color;
 };
 
-int main(int argc, char ** argv) {
-    if (!glfwInit()) {
-        throw std::runtime_error("Failed to init GLFW!");
-    }
-
-    //mvk::Instance::enableLayer(mvk::InstanceLayer::API_DUMP);
-    mvk::Instance::enableRequiredGLFWExtensions();
-
-    auto& instance = mvk::Instance::getCurrent();
-    auto& physicalDevice = instance.getPhysicalDevice(0);
-    auto pDevice = physicalDevice.createDevice(std::set<std::string>({VK_KHR_SWAPCHAIN_EXTENSION_NAME}));
-
-    glfwDefaultWindowHints();
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-
-    auto pWindow = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Test Draw", nullptr, nullptr);
-    auto pSurface = std::make_unique<mvk::Surface> (instance, pWindow);
-
-    auto pQueueFamily = pDevice->getQueueFamily(0);
-
-    if (!pQueueFamily->canPresent(pSurface)) {
-        throw std::runtime_error("Selected QueueFamily cannot present image!");
-    }
-
-    auto swapchainCI = mvk::Swapchain::CreateInfo {};    
-    swapchainCI.queueFamily = pQueueFamily;
-    swapchainCI.surface = pSurface.get();
-    swapchainCI.surfaceFormat.format = mvk::Format::B8G8R8A8_UNORM;
-    swapchainCI.presentMode = mvk::PresentMode::FIFO;
-
-    auto pSwapchain = pDevice->createSwapchain(swapchainCI);
-    pSwapchain->resize(WINDOW_WIDTH, WINDOW_HEIGHT);
-
-    auto imageCI = mvk::Image::CreateInfo {};
-    imageCI.usage = mvk::ImageUsageFlag::COLOR_ATTACHMENT | mvk::ImageUsageFlag::TRANSFER_SRC;
-    imageCI.extent.width = WINDOW_WIDTH;
-    imageCI.extent.height = WINDOW_HEIGHT;
-    imageCI.extent.depth = 1;
-    imageCI.imageType = mvk::ImageType::IMAGE_2D;
-    imageCI.format = mvk::Format::B8G8R8A8_UNORM; 
-    imageCI.arrayLayers = 1;
-    imageCI.mipLevels = 1;
-    imageCI.samples = 1;
-    
-    //NOTE: A format that isn't copy-compatible with the backbuffer will force a more expensive image blit.
-    // You will have to pay for this anyway if you have extent mismatch
-
-    auto pImage = pDevice->createImage(imageCI, mvk::MemoryUsage::GPU_ONLY);
-    auto imageView = mvk::ImageView(pImage);
-
+mvk::UPtrRenderPass createRenderPass(mvk::Device * device, mvk::Format format) {
     auto renderpassCI = mvk::RenderPass::CreateInfo {};
 
     {
         auto attachmentDescription = mvk::AttachmentDescription {};
         attachmentDescription.finalLayout = mvk::ImageLayout::COLOR_ATTACHMENT;
-        attachmentDescription.format = pImage->getInfo().format;
+        attachmentDescription.format = format;
         attachmentDescription.loadOp = mvk::LoadOp::CLEAR;
         attachmentDescription.storeOp = mvk::StoreOp::STORE;
         attachmentDescription.stencilLoadOp = mvk::LoadOp::DONT_CARE;
@@ -113,15 +81,10 @@ int main(int argc, char ** argv) {
         renderpassCI.dependencies.push_back(subpassDependency);
     }
 
-    auto pRenderPass = pDevice->createRenderPass(renderpassCI);
-
-    auto framebufferCI = mvk::Framebuffer::CreateInfo {};
-    framebufferCI.width = WINDOW_WIDTH;
-    framebufferCI.height = WINDOW_HEIGHT;
-    framebufferCI.layers = 1;
-
-    auto framebuffer = mvk::Framebuffer(pRenderPass, framebufferCI, std::vector<const mvk::ImageView * > ({&imageView}));
+    return device->createRenderPass(renderpassCI);
+}
 
+mvk::UPtrGraphicsPipeline createPipeline(mvk::Device * device, const mvk::UPtrRenderPass& renderPass) {
     auto pipelineCI = mvk::GraphicsPipeline::CreateInfo {};
     
     {
@@ -175,7 +138,69 @@ int main(int argc, char ** argv) {
         pipelineCI.vertexInputState.vertexAttributeDescriptions.push_back(attribute);
     }
 
-    auto pPipeline = pDevice->createPipeline(pipelineCI, pRenderPass);
+    return device->createPipeline(pipelineCI, renderPass);
+}
+
+int runWindowed() {
+    if (!glfwInit()) {
+        throw std::runtime_error("Failed to init GLFW!");
+    }
+
+    //mvk::Instance::enableLayer(mvk::InstanceLayer::API_DUMP);
+    mvk::Instance::enableRequiredGLFWExtensions();
+
+    auto& instance = mvk::Instance::getCurrent();
+    auto& physicalDevice = instance.getPhysicalDevice(0);
+    auto pDevice = physicalDevice.createDevice(std::set<std::string>({VK_KHR_SWAPCHAIN_EXTENSION_NAME}));
+
+    glfwDefaultWindowHints();
+    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+
+    auto pWindow = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Test Draw", nullptr, nullptr);
+    auto pSurface = std::make_unique<mvk::Surface> (instance, pWindow);
+
+    auto pQueueFamily = pDevice->getQueueFamily(0);
+
+    if (!pQueueFamily->canPresent(pSurface)) {
+        throw std::runtime_error("Selected QueueFamily cannot present image!");
+    }
+
+    auto swapchainCI = mvk::Swapchain::CreateInfo {};    
+    swapchainCI.queueFamily = pQueueFamily;
+    swapchainCI.surface = pSurface.get();
+    swapchainCI.surfaceFormat.format = mvk::Format::B8G8R8A8_UNORM;
+    swapchainCI.presentMode = mvk::PresentMode::FIFO;
+
+    auto pSwapchain = pDevice->createSwapchain(swapchainCI);
+    pSwapchain->resize(WINDOW_WIDTH, WINDOW_HEIGHT);
+
+    auto imageCI = mvk::Image::CreateInfo {};
+    imageCI.usage = mvk::ImageUsageFlag::COLOR_ATTACHMENT | mvk::ImageUsageFlag::TRANSFER_SRC;
+    imageCI.extent.width = WINDOW_WIDTH;
+    imageCI.extent.height = WINDOW_HEIGHT;
+    imageCI.extent.depth = 1;
+    imageCI.imageType = mvk::ImageType::IMAGE_2D;
+    imageCI.format = mvk::Format::B8G8R8A8_UNORM; 
+    imageCI.arrayLayers = 1;
+    imageCI.mipLevels = 1;
+    imageCI.samples = 1;
+    
+    //NOTE: A format that isn't copy-compatible with the backbuffer will force a more expensive image blit.
+    // You will have to pay for this anyway if you have extent mismatch
+
+    auto pImage = pDevice->createImage(imageCI, mvk::MemoryUsage::GPU_ONLY);
+    auto imageView = mvk::ImageView(pImage);
+
+    auto pRenderPass = createRenderPass(pDevice.get(), pImage->getInfo().format);
+
+    auto framebufferCI = mvk::Framebuffer::CreateInfo {};
+    framebufferCI.width = WINDOW_WIDTH;
+    framebufferCI.height = WINDOW_HEIGHT;
+    framebufferCI.layers = 1;
+
+    auto framebuffer = mvk::Framebuffer(pRenderPass, framebufferCI, std::vector<const mvk::ImageView * > ({&imageView}));
+
+    auto pPipeline = createPipeline(pDevice.get(), pRenderPass);
 
     float constants[16];
     for (int i = 0; i < 16; i++) {
@@ -210,18 +235,22 @@ int main(int argc, char ** argv) {
         indices[2] = 2;
     });
 
-    auto pDrawCommand = pQueueFamily->getCurrentCommandPool()->allocate();
-    pDrawCommand->begin(mvk::CommandBufferUsageFlag::SIMULTANEOUS_USE);
-    pDrawCommand->beginRenderPass(framebuffer);
-    pDrawCommand->setScissor(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
-    pDrawCommand->setViewport(0.0F, 0.0F, static_cast<float> (WINDOW_WIDTH), static_cast<float> (WINDOW_HEIGHT));
-    pDrawCommand->bindPipeline(pPipeline);
-    pDrawCommand->pushConstants(pPipeline, mvk::ShaderStage::VERTEX, 0, 16 * sizeof(float), constants);
-    pDrawCommand->bindVertexBuffer(0, pVertices);
-    pDrawCommand->bindIndexBuffer(pIndices, 0, mvk::IndexType::UINT16);
-    pDrawCommand->drawIndexed(3);
-    pDrawCommand->endRenderPass();
-    pDrawCommand->end();
+    auto pDrawCommand = pQueueFamily->getCurrentCommandPool()->allocateCached(mvk::CommandBufferUsageFlag::SIMULTANEOUS_USE, [&](auto cmd) {
+        cmd->beginRenderPass(framebuffer);
+        cmd->setScissor(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+        cmd->setViewport(0.0F, 0.0F, static_cast<float> (WINDOW_WIDTH), static_cast<float> (WINDOW_HEIGHT));
+        cmd->bindPipeline(pPipeline);
+        cmd->pushConstants(pPipeline, mvk::ShaderStage::VERTEX, 0, 16 * sizeof(float), constants);
+        cmd->bindVertexBuffer(0, pVertices);
+        cmd->bindIndexBuffer(pIndices, 0, mvk::IndexType::UINT16);
+        cmd->drawIndexed(3);
+        cmd->endRenderPass();
+    });
+
+    pDrawCommand->track(&framebuffer);
+    pDrawCommand->track(pPipeline);
+    pDrawCommand->track(pVertices);
+    pDrawCommand->track(pIndices);
 
     auto pQueue = pQueueFamily->getQueue(0);
 
@@ -240,7 +269,7 @@ int main(int argc, char ** argv) {
     while (!glfwWindowShouldClose(pWindow)) {
         auto now = glfwGetTime();
 
-        pQueue->submit(pDrawCommand.get());
+        pQueue->submit(pDrawCommand->getCommandBuffer());
         pQueue->present(presentInfo);
 
         glfwPollEvents();
@@ -261,4 +290,273 @@ int main(int argc, char ** argv) {
 
     glfwDestroyWindow(pWindow);
     glfwTerminate();
+
+    return 0;
+}
+
+struct HeadlessOptions {
+    std::uint32_t triangles = 10000;
+    std::uint32_t draws = 100;
+    std::uint32_t frames = 500;
+    std::ptrdiff_t device = 0;
+};
+
+// Vertex colors are packed as R8G8B8A8_UNORM; each triangle gets its own opaque color.
+unsigned int triangleColor(std::uint32_t triangle) noexcept {
+    return 0xFF000000u | ((triangle * 2654435761u) & 0x00FFFFFFu) | 0x00000080u;
+}
+
+int runHeadless(const HeadlessOptions& options) {
+    auto& instance = mvk::Instance::getCurrent();
+    auto& physicalDevice = instance.getPhysicalDevice(options.device);
+    auto pDevice = physicalDevice.createDevice();
+
+    auto pQueueFamily = pDevice->getQueueFamily(0);
+    auto pQueue = pQueueFamily->getQueue(0);
+    auto pCommandPool = pQueueFamily->getCurrentCommandPool();
+
+    auto imageCI = mvk::Image::CreateInfo {};
+    imageCI.usage = mvk::ImageUsageFlag::COLOR_ATTACHMENT | mvk::ImageUsageFlag::TRANSFER_SRC;
+    imageCI.extent.width = WINDOW_WIDTH;
+    imageCI.extent.height = WINDOW_HEIGHT;
+    imageCI.extent.depth = 1;
+    imageCI.imageType = mvk::ImageType::IMAGE_2D;
+    imageCI.format = mvk::Format::B8G8R8A8_UNORM;
+    imageCI.arrayLayers = 1;
+    imageCI.mipLevels = 1;
+    imageCI.samples = 1;
+    imageCI.name = "offscreen";
+
+    auto pImage = pDevice->createImage(imageCI, mvk::MemoryUsage::GPU_ONLY);
+    auto imageView = mvk::ImageView(pImage);
+    auto pRenderPass = createRenderPass(pDevice.get(), imageCI.format);
+
+    auto framebufferCI = mvk::Framebuffer::CreateInfo {};
+    framebufferCI.width = WINDOW_WIDTH;
+    framebufferCI.height = WINDOW_HEIGHT;
+    framebufferCI.layers = 1;
+
+    auto framebuffer = mvk::Framebuffer(pRenderPass, framebufferCI, std::vector<const mvk::ImageView * > ({&imageView}));
+    auto pPipeline = createPipeline(pDevice.get(), pRenderPass);
+
+    float constants[16];
+    for (int i = 0; i < 16; i++) {
+        constants[i] = static_cast<float> (i % 5 == 0);
+    }
+
+    // one triangle in the lower-left half of every cell of a square grid, so triangles never overlap
+    const auto gridSize = static_cast<std::uint32_t> (std::ceil(std::sqrt(static_cast<double> (options.triangles))));
+    const auto cellSize = 2.0F / gridSize;
+
+    auto bufferCI = mvk::Buffer::CreateInfo {};
+    bufferCI.usage = mvk::BufferUsageFlag::VERTEX_BUFFER;
+    bufferCI.size = 3 * sizeof(Vertex) * options.triangles;
+
+    auto pVertices = pDevice->createBuffer(bufferCI, mvk::MemoryUsage::CPU_TO_GPU);
+    pVertices->mapping<Vertex>([&](auto verts) {
+        for (std::uint32_t i = 0; i < options.triangles; i++) {
+            const auto x = -1.0F + (i % gridSize) * cellSize;
+            const auto y = -1.0F + (i / gridSize) * cellSize;
+            const auto color = triangleColor(i);
+
+            verts[3 * i + 0] = {x, y, color};
+            verts[3 * i + 1] = {x, y + cellSize, color};
+            verts[3 * i + 2] = {x + cellSize, y + cellSize, color};
+        }
+    });
+
+    const auto draws = std::max(1u, std::min(options.draws, options.triangles));
+    const auto trianglesPerDraw = options.triangles / draws;
+
+    auto commandBuffers = std::vector<mvk::UPtrCommandBuffer> ();
+    auto fences = std::vector<mvk::Fence * > ();
+    auto pending = std::vector<bool> (FRAMES_IN_FLIGHT, false);
+
+    for (std::uint32_t i = 0; i < FRAMES_IN_FLIGHT; i++) {
+        commandBuffers.push_back(pCommandPool->allocate());
+        fences.push_back(pDevice->acquireFence());
+    }
+
+    auto recordTimes = std::vector<double> ();
+    recordTimes.reserve(options.frames);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (std::uint32_t frame = 0; frame < options.frames; frame++) {
+        const auto slot = frame % FRAMES_IN_FLIGHT;
+        auto cmd = commandBuffers[slot].get();
+
+        if (pending[slot]) {
+            fences[slot]->waitFor();
+            fences[slot]->reset();
+        }
+
+        const auto recordStart = std::chrono::steady_clock::now();
+
+        cmd->begin(mvk::CommandBufferUsageFlag::ONE_TIME_SUBMIT);
+        cmd->beginRenderPass(framebuffer);
+        cmd->setScissor(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+        cmd->setViewport(0.0F, 0.0F, static_cast<float> (WINDOW_WIDTH), static_cast<float> (WINDOW_HEIGHT));
+        cmd->bindPipeline(pPipeline);
+        cmd->pushConstants(pPipeline, mvk::ShaderStage::VERTEX, 0, 16 * sizeof(float), constants);
+        cmd->bindVertexBuffer(0, pVertices);
+
+        for (std::uint32_t draw = 0; draw < draws; draw++) {
+            // the last draw takes the remainder
+            const auto first = draw * trianglesPerDraw;
+            const auto count = (draws - 1 == draw) ? options.triangles - first : trianglesPerDraw;
+
+            cmd->draw(static_cast<int> (3 * count), 1, static_cast<int> (3 * first));
+        }
+
+        cmd->endRenderPass();
+        cmd->end();
+
+        recordTimes.push_back(std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now() - recordStart).count());
+
+        pQueue->submit(cmd, fences[slot]);
+        pending[slot] = true;
+    }
+
+    pQueue->waitIdle();
+
+    const auto seconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+
+    for (auto fence : fences) {
+        fence->reset();
+        fence->release();
+    }
+
+    // read back the last frame
+    auto readbackCI = mvk::Buffer::CreateInfo {};
+    readbackCI.usage = mvk::BufferUsageFlag::TRANSFER_DST;
+    readbackCI.size = WINDOW_WIDTH * WINDOW_HEIGHT * 4;
+
+    auto pReadback = pDevice->createBuffer(readbackCI, mvk::MemoryUsage::GPU_TO_CPU);
+
+    {
+        auto subresource = mvk::ImageSubresourceLayers {};
+        subresource.aspectMask = mvk::AspectFlag::COLOR;
+        subresource.mipLevel = 0;
+        subresource.baseArrayLayer = 0;
+        subresource.layerCount = 1;
+
+        auto cmd = pCommandPool->allocate();
+
+        cmd->begin(mvk::CommandBufferUsageFlag::ONE_TIME_SUBMIT);
+        cmd->stageImage(pImage,
+            mvk::ImageLayout::COLOR_ATTACHMENT, mvk::ImageLayout::TRANSFER_SRC,
+            mvk::PipelineStageFlag::COLOR_ATTACHMENT_OUTPUT_BIT, mvk::PipelineStageFlag::TRANSFER,
+            mvk::AccessFlag::COLOR_ATTACHMENT_WRITE, mvk::AccessFlag::TRANSFER_READ);
+        cmd->copyImageToBuffer(pImage, mvk::ImageLayout::TRANSFER_SRC, subresource, {0, 0, 0}, imageCI.extent, pReadback, 0);
+
+        // makes the copy visible to the host mapping below
+        auto readbackBarrier = mvk::BufferMemoryBarrier {};
+        readbackBarrier.srcAccessMask = mvk::AccessFlag::TRANSFER_WRITE;
+        readbackBarrier.dstAccessMask = mvk::AccessFlag::HOST_READ;
+        readbackBarrier.buffer = pReadback.get();
+        readbackBarrier.offset = 0;
+        readbackBarrier.size = mvk::Buffer::WHOLE_SIZE;
+
+        cmd->pipelineBarrier(
+            mvk::PipelineStageFlag::TRANSFER, mvk::PipelineStageFlag::HOST,
+            mvk::DependencyFlag::NONE,
+            0, nullptr,
+            1, &readbackBarrier,
+            0, nullptr);
+
+        cmd->end();
+
+        pQueue->submit(cmd);
+        pQueue->waitIdle();
+    }
+
+    // every checked pixel must be either the clear color or the color of the triangle covering it
+    std::size_t errors = 0;
+    std::size_t covered = 0;
+
+    pReadback->mapping<std::uint8_t>([&](auto pixels) {
+        const auto cellWidth = static_cast<double> (WINDOW_WIDTH) / gridSize;
+        const auto cellHeight = static_cast<double> (WINDOW_HEIGHT) / gridSize;
+
+        for (std::uint32_t i = 0; i < options.triangles; i += std::max(1u, options.triangles / 256)) {
+            // a point well inside the triangle, at a quarter of the cell from its lower-left corner
+            const auto px = static_cast<int> (((i % gridSize) + 0.25) * cellWidth);
+            const auto py = static_cast<int> (((i / gridSize) + 0.75) * cellHeight);
+
+            if (cellWidth < 4.0 || cellHeight < 4.0) {
+                break;
+            }
+
+            const auto pixel = pixels + 4 * (py * WINDOW_WIDTH + px);
+            const auto color = triangleColor(i);
+
+            covered++;
+
+            // B8G8R8A8 against R8G8B8A8
+            if (pixel[0] != ((color >> 16) & 0xFF) || pixel[1] != ((color >> 8) & 0xFF) || pixel[2] != (color & 0xFF)) {
+                errors++;
+            }
+        }
+
+        if (0 == covered) {
+            // the cells are too small to sample; only check that something was drawn
+            bool drawn = false;
+
+            for (int i = 0; i < WINDOW_WIDTH * WINDOW_HEIGHT && !drawn; i++) {
+                drawn = 0 != pixels[4 * i] || 0 != pixels[4 * i + 1] || 0 != pixels[4 * i + 2];
+            }
+
+            errors = drawn ? 0 : 1;
+        }
+    });
+
+    std::sort(recordTimes.begin(), recordTimes.end());
+
+    double recordSum = 0.0;
+
+    for (auto recordTime : recordTimes) {
+        recordSum += recordTime;
+    }
+
+    std::printf("%s\n", physicalDevice.toString().c_str());
+    std::printf("triangles: %u draws: %u frames: %u resolution: %dx%d\n", options.triangles, draws, options.frames, WINDOW_WIDTH, WINDOW_HEIGHT);
+    std::printf("FPS: %.2f\n", options.frames / seconds);
+    std::printf("draws/s: %.0f\n", static_cast<double> (draws) * options.frames / seconds);
+    std::printf("triangles/s: %.0f\n", static_cast<double> (options.triangles) * options.frames / seconds);
+    std::printf("CPU record ms/frame: mean %.4f median %.4f p99 %.4f\n",
+        recordSum / recordTimes.size(),
+        recordTimes[recordTimes.size() / 2],
+        recordTimes[std::min(recordTimes.size() - 1, recordTimes.size() * 99 / 100)]);
+    std::printf("readback check: %s (%zu sampled triangles)\n", 0 == errors ? "PASS" : "FAIL", covered);
+
+    pQueueFamily->detach();
+
+    return 0 == errors ? 0 : 1;
+}
+
+int main(int argc, char ** argv) {
+    bool headless = false;
+    auto options = HeadlessOptions {};
+
+    for (int i = 1; i < argc; i++) {
+        const auto arg = std::string(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if ("--headless" == arg) {
+            headless = true;
+        } else if ("--triangles" == arg && hasValue) {
+            options.triangles = static_cast<std::uint32_t> (std::max(1, std::atoi(argv[++i])));
+        } else if ("--draws" == arg && hasValue) {
+            options.draws = static_cast<std::uint32_t> (std::max(1, std::atoi(argv[++i])));
+        } else if ("--frames" == arg && hasValue) {
+            options.frames = static_cast<std::uint32_t> (std::max(1, std::atoi(argv[++i])));
+        } else if ("--device" == arg && hasValue) {
+            options.device = std::atoi(argv[++i]);
+        } else {
+            throw std::runtime_error("Unknown argument: " + arg);
+        }
+    }
+
+    return headless ? runHeadless(options) : runWindowed();
 }